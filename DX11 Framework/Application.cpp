@@ -44,6 +44,8 @@ void Application::Update()
 		Keyboard::KeyboardEvent kbe = keyboard.ReadKey();
 		unsigned char keycode = kbe.GetKeyCode();
 	}
+	// picking rays all come from the main camera as it was at the start of the frame
+	mousePick.UpdateMatrices( gfx.cameras["Main"]->GetViewMatrix(), gfx.cameras["Main"]->GetProjectionMatrix() );
 	while ( !mouse.EventBufferIsEmpty() )
 	{
 		Mouse::MouseEvent me = mouse.ReadEvent();
@@ -65,9 +67,9 @@ void Application::Update()
 						0.0f
 					);
 				}
-				else
+				else if ( Transform* player = gfx.GetPlayerTransform() )
 				{
-					gfx.renderables[0].AdjustRotation(
+					player->AdjustRotation(
 						0.0f,
 						static_cast<float>( me.GetPosX() ) * 0.005f,
 						0.0f
@@ -77,8 +79,7 @@ void Application::Update()
 		}
 		if( me.GetType() == Mouse::MouseEvent::EventType::LPress && gfx.gameState != Graphics::GameState::MENU )
 		{
-			mousePick.UpdateMatrices( gfx.cameras["Main"]->GetViewMatrix(), gfx.cameras["Main"]->GetProjectionMatrix() );
-			if ( mousePick.TestIntersection( me.GetPosX(), me.GetPosY(), gfx.light ) && !lightParams.lightStuck )
+			if ( PickObject( me.GetPosX(), me.GetPosY() ) == gfx.GetLightObjectIndex() && !lightParams.lightStuck )
 			{
 				lightParams.lightIntersection = true;
 				PlaySound( TEXT( "res\\audio\\pickup.wav" ), NULL, SND_FILENAME || SND_ASYNC );
@@ -86,8 +87,7 @@ void Application::Update()
 		}
 		if( me.GetType() == Mouse::MouseEvent::EventType::Move && gfx.gameState != Graphics::GameState::MENU )
 		{
-			mousePick.UpdateMatrices( gfx.cameras["Main"]->GetViewMatrix(), gfx.cameras["Main"]->GetProjectionMatrix() );
-			if ( mousePick.TestIntersection( me.GetPosX(), me.GetPosY(), gfx.light ) )
+			if ( PickObject( me.GetPosX(), me.GetPosY() ) == gfx.GetLightObjectIndex() )
 				lightParams.lightHover = true;
 		}
 		else
@@ -173,25 +173,29 @@ void Application::Update()
 				gfx.cameras[gfx.cameraToUse]->SetPosition( gfx.cameras[gfx.cameraToUse]->GetPositionFloat3().x,
 					9.0f, gfx.cameras[gfx.cameraToUse]->GetPositionFloat3().z );
 		}
-		else
+		else if ( Transform* player = gfx.GetPlayerTransform() )
 		{
 			// model movement
 			if ( keyboard.KeyIsPressed( 'W' ) )
-				CameraMove::MoveForward( gfx.cameras[gfx.cameraToUse], gfx.renderables[0], dt );
+				CameraMove::MoveForward( gfx.cameras[gfx.cameraToUse], *player, dt );
 
 			if ( keyboard.KeyIsPressed( 'A' ) )
-				CameraMove::MoveLeft( gfx.cameras[gfx.cameraToUse], gfx.renderables[0], dt );
+				CameraMove::MoveLeft( gfx.cameras[gfx.cameraToUse], *player, dt );
 
 			if ( keyboard.KeyIsPressed( 'S' ) )
-				CameraMove::MoveBackward( gfx.cameras[gfx.cameraToUse], gfx.renderables[0], dt );
+				CameraMove::MoveBackward( gfx.cameras[gfx.cameraToUse], *player, dt );
 
 			if ( keyboard.KeyIsPressed( 'D' ) )
-				CameraMove::MoveRight( gfx.cameras[gfx.cameraToUse], gfx.renderables[0], dt );
+				CameraMove::MoveRight( gfx.cameras[gfx.cameraToUse], *player, dt );
 		}
 
 		// camera world collisions
 		for ( auto const& cam : gfx.cameras )
 		{
+			// attached cameras go wherever their parent takes them
+			if ( cam.second->HasParent() )
+				continue;
+
 			// y world collisions
 			if ( cam.second->GetPositionFloat3().y <= 6.0f )
 				cam.second->SetPosition( cam.second->GetPositionFloat3().x, 6.0f, cam.second->GetPositionFloat3().z );
@@ -211,38 +215,57 @@ void Application::Update()
 				cam.second->SetPosition( cam.second->GetPositionFloat3().x, cam.second->GetPositionFloat3().y, 50.0f );
 		}
 
-		// third person x world collisions
-		if ( gfx.renderables[0].GetPositionFloat3().x >= 50.0f )
-			gfx.renderables[0].SetPosition( 50.0f, gfx.renderables[0].GetPositionFloat3().y, gfx.renderables[0].GetPositionFloat3().z );
-		if ( gfx.renderables[0].GetPositionFloat3().x <= -125.0f )
-			gfx.renderables[0].SetPosition( -125.0f, gfx.renderables[0].GetPositionFloat3().y, gfx.renderables[0].GetPositionFloat3().z );
-
-		// third person z world collisions
-		if ( gfx.renderables[0].GetPositionFloat3().z >= 50.0f )
-			gfx.renderables[0].SetPosition( gfx.renderables[0].GetPositionFloat3().x, gfx.renderables[0].GetPositionFloat3().y, 50.0f );
-		if ( gfx.renderables[0].GetPositionFloat3().z <= -100.0f )
-			gfx.renderables[0].SetPosition( gfx.renderables[0].GetPositionFloat3().x, gfx.renderables[0].GetPositionFloat3().y, -100.0f );
-
-		// light object position
-		XMVECTOR lightPosition = gfx.cameras[gfx.cameraToUse]->GetPositionVector();
-		lightPosition += gfx.cameras[gfx.cameraToUse]->GetForwardVector() / 2;
-		if ( ( ( keyboard.KeyIsPressed( 'C' ) || lightParams.lightStuck ) && lightParams.isEquippable ) || lightParams.lightIntersection )
+		if ( Transform* player = gfx.GetPlayerTransform() )
+		{
+			// third person x world collisions
+			if ( player->GetPositionFloat3().x >= 50.0f )
+				player->SetPosition( 50.0f, player->GetPositionFloat3().y, player->GetPositionFloat3().z );
+			if ( player->GetPositionFloat3().x <= -125.0f )
+				player->SetPosition( -125.0f, player->GetPositionFloat3().y, player->GetPositionFloat3().z );
+
+			// third person z world collisions
+			if ( player->GetPositionFloat3().z >= 50.0f )
+				player->SetPosition( player->GetPositionFloat3().x, player->GetPositionFloat3().y, 50.0f );
+			if ( player->GetPositionFloat3().z <= -100.0f )
+				player->SetPosition( player->GetPositionFloat3().x, player->GetPositionFloat3().y, -100.0f );
+		}
+
+		// light object position, an equipped light is held by whichever camera is in use
+		Camera3D* camera = gfx.cameras[gfx.cameraToUse].get();
+		Transform* light = gfx.GetLightTransform();
+		if ( light != nullptr &&
+			( ( ( keyboard.KeyIsPressed( 'C' ) || lightParams.lightStuck ) && lightParams.isEquippable ) || lightParams.lightIntersection ) )
 		{
 			lightParams.lightStuck = true;
 			lightParams.lightHover = false;
 			lightParams.lightIntersection = false;
-			lightPosition += gfx.cameras[gfx.cameraToUse]->GetRightVector() / 2;
-			lightPosition -= { 0.0f, 0.25f, 0.0f, 0.0f };
-			gfx.light.SetPosition( lightPosition );
-			gfx.light.SetRotation( gfx.cameras[gfx.cameraToUse]->GetRotationVector() );
+			if ( light->GetParent() != camera->GetTransformHandle() )
+			{
+				light->SetParent( camera->GetTransformHandle() );
+				light->SetRotation( 0.0f, 0.0f, 0.0f );
+			}
+
+			// half a unit ahead and to the right of the camera, the quarter unit drop stays in world space as the camera pitches
+			const XMVECTOR forward = camera->GetForwardVector();
+			const XMVECTOR right = camera->GetRightVector();
+			const XMVECTOR drop = XMVectorSet( 0.0f, -0.25f, 0.0f, 0.0f );
+			light->SetPosition(
+				0.5f + XMVectorGetX( XMVector3Dot( drop, right ) ),
+				XMVectorGetX( XMVector3Dot( drop, XMVector3Cross( forward, right ) ) ),
+				0.5f + XMVectorGetX( XMVector3Dot( drop, forward ) ) );
 		}
 
-		if ( keyboard.KeyIsPressed( 'X' ) && lightParams.lightStuck )
+		if ( light != nullptr && keyboard.KeyIsPressed( 'X' ) && lightParams.lightStuck )
 		{
 			lightParams.lightStuck = false;
-			gfx.light.SetPosition( lightPosition );
+			light->SetParent( TransformStore::INVALID, true );
+			light->SetPosition( camera->GetWorldPositionVector() + camera->GetForwardVector() / 2 );
 		}
 
+		// unequipped from the scene window, it drops from where it was held
+		if ( light != nullptr && !lightParams.lightStuck && light->GetParent() != TransformStore::INVALID )
+			light->SetParent( TransformStore::INVALID, true );
+
 		// manage viewports
 		if ( keyboard.KeyIsPressed( VK_UP ) )
 		{
@@ -268,24 +291,14 @@ void Application::Update()
 
 void Application::Render()
 {
-	if ( !viewportParams.useSplit )
-	{
-		gfx.BeginFrame();
-		gfx.RenderFrame();
-		gfx.EndFrame();
-	}
-	else
-	{
-		viewportParams.useLeft = true;
-		gfx.BeginFrame();
-		gfx.RenderFrame();
-
-		viewportParams.useRight = true;
-		gfx.BeginFrame();
-		gfx.RenderFrame();
+	gfx.RenderFrame();
+}
 
-		viewportParams.useFull = true;
-		gfx.BeginFrame();
-		gfx.EndFrame();
-	}
+// triangle picking finds what is under the cursor, box picking only the nearest bounds the ray enters
+UINT Application::PickObject( int mouseX, int mouseY ) const noexcept
+{
+	const PickRay ray = mousePick.GetRay( mouseX, mouseY );
+	if ( sceneParams.precisePicking )
+		return gfx.PickTriangle( ray ).object;
+	return gfx.GetSceneBVH().Intersect( ray ).object;
 }
\ No newline at end of file
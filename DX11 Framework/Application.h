@@ -20,6 +20,7 @@ public:
 	void Update();
 	void Render();
 private:
+	UINT PickObject( int mouseX, int mouseY ) const noexcept;
 	Timer timer;
 	MousePicking mousePick;
 };
@@ -1,13 +1,20 @@
 #include "Application.h"
+#include "utility/Tools.h"
+#include "utility/Benchmarks.h"
 
 int WINAPI WinMain( HINSTANCE hInstance, HINSTANCE hPrevInstance, LPSTR lpCmdLine, int nCmdShow )
 {
     UNREFERENCED_PARAMETER( hPrevInstance );
-    UNREFERENCED_PARAMETER( lpCmdLine );
     UNREFERENCED_PARAMETER( nCmdShow );
 
     HRESULT hr = CoInitialize( NULL );
 
+    // offline tools and benchmarks run without creating a window
+    if ( Tools::IsToolCommand( lpCmdLine ) )
+        return Tools::Run( lpCmdLine );
+    if ( Benchmarks::IsBenchmarkCommand( lpCmdLine ) )
+        return Benchmarks::Run( lpCmdLine );
+
     Application theApp;
 	if ( theApp.Initialize( hInstance, "DX11 Framework", "TutorialWindowClass", 1280, 720 ) )
 	{
@@ -0,0 +1,142 @@
+#include "Archetype.h"
+#include <bitset>
+#include <mutex>
+#include <new>
+#include <stdexcept>
+
+namespace
+{
+	std::mutex registryMutex;
+	std::vector<ComponentInfo> registryInfos;
+}
+
+ComponentInfo ComponentRegistry::GetInfo( ComponentId id )
+{
+	std::lock_guard<std::mutex> lock( registryMutex );
+	return registryInfos[id];
+}
+
+uint32_t ComponentRegistry::GetCount()
+{
+	std::lock_guard<std::mutex> lock( registryMutex );
+	return static_cast<uint32_t>( registryInfos.size() );
+}
+
+// a mask bit per type, so the number of types is capped
+ComponentId ComponentRegistry::Register( const ComponentInfo& info )
+{
+	std::lock_guard<std::mutex> lock( registryMutex );
+	if ( registryInfos.size() >= MAX_COMPONENT_TYPES )
+		throw std::length_error( "too many component types" );
+	registryInfos.push_back( info );
+	return static_cast<ComponentId>( registryInfos.size() - 1 );
+}
+
+Column::Column( const ComponentInfo& info ) noexcept
+	: info( info )
+{}
+
+Column::Column( Column&& other ) noexcept
+	: info( other.info ), data( other.data ), count( other.count ), capacity( other.capacity )
+{
+	other.data = nullptr;
+	other.count = 0;
+	other.capacity = 0;
+}
+
+Column::~Column()
+{
+	if ( info.destroy != nullptr )
+		for ( uint32_t i = 0; i < count; i++ )
+			info.destroy( Get( i ) );
+	if ( data != nullptr )
+		::operator delete( data, std::align_val_t( info.alignment ) );
+}
+
+// the returned slot is uninitialized, the caller constructs the value in place
+void* Column::Push()
+{
+	if ( count == capacity )
+		Reserve( capacity == 0 ? 16u : capacity * 2u );
+	return Get( count++ );
+}
+
+void Column::MoveFrom( void* destination, void* source ) noexcept
+{
+	if ( info.moveConstruct != nullptr )
+		info.moveConstruct( destination, source );
+	else
+		std::memcpy( destination, source, info.size );
+}
+
+// the last row fills the hole, so rows stay packed but their order changes
+void Column::SwapRemove( uint32_t row ) noexcept
+{
+	void* hole = Get( row );
+	if ( info.destroy != nullptr )
+		info.destroy( hole );
+	const uint32_t last = count - 1u;
+	if ( row != last )
+	{
+		MoveFrom( hole, Get( last ) );
+		if ( info.destroy != nullptr )
+			info.destroy( Get( last ) );
+	}
+	count--;
+}
+
+void Column::Reserve( uint32_t newCapacity )
+{
+	unsigned char* newData = static_cast<unsigned char*>( ::operator new( static_cast<size_t>( newCapacity ) * info.size, std::align_val_t( info.alignment ) ) );
+	if ( data != nullptr )
+	{
+		for ( uint32_t i = 0; i < count; i++ )
+		{
+			void* source = Get( i );
+			MoveFrom( newData + static_cast<size_t>( i ) * info.size, source );
+			if ( info.destroy != nullptr )
+				info.destroy( source );
+		}
+		::operator delete( data, std::align_val_t( info.alignment ) );
+	}
+	data = newData;
+	capacity = newCapacity;
+}
+
+Archetype::Archetype( ComponentMask mask )
+	: mask( mask )
+{
+	columns.reserve( std::bitset<MAX_COMPONENT_TYPES>( mask ).count() );
+	for ( ComponentId id = 0; id < MAX_COMPONENT_TYPES; id++ )
+		if ( Has( id ) )
+			columns.emplace_back( ComponentRegistry::GetInfo( id ) );
+}
+
+// columns are in id order, so a type's column is the number of lower ids in the mask
+Column& Archetype::GetColumn( ComponentId id ) noexcept
+{
+	const ComponentMask lower = mask & ( ( 1ull << id ) - 1ull );
+	return columns[std::bitset<MAX_COMPONENT_TYPES>( lower ).count()];
+}
+
+// only records the entity, the caller pushes a value onto every column
+uint32_t Archetype::Push( Entity entity )
+{
+	entities.push_back( entity );
+	return static_cast<uint32_t>( entities.size() - 1 );
+}
+
+// returns the entity that moved into the removed row, if any
+Entity Archetype::SwapRemove( uint32_t row ) noexcept
+{
+	for ( Column& column : columns )
+		column.SwapRemove( row );
+	Entity moved;
+	if ( row != entities.size() - 1 )
+	{
+		entities[row] = entities.back();
+		moved = entities[row];
+	}
+	entities.pop_back();
+	return moved;
+}
\ No newline at end of file
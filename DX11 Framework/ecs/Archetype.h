@@ -0,0 +1,115 @@
+#pragma once
+#ifndef ARCHETYPE_H
+#define ARCHETYPE_H
+
+#include <array>
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <utility>
+#include <vector>
+
+// standard library only, nothing here knows about direct3d
+using ComponentId = uint32_t;
+using ComponentMask = uint64_t;
+static constexpr uint32_t MAX_COMPONENT_TYPES = 64u;
+
+// an index into the world's records, the generation tells a reused index from the entity that held it before
+struct Entity
+{
+	uint32_t index = UINT32_MAX;
+	uint32_t generation = 0;
+	bool IsValid() const noexcept { return index != UINT32_MAX; }
+	bool operator==( const Entity& other ) const noexcept { return index == other.index && generation == other.generation; }
+	bool operator!=( const Entity& other ) const noexcept { return !( *this == other ); }
+};
+
+// how a column moves and destroys values it only knows by size
+// trivially copyable types leave both empty and are moved with memcpy
+struct ComponentInfo
+{
+	size_t size = 0;
+	size_t alignment = 0;
+	void ( *moveConstruct )( void* destination, void* source ) = nullptr;
+	void ( *destroy )( void* value ) = nullptr;
+};
+
+// every component type gets an id on first use, shared by all worlds
+class ComponentRegistry
+{
+public:
+	template<typename T>
+	static ComponentId GetId()
+	{
+		static const ComponentId id = Register( MakeInfo<T>() );
+		return id;
+	}
+	template<typename T>
+	static ComponentMask GetMask() { return 1ull << GetId<T>(); }
+	static ComponentInfo GetInfo( ComponentId id );
+	static uint32_t GetCount();
+private:
+	template<typename T>
+	static ComponentInfo MakeInfo()
+	{
+		static_assert( std::is_nothrow_move_constructible_v<T>, "components must be nothrow move constructible" );
+		ComponentInfo info;
+		info.size = sizeof( T );
+		info.alignment = alignof( T );
+		if constexpr ( !std::is_trivially_copyable_v<T> )
+			info.moveConstruct = []( void* destination, void* source ) { new ( destination ) T( std::move( *static_cast<T*>( source ) ) ); };
+		if constexpr ( !std::is_trivially_destructible_v<T> )
+			info.destroy = []( void* value ) { static_cast<T*>( value )->~T(); };
+		return info;
+	}
+	static ComponentId Register( const ComponentInfo& info );
+};
+
+// one component's values for every entity of an archetype, packed in row order
+class Column
+{
+public:
+	explicit Column( const ComponentInfo& info ) noexcept;
+	Column( Column&& other ) noexcept;
+	Column( const Column& ) = delete;
+	Column& operator=( const Column& ) = delete;
+	~Column();
+	void* Get( uint32_t row ) const noexcept { return data + static_cast<size_t>( row ) * info.size; }
+	void* Push();
+	void MoveFrom( void* destination, void* source ) noexcept;
+	void SwapRemove( uint32_t row ) noexcept;
+	uint32_t GetCount() const noexcept { return count; }
+private:
+	void Reserve( uint32_t newCapacity );
+	ComponentInfo info;
+	unsigned char* data = nullptr;
+	uint32_t count = 0;
+	uint32_t capacity = 0;
+};
+
+// every entity with exactly one set of component types, a column per type in ascending id order
+// the add and remove edges remember which archetype an entity moves to, so repeated changes skip the lookup
+class Archetype
+{
+public:
+	explicit Archetype( ComponentMask mask );
+	ComponentMask GetMask() const noexcept { return mask; }
+	bool Has( ComponentId id ) const noexcept { return ( mask >> id & 1u ) != 0u; }
+	uint32_t GetCount() const noexcept { return static_cast<uint32_t>( entities.size() ); }
+	const Entity* GetEntities() const noexcept { return entities.data(); }
+	Column& GetColumn( ComponentId id ) noexcept;
+	template<typename T>
+	T* GetValues() noexcept { return static_cast<T*>( GetColumn( ComponentRegistry::GetId<T>() ).Get( 0 ) ); }
+	void* Get( ComponentId id, uint32_t row ) noexcept { return GetColumn( id ).Get( row ); }
+	uint32_t Push( Entity entity );
+	Entity SwapRemove( uint32_t row ) noexcept;
+	std::array<Archetype*, MAX_COMPONENT_TYPES> addEdges = {};
+	std::array<Archetype*, MAX_COMPONENT_TYPES> removeEdges = {};
+private:
+	ComponentMask mask;
+	std::vector<Column> columns;
+	std::vector<Entity> entities;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,125 @@
+#include "World.h"
+
+World::World()
+{
+	GetArchetype( 0ull );
+}
+
+// new entities hold no components and live in the empty archetype
+Entity World::Create()
+{
+	Entity entity;
+	if ( !freeIndices.empty() )
+	{
+		entity.index = freeIndices.back();
+		freeIndices.pop_back();
+	}
+	else
+	{
+		entity.index = static_cast<uint32_t>( records.size() );
+		records.emplace_back();
+	}
+	Record& record = records[entity.index];
+	entity.generation = record.generation;
+	record.archetype = archetypes[0].get();
+	record.row = record.archetype->Push( entity );
+	entityCount++;
+	return entity;
+}
+
+// the index is reused by a later entity, the bumped generation keeps old handles from reaching it
+void World::Destroy( Entity entity )
+{
+	if ( !IsAlive( entity ) )
+		return;
+	Record& record = records[entity.index];
+	const Entity moved = record.archetype->SwapRemove( record.row );
+	if ( moved.IsValid() )
+		records[moved.index].row = record.row;
+	record.archetype = nullptr;
+	record.generation++;
+	freeIndices.push_back( entity.index );
+	entityCount--;
+}
+
+bool World::IsAlive( Entity entity ) const noexcept
+{
+	return entity.index < records.size() && records[entity.index].generation == entity.generation && records[entity.index].archetype != nullptr;
+}
+
+void World::Clear()
+{
+	queries.clear();
+	archetypeLookup.clear();
+	archetypes.clear();
+	records.clear();
+	freeIndices.clear();
+	entityCount = 0;
+	GetArchetype( 0ull );
+}
+
+uint32_t World::GetEntityCount() const noexcept
+{
+	return entityCount;
+}
+
+uint32_t World::GetArchetypeCount() const noexcept
+{
+	return static_cast<uint32_t>( archetypes.size() );
+}
+
+Archetype* World::GetArchetype( ComponentMask mask )
+{
+	auto found = archetypeLookup.find( mask );
+	if ( found != archetypeLookup.end() )
+		return found->second;
+	archetypes.push_back( std::make_unique<Archetype>( mask ) );
+	Archetype* archetype = archetypes.back().get();
+	archetypeLookup.emplace( mask, archetype );
+	return archetype;
+}
+
+// moves every component the two archetypes share, drops the ones the target lacks
+// returns the uninitialized slot of the one component only the target has, if any
+void* World::Move( Entity entity, Archetype* target )
+{
+	Record& record = records[entity.index];
+	Archetype* source = record.archetype;
+	const uint32_t sourceRow = record.row;
+	const uint32_t row = target->Push( entity );
+	void* added = nullptr;
+	for ( ComponentMask remaining = target->GetMask(); remaining != 0ull; remaining &= remaining - 1ull )
+	{
+		ComponentId id = 0;
+		while ( ( remaining >> id & 1ull ) == 0ull )
+			id++;
+		Column& column = target->GetColumn( id );
+		void* destination = column.Push();
+		if ( source->Has( id ) )
+			column.MoveFrom( destination, source->Get( id, sourceRow ) );
+		else
+			added = destination;
+	}
+	const Entity moved = source->SwapRemove( sourceRow );
+	if ( moved.IsValid() )
+		records[moved.index].row = sourceRow;
+	record.archetype = target;
+	record.row = row;
+	return added;
+}
+
+// archetypes created since the query last ran are checked once, then the list is reused
+const std::vector<Archetype*>& World::Match( ComponentMask mask )
+{
+	auto found = queries.find( mask );
+	if ( found != queries.end() && found->second.checkedCount == archetypes.size() )
+		return found->second.matches;
+	Query& query = queries[mask];
+	for ( ; query.checkedCount < archetypes.size(); query.checkedCount++ )
+	{
+		Archetype* archetype = archetypes[query.checkedCount].get();
+		if ( ( archetype->GetMask() & mask ) == mask )
+			query.matches.push_back( archetype );
+	}
+	return query.matches;
+}
\ No newline at end of file
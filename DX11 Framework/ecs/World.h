@@ -0,0 +1,154 @@
+#pragma once
+#ifndef WORLD_H
+#define WORLD_H
+
+#include "Archetype.h"
+#include <memory>
+#include <tuple>
+#include <unordered_map>
+
+// entities with their components stored by archetype, one archetype per distinct set of component types
+//  - a type's values are packed per archetype, a query walks plain arrays instead of chasing pointers
+//  - adding or removing a component moves the entity's values to the archetype of its new set
+//  - archetypes are never freed, so the archetypes matching a query are found once and then only extended
+//  - pointers and references to components are valid until the next structural change: create, destroy, add or remove
+//  - a query's first run after new archetypes appear updates its match list, later runs only read
+//    so Each may run on several threads at once, once it has run on one thread since the last structural change
+class World
+{
+public:
+	World();
+	World( const World& ) = delete;
+	World& operator=( const World& ) = delete;
+	Entity Create();
+	void Destroy( Entity entity );
+	bool IsAlive( Entity entity ) const noexcept;
+	void Clear();
+
+	// adding a type the entity already holds assigns it, removing one it lacks does nothing
+	template<typename T>
+	T& Add( Entity entity, T value = T() );
+	template<typename T>
+	void Remove( Entity entity );
+	template<typename T>
+	T* Get( Entity entity ) noexcept;
+	template<typename T>
+	const T* Get( Entity entity ) const noexcept { return const_cast<World*>( this )->Get<T>( entity ); }
+	template<typename T>
+	bool Has( Entity entity ) const noexcept;
+
+	// calls function( Entity, Ts&... ) for every entity holding all of Ts, const types are only read
+	template<typename... Ts, typename Function>
+	void Each( Function&& function );
+	template<typename... Ts>
+	uint32_t Count();
+
+	uint32_t GetEntityCount() const noexcept;
+	uint32_t GetArchetypeCount() const noexcept;
+private:
+	struct Record
+	{
+		Archetype* archetype = nullptr;
+		uint32_t row = 0;
+		uint32_t generation = 0;
+	};
+	struct Query
+	{
+		std::vector<Archetype*> matches;
+		size_t checkedCount = 0;
+	};
+	template<typename... Ts>
+	static ComponentMask MaskOf() { return ( 0ull | ... | ComponentRegistry::GetMask<std::remove_const_t<Ts>>() ); }
+	Archetype* GetArchetype( ComponentMask mask );
+	void* Move( Entity entity, Archetype* target );
+	const std::vector<Archetype*>& Match( ComponentMask mask );
+private:
+	std::vector<Record> records;
+	std::vector<uint32_t> freeIndices;
+	std::vector<std::unique_ptr<Archetype>> archetypes;
+	std::unordered_map<ComponentMask, Archetype*> archetypeLookup;
+	std::unordered_map<ComponentMask, Query> queries;
+	uint32_t entityCount = 0;
+};
+
+template<typename T>
+T& World::Add( Entity entity, T value )
+{
+	Record& record = records[entity.index];
+	const ComponentId id = ComponentRegistry::GetId<T>();
+	if ( record.archetype->Has( id ) )
+	{
+		T& existing = *static_cast<T*>( record.archetype->Get( id, record.row ) );
+		existing = std::move( value );
+		return existing;
+	}
+	Archetype*& target = record.archetype->addEdges[id];
+	if ( target == nullptr )
+	{
+		target = GetArchetype( record.archetype->GetMask() | 1ull << id );
+		target->removeEdges[id] = record.archetype;
+	}
+	return *new ( Move( entity, target ) ) T( std::move( value ) );
+}
+
+template<typename T>
+void World::Remove( Entity entity )
+{
+	Record& record = records[entity.index];
+	const ComponentId id = ComponentRegistry::GetId<T>();
+	if ( !record.archetype->Has( id ) )
+		return;
+	Archetype*& target = record.archetype->removeEdges[id];
+	if ( target == nullptr )
+	{
+		target = GetArchetype( record.archetype->GetMask() & ~( 1ull << id ) );
+		target->addEdges[id] = record.archetype;
+	}
+	Move( entity, target );
+}
+
+template<typename T>
+T* World::Get( Entity entity ) noexcept
+{
+	if ( !IsAlive( entity ) )
+		return nullptr;
+	const Record& record = records[entity.index];
+	const ComponentId id = ComponentRegistry::GetId<T>();
+	if ( !record.archetype->Has( id ) )
+		return nullptr;
+	return static_cast<T*>( record.archetype->Get( id, record.row ) );
+}
+
+template<typename T>
+bool World::Has( Entity entity ) const noexcept
+{
+	return IsAlive( entity ) && records[entity.index].archetype->Has( ComponentRegistry::GetId<T>() );
+}
+
+template<typename... Ts, typename Function>
+void World::Each( Function&& function )
+{
+	for ( Archetype* archetype : Match( MaskOf<Ts...>() ) )
+	{
+		const uint32_t count = archetype->GetCount();
+		if ( count == 0 )
+			continue;
+		const Entity* entities = archetype->GetEntities();
+		std::apply( [&function, entities, count]( auto*... values )
+		{
+			for ( uint32_t row = 0; row < count; row++ )
+				function( entities[row], values[row]... );
+		}, std::make_tuple( archetype->GetValues<std::remove_const_t<Ts>>()... ) );
+	}
+}
+
+template<typename... Ts>
+uint32_t World::Count()
+{
+	uint32_t count = 0;
+	for ( Archetype* archetype : Match( MaskOf<Ts...>() ) )
+		count += archetype->GetCount();
+	return count;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,147 @@
+#include "World.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <memory>
+#include <random>
+#include <string>
+
+// the scene's old object lists against entity-component queries, with plain structs in place of directxmath
+namespace
+{
+	constexpr int ITERATIONS = 5;
+
+	struct Float3 { float x = 0.0f, y = 0.0f, z = 0.0f; };
+	struct Float4x4 { float m[16] = { 0.0f }; };
+	struct Box { Float3 center; Float3 extents = { 1.0f, 1.0f, 1.0f }; };
+
+	// an object as the scene held one, a virtual update reading a few fields out of everything else it carries
+	struct Object
+	{
+		virtual ~Object() = default;
+		virtual void Update( float dt ) noexcept
+		{
+			if ( !moving )
+				return;
+			position.x += velocity.x * dt;
+			position.y += velocity.y * dt;
+			position.z += velocity.z * dt;
+		}
+		Float4x4 world;
+		Float3 position;
+		Float3 rotation;
+		Float3 scale = { 1.0f, 1.0f, 1.0f };
+		Float3 velocity;
+		Box bounds;
+		std::string name;
+		bool moving = true;
+	};
+
+	// the same data split into components, the update only walks the two it needs
+	struct Position { Float3 value; };
+	struct Velocity { Float3 value; };
+	struct Details
+	{
+		Float4x4 world;
+		Float3 rotation;
+		Float3 scale = { 1.0f, 1.0f, 1.0f };
+		Box bounds;
+		std::string name;
+	};
+
+	double Milliseconds( std::chrono::steady_clock::time_point start )
+	{
+		return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	double Time( const std::function<void()>& update )
+	{
+		double total = 0.0;
+		for ( int run = 0; run < ITERATIONS; run++ )
+		{
+			const auto start = std::chrono::steady_clock::now();
+			update();
+			total += Milliseconds( start );
+		}
+		return total / ITERATIONS;
+	}
+}
+
+int main()
+{
+	std::printf( "Per-frame position update of every moving object, object lists against entity-component queries\n" );
+	std::printf( "%-8s %13s %11s %8s %16s %14s %13s %10s\n", "Objects", "Pointers (ms)", "Values (ms)", "ECS (ms)",
+		"Remove half (ms)", "Half ptrs (ms)", "Half ECS (ms)", "Max error" );
+
+	const float dt = 16.0f;
+	for ( uint32_t objectCount : { 10000u, 100000u, 1000000u } )
+	{
+		std::mt19937_64 generator( 42 );
+		std::uniform_real_distribution<float> positions( -100.0f, 100.0f );
+		std::uniform_real_distribution<float> velocities( -0.01f, 0.01f );
+		std::vector<std::unique_ptr<Object>> pointers;
+		std::vector<Object> values( objectCount );
+		std::vector<Entity> entities( objectCount );
+		World world;
+		pointers.reserve( objectCount );
+		for ( uint32_t i = 0; i < objectCount; i++ )
+		{
+			Object& object = values[i];
+			object.position = { positions( generator ), positions( generator ), positions( generator ) };
+			object.velocity = { velocities( generator ), velocities( generator ), velocities( generator ) };
+			object.name = "object " + std::to_string( i );
+			pointers.push_back( std::make_unique<Object>( object ) );
+
+			entities[i] = world.Create();
+			world.Add<Position>( entities[i] ).value = object.position;
+			world.Add<Velocity>( entities[i] ).value = object.velocity;
+			world.Add<Details>( entities[i] ).name = object.name;
+		}
+
+		auto updatePointers = [&pointers, dt]()
+		{
+			for ( const std::unique_ptr<Object>& object : pointers )
+				object->Update( dt );
+		};
+		auto updateWorld = [&world, dt]()
+		{
+			world.Each<Position, const Velocity>( [dt]( Entity, Position& position, const Velocity& velocity )
+			{
+				position.value.x += velocity.value.x * dt;
+				position.value.y += velocity.value.y * dt;
+				position.value.z += velocity.value.z * dt;
+			} );
+		};
+		const double pointerTime = Time( updatePointers );
+		const double valueTime = Time( [&values, dt]()
+		{
+			for ( Object& object : values )
+				object.Update( dt );
+		} );
+		const double worldTime = Time( updateWorld );
+
+		// half the objects stop, the lists still visit them while the query no longer matches them
+		const auto start = std::chrono::steady_clock::now();
+		for ( uint32_t i = 1; i < objectCount; i += 2 )
+			world.Remove<Velocity>( entities[i] );
+		const double removeTime = Milliseconds( start );
+		for ( uint32_t i = 1; i < objectCount; i += 2 )
+			pointers[i]->moving = false;
+		const double halfPointerTime = Time( updatePointers );
+		const double halfWorldTime = Time( updateWorld );
+
+		float maxError = 0.0f;
+		for ( uint32_t i = 0; i < objectCount; i++ )
+		{
+			const Float3& expected = pointers[i]->position;
+			const Float3& actual = world.Get<Position>( entities[i] )->value;
+			maxError = std::max( { maxError, std::fabs( actual.x - expected.x ), std::fabs( actual.y - expected.y ),
+				std::fabs( actual.z - expected.z ) } );
+		}
+		std::printf( "%-8u %13.3f %11.3f %8.3f %16.3f %14.3f %13.3f %10.2e\n", objectCount, pointerTime, valueTime, worldTime,
+			removeTime, halfPointerTime, halfWorldTime, maxError );
+	}
+	return 0;
+}
\ No newline at end of file
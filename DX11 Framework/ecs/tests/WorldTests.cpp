@@ -0,0 +1,381 @@
+#include "World.h"
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <map>
+#include <random>
+#include <string>
+#include <thread>
+
+// no test framework, a failed check reports where it was and the run ends with a failing exit code
+namespace
+{
+	int failures = 0;
+}
+
+// variadic, so conditions with template argument lists need no extra parentheses
+#define CHECK( ... ) \
+	do { if ( !( __VA_ARGS__ ) ) { failures++; std::printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #__VA_ARGS__ ); } } while ( false )
+
+namespace
+{
+	struct Position { float x = 0.0f, y = 0.0f, z = 0.0f; };
+	struct Velocity { float x = 0.0f, y = 0.0f, z = 0.0f; };
+	struct Name { std::string value; };
+	struct alignas( 32 ) Aligned { float values[8] = { 0.0f }; };
+
+	// counts the values alive, so a column that leaks or destroys twice shows up
+	struct Tracked
+	{
+		static inline int alive = 0;
+		int value = 0;
+		Tracked( int value = 0 ) noexcept : value( value ) { alive++; }
+		Tracked( const Tracked& other ) noexcept : value( other.value ) { alive++; }
+		Tracked( Tracked&& other ) noexcept : value( other.value ) { other.value = -1; alive++; }
+		Tracked& operator=( const Tracked& other ) noexcept { value = other.value; return *this; }
+		Tracked& operator=( Tracked&& other ) noexcept { value = other.value; other.value = -1; return *this; }
+		~Tracked() { alive--; }
+	};
+
+	void TestCreateAndDestroy()
+	{
+		World world;
+		CHECK( !world.IsAlive( Entity() ) );
+		CHECK( world.Get<Position>( Entity() ) == nullptr );
+
+		const Entity first = world.Create();
+		const Entity second = world.Create();
+		CHECK( world.IsAlive( first ) && world.IsAlive( second ) );
+		CHECK( first != second );
+		CHECK( world.GetEntityCount() == 2u );
+
+		world.Add<Position>( first, { 1.0f, 2.0f, 3.0f } );
+		world.Destroy( first );
+		CHECK( !world.IsAlive( first ) );
+		CHECK( world.Get<Position>( first ) == nullptr );
+		CHECK( !world.Has<Position>( first ) );
+		CHECK( world.GetEntityCount() == 1u );
+
+		// the index comes back with a new generation, the old handle still reaches nothing
+		const Entity reused = world.Create();
+		CHECK( reused.index == first.index );
+		CHECK( reused.generation != first.generation );
+		CHECK( !world.IsAlive( first ) );
+		CHECK( !world.Has<Position>( reused ) );
+		world.Destroy( first );
+		CHECK( world.IsAlive( reused ) );
+		CHECK( world.GetEntityCount() == 2u );
+	}
+
+	void TestAddGetRemove()
+	{
+		World world;
+		const Entity entity = world.Create();
+		Position& position = world.Add<Position>( entity, { 1.0f, 2.0f, 3.0f } );
+		CHECK( &position == world.Get<Position>( entity ) );
+		CHECK( world.Get<Velocity>( entity ) == nullptr );
+
+		// adding again assigns the value in place
+		world.Add<Position>( entity, { 4.0f, 5.0f, 6.0f } );
+		CHECK( world.Get<Position>( entity )->x == 4.0f );
+		CHECK( world.Count<Position>() == 1u );
+
+		world.Add<Velocity>( entity, { 7.0f, 8.0f, 9.0f } );
+		world.Add<Name>( entity, { "entity" } );
+		CHECK( world.Get<Position>( entity )->z == 6.0f );
+		CHECK( world.Get<Velocity>( entity )->y == 8.0f );
+		CHECK( world.Get<Name>( entity )->value == "entity" );
+
+		world.Remove<Velocity>( entity );
+		CHECK( !world.Has<Velocity>( entity ) );
+		CHECK( world.Get<Position>( entity )->y == 5.0f );
+		CHECK( world.Get<Name>( entity )->value == "entity" );
+
+		// removing a type the entity lacks does nothing
+		world.Remove<Velocity>( entity );
+		CHECK( world.Has<Position>( entity ) && world.Has<Name>( entity ) );
+
+		const World& constWorld = world;
+		CHECK( constWorld.Get<Name>( entity ) == world.Get<Name>( entity ) );
+	}
+
+	void TestLifetimes()
+	{
+		{
+			World world;
+			std::vector<Entity> entities;
+			for ( int i = 0; i < 100; i++ )
+			{
+				entities.push_back( world.Create() );
+				world.Add<Tracked>( entities.back(), Tracked( i ) );
+			}
+			CHECK( Tracked::alive == 100 );
+
+			// moving between archetypes keeps one value per entity
+			for ( size_t i = 0; i < entities.size(); i += 2 )
+				world.Add<Position>( entities[i] );
+			for ( size_t i = 0; i < entities.size(); i += 4 )
+				world.Remove<Position>( entities[i] );
+			CHECK( Tracked::alive == 100 );
+			for ( size_t i = 0; i < entities.size(); i++ )
+				CHECK( world.Get<Tracked>( entities[i] )->value == static_cast<int>( i ) );
+
+			for ( size_t i = 0; i < entities.size(); i += 3 )
+				world.Destroy( entities[i] );
+			CHECK( Tracked::alive == 66 );
+			for ( size_t i = 1; i < entities.size(); i += 3 )
+				world.Remove<Tracked>( entities[i] );
+			CHECK( Tracked::alive == 33 );
+
+			world.Clear();
+			CHECK( Tracked::alive == 0 );
+			CHECK( world.GetEntityCount() == 0u );
+
+			const Entity entity = world.Create();
+			world.Add<Tracked>( entity, Tracked( 7 ) );
+		}
+		// and the world's destructor takes the rest
+		CHECK( Tracked::alive == 0 );
+	}
+
+	void TestAlignment()
+	{
+		World world;
+		for ( int i = 0; i < 100; i++ )
+		{
+			const Entity entity = world.Create();
+			if ( i % 2 == 0 )
+				world.Add<Position>( entity );
+			world.Add<Aligned>( entity );
+			CHECK( reinterpret_cast<uintptr_t>( world.Get<Aligned>( entity ) ) % alignof( Aligned ) == 0u );
+		}
+	}
+
+	void TestQueries()
+	{
+		World world;
+		std::vector<Entity> entities;
+		for ( int i = 0; i < 10; i++ )
+		{
+			const Entity entity = world.Create();
+			world.Add<Position>( entity, { static_cast<float>( i ), 0.0f, 0.0f } );
+			if ( i % 2 == 0 )
+				world.Add<Velocity>( entity, { 1.0f, 0.0f, 0.0f } );
+			entities.push_back( entity );
+		}
+		CHECK( world.Count<Position>() == 10u );
+		CHECK( world.Count<Position, Velocity>() == 5u );
+		CHECK( world.Count<Name>() == 0u );
+
+		uint32_t visited = 0u;
+		world.Each<Position, const Velocity>( [&world, &visited]( Entity entity, Position& position, const Velocity& velocity )
+		{
+			CHECK( world.Get<Position>( entity ) == &position );
+			position.x += velocity.x;
+			visited++;
+		} );
+		CHECK( visited == 5u );
+		for ( size_t i = 0; i < entities.size(); i++ )
+			CHECK( world.Get<Position>( entities[i] )->x == static_cast<float>( i ) + ( i % 2 == 0 ? 1.0f : 0.0f ) );
+
+		// a query that already ran picks up archetypes made after it
+		world.Add<Name>( entities[1], { "named" } );
+		CHECK( world.Count<Position, Velocity>() == 5u );
+		world.Add<Velocity>( entities[1] );
+		CHECK( world.Count<Position, Velocity>() == 6u );
+		CHECK( world.Count<Position, Velocity, Name>() == 1u );
+
+		// archetypes are visited in the order they were made
+		std::vector<Entity> order;
+		world.Each<const Position>( [&order]( Entity entity, const Position& ) { order.push_back( entity ); } );
+		CHECK( order.size() == 10u );
+		CHECK( !order.empty() && world.Has<Velocity>( order.front() ) == false );
+		CHECK( !order.empty() && order.back() == entities[1] );
+	}
+
+	// once a query has run since the last structural change, several threads may walk it at once
+	void TestConcurrentEach()
+	{
+		World world;
+		for ( int i = 0; i < 10000; i++ )
+		{
+			const Entity entity = world.Create();
+			world.Add<Position>( entity, { 1.0f, 0.0f, 0.0f } );
+			if ( i % 3 == 0 )
+				world.Add<Name>( entity );
+		}
+		world.Count<const Position>();
+
+		std::atomic<uint32_t> visited = 0u;
+		std::vector<std::thread> threads;
+		for ( int t = 0; t < 4; t++ )
+			threads.emplace_back( [&world, &visited]()
+			{
+				uint32_t count = 0u;
+				world.Each<const Position>( [&count]( Entity, const Position& position ) { count += position.x == 1.0f; } );
+				visited += count;
+			} );
+		for ( std::thread& thread : threads )
+			thread.join();
+		CHECK( visited == 40000u );
+	}
+
+	// random creates, destroys, adds and removes checked against a map of what each entity should hold
+	struct Expected
+	{
+		Entity entity;
+		bool hasPosition = false;
+		bool hasVelocity = false;
+		bool hasName = false;
+		Position position;
+		Velocity velocity;
+		std::string name;
+	};
+
+	void CheckAgainst( World& world, const std::map<uint32_t, Expected>& expected, const std::vector<Entity>& destroyed )
+	{
+		CHECK( world.GetEntityCount() == expected.size() );
+		uint32_t positions = 0u, velocities = 0u, names = 0u, moving = 0u;
+		for ( const auto& [index, value] : expected )
+		{
+			const Entity entity = value.entity;
+			CHECK( world.IsAlive( entity ) );
+			CHECK( world.Has<Position>( entity ) == value.hasPosition );
+			CHECK( world.Has<Velocity>( entity ) == value.hasVelocity );
+			CHECK( world.Has<Name>( entity ) == value.hasName );
+			if ( value.hasPosition )
+			{
+				const Position* position = world.Get<Position>( entity );
+				CHECK( position != nullptr && position->x == value.position.x && position->z == value.position.z );
+				positions++;
+			}
+			if ( value.hasVelocity )
+			{
+				const Velocity* velocity = world.Get<Velocity>( entity );
+				CHECK( velocity != nullptr && velocity->x == value.velocity.x && velocity->y == value.velocity.y );
+				velocities++;
+			}
+			if ( value.hasName )
+			{
+				const Name* name = world.Get<Name>( entity );
+				CHECK( name != nullptr && name->value == value.name );
+				names++;
+			}
+			moving += value.hasPosition && value.hasVelocity;
+		}
+		CHECK( world.Count<Position>() == positions );
+		CHECK( world.Count<Velocity>() == velocities );
+		CHECK( world.Count<Name>() == names );
+		CHECK( world.Count<Position, Velocity>() == moving );
+
+		// each entity holding both is visited exactly once, with its own values
+		std::vector<uint32_t> visits;
+		world.Each<const Position, const Velocity>( [&]( Entity entity, const Position& position, const Velocity& velocity )
+		{
+			auto found = expected.find( entity.index );
+			CHECK( found != expected.end() && found->second.entity == entity );
+			if ( found == expected.end() )
+				return;
+			CHECK( position.x == found->second.position.x && velocity.x == found->second.velocity.x );
+			visits.push_back( entity.index );
+		} );
+		std::sort( visits.begin(), visits.end() );
+		CHECK( std::adjacent_find( visits.begin(), visits.end() ) == visits.end() );
+		CHECK( visits.size() == moving );
+
+		for ( const Entity entity : destroyed )
+		{
+			CHECK( !world.IsAlive( entity ) );
+			CHECK( world.Get<Position>( entity ) == nullptr );
+		}
+	}
+
+	void TestRandomAgainstReference( uint32_t seed )
+	{
+		World world;
+		std::mt19937 generator( seed );
+		std::map<uint32_t, Expected> expected;
+		std::vector<Entity> alive;
+		std::vector<Entity> destroyed;
+		for ( int step = 0; step < 50000; step++ )
+		{
+			const uint32_t operation = generator() % 8u;
+			if ( operation == 0u || alive.empty() )
+			{
+				const Entity entity = world.Create();
+				alive.push_back( entity );
+				expected[entity.index].entity = entity;
+				continue;
+			}
+			const size_t slot = generator() % alive.size();
+			const Entity entity = alive[slot];
+			Expected& value = expected[entity.index];
+			const float number = static_cast<float>( generator() % 1000u );
+			switch ( operation )
+			{
+			case 1u:
+				world.Add<Position>( entity, { number, 0.0f, -number } );
+				value.hasPosition = true;
+				value.position = { number, 0.0f, -number };
+				break;
+			case 2u:
+				world.Add<Velocity>( entity, { number, 1.0f, 0.0f } );
+				value.hasVelocity = true;
+				value.velocity = { number, 1.0f, 0.0f };
+				break;
+			case 3u:
+				// long enough to live on the heap
+				value.name = "entity with a name too long for small strings " + std::to_string( number );
+				world.Add<Name>( entity, { value.name } );
+				value.hasName = true;
+				break;
+			case 4u:
+				world.Remove<Position>( entity );
+				value.hasPosition = false;
+				break;
+			case 5u:
+				world.Remove<Velocity>( entity );
+				value.hasVelocity = false;
+				break;
+			case 6u:
+				world.Remove<Name>( entity );
+				value.hasName = false;
+				break;
+			case 7u:
+				world.Destroy( entity );
+				expected.erase( entity.index );
+				alive[slot] = alive.back();
+				alive.pop_back();
+				if ( destroyed.size() < 1000u )
+					destroyed.push_back( entity );
+				break;
+			}
+			if ( step % 5000 == 0 )
+				CheckAgainst( world, expected, destroyed );
+		}
+		CheckAgainst( world, expected, destroyed );
+		world.Clear();
+		CHECK( world.GetEntityCount() == 0u );
+		CHECK( world.Count<Position>() == 0u );
+	}
+}
+
+int main()
+{
+	TestCreateAndDestroy();
+	TestAddGetRemove();
+	TestLifetimes();
+	TestAlignment();
+	TestQueries();
+	TestConcurrentEach();
+	for ( uint32_t seed = 1u; seed <= 4u; seed++ )
+		TestRandomAgainstReference( seed );
+
+	if ( failures != 0 )
+	{
+		std::printf( "%d checks failed\n", failures );
+		return 1;
+	}
+	std::printf( "all checks passed\n" );
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,318 @@
+#pragma once
+#ifndef BASICSTATECACHE_H
+#define BASICSTATECACHE_H
+
+#include <cstdint>
+#include <cstring>
+#include "ThreadStatistics.h"
+
+struct StateCacheStatistics
+{
+	uint32_t issuedCount = 0;
+	uint32_t filteredCount = 0;
+	uint32_t drawCount = 0;
+	StateCacheStatistics& operator+=( const StateCacheStatistics& other ) noexcept
+	{
+		issuedCount += other.issuedCount;
+		filteredCount += other.filteredCount;
+		drawCount += other.drawCount;
+		return *this;
+	}
+};
+
+// remembers what is bound to each pipeline slot of a context and drops binds that would change nothing
+// anything that sets state behind its back, such as imgui or the sprite batch, must be followed by Invalidate
+// a cache can record on behalf of another context, objects holding the immediate context then draw into a deferred one
+// Target issues the binds that get through and names the state types, StateCache.h has the one for d3d 11
+template<class Target>
+class BasicStateCache
+{
+public:
+	using Context = typename Target::Context;
+	using VertexShader = typename Target::VertexShader;
+	using PixelShader = typename Target::PixelShader;
+	using InputLayout = typename Target::InputLayout;
+	using Topology = typename Target::Topology;
+	using Buffer = typename Target::Buffer;
+	using Format = typename Target::Format;
+	using ShaderResourceView = typename Target::ShaderResourceView;
+	using SamplerState = typename Target::SamplerState;
+	using RasterizerState = typename Target::RasterizerState;
+	using DepthStencilState = typename Target::DepthStencilState;
+	using BlendState = typename Target::BlendState;
+	using Viewport = typename Target::Viewport;
+
+	static constexpr uint32_t MAX_VERTEX_BUFFERS = Target::MAX_VERTEX_BUFFERS;
+	static constexpr uint32_t MAX_CONSTANT_BUFFERS = Target::MAX_CONSTANT_BUFFERS;
+	static constexpr uint32_t MAX_SHADER_RESOURCES = 16u;
+	static constexpr uint32_t MAX_SAMPLERS = Target::MAX_SAMPLERS;
+
+	void Initialize( Context* context, Context* source = nullptr )
+	{
+		target.Reset( context );
+		this->source = source;
+		tracking = true;
+		Invalidate();
+	}
+	void Invalidate() noexcept
+	{
+		// nothing compares equal to the unknown marker, so the next bind of every slot goes through
+		vertexShader = Unknown<VertexShader>();
+		pixelShader = Unknown<PixelShader>();
+		inputLayout = Unknown<InputLayout>();
+		topology = static_cast<Topology>( -1 );
+		for ( uint32_t i = 0; i < MAX_VERTEX_BUFFERS; i++ )
+			vertexBuffers[i] = Unknown<Buffer>();
+		indexBuffer = Unknown<Buffer>();
+		for ( uint32_t i = 0; i < MAX_CONSTANT_BUFFERS; i++ )
+		{
+			vsConstantBuffers[i].buffer = Unknown<Buffer>();
+			psConstantBuffers[i].buffer = Unknown<Buffer>();
+		}
+		for ( uint32_t i = 0; i < MAX_SHADER_RESOURCES; i++ )
+		{
+			vsShaderResources[i] = Unknown<ShaderResourceView>();
+			psShaderResources[i] = Unknown<ShaderResourceView>();
+		}
+		for ( uint32_t i = 0; i < MAX_SAMPLERS; i++ )
+			psSamplers[i] = Unknown<SamplerState>();
+		rasterizerState = Unknown<RasterizerState>();
+		depthStencilState = Unknown<DepthStencilState>();
+		blendState = Unknown<BlendState>();
+		viewport.Width = -1.0f;
+	}
+	Context* GetContext() const noexcept
+	{
+		return target.GetContext();
+	}
+
+	void SetVertexShader( VertexShader* shader ) noexcept
+	{
+		if ( Filter( shader == vertexShader ) )
+			return;
+		vertexShader = shader;
+		target.SetVertexShader( shader );
+	}
+	void SetPixelShader( PixelShader* shader ) noexcept
+	{
+		if ( Filter( shader == pixelShader ) )
+			return;
+		pixelShader = shader;
+		target.SetPixelShader( shader );
+	}
+	void SetInputLayout( InputLayout* inputLayout ) noexcept
+	{
+		if ( Filter( inputLayout == this->inputLayout ) )
+			return;
+		this->inputLayout = inputLayout;
+		target.SetInputLayout( inputLayout );
+	}
+	void SetPrimitiveTopology( Topology topology ) noexcept
+	{
+		if ( Filter( topology == this->topology ) )
+			return;
+		this->topology = topology;
+		target.SetPrimitiveTopology( topology );
+	}
+	void SetVertexBuffers( uint32_t startSlot, uint32_t count, Buffer* const* buffers, const uint32_t* strides, const uint32_t* offsets ) noexcept
+	{
+		bool unchanged = startSlot + count <= MAX_VERTEX_BUFFERS;
+		for ( uint32_t i = 0; i < count && unchanged; i++ )
+			unchanged = vertexBuffers[startSlot + i] == buffers[i] &&
+				vertexStrides[startSlot + i] == strides[i] && vertexOffsets[startSlot + i] == offsets[i];
+		if ( Filter( unchanged ) )
+			return;
+		for ( uint32_t i = 0; i < count && startSlot + i < MAX_VERTEX_BUFFERS; i++ )
+		{
+			vertexBuffers[startSlot + i] = buffers[i];
+			vertexStrides[startSlot + i] = strides[i];
+			vertexOffsets[startSlot + i] = offsets[i];
+		}
+		target.SetVertexBuffers( startSlot, count, buffers, strides, offsets );
+	}
+	void SetIndexBuffer( Buffer* buffer, Format format, uint32_t offset ) noexcept
+	{
+		if ( Filter( buffer == indexBuffer && format == indexFormat && offset == indexOffset ) )
+			return;
+		indexBuffer = buffer;
+		indexFormat = format;
+		indexOffset = offset;
+		target.SetIndexBuffer( buffer, format, offset );
+	}
+	// a constant count of zero binds the whole buffer, anything else binds a block of the upload ring
+	void SetVSConstantBuffer( uint32_t slot, Buffer* buffer, uint32_t firstConstant = 0u, uint32_t constantCount = 0u ) noexcept
+	{
+		ConstantBufferBinding& binding = vsConstantBuffers[slot];
+		if ( Filter( binding.buffer == buffer && binding.firstConstant == firstConstant && binding.constantCount == constantCount ) )
+			return;
+		binding = { buffer, firstConstant, constantCount };
+		target.SetVSConstantBuffer( slot, buffer, firstConstant, constantCount );
+	}
+	void SetPSConstantBuffer( uint32_t slot, Buffer* buffer, uint32_t firstConstant = 0u, uint32_t constantCount = 0u ) noexcept
+	{
+		ConstantBufferBinding& binding = psConstantBuffers[slot];
+		if ( Filter( binding.buffer == buffer && binding.firstConstant == firstConstant && binding.constantCount == constantCount ) )
+			return;
+		binding = { buffer, firstConstant, constantCount };
+		target.SetPSConstantBuffer( slot, buffer, firstConstant, constantCount );
+	}
+	void SetVSShaderResource( uint32_t slot, ShaderResourceView* view ) noexcept
+	{
+		const bool tracked = slot < MAX_SHADER_RESOURCES;
+		if ( Filter( tracked && vsShaderResources[slot] == view ) )
+			return;
+		if ( tracked )
+			vsShaderResources[slot] = view;
+		target.SetVSShaderResource( slot, view );
+	}
+	void SetPSShaderResource( uint32_t slot, ShaderResourceView* view ) noexcept
+	{
+		const bool tracked = slot < MAX_SHADER_RESOURCES;
+		if ( Filter( tracked && psShaderResources[slot] == view ) )
+			return;
+		if ( tracked )
+			psShaderResources[slot] = view;
+		target.SetPSShaderResource( slot, view );
+	}
+	void SetPSSampler( uint32_t slot, SamplerState* sampler ) noexcept
+	{
+		if ( Filter( psSamplers[slot] == sampler ) )
+			return;
+		psSamplers[slot] = sampler;
+		target.SetPSSampler( slot, sampler );
+	}
+	void SetRasterizerState( RasterizerState* state ) noexcept
+	{
+		if ( Filter( state == rasterizerState ) )
+			return;
+		rasterizerState = state;
+		target.SetRasterizerState( state );
+	}
+	void SetDepthStencilState( DepthStencilState* state, uint32_t stencilRef ) noexcept
+	{
+		if ( Filter( state == depthStencilState && stencilRef == this->stencilRef ) )
+			return;
+		depthStencilState = state;
+		this->stencilRef = stencilRef;
+		target.SetDepthStencilState( state, stencilRef );
+	}
+	void SetBlendState( BlendState* state ) noexcept
+	{
+		if ( Filter( state == blendState ) )
+			return;
+		blendState = state;
+		target.SetBlendState( state );
+	}
+	void SetViewport( const Viewport& viewport ) noexcept
+	{
+		if ( Filter( std::memcmp( &viewport, &this->viewport, sizeof( Viewport ) ) == 0 ) )
+			return;
+		this->viewport = viewport;
+		target.SetViewport( viewport );
+	}
+
+	// draws are never filtered, they only go through here so they land on the context being recorded
+	void Draw( uint32_t vertexCount, uint32_t startVertex ) noexcept
+	{
+		Statistics::Local().drawCount++;
+		target.Draw( vertexCount, startVertex );
+	}
+	void DrawIndexed( uint32_t indexCount, uint32_t startIndex, int32_t baseVertex ) noexcept
+	{
+		Statistics::Local().drawCount++;
+		target.DrawIndexed( indexCount, startIndex, baseVertex );
+	}
+	void DrawIndexedInstanced( uint32_t indexCount, uint32_t instanceCount, uint32_t startIndex, int32_t baseVertex, uint32_t startInstance ) noexcept
+	{
+		Statistics::Local().drawCount++;
+		target.DrawIndexedInstanced( indexCount, instanceCount, startIndex, baseVertex, startInstance );
+	}
+
+	// the cache attached to this context on the calling thread, or one that forwards every call untouched
+	static BasicStateCache& Get( Context* context ) noexcept
+	{
+		if ( active != nullptr && ( active->GetContext() == context || ( active->source != nullptr && active->source == context ) ) )
+			return *active;
+
+		// contexts nobody attached a cache to still get their binds, just without filtering
+		if ( passThrough.GetContext() != context )
+			passThrough.target.Reset( context );
+		return passThrough;
+	}
+	static BasicStateCache* GetAttached() noexcept
+	{
+		return active;
+	}
+	void Attach() noexcept
+	{
+		active = this;
+	}
+	static void Detach() noexcept
+	{
+		active = nullptr;
+	}
+	static StateCacheStatistics GetStatistics()
+	{
+		return Statistics::Get();
+	}
+	static void FoldStatistics()
+	{
+		Statistics::Fold();
+	}
+	static void ResetStatistics()
+	{
+		Statistics::Reset();
+	}
+private:
+	bool Filter( bool unchanged ) noexcept
+	{
+		if ( tracking && unchanged )
+		{
+			Statistics::Local().filteredCount++;
+			return true;
+		}
+		Statistics::Local().issuedCount++;
+		return false;
+	}
+	template<class T> static T* Unknown() noexcept { return reinterpret_cast<T*>( ~static_cast<uintptr_t>( 0 ) ); }
+	struct ConstantBufferBinding
+	{
+		Buffer* buffer = nullptr;
+		uint32_t firstConstant = 0u;
+		uint32_t constantCount = 0u;
+	};
+
+	Target target;
+	Context* source = nullptr;
+	bool tracking = false;
+
+	VertexShader* vertexShader = nullptr;
+	PixelShader* pixelShader = nullptr;
+	InputLayout* inputLayout = nullptr;
+	Topology topology = Topology();
+	Buffer* vertexBuffers[MAX_VERTEX_BUFFERS] = {};
+	uint32_t vertexStrides[MAX_VERTEX_BUFFERS] = {};
+	uint32_t vertexOffsets[MAX_VERTEX_BUFFERS] = {};
+	Buffer* indexBuffer = nullptr;
+	Format indexFormat = Format();
+	uint32_t indexOffset = 0u;
+	ConstantBufferBinding vsConstantBuffers[MAX_CONSTANT_BUFFERS];
+	ConstantBufferBinding psConstantBuffers[MAX_CONSTANT_BUFFERS];
+	ShaderResourceView* vsShaderResources[MAX_SHADER_RESOURCES] = {};
+	ShaderResourceView* psShaderResources[MAX_SHADER_RESOURCES] = {};
+	SamplerState* psSamplers[MAX_SAMPLERS] = {};
+	RasterizerState* rasterizerState = nullptr;
+	DepthStencilState* depthStencilState = nullptr;
+	uint32_t stencilRef = 0u;
+	BlendState* blendState = nullptr;
+	Viewport viewport = {};
+
+	static thread_local BasicStateCache* active;
+	static thread_local BasicStateCache passThrough;
+	using Statistics = ThreadStatistics<StateCacheStatistics>;
+};
+
+template<class Target> thread_local BasicStateCache<Target>* BasicStateCache<Target>::active = nullptr;
+template<class Target> thread_local BasicStateCache<Target> BasicStateCache<Target>::passThrough;
+
+#endif
\ No newline at end of file
@@ -36,7 +36,7 @@ namespace Bind
 		}
 		void Bind( Graphics& gfx ) noexcept override
 		{
-			GetContext( gfx )->OMSetBlendState( blendState.Get(), NULL, 0xFFFFFFFF );
+			GetStateCache( gfx ).SetBlendState( blendState.Get() );
 		}
 	private:
 		Microsoft::WRL::ComPtr<ID3D11BlendState> blendState;
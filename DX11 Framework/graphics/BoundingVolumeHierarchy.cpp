@@ -0,0 +1,360 @@
+#include "BoundingVolumeHierarchy.h"
+#include <algorithm>
+
+PickRay TransformPickRay( const PickRay& ray, DirectX::FXMMATRIX matrix ) noexcept
+{
+	PickRay transformed;
+	DirectX::XMStoreFloat3( &transformed.origin, DirectX::XMVector3TransformCoord( DirectX::XMLoadFloat3( &ray.origin ), matrix ) );
+	DirectX::XMStoreFloat3( &transformed.direction, DirectX::XMVector3TransformNormal( DirectX::XMLoadFloat3( &ray.direction ), matrix ) );
+	transformed.maxDistance = ray.maxDistance;
+	return transformed;
+}
+
+void BoundingVolumeHierarchy::Box::Reset() noexcept
+{
+	for ( UINT i = 0; i < 3; i++ )
+	{
+		min[i] = FLT_MAX;
+		max[i] = -FLT_MAX;
+	}
+}
+
+void BoundingVolumeHierarchy::Box::Grow( const Box& other ) noexcept
+{
+	for ( UINT i = 0; i < 3; i++ )
+	{
+		min[i] = std::min( min[i], other.min[i] );
+		max[i] = std::max( max[i], other.max[i] );
+	}
+}
+
+// half the surface area, only ever compared
+float BoundingVolumeHierarchy::Box::GetArea() const noexcept
+{
+	const float x = max[0] - min[0];
+	const float y = max[1] - min[1];
+	const float z = max[2] - min[2];
+	return x * y + y * z + z * x;
+}
+
+bool BoundingVolumeHierarchy::Box::operator==( const Box& other ) const noexcept
+{
+	return min[0] == other.min[0] && min[1] == other.min[1] && min[2] == other.min[2] &&
+		max[0] == other.max[0] && max[1] == other.max[1] && max[2] == other.max[2];
+}
+
+void BoundingVolumeHierarchy::Build( const std::vector<DirectX::BoundingBox>& bounds )
+{
+	Build( bounds.data(), static_cast<UINT>( bounds.size() ) );
+}
+
+void BoundingVolumeHierarchy::Build( const DirectX::BoundingBox* bounds, UINT count )
+{
+	objectBounds.resize( count );
+	for ( UINT i = 0; i < count; i++ )
+		objectBounds[i] = ToBox( bounds[i] );
+	objectBoxes.assign( bounds, bounds + count );
+	Rebuild();
+}
+
+// only marks the leaf, nothing above it is touched until Refit
+void BoundingVolumeHierarchy::Update( UINT object, const DirectX::BoundingBox& bounds ) noexcept
+{
+	const Box box = ToBox( bounds );
+	if ( box == objectBounds[object] )
+		return;
+	objectBounds[object] = box;
+	objectBoxes[object] = bounds;
+	SetLeafBox( objectSlots[object], bounds );
+	const UINT leaf = objectLeaves[object];
+	if ( !leafDirty[leaf] )
+	{
+		leafDirty[leaf] = 1;
+		dirtyLeaves.push_back( leaf );
+	}
+}
+
+// true when the tree had loosened enough to be rebuilt instead
+bool BoundingVolumeHierarchy::Refit()
+{
+	if ( dirtyLeaves.empty() )
+		return false;
+	for ( UINT leaf : dirtyLeaves )
+	{
+		leafDirty[leaf] = 0;
+		RefitLeaf( leaf );
+	}
+	dirtyLeaves.clear();
+
+	const double rootArea = nodes[0].bounds.GetArea();
+	if ( rootArea > 0.0 && totalArea / rootArea > buildAreaRatio * 1.5 )
+	{
+		Rebuild();
+		return true;
+	}
+	return false;
+}
+
+PickHit BoundingVolumeHierarchy::Intersect( const PickRay& ray ) const noexcept
+{
+	return Intersect( ray, []( UINT, float boxDistance, float ) { return boxDistance; } );
+}
+
+void BoundingVolumeHierarchy::Intersect( const PickRay* rays, UINT count, PickHit* hits ) const noexcept
+{
+	for ( UINT i = 0; i < count; i++ )
+		hits[i] = Intersect( rays[i] );
+}
+
+// objects in leaf order, the ranges IntersectLeaves hands out index into this
+const std::vector<UINT>& BoundingVolumeHierarchy::GetObjectOrder() const noexcept
+{
+	return objectIndices;
+}
+
+UINT BoundingVolumeHierarchy::GetObjectCount() const noexcept
+{
+	return static_cast<UINT>( objectBounds.size() );
+}
+
+const BVHStatistics& BoundingVolumeHierarchy::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+BoundingVolumeHierarchy::Box BoundingVolumeHierarchy::ToBox( const DirectX::BoundingBox& bounds ) noexcept
+{
+	return {
+		{ bounds.Center.x - bounds.Extents.x, bounds.Center.y - bounds.Extents.y, bounds.Center.z - bounds.Extents.z },
+		{ bounds.Center.x + bounds.Extents.x, bounds.Center.y + bounds.Extents.y, bounds.Center.z + bounds.Extents.z }
+	};
+}
+
+BoundingVolumeHierarchy::Ray BoundingVolumeHierarchy::ToRay( const PickRay& pickRay ) noexcept
+{
+	return {
+		{ pickRay.origin.x, pickRay.origin.y, pickRay.origin.z },
+		{ 1.0f / pickRay.direction.x, 1.0f / pickRay.direction.y, 1.0f / pickRay.direction.z }
+	};
+}
+
+// slab test, returns where the ray enters the box or FLT_MAX when it misses within maxDistance
+// axes the ray runs parallel to give nans, which the min and max below pass over
+float BoundingVolumeHierarchy::IntersectBox( const Box& box, const Ray& ray, float maxDistance ) noexcept
+{
+	float entry = 0.0f;
+	float exit = maxDistance;
+	for ( UINT i = 0; i < 3; i++ )
+	{
+		const float t1 = ( box.min[i] - ray.origin[i] ) * ray.inverseDirection[i];
+		const float t2 = ( box.max[i] - ray.origin[i] ) * ray.inverseDirection[i];
+		entry = std::max( entry, std::min( t1, t2 ) );
+		exit = std::min( exit, std::max( t1, t2 ) );
+	}
+	return entry <= exit ? entry : FLT_MAX;
+}
+
+void BoundingVolumeHierarchy::SetLeafBox( UINT slot, const DirectX::BoundingBox& bounds ) noexcept
+{
+	const float values[6] = { bounds.Center.x, bounds.Center.y, bounds.Center.z, bounds.Extents.x, bounds.Extents.y, bounds.Extents.z };
+	for ( UINT i = 0; i < 6; i++ )
+		leafBoxes[i][slot] = values[i];
+}
+
+// the boxes from a place in leaf order onwards
+BoxStreams BoundingVolumeHierarchy::GetLeafBoxes( UINT first ) const noexcept
+{
+	return { &leafBoxes[0][first], &leafBoxes[1][first], &leafBoxes[2][first], &leafBoxes[3][first], &leafBoxes[4][first], &leafBoxes[5][first] };
+}
+
+void BoundingVolumeHierarchy::Rebuild()
+{
+	const UINT count = static_cast<UINT>( objectBounds.size() );
+	nodes.clear();
+	parents.clear();
+	dirtyLeaves.clear();
+	objectIndices.resize( count );
+	objectLeaves.assign( count, INVALID );
+	statistics.nodeCount = 0;
+	statistics.leafCount = 0;
+	statistics.depth = 0;
+	statistics.buildCount++;
+	totalArea = 0.0;
+	buildAreaRatio = 0.0;
+	if ( count == 0 )
+	{
+		leafDirty.clear();
+		return;
+	}
+
+	// a binary tree over n objects has at most 2n - 1 nodes, so references into it stay valid while building
+	for ( UINT axis = 0; axis < 3; axis++ )
+	{
+		centroids[axis].resize( count );
+		for ( UINT i = 0; i < count; i++ )
+			centroids[axis][i] = ( objectBounds[i].min[axis] + objectBounds[i].max[axis] ) * 0.5f;
+	}
+	for ( UINT i = 0; i < count; i++ )
+		objectIndices[i] = i;
+	nodes.reserve( count * 2 );
+	parents.reserve( count * 2 );
+	nodes.push_back( { {}, 0, count } );
+	parents.push_back( INVALID );
+	Subdivide( 0, 1 );
+
+	// leaf order is settled, the box streams follow it
+	objectSlots.resize( count );
+	for ( std::vector<float>& stream : leafBoxes )
+		stream.resize( count );
+	for ( UINT i = 0; i < count; i++ )
+	{
+		objectSlots[objectIndices[i]] = i;
+		SetLeafBox( i, objectBoxes[objectIndices[i]] );
+	}
+
+	statistics.nodeCount = static_cast<UINT>( nodes.size() );
+	leafDirty.assign( nodes.size(), 0 );
+	for ( const Node& node : nodes )
+		totalArea += node.bounds.GetArea();
+	const double rootArea = nodes[0].bounds.GetArea();
+	buildAreaRatio = rootArea > 0.0 ? totalArea / rootArea : 0.0;
+}
+
+// splits at the cheapest of a handful of evenly spaced planes per axis, costed as objects times area on each side
+void BoundingVolumeHierarchy::Subdivide( UINT index, UINT depth )
+{
+	constexpr UINT BIN_COUNT = 12u;
+	Node& node = nodes[index];
+	Box centroidBounds;
+	node.bounds.Reset();
+	centroidBounds.Reset();
+	for ( UINT i = node.first; i < node.first + node.count; i++ )
+	{
+		const UINT object = objectIndices[i];
+		node.bounds.Grow( objectBounds[object] );
+		for ( UINT axis = 0; axis < 3; axis++ )
+		{
+			centroidBounds.min[axis] = std::min( centroidBounds.min[axis], centroids[axis][object] );
+			centroidBounds.max[axis] = std::max( centroidBounds.max[axis], centroids[axis][object] );
+		}
+	}
+	statistics.depth = std::max( statistics.depth, depth );
+	if ( node.count <= MAX_LEAF_OBJECTS || depth >= MAX_DEPTH )
+	{
+		for ( UINT i = node.first; i < node.first + node.count; i++ )
+			objectLeaves[objectIndices[i]] = index;
+		statistics.leafCount++;
+		return;
+	}
+
+	float bestCost = FLT_MAX;
+	UINT bestAxis = INVALID;
+	UINT bestSplit = 0;
+	for ( UINT axis = 0; axis < 3; axis++ )
+	{
+		const float extent = centroidBounds.max[axis] - centroidBounds.min[axis];
+		if ( extent <= 0.0f )
+			continue;
+		Box bins[BIN_COUNT];
+		UINT binCounts[BIN_COUNT] = { 0 };
+		for ( UINT i = 0; i < BIN_COUNT; i++ )
+			bins[i].Reset();
+		const float scale = BIN_COUNT / extent;
+		const std::vector<float>& centroid = centroids[axis];
+		for ( UINT i = node.first; i < node.first + node.count; i++ )
+		{
+			const UINT object = objectIndices[i];
+			const UINT bin = std::min( BIN_COUNT - 1, static_cast<UINT>( ( centroid[object] - centroidBounds.min[axis] ) * scale ) );
+			bins[bin].Grow( objectBounds[object] );
+			binCounts[bin]++;
+		}
+
+		// sweep from the right so each split's right side is known when the left sweep reaches it
+		float rightAreas[BIN_COUNT];
+		UINT rightCounts[BIN_COUNT];
+		Box right;
+		right.Reset();
+		UINT rightCount = 0;
+		for ( UINT i = BIN_COUNT - 1; i > 0; i-- )
+		{
+			right.Grow( bins[i] );
+			rightCount += binCounts[i];
+			rightAreas[i] = right.GetArea();
+			rightCounts[i] = rightCount;
+		}
+		Box left;
+		left.Reset();
+		UINT leftCount = 0;
+		for ( UINT i = 1; i < BIN_COUNT; i++ )
+		{
+			left.Grow( bins[i - 1] );
+			leftCount += binCounts[i - 1];
+			if ( leftCount == 0 || rightCounts[i] == 0 )
+				continue;
+			const float cost = leftCount * left.GetArea() + rightCounts[i] * rightAreas[i];
+			if ( cost < bestCost )
+			{
+				bestCost = cost;
+				bestAxis = axis;
+				bestSplit = i;
+			}
+		}
+	}
+
+	// objects whose centres all coincide can't be told apart, halve them in whatever order they are in
+	const UINT first = node.first;
+	const UINT count = node.count;
+	UINT middle = first + count / 2;
+	if ( bestAxis != INVALID )
+	{
+		const float minimum = centroidBounds.min[bestAxis];
+		const float scale = BIN_COUNT / ( centroidBounds.max[bestAxis] - minimum );
+		const std::vector<float>& centroid = centroids[bestAxis];
+		middle = static_cast<UINT>( std::partition( objectIndices.begin() + first, objectIndices.begin() + first + count,
+			[&centroid, bestSplit, minimum, scale]( UINT object )
+			{
+				return std::min( BIN_COUNT - 1, static_cast<UINT>( ( centroid[object] - minimum ) * scale ) ) < bestSplit;
+			} ) - objectIndices.begin() );
+	}
+
+	const UINT left = static_cast<UINT>( nodes.size() );
+	node.first = left;
+	node.count = 0;
+	nodes.push_back( { {}, first, middle - first } );
+	nodes.push_back( { {}, middle, first + count - middle } );
+	parents.push_back( index );
+	parents.push_back( index );
+	Subdivide( left, depth + 1 );
+	Subdivide( left + 1, depth + 1 );
+}
+
+void BoundingVolumeHierarchy::RefitLeaf( UINT index ) noexcept
+{
+	const Node& leaf = nodes[index];
+	Box bounds;
+	bounds.Reset();
+	for ( UINT i = leaf.first; i < leaf.first + leaf.count; i++ )
+		bounds.Grow( objectBounds[objectIndices[i]] );
+
+	// ancestors only change while the node below them did
+	bool changed = SetNodeBounds( index, bounds );
+	while ( changed && parents[index] != INVALID )
+	{
+		index = parents[index];
+		const Node& node = nodes[index];
+		bounds = nodes[node.first].bounds;
+		bounds.Grow( nodes[node.first + 1].bounds );
+		changed = SetNodeBounds( index, bounds );
+	}
+}
+
+bool BoundingVolumeHierarchy::SetNodeBounds( UINT index, const Box& bounds ) noexcept
+{
+	Node& node = nodes[index];
+	if ( node.bounds == bounds )
+		return false;
+	totalArea += static_cast<double>( bounds.GetArea() ) - node.bounds.GetArea();
+	node.bounds = bounds;
+	statistics.refitNodeCount++;
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,186 @@
+#pragma once
+#ifndef BOUNDINGVOLUMEHIERARCHY_H
+#define BOUNDINGVOLUMEHIERARCHY_H
+
+#include <Windows.h>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <algorithm>
+#include <cfloat>
+#include <utility>
+#include <vector>
+#include "../utility/Intersection.h"
+
+// world space ray, the direction needn't be normalized but distances are measured in its length
+struct PickRay
+{
+	DirectX::XMFLOAT3 origin = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 direction = { 0.0f, 0.0f, 1.0f };
+	float maxDistance = FLT_MAX;
+};
+
+// the ray in the space the matrix maps to, distances along it are unchanged
+PickRay TransformPickRay( const PickRay& ray, DirectX::FXMMATRIX matrix ) noexcept;
+
+struct PickHit
+{
+	UINT object = UINT_MAX;
+	float distance = FLT_MAX;
+	bool IsHit() const noexcept { return object != UINT_MAX; }
+};
+
+struct BVHStatistics
+{
+	UINT nodeCount = 0;
+	UINT leafCount = 0;
+	UINT depth = 0;
+	UINT buildCount = 0;
+	UINT refitNodeCount = 0;
+};
+
+// bounding volume hierarchy over world space object bounds, split by binned surface area cost
+// objects keep the index they were built with, moving one refits only the nodes above its leaf
+// refitting loosens the tree, it is rebuilt once the summed node area relative to the root has grown by half
+// object boxes are also kept in leaf order as streams, so the boxes of a leaf are tested against a ray together
+class BoundingVolumeHierarchy
+{
+public:
+	static constexpr UINT INVALID = UINT_MAX;
+	static constexpr UINT MAX_LEAF_OBJECTS = 4u;
+	static constexpr UINT MAX_DEPTH = 64u;
+	void Build( const std::vector<DirectX::BoundingBox>& bounds );
+	void Build( const DirectX::BoundingBox* bounds, UINT count );
+	void Update( UINT object, const DirectX::BoundingBox& bounds ) noexcept;
+	bool Refit();
+	PickHit Intersect( const PickRay& ray ) const noexcept;
+	void Intersect( const PickRay* rays, UINT count, PickHit* hits ) const noexcept;
+	template<class ObjectTest>
+	PickHit Intersect( const PickRay& ray, ObjectTest&& objectTest ) const;
+	template<class LeafTest>
+	void IntersectLeaves( const PickRay& ray, LeafTest&& leafTest ) const;
+	const std::vector<UINT>& GetObjectOrder() const noexcept;
+	UINT GetObjectCount() const noexcept;
+	const BVHStatistics& GetStatistics() const noexcept;
+private:
+	struct Box
+	{
+		float min[3];
+		float max[3];
+		void Reset() noexcept;
+		void Grow( const Box& other ) noexcept;
+		float GetArea() const noexcept;
+		bool operator==( const Box& other ) const noexcept;
+	};
+	// interior nodes keep their children side by side at 'first' and 'first + 1', leaves a range of objectIndices
+	struct Node
+	{
+		Box bounds;
+		UINT first;
+		UINT count;
+	};
+	struct Ray
+	{
+		float origin[3];
+		float inverseDirection[3];
+	};
+	static Box ToBox( const DirectX::BoundingBox& bounds ) noexcept;
+	static Ray ToRay( const PickRay& ray ) noexcept;
+	static float IntersectBox( const Box& box, const Ray& ray, float maxDistance ) noexcept;
+	void SetLeafBox( UINT slot, const DirectX::BoundingBox& bounds ) noexcept;
+	BoxStreams GetLeafBoxes( UINT first ) const noexcept;
+	void Rebuild();
+	void Subdivide( UINT node, UINT depth );
+	void RefitLeaf( UINT node ) noexcept;
+	bool SetNodeBounds( UINT node, const Box& bounds ) noexcept;
+private:
+	std::vector<Node> nodes;
+	std::vector<UINT> parents;
+	std::vector<Box> objectBounds;
+	std::vector<UINT> objectIndices;
+	std::vector<float> centroids[3];
+	std::vector<UINT> objectLeaves;
+	std::vector<DirectX::BoundingBox> objectBoxes;
+	std::vector<UINT> objectSlots;
+	std::vector<float> leafBoxes[6];
+	std::vector<BYTE> leafDirty;
+	std::vector<UINT> dirtyLeaves;
+	double totalArea = 0.0;
+	double buildAreaRatio = 0.0;
+	BVHStatistics statistics;
+};
+
+// objectTest( object, boxDistance, nearest ) runs for each object whose box the ray enters before the closest hit so far
+// it returns where the object itself is hit, or FLT_MAX, so a box can stand in for finer geometry
+template<class ObjectTest>
+PickHit BoundingVolumeHierarchy::Intersect( const PickRay& pickRay, ObjectTest&& objectTest ) const
+{
+	PickHit hit;
+	IntersectLeaves( pickRay, [&]( UINT first, UINT count, float& nearest )
+	{
+		// a block's boxes are tested against the closest hit when it starts, so entries beyond a later hit are skipped here
+		float boxDistances[MAX_LEAF_OBJECTS];
+		for ( UINT block = first; block < first + count; block += MAX_LEAF_OBJECTS )
+		{
+			const UINT blockCount = std::min( MAX_LEAF_OBJECTS, first + count - block );
+			if ( Intersection::RayBox( GetLeafBoxes( block ), blockCount, pickRay.origin, pickRay.direction, nearest, boxDistances ) == 0 )
+				continue;
+			for ( UINT i = 0; i < blockCount; i++ )
+			{
+				if ( boxDistances[i] == FLT_MAX || boxDistances[i] > nearest )
+					continue;
+				const UINT object = objectIndices[block + i];
+				const float distance = objectTest( object, boxDistances[i], nearest );
+				if ( distance < nearest )
+				{
+					hit = { object, distance };
+					nearest = distance;
+				}
+			}
+		}
+	} );
+	return hit;
+}
+
+// nearest first traversal, a subtree is skipped once its entry lies beyond the closest hit so far
+// leafTest( first, count, nearest ) sees a leaf's range of GetObjectOrder and shortens nearest for every hit it finds
+template<class LeafTest>
+void BoundingVolumeHierarchy::IntersectLeaves( const PickRay& pickRay, LeafTest&& leafTest ) const
+{
+	if ( nodes.empty() )
+		return;
+	struct Entry
+	{
+		UINT node;
+		float distance;
+	};
+	Entry stack[MAX_DEPTH * 2];
+	UINT size = 0;
+	const Ray ray = ToRay( pickRay );
+	float nearest = pickRay.maxDistance;
+	const float rootDistance = IntersectBox( nodes[0].bounds, ray, nearest );
+	if ( rootDistance != FLT_MAX )
+		stack[size++] = { 0, rootDistance };
+	while ( size > 0 )
+	{
+		const Entry entry = stack[--size];
+		if ( entry.distance > nearest )
+			continue;
+		const Node& node = nodes[entry.node];
+		if ( node.count > 0 )
+		{
+			leafTest( node.first, node.count, nearest );
+			continue;
+		}
+
+		Entry closer = { node.first, IntersectBox( nodes[node.first].bounds, ray, nearest ) };
+		Entry further = { node.first + 1, IntersectBox( nodes[node.first + 1].bounds, ray, nearest ) };
+		if ( further.distance < closer.distance )
+			std::swap( closer, further );
+		if ( further.distance != FLT_MAX )
+			stack[size++] = further;
+		if ( closer.distance != FLT_MAX )
+			stack[size++] = closer;
+	}
+}
+
+#endif
\ No newline at end of file
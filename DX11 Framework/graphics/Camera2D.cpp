@@ -2,11 +2,9 @@
 
 Camera2D::Camera2D()
 {
-	position = XMFLOAT3( 0.0f, 0.0f, 0.0f );
-	posVector = XMLoadFloat3( &position );
-	rotation = XMFLOAT3( 0.0f, 0.0f, 0.0f );
-	rotVector = XMLoadFloat3( &rotation );
-	UpdateMatrix();
+	SetPosition( 0.0f, 0.0f, 0.0f );
+	SetRotation( 0.0f, 0.0f, 0.0f );
+	ResolveTransform();
 }
 
 void Camera2D::SetProjectionValues( float width, float height, float nearZ, float farZ )
@@ -21,16 +19,20 @@ const XMMATRIX& Camera2D::GetOrthoMatrix() const noexcept
 
 const XMMATRIX& Camera2D::GetWorldMatrix() const noexcept
 {
+	ResolveTransform();
 	return worldMatrix;
 }
 
 const XMMATRIX& Camera2D::GetWorldOrthoMatrix() const noexcept
 {
+	ResolveTransform();
 	return worldMatrix * orthoMatrix;
 }
 
 void Camera2D::UpdateMatrix()
 {
+	const XMFLOAT3 position = GetPositionFloat3();
+	const XMFLOAT3 rotation = GetRotationFloat3();
 	XMMATRIX translationOffsetMatrix = XMMatrixTranslation( -position.x, -position.y, 0.0f );
 	XMMATRIX cameraRotationMatrix = XMMatrixRotationRollPitchYaw( rotation.x, rotation.y, rotation.z );
 	worldMatrix = cameraRotationMatrix * translationOffsetMatrix;
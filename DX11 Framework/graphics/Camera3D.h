@@ -3,7 +3,7 @@
 #define CAMERA_H
 
 #include "GameObject3D.h"
-#include "RenderableGameObject.h"
+#include "Culling.h"
 using namespace DirectX;
 
 class Camera3D : public GameObject3D
@@ -16,6 +16,7 @@ public:
 
 	const XMMATRIX& GetViewMatrix() const noexcept;
 	const XMMATRIX& GetProjectionMatrix() const noexcept;
+	const Frustum& GetFrustum() const noexcept;
 
 	const float& GetCameraSpeed() const noexcept;
 	void SetCameraSpeed( float newSpeed ) noexcept;
@@ -27,11 +28,11 @@ public:
 
 	void ResetOrientation() noexcept;
 	void ResetProjection( float aspectRatio ) noexcept;
-
-	static void UpdateThirdPerson( std::shared_ptr<Camera3D>& camera, GameObject3D& model ) noexcept;
 private:
 	void UpdateMatrix() override;
+	void UpdateFrustum() noexcept;
 	XMMATRIX view, projection;
+	Frustum frustum;
 	float cameraSpeed, fovDegrees;
 	float nearZ, farZ;
 };
@@ -3,6 +3,7 @@
 #define CAMERAMOVE_H
 
 #include "Camera3D.h"
+#include "Transform.h"
 
 class CameraMove : public Camera3D
 {
@@ -39,24 +40,24 @@ public:
 	}
 
 	/// MODEL MOVEMENT
-	static void MoveForward( std::shared_ptr<Camera3D>& camera, RenderableGameObject& object, float dt ) noexcept
+	static void MoveForward( std::shared_ptr<Camera3D>& camera, Transform& object, float dt ) noexcept
 	{
-		object.AdjustPosition( object.GetBackwardVector() * camera->GetCameraSpeed() * dt );
+		object.AdjustPosition( -object.GetForwardVector() * camera->GetCameraSpeed() * dt );
 	}
 
-	static void MoveBackward( std::shared_ptr<Camera3D>& camera, RenderableGameObject& object, float dt ) noexcept
+	static void MoveBackward( std::shared_ptr<Camera3D>& camera, Transform& object, float dt ) noexcept
 	{
 		object.AdjustPosition( object.GetForwardVector() * camera->GetCameraSpeed() * dt );
 	}
 
-	static void MoveLeft( std::shared_ptr<Camera3D>& camera, RenderableGameObject& object, float dt ) noexcept
+	static void MoveLeft( std::shared_ptr<Camera3D>& camera, Transform& object, float dt ) noexcept
 	{
 		object.AdjustPosition( object.GetRightVector() * camera->GetCameraSpeed() * dt );
 	}
 
-	static void MoveRight( std::shared_ptr<Camera3D>& camera, RenderableGameObject& object, float dt ) noexcept
+	static void MoveRight( std::shared_ptr<Camera3D>& camera, Transform& object, float dt ) noexcept
 	{
-		object.AdjustPosition( object.GetLeftVector() * camera->GetCameraSpeed() * dt );
+		object.AdjustPosition( -object.GetRightVector() * camera->GetCameraSpeed() * dt );
 	}
 };
 
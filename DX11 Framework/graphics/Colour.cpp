@@ -70,4 +70,9 @@ constexpr BYTE Colour::GetA() const
 void Colour::SetA( BYTE a )
 {
 	rgba[3] = a;
+}
+
+unsigned int Colour::GetColour() const
+{
+	return colour;
 }
\ No newline at end of file
@@ -25,6 +25,7 @@ public:
 	void SetB( BYTE b );
 	constexpr BYTE GetA() const;
 	void SetA( BYTE a );
+	unsigned int GetColour() const;
 private:
 	union
 	{
@@ -0,0 +1,204 @@
+#include "CommandRecorder.h"
+#include "../utility/ErrorLogger.h"
+#include <algorithm>
+
+HRESULT DeferredRecordingBackend::Initialize( ID3D11Device* device, ID3D11DeviceContext* immediate, UINT viewCount )
+{
+	this->immediate = immediate;
+	views.clear();
+	for ( UINT i = 0; i < viewCount; i++ )
+	{
+		// drivers without native command lists are emulated by the runtime, recording still leaves the immediate thread
+		auto view = std::make_unique<ViewContext>();
+		HRESULT hr = device->CreateDeferredContext( 0, view->context.GetAddressOf() );
+		if ( FAILED( hr ) )
+			return hr;
+		view->stateCache.Initialize( view->context.Get(), immediate );
+		hr = view->ring.Initialize( device, view->context.Get() );
+		if ( FAILED( hr ) )
+			return hr;
+		views.push_back( std::move( view ) );
+	}
+	return S_OK;
+}
+
+// every command list must open its ring with a discard, a deferred context can't continue another list's mapping
+void DeferredRecordingBackend::BeginFrame() noexcept
+{
+	for ( UINT i = 0; i < views.size(); i++ )
+		views[i]->ring.BeginFrame();
+}
+
+void DeferredRecordingBackend::BeginView( UINT index )
+{
+	ViewContext& view = *views[index];
+	view.previousCache = StateCache::GetAttached();
+	view.previousRing = ConstantBufferRing::GetActive();
+	view.stateCache.Attach();
+	ConstantBufferRing::SetActive( &view.ring );
+}
+
+void DeferredRecordingBackend::EndView( UINT index )
+{
+	ViewContext& view = *views[index];
+	if ( view.previousCache != nullptr )
+		view.previousCache->Attach();
+	else
+		StateCache::Detach();
+	ConstantBufferRing::SetActive( view.previousRing );
+	view.previousCache = nullptr;
+	view.previousRing = nullptr;
+}
+
+void DeferredRecordingBackend::ExecuteView( UINT index )
+{
+	ViewContext& view = *views[index];
+	HRESULT hr = view.context->FinishCommandList( FALSE, view.commandList.ReleaseAndGetAddressOf() );
+	if ( FAILED( hr ) )
+	{
+		ErrorLogger::Log( hr, "Failed to finish view command list!" );
+		return;
+	}
+	immediate->ExecuteCommandList( view.commandList.Get(), FALSE );
+	view.commandList.Reset();
+
+	// finishing returns the deferred context to default state and executing without restore clears the immediate one
+	view.stateCache.Invalidate();
+	StateCache::Get( immediate ).Invalidate();
+}
+
+UINT DeferredRecordingBackend::GetViewCount() const noexcept
+{
+	return static_cast<UINT>( views.size() );
+}
+
+void HeadlessRecordingBackend::Initialize( UINT viewCount )
+{
+	commands.assign( viewCount, {} );
+	executed.clear();
+}
+
+void HeadlessRecordingBackend::BeginView( UINT view )
+{
+	commands[view].clear();
+}
+
+void HeadlessRecordingBackend::EndView( UINT view ) {}
+
+void HeadlessRecordingBackend::ExecuteView( UINT view )
+{
+	executed.insert( executed.end(), commands[view].begin(), commands[view].end() );
+	commands[view].clear();
+}
+
+void HeadlessRecordingBackend::Record( UINT view, UINT64 command )
+{
+	commands[view].push_back( command );
+}
+
+const std::vector<UINT64>& HeadlessRecordingBackend::GetExecuted() const noexcept
+{
+	return executed;
+}
+
+void HeadlessRecordingBackend::ClearExecuted() noexcept
+{
+	executed.clear();
+}
+
+CommandRecorder::~CommandRecorder()
+{
+	Stop();
+}
+
+void CommandRecorder::Start( UINT threadCount )
+{
+	Stop();
+	stopping = false;
+
+	// the calling thread records as well, so a single thread needs no workers
+	for ( UINT i = 1; i < threadCount; i++ )
+		workers.emplace_back( &CommandRecorder::WorkerThread, this );
+}
+
+void CommandRecorder::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		stopping = true;
+	}
+	condition.notify_all();
+	for ( unsigned int i = 0; i < workers.size(); i++ )
+		workers[i].join();
+	workers.clear();
+}
+
+void CommandRecorder::Record( RecordingBackend& backend, UINT viewCount, const RecordFunction& record )
+{
+	std::unique_lock<std::mutex> lock( mutex );
+	this->backend = &backend;
+	this->record = &record;
+	this->viewCount = viewCount;
+	nextView = 0;
+	finishedCount = 0;
+	batch++;
+	lock.unlock();
+	condition.notify_all();
+
+	lock.lock();
+	while ( RecordNext( lock ) ) {}
+	finished.wait( lock, [this] { return finishedCount == this->viewCount; } );
+	this->backend = nullptr;
+	this->record = nullptr;
+}
+
+void CommandRecorder::Execute( RecordingBackend& backend, UINT viewCount )
+{
+	for ( UINT i = 0; i < viewCount; i++ )
+		backend.ExecuteView( i );
+}
+
+UINT CommandRecorder::GetThreadCount() const noexcept
+{
+	return static_cast<UINT>( workers.size() ) + 1u;
+}
+
+UINT CommandRecorder::GetDefaultThreadCount() noexcept
+{
+	UINT cores = std::thread::hardware_concurrency();
+	return std::max( cores, 1u );
+}
+
+void CommandRecorder::WorkerThread()
+{
+	UINT currentBatch = 0;
+	std::unique_lock<std::mutex> lock( mutex );
+	for ( ;; )
+	{
+		condition.wait( lock, [this, currentBatch] { return stopping || batch != currentBatch; } );
+		if ( stopping )
+			return;
+		currentBatch = batch;
+		while ( RecordNext( lock ) ) {}
+	}
+}
+
+// takes the next unrecorded view of the current batch and records it with the lock released
+bool CommandRecorder::RecordNext( std::unique_lock<std::mutex>& lock )
+{
+	if ( record == nullptr || nextView >= viewCount )
+		return false;
+	const UINT view = nextView++;
+	RecordingBackend& backend = *this->backend;
+	const RecordFunction& record = *this->record;
+	lock.unlock();
+
+	backend.BeginView( view );
+	record( view );
+	backend.EndView( view );
+
+	lock.lock();
+	if ( ++finishedCount == viewCount )
+		finished.notify_all();
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,100 @@
+#pragma once
+#ifndef COMMANDRECORDER_H
+#define COMMANDRECORDER_H
+
+#include "StateCache.h"
+#include "ConstantBufferRing.h"
+#include <mutex>
+#include <memory>
+#include <thread>
+#include <vector>
+#include <functional>
+#include <condition_variable>
+
+// where the commands of one view go while it is recorded
+// views are recorded in any order on any thread, then executed strictly in view order
+class RecordingBackend
+{
+public:
+	virtual ~RecordingBackend() = default;
+	virtual void BeginView( UINT view ) = 0;
+	virtual void EndView( UINT view ) = 0;
+	virtual void ExecuteView( UINT view ) = 0;
+};
+
+// one deferred context per view, each with its own state cache and upload ring
+// the caches record on behalf of the immediate context, so objects holding that context draw into the view being recorded
+class DeferredRecordingBackend : public RecordingBackend
+{
+public:
+	HRESULT Initialize( ID3D11Device* device, ID3D11DeviceContext* immediate, UINT viewCount );
+	void BeginFrame() noexcept;
+	void BeginView( UINT view ) override;
+	void EndView( UINT view ) override;
+	void ExecuteView( UINT view ) override;
+	UINT GetViewCount() const noexcept;
+private:
+	struct ViewContext
+	{
+		Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+		Microsoft::WRL::ComPtr<ID3D11CommandList> commandList;
+		StateCache stateCache;
+		ConstantBufferRing ring;
+		StateCache* previousCache = nullptr;
+		ConstantBufferRing* previousRing = nullptr;
+	};
+	ID3D11DeviceContext* immediate = nullptr;
+	std::vector<std::unique_ptr<ViewContext>> views;
+};
+
+// records a stream of command ids per view instead of d3d calls
+// lets the recording path be checked and timed without a gpu
+class HeadlessRecordingBackend : public RecordingBackend
+{
+public:
+	void Initialize( UINT viewCount );
+	void BeginView( UINT view ) override;
+	void EndView( UINT view ) override;
+	void ExecuteView( UINT view ) override;
+	void Record( UINT view, UINT64 command );
+	const std::vector<UINT64>& GetExecuted() const noexcept;
+	void ClearExecuted() noexcept;
+private:
+	std::vector<std::vector<UINT64>> commands;
+	std::vector<UINT64> executed;
+};
+
+// records views in parallel on a pool of persistent workers, the calling thread takes views as well
+// each view is recorded start to finish by one thread, so per-view state needs no locking
+class CommandRecorder
+{
+public:
+	using RecordFunction = std::function<void( UINT view )>;
+	CommandRecorder() = default;
+	CommandRecorder( const CommandRecorder& ) = delete;
+	CommandRecorder& operator=( const CommandRecorder& ) = delete;
+	~CommandRecorder();
+	void Start( UINT threadCount );
+	void Stop();
+	void Record( RecordingBackend& backend, UINT viewCount, const RecordFunction& record );
+	static void Execute( RecordingBackend& backend, UINT viewCount );
+	UINT GetThreadCount() const noexcept;
+	static UINT GetDefaultThreadCount() noexcept;
+private:
+	void WorkerThread();
+	bool RecordNext( std::unique_lock<std::mutex>& lock );
+private:
+	bool stopping = false;
+	UINT batch = 0;
+	UINT viewCount = 0;
+	UINT nextView = 0;
+	UINT finishedCount = 0;
+	RecordingBackend* backend = nullptr;
+	const RecordFunction* record = nullptr;
+	std::vector<std::thread> workers;
+	std::condition_variable condition;
+	std::condition_variable finished;
+	std::mutex mutex;
+};
+
+#endif
\ No newline at end of file
@@ -4,17 +4,34 @@
 
 #include <d3d11.h>
 #include <wrl/client.h>
+#include <cstring>
+#include <type_traits>
 #include "ConstantBufferTypes.h"
+#include "ConstantBufferRing.h"
+#include "StateCache.h"
 #include "../utility/ErrorLogger.h"
 
 template<class T>
 class ConstantBuffer
 {
+	static_assert( std::is_trivially_copyable_v<T>, "constant buffer data is uploaded and compared bytewise" );
 private:
 	ConstantBuffer( const ConstantBuffer<T>& rhs ) {}
+	void SetUploaded() noexcept
+	{
+		std::memcpy( &uploadedData, &data, sizeof( T ) );
+		hasUpload = true;
+	}
 private:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
 	ID3D11DeviceContext* context = nullptr;
+	bool useRing = true;
+	ConstantBufferRing* uploadRing = nullptr;
+	UINT firstConstant = 0;
+	UINT constantCount = 0;
+	bool hasUpload = false;
+	UINT uploadGeneration = 0;
+	T uploadedData;
 public:
 	ConstantBuffer() {}
 	T data;
@@ -26,16 +43,20 @@ public:
 	{
 		return buffer.GetAddressOf();
 	}
-	HRESULT Initialize( ID3D11Device* device, ID3D11DeviceContext* context )
+	// constants written once and kept across frames must not live in the per-frame ring
+	HRESULT Initialize( ID3D11Device* device, ID3D11DeviceContext* context, bool useRing = true )
 	{
 		if ( buffer.Get() != nullptr )
 			buffer.Reset();
 		
 		this->context = context;
+		this->useRing = useRing;
+		uploadRing = nullptr;
+		hasUpload = false;
 
 		D3D11_BUFFER_DESC constantBufferDesc = { 0 };
 		constantBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
-		constantBufferDesc.ByteWidth = static_cast<UINT>( sizeof( T ) + ( 16 - ( sizeof( T ) % 16 ) ) );
+		constantBufferDesc.ByteWidth = HLSL::BufferSize<T>();
 		constantBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
 		constantBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
 		constantBufferDesc.MiscFlags = 0;
@@ -44,19 +65,63 @@ public:
 		HRESULT hr = device->CreateBuffer( &constantBufferDesc, NULL, buffer.GetAddressOf() );
 		return hr;
 	}
+	// the gpu copy is left alone when data matches the last upload and that upload is still resident
+	// each recorded view has its own ring, a block in another view's ring is no use to this one
+	bool IsUploadCurrent() const noexcept
+	{
+		if ( !hasUpload || std::memcmp( &uploadedData, &data, sizeof( T ) ) != 0 )
+			return false;
+		if ( uploadRing == nullptr )
+			return true;
+		return uploadRing == ConstantBufferRing::GetActive() && uploadRing->GetGeneration() == uploadGeneration;
+	}
 	bool ApplyChanges()
 	{
+		if ( IsUploadCurrent() )
+		{
+			ConstantBufferRing::RecordSkip( sizeof( T ) );
+			return true;
+		}
+
+		hasUpload = false;
+		ConstantBufferRing* ring = useRing ? ConstantBufferRing::GetActive() : nullptr;
+		uploadRing = ring != nullptr && ring->Upload( &data, sizeof( T ), firstConstant, constantCount ) ? ring : nullptr;
+		if ( uploadRing != nullptr )
+		{
+			uploadGeneration = ring->GetGeneration();
+			SetUploaded();
+			return true;
+		}
+
+		ID3D11DeviceContext* recordingContext = StateCache::Get( context ).GetContext();
 		D3D11_MAPPED_SUBRESOURCE mappedResource;
-		HRESULT hr = context->Map( buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource );
+		HRESULT hr = recordingContext->Map( buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource );
 		if ( FAILED( hr ) )
 		{
 			ErrorLogger::Log( hr, "Failed to map constant buffer!" );
 			return false;
 		}
 		CopyMemory( mappedResource.pData, &data, sizeof( T ) );
-		context->Unmap( buffer.Get(), 0 );
+		recordingContext->Unmap( buffer.Get(), 0 );
+		ConstantBufferRing::RecordUpload( sizeof( T ) );
+		SetUploaded();
 		return true;
 	}
+	// binds wherever the last ApplyChanges wrote the data, so call it after every upload
+	void BindVS( UINT slot ) const noexcept
+	{
+		if ( uploadRing != nullptr )
+			StateCache::Get( context ).SetVSConstantBuffer( slot, uploadRing->Get(), firstConstant, constantCount );
+		else
+			StateCache::Get( context ).SetVSConstantBuffer( slot, buffer.Get() );
+	}
+	void BindPS( UINT slot ) const noexcept
+	{
+		if ( uploadRing != nullptr )
+			StateCache::Get( context ).SetPSConstantBuffer( slot, uploadRing->Get(), firstConstant, constantCount );
+		else
+			StateCache::Get( context ).SetPSConstantBuffer( slot, buffer.Get() );
+	}
 };
 
 #endif
\ No newline at end of file
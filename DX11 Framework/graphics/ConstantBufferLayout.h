@@ -0,0 +1,101 @@
+#pragma once
+#ifndef CONSTANTBUFFERLAYOUT_H
+#define CONSTANTBUFFERLAYOUT_H
+
+#include <Windows.h>
+#include <DirectXMath.h>
+#include <cstddef>
+
+// compile time mirror of the hlsl cbuffer packing rules
+// members pack in declaration order into 16 byte registers, a member never straddles a register
+// and matrices always start a new one, the buffer itself is a whole number of registers
+namespace HLSL
+{
+	static constexpr size_t REGISTER_SIZE = 16u;
+
+	// hlsl bools are four bytes, a c++ bool in its place leaves three bytes of whatever was in memory
+	struct Bool
+	{
+		Bool() = default;
+		constexpr Bool( bool value ) noexcept : value( value ? 1u : 0u ) {}
+		constexpr operator bool() const noexcept { return value != 0u; }
+		UINT value = 0u;
+	};
+
+	template<class T> struct MemberType;
+	template<class T, size_t Size, bool NewRegister = false> struct MemberTypeInfo
+	{
+		static_assert( sizeof( T ) == Size, "c++ type is not the size of its hlsl counterpart" );
+		static constexpr size_t size = Size;
+		static constexpr bool newRegister = NewRegister;
+	};
+	template<> struct MemberType<float> : MemberTypeInfo<float, 4u> {};
+	template<> struct MemberType<INT> : MemberTypeInfo<INT, 4u> {};
+	template<> struct MemberType<UINT> : MemberTypeInfo<UINT, 4u> {};
+	template<> struct MemberType<Bool> : MemberTypeInfo<Bool, 4u> {};
+	template<> struct MemberType<DirectX::XMFLOAT2> : MemberTypeInfo<DirectX::XMFLOAT2, 8u> {};
+	template<> struct MemberType<DirectX::XMFLOAT3> : MemberTypeInfo<DirectX::XMFLOAT3, 12u> {};
+	template<> struct MemberType<DirectX::XMFLOAT4> : MemberTypeInfo<DirectX::XMFLOAT4, 16u> {};
+	template<> struct MemberType<DirectX::XMFLOAT4X4> : MemberTypeInfo<DirectX::XMFLOAT4X4, 64u, true> {};
+	template<> struct MemberType<DirectX::XMMATRIX> : MemberTypeInfo<DirectX::XMMATRIX, 64u, true> {};
+
+	constexpr size_t RoundToRegister( size_t size ) noexcept
+	{
+		return ( size + REGISTER_SIZE - 1u ) & ~( REGISTER_SIZE - 1u );
+	}
+
+	constexpr size_t PackOffset( size_t offset, size_t size, bool newRegister ) noexcept
+	{
+		return newRegister || offset % REGISTER_SIZE + size > REGISTER_SIZE ? RoundToRegister( offset ) : offset;
+	}
+
+	template<class T, size_t Offset> struct Member
+	{
+		using Type = T;
+		static constexpr size_t offset = Offset;
+	};
+
+	// end of the last member once every member is packed the way the shader compiler would
+	template<class... Members>
+	constexpr size_t PackedSize() noexcept
+	{
+		size_t offset = 0u;
+		( ( offset = PackOffset( offset, MemberType<typename Members::Type>::size, MemberType<typename Members::Type>::newRegister ) +
+			MemberType<typename Members::Type>::size ), ... );
+		return offset;
+	}
+
+	// true when each c++ member sits at the offset hlsl packs it to
+	template<class... Members>
+	constexpr bool OffsetsMatch() noexcept
+	{
+		size_t offset = 0u;
+		bool matches = true;
+		( ( offset = PackOffset( offset, MemberType<typename Members::Type>::size, MemberType<typename Members::Type>::newRegister ),
+			matches = matches && offset == Members::offset,
+			offset += MemberType<typename Members::Type>::size ), ... );
+		return matches;
+	}
+
+	// the c++ struct may stop at its last member or carry padding up to the next register, never beyond it
+	template<class Struct, class... Members>
+	constexpr bool SizeMatches() noexcept
+	{
+		return sizeof( Struct ) >= PackedSize<Members...>() && sizeof( Struct ) <= RoundToRegister( PackedSize<Members...>() );
+	}
+
+	// bytes the gpu buffer needs for a struct, the upload itself only copies sizeof( T )
+	template<class T>
+	constexpr UINT BufferSize() noexcept
+	{
+		return static_cast<UINT>( RoundToRegister( sizeof( T ) ) );
+	}
+}
+
+// list every member of the cbuffer in shader declaration order
+#define HLSL_MEMBER( cbuffer, member ) HLSL::Member<decltype( cbuffer::member ), offsetof( cbuffer, member )>
+#define HLSL_VALIDATE_LAYOUT( cbuffer, ... ) \
+	static_assert( HLSL::OffsetsMatch<__VA_ARGS__>(), #cbuffer " members are not where hlsl packs them" ); \
+	static_assert( HLSL::SizeMatches<cbuffer, __VA_ARGS__>(), #cbuffer " is not the size of its hlsl cbuffer" )
+
+#endif
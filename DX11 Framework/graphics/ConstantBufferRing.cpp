@@ -0,0 +1,119 @@
+#include "ConstantBufferRing.h"
+#include "../utility/ErrorLogger.h"
+
+HRESULT ConstantBufferRing::Initialize( ID3D11Device* device, ID3D11DeviceContext* context, UINT capacity )
+{
+	supported = false;
+	buffer.Reset();
+	this->context.Reset();
+
+	// offsets need the 11.1 context, and no-overwrite maps of constant buffers are what make sub-allocation pay off
+	D3D11_FEATURE_DATA_D3D11_OPTIONS options = {};
+	if ( FAILED( device->CheckFeatureSupport( D3D11_FEATURE_D3D11_OPTIONS, &options, sizeof( options ) ) ) ||
+		!options.ConstantBufferOffsetting || !options.MapNoOverwriteOnDynamicConstantBuffer )
+		return S_OK;
+	if ( FAILED( context->QueryInterface( __uuidof( ID3D11DeviceContext1 ), reinterpret_cast<void**>( this->context.GetAddressOf() ) ) ) )
+		return S_OK;
+
+	allocator.Reset( capacity );
+	D3D11_BUFFER_DESC ringBufferDesc = { 0 };
+	ringBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+	ringBufferDesc.ByteWidth = allocator.GetCapacity();
+	ringBufferDesc.BindFlags = D3D11_BIND_CONSTANT_BUFFER;
+	ringBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+	ringBufferDesc.MiscFlags = 0;
+	ringBufferDesc.StructureByteStride = 0;
+
+	HRESULT hr = device->CreateBuffer( &ringBufferDesc, NULL, buffer.GetAddressOf() );
+	supported = SUCCEEDED( hr );
+	return hr;
+}
+
+bool ConstantBufferRing::IsSupported() const noexcept
+{
+	return supported;
+}
+
+void ConstantBufferRing::BeginFrame() noexcept
+{
+	allocator.BeginFrame();
+}
+
+bool ConstantBufferRing::Upload( const void* data, UINT size, UINT& firstConstant, UINT& constantCount )
+{
+	UploadRingAllocator::Allocation allocation;
+	if ( !supported )
+		return false;
+	if ( !allocator.Allocate( size, allocation ) )
+	{
+		Statistics::Local().ringOverflowCount++;
+		return false;
+	}
+
+	D3D11_MAPPED_SUBRESOURCE mappedResource;
+	HRESULT hr = context->Map( buffer.Get(), 0, allocation.discard ? D3D11_MAP_WRITE_DISCARD : D3D11_MAP_WRITE_NO_OVERWRITE, 0, &mappedResource );
+	if ( FAILED( hr ) )
+	{
+		ErrorLogger::Log( hr, "Failed to map constant buffer ring!" );
+		return false;
+	}
+	CopyMemory( static_cast<BYTE*>( mappedResource.pData ) + allocation.offset, data, size );
+	context->Unmap( buffer.Get(), 0 );
+
+	// offsets and counts are in 16 byte constants
+	firstConstant = allocation.offset / 16u;
+	constantCount = allocation.size / 16u;
+	Statistics::Local().ringAllocationCount++;
+	RecordUpload( size );
+	return true;
+}
+
+ID3D11Buffer* ConstantBufferRing::Get() const noexcept
+{
+	return buffer.Get();
+}
+
+// the first block of each frame discards the ring, so blocks from an earlier generation must be uploaded again
+UINT ConstantBufferRing::GetGeneration() const noexcept
+{
+	return allocator.GetGeneration();
+}
+
+ConstantBufferRing* ConstantBufferRing::GetActive() noexcept
+{
+	return active;
+}
+
+void ConstantBufferRing::SetActive( ConstantBufferRing* ring ) noexcept
+{
+	active = ring != nullptr && ring->IsSupported() ? ring : nullptr;
+}
+
+void ConstantBufferRing::RecordUpload( UINT size ) noexcept
+{
+	ConstantUploadStatistics& statistics = Statistics::Local();
+	statistics.bytesUploaded += size;
+	statistics.mapCount++;
+}
+
+void ConstantBufferRing::RecordSkip( UINT size ) noexcept
+{
+	ConstantUploadStatistics& statistics = Statistics::Local();
+	statistics.bytesSkipped += size;
+	statistics.skippedCount++;
+}
+
+ConstantUploadStatistics ConstantBufferRing::GetStatistics()
+{
+	return Statistics::Get();
+}
+
+void ConstantBufferRing::FoldStatistics()
+{
+	Statistics::Fold();
+}
+
+void ConstantBufferRing::ResetStatistics()
+{
+	Statistics::Reset();
+}
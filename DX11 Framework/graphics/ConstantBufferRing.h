@@ -0,0 +1,58 @@
+#pragma once
+#ifndef CONSTANTBUFFERRING_H
+#define CONSTANTBUFFERRING_H
+
+#include <d3d11_1.h>
+#include <wrl/client.h>
+#include "ThreadStatistics.h"
+#include "UploadRingAllocator.h"
+
+struct ConstantUploadStatistics
+{
+	UINT64 bytesUploaded = 0;
+	UINT mapCount = 0;
+	UINT ringAllocationCount = 0;
+	UINT ringOverflowCount = 0;
+	UINT64 bytesSkipped = 0;
+	UINT skippedCount = 0;
+	ConstantUploadStatistics& operator+=( const ConstantUploadStatistics& other ) noexcept
+	{
+		bytesUploaded += other.bytesUploaded;
+		mapCount += other.mapCount;
+		ringAllocationCount += other.ringAllocationCount;
+		ringOverflowCount += other.ringOverflowCount;
+		bytesSkipped += other.bytesSkipped;
+		skippedCount += other.skippedCount;
+		return *this;
+	}
+};
+
+// one large dynamic constant buffer that per-draw constants are sub-allocated from
+// blocks are bound with constant buffer offsets, which needs a d3d 11.1 runtime and driver support
+class ConstantBufferRing
+{
+public:
+	static constexpr UINT DEFAULT_CAPACITY = 1u << 20;
+	HRESULT Initialize( ID3D11Device* device, ID3D11DeviceContext* context, UINT capacity = DEFAULT_CAPACITY );
+	bool IsSupported() const noexcept;
+	void BeginFrame() noexcept;
+	bool Upload( const void* data, UINT size, UINT& firstConstant, UINT& constantCount );
+	ID3D11Buffer* Get() const noexcept;
+	UINT GetGeneration() const noexcept;
+	static ConstantBufferRing* GetActive() noexcept;
+	static void SetActive( ConstantBufferRing* ring ) noexcept;
+	static void RecordUpload( UINT size ) noexcept;
+	static void RecordSkip( UINT size ) noexcept;
+	static ConstantUploadStatistics GetStatistics();
+	static void FoldStatistics();
+	static void ResetStatistics();
+private:
+	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context;
+	UploadRingAllocator allocator;
+	bool supported = false;
+	static inline thread_local ConstantBufferRing* active = nullptr;
+	using Statistics = ThreadStatistics<ConstantUploadStatistics>;
+};
+
+#endif
@@ -3,6 +3,7 @@
 #define CONSTANTBUFFERTYPES_H
 
 #include <DirectXMath.h>
+#include "ConstantBufferLayout.h"
 
 struct CB_VS_matrix
 {
@@ -10,24 +11,50 @@ struct CB_VS_matrix
 	DirectX::XMMATRIX viewMatrix;
 	DirectX::XMMATRIX projectionMatrix;
 };
+HLSL_VALIDATE_LAYOUT( CB_VS_matrix,
+	HLSL_MEMBER( CB_VS_matrix, worldMatrix ),
+	HLSL_MEMBER( CB_VS_matrix, viewMatrix ),
+	HLSL_MEMBER( CB_VS_matrix, projectionMatrix ) );
+
+struct CB_VS_quantization
+{
+	alignas(16) DirectX::XMFLOAT3 positionOffset;
+	alignas(16) DirectX::XMFLOAT3 positionScale;
+};
+HLSL_VALIDATE_LAYOUT( CB_VS_quantization,
+	HLSL_MEMBER( CB_VS_quantization, positionOffset ),
+	HLSL_MEMBER( CB_VS_quantization, positionScale ) );
 
 struct CB_VS_matrix_2D
 {
 	DirectX::XMMATRIX wvpMatrix;
 };
+HLSL_VALIDATE_LAYOUT( CB_VS_matrix_2D,
+	HLSL_MEMBER( CB_VS_matrix_2D, wvpMatrix ) );
 
 struct CB_VS_fullscreen
 {
-	alignas(16) bool multiView;
+	DirectX::XMFLOAT2 uvScale;
+	DirectX::XMFLOAT2 uvMax;
+	HLSL::Bool multiView;
 };
+HLSL_VALIDATE_LAYOUT( CB_VS_fullscreen,
+	HLSL_MEMBER( CB_VS_fullscreen, uvScale ),
+	HLSL_MEMBER( CB_VS_fullscreen, uvMax ),
+	HLSL_MEMBER( CB_VS_fullscreen, multiView ) );
 
 struct CB_VS_fog
 {
 	DirectX::XMFLOAT3 fogColor;
-	float fogEnd;
 	float fogStart;
-	bool fogEnable;
+	float fogEnd;
+	HLSL::Bool fogEnable;
 };
+HLSL_VALIDATE_LAYOUT( CB_VS_fog,
+	HLSL_MEMBER( CB_VS_fog, fogColor ),
+	HLSL_MEMBER( CB_VS_fog, fogStart ),
+	HLSL_MEMBER( CB_VS_fog, fogEnd ),
+	HLSL_MEMBER( CB_VS_fog, fogEnable ) );
 
 struct CB_PS_light
 {
@@ -47,26 +74,54 @@ struct CB_PS_light
 	float lightQuadratic;
 
 	float directionalLightIntensity;
-	bool usePointLight;
+	HLSL::Bool usePointLight;
 	float quadIntensity;
-	bool useQuad;
+	HLSL::Bool useQuad;
 	float lightTimer;
-	bool lightFlicker;
+	HLSL::Bool lightFlicker;
 	float randLightAmount;
-	bool padding;
+	HLSL::Bool padding;
 
 	float flickerAmount;
 };
+HLSL_VALIDATE_LAYOUT( CB_PS_light,
+	HLSL_MEMBER( CB_PS_light, ambientLightColor ),
+	HLSL_MEMBER( CB_PS_light, dynamicLightColor ),
+	HLSL_MEMBER( CB_PS_light, specularLightColor ),
+	HLSL_MEMBER( CB_PS_light, dynamicLightPosition ),
+	HLSL_MEMBER( CB_PS_light, directionalLightColor ),
+	HLSL_MEMBER( CB_PS_light, directionalLightPosition ),
+	HLSL_MEMBER( CB_PS_light, ambientLightStrength ),
+	HLSL_MEMBER( CB_PS_light, dynamicLightStrength ),
+	HLSL_MEMBER( CB_PS_light, specularLightIntensity ),
+	HLSL_MEMBER( CB_PS_light, specularLightPower ),
+	HLSL_MEMBER( CB_PS_light, lightConstant ),
+	HLSL_MEMBER( CB_PS_light, lightLinear ),
+	HLSL_MEMBER( CB_PS_light, lightQuadratic ),
+	HLSL_MEMBER( CB_PS_light, directionalLightIntensity ),
+	HLSL_MEMBER( CB_PS_light, usePointLight ),
+	HLSL_MEMBER( CB_PS_light, quadIntensity ),
+	HLSL_MEMBER( CB_PS_light, useQuad ),
+	HLSL_MEMBER( CB_PS_light, lightTimer ),
+	HLSL_MEMBER( CB_PS_light, lightFlicker ),
+	HLSL_MEMBER( CB_PS_light, randLightAmount ),
+	HLSL_MEMBER( CB_PS_light, padding ),
+	HLSL_MEMBER( CB_PS_light, flickerAmount ) );
 
 struct CB_PS_scene
 {
 	float alphaFactor;
-	bool useTexture;
+	HLSL::Bool useTexture;
 };
+HLSL_VALIDATE_LAYOUT( CB_PS_scene,
+	HLSL_MEMBER( CB_PS_scene, alphaFactor ),
+	HLSL_MEMBER( CB_PS_scene, useTexture ) );
 
 struct CB_PS_outline
 {
 	alignas(16) DirectX::XMFLOAT3 outlineColor;
 };
+HLSL_VALIDATE_LAYOUT( CB_PS_outline,
+	HLSL_MEMBER( CB_PS_outline, outlineColor ) );
 
 #endif
\ No newline at end of file
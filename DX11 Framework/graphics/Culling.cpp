@@ -0,0 +1,98 @@
+#include "Culling.h"
+
+using namespace DirectX;
+
+Frustum Frustum::FromMatrix( const XMMATRIX& viewProjectionMatrix ) noexcept
+{
+	// planes are sums and differences of the matrix columns (gribb & hartmann), with d3d's 0 to 1 depth range
+	const XMMATRIX columns = XMMatrixTranspose( viewProjectionMatrix );
+	const XMVECTOR planes[6] = {
+		columns.r[3] + columns.r[0], // left
+		columns.r[3] - columns.r[0], // right
+		columns.r[3] + columns.r[1], // bottom
+		columns.r[3] - columns.r[1], // top
+		columns.r[2],                // near
+		columns.r[3] - columns.r[2]  // far
+	};
+
+	Frustum frustum;
+	for ( UINT i = 0; i < 6; i++ )
+		XMStoreFloat4( &frustum.planes[i], XMPlaneNormalize( planes[i] ) );
+	return frustum;
+}
+
+void CullingBatch::Clear() noexcept
+{
+	count = 0;
+	visibleCount = 0;
+}
+
+UINT CullingBatch::Add( const BoundingBox& box )
+{
+	if ( count + 1 > centerX.size() )
+	{
+		for ( std::vector<float>* stream : { &centerX, &centerY, &centerZ, &extentX, &extentY, &extentZ } )
+			stream->resize( count + 1, 0.0f );
+		visible.resize( count + 1, 1 );
+	}
+	Set( count, box );
+	visible[count] = 1;
+	return count++;
+}
+
+void CullingBatch::Set( UINT index, const BoundingBox& box ) noexcept
+{
+	centerX[index] = box.Center.x;
+	centerY[index] = box.Center.y;
+	centerZ[index] = box.Center.z;
+	extentX[index] = box.Extents.x;
+	extentY[index] = box.Extents.y;
+	extentZ[index] = box.Extents.z;
+}
+
+void CullingBatch::Cull( const Frustum& frustum )
+{
+	visibleCount = Cull( frustum, visible.data() );
+}
+
+// writes one visibility byte per box, leaving the batch untouched so views on other threads can share it
+UINT CullingBatch::Cull( const Frustum& frustum, BYTE* visibility ) const
+{
+	const BoxStreams boxes = { centerX.data(), centerY.data(), centerZ.data(), extentX.data(), extentY.data(), extentZ.data() };
+	const UINT visibleBoxes = Intersection::BoxFrustum( boxes, count, frustum.planes, visibility );
+
+	CullingStatistics& statistics = Statistics::Local();
+	statistics.visibleCount += visibleBoxes;
+	statistics.culledCount += count - visibleBoxes;
+	return visibleBoxes;
+}
+
+bool CullingBatch::IsVisible( UINT index ) const noexcept
+{
+	return visible[index] != 0;
+}
+
+UINT CullingBatch::GetCount() const noexcept
+{
+	return count;
+}
+
+UINT CullingBatch::GetVisibleCount() const noexcept
+{
+	return visibleCount;
+}
+
+CullingStatistics CullingBatch::GetStatistics()
+{
+	return Statistics::Get();
+}
+
+void CullingBatch::FoldStatistics()
+{
+	Statistics::Fold();
+}
+
+void CullingBatch::ResetStatistics()
+{
+	Statistics::Reset();
+}
\ No newline at end of file
@@ -0,0 +1,56 @@
+#pragma once
+#ifndef CULLING_H
+#define CULLING_H
+
+#include <Windows.h>
+#include <DirectXMath.h>
+#include <DirectXCollision.h>
+#include <vector>
+#include "ThreadStatistics.h"
+#include "../utility/Intersection.h"
+
+// world space view frustum, normalized planes facing inwards
+struct Frustum
+{
+	static Frustum FromMatrix( const DirectX::XMMATRIX& viewProjectionMatrix ) noexcept;
+	DirectX::XMFLOAT4 planes[6];
+};
+
+struct CullingStatistics
+{
+	UINT visibleCount = 0;
+	UINT culledCount = 0;
+	CullingStatistics& operator+=( const CullingStatistics& other ) noexcept
+	{
+		visibleCount += other.visibleCount;
+		culledCount += other.culledCount;
+		return *this;
+	}
+};
+
+// frustum test of a batch of world space bounding boxes
+// boxes are kept as a structure of arrays so the intersection kernels test each plane against several boxes at once
+class CullingBatch
+{
+public:
+	void Clear() noexcept;
+	UINT Add( const DirectX::BoundingBox& box );
+	void Set( UINT index, const DirectX::BoundingBox& box ) noexcept;
+	void Cull( const Frustum& frustum );
+	UINT Cull( const Frustum& frustum, BYTE* visibility ) const;
+	bool IsVisible( UINT index ) const noexcept;
+	UINT GetCount() const noexcept;
+	UINT GetVisibleCount() const noexcept;
+	static CullingStatistics GetStatistics();
+	static void FoldStatistics();
+	static void ResetStatistics();
+private:
+	std::vector<float> centerX, centerY, centerZ;
+	std::vector<float> extentX, extentY, extentZ;
+	std::vector<BYTE> visible;
+	UINT count = 0;
+	UINT visibleCount = 0;
+	using Statistics = ThreadStatistics<CullingStatistics>;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,83 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cmath>
+
+void DynamicResolution::Reset() noexcept
+{
+	statistics = DynamicResolutionStatistics();
+	scale = settings.maxScale;
+	smoothed = 0.0f;
+	settleCount = 0;
+	underCount = 0;
+}
+
+float DynamicResolution::Update( float frameTime ) noexcept
+{
+	if ( frameTime <= 0.0f )
+		return GetScale();
+	statistics.frameCount++;
+	statistics.lastFrameTime = frameTime;
+	if ( frameTime > settings.frameBudget )
+		statistics.overBudgetCount++;
+	if ( !settings.enabled )
+	{
+		SetScale( settings.maxScale );
+		return scale;
+	}
+	if ( settleCount > 0 )
+	{
+		settleCount--;
+		return scale;
+	}
+
+	// rises quickly so spikes are caught, falls slowly so one quick frame doesn't invite a scale up
+	smoothed = smoothed == 0.0f ? frameTime : smoothed + ( frameTime - smoothed ) * ( frameTime > smoothed ? 0.5f : 0.1f );
+	statistics.smoothedFrameTime = smoothed;
+
+	// aim between the headroom and the budget, so neither direction triggers again straight away
+	const float target = settings.frameBudget * ( 1.0f + settings.headroom ) * 0.5f;
+	const float ideal = scale * std::sqrt( target / smoothed );
+	if ( smoothed > settings.frameBudget )
+	{
+		underCount = 0;
+		SetScale( ideal );
+	}
+	else if ( smoothed < settings.frameBudget * settings.headroom && scale < settings.maxScale )
+	{
+		if ( ++underCount >= settings.upscaleDelay )
+			SetScale( std::min( ideal, scale + settings.maxStepUp ) );
+	}
+	else
+	{
+		underCount = 0;
+	}
+	return scale;
+}
+
+float DynamicResolution::GetScale() const noexcept
+{
+	return settings.enabled ? scale : settings.maxScale;
+}
+
+DynamicResolutionSettings& DynamicResolution::GetSettings() noexcept
+{
+	return settings;
+}
+
+const DynamicResolutionStatistics& DynamicResolution::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+// changes under half a percent aren't worth invalidating the timings already in flight
+void DynamicResolution::SetScale( float scale ) noexcept
+{
+	scale = std::clamp( scale, settings.minScale, settings.maxScale );
+	if ( std::fabs( scale - this->scale ) < 0.005f )
+		return;
+	this->scale = scale;
+	statistics.changeCount++;
+	smoothed = 0.0f;
+	settleCount = settings.latency;
+	underCount = 0;
+}
\ No newline at end of file
@@ -0,0 +1,52 @@
+#pragma once
+#ifndef DYNAMICRESOLUTION_H
+#define DYNAMICRESOLUTION_H
+
+#include <cstdint>
+
+struct DynamicResolutionSettings
+{
+	bool enabled = true;
+	float frameBudget = 14.0f;
+	float minScale = 0.5f;
+	float maxScale = 1.0f;
+	float headroom = 0.85f;
+	float maxStepUp = 0.05f;
+	uint32_t upscaleDelay = 10u;
+	uint32_t latency = 3u;
+};
+
+struct DynamicResolutionStatistics
+{
+	uint32_t frameCount = 0;
+	uint32_t overBudgetCount = 0;
+	uint32_t changeCount = 0;
+	float lastFrameTime = 0.0f;
+	float smoothedFrameTime = 0.0f;
+};
+
+// picks the fraction of the scene target to render so measured frame times stay within a budget
+// pure c++, fed frame times that arrive 'latency' frames after the frame they measure
+//  - frame time is taken to follow pixel count, so the scale moves with the square root of the time ratio
+//  - going over budget scales down at once, scaling up waits until frames sit under the headroom and moves in small steps
+//  - timings taken before a change can't reflect it, so they are skipped
+class DynamicResolution
+{
+public:
+	void Reset() noexcept;
+	float Update( float frameTime ) noexcept;
+	float GetScale() const noexcept;
+	DynamicResolutionSettings& GetSettings() noexcept;
+	const DynamicResolutionStatistics& GetStatistics() const noexcept;
+private:
+	void SetScale( float scale ) noexcept;
+private:
+	DynamicResolutionSettings settings;
+	DynamicResolutionStatistics statistics;
+	float scale = 1.0f;
+	float smoothed = 0.0f;
+	uint32_t settleCount = 0;
+	uint32_t underCount = 0;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,377 @@
+#include "FrameGraph.h"
+#include <algorithm>
+#include <functional>
+#include <queue>
+
+void FrameGraph::Reset()
+{
+	resources.clear();
+	passes.clear();
+	order.clear();
+	statistics = FrameGraphStatistics();
+	error.clear();
+}
+
+FrameGraph::Resource FrameGraph::Import( const std::string& name, const FrameResourceDesc& desc )
+{
+	return AddResource( name, desc, true );
+}
+
+FrameGraph::Resource FrameGraph::Create( const std::string& name, const FrameResourceDesc& desc )
+{
+	return AddResource( name, desc, false );
+}
+
+FrameGraph::Pass FrameGraph::AddPass( const std::string& name, std::function<void()> execute )
+{
+	PassNode pass;
+	pass.name = name;
+	pass.execute = std::move( execute );
+	passes.push_back( std::move( pass ) );
+	return static_cast<Pass>( passes.size() - 1 );
+}
+
+// a pass that reads and writes the same resource sees the contents from before its own write
+void FrameGraph::Read( Pass pass, Resource resource )
+{
+	const std::vector<Pass>& writers = resources[resource].writers;
+	uint32_t version = static_cast<uint32_t>( writers.size() );
+	if ( !writers.empty() && writers.back() == pass )
+		version--;
+	passes[pass].reads.push_back( resource );
+	passes[pass].readVersions.push_back( version );
+}
+
+void FrameGraph::Write( Pass pass, Resource resource, WriteMode mode )
+{
+	passes[pass].writes.push_back( resource );
+	resources[resource].writers.push_back( pass );
+	resources[resource].writeModes.push_back( mode );
+}
+
+void FrameGraph::SetSideEffect( Pass pass )
+{
+	passes[pass].sideEffect = true;
+}
+
+bool FrameGraph::Compile()
+{
+	order.clear();
+	error.clear();
+	statistics = FrameGraphStatistics();
+	statistics.passCount = GetPassCount();
+	for ( PassNode& pass : passes )
+	{
+		pass.culled = true;
+		pass.clears.clear();
+	}
+	for ( ResourceNode& resource : resources )
+	{
+		resource.physical = INVALID;
+		resource.firstUse = INVALID;
+		resource.lastUse = INVALID;
+	}
+	for ( const PassNode& pass : passes )
+		for ( uint32_t i = 0; i < pass.reads.size(); i++ )
+			if ( !resources[pass.reads[i]].imported && pass.readVersions[i] == 0u )
+				return Fail( "'" + pass.name + "' reads '" + resources[pass.reads[i]].name + "' before anything writes it" );
+
+	// walk back from the passes whose results leave the graph, everything they don't depend on is culled
+	std::vector<Pass> stack;
+	for ( Pass i = 0; i < passes.size(); i++ )
+	{
+		if ( passes[i].sideEffect )
+		{
+			passes[i].culled = false;
+			stack.push_back( i );
+		}
+	}
+	for ( Resource i = 0; i < resources.size(); i++ )
+		if ( resources[i].imported )
+			KeepWriters( i, static_cast<uint32_t>( resources[i].writers.size() ), stack );
+	while ( !stack.empty() )
+	{
+		const Pass pass = stack.back();
+		stack.pop_back();
+		for ( uint32_t i = 0; i < passes[pass].reads.size(); i++ )
+			KeepWriters( passes[pass].reads[i], passes[pass].readVersions[i], stack );
+		for ( Resource resource : passes[pass].writes )
+		{
+			const ResourceNode& node = resources[resource];
+			const uint32_t position = static_cast<uint32_t>( std::find( node.writers.begin(), node.writers.end(), pass ) - node.writers.begin() );
+			if ( node.writeModes[position] == WriteMode::Partial )
+				KeepWriters( resource, position, stack );
+		}
+	}
+
+	if ( !SortPasses() )
+		return false;
+
+	// lifetimes in execution order, then a clear ahead of each resource's first write that leaves pixels untouched
+	for ( uint32_t i = 0; i < order.size(); i++ )
+	{
+		const PassNode& pass = passes[order[i]];
+		for ( const std::vector<Resource>* list : { &pass.reads, &pass.writes } )
+		{
+			for ( Resource resource : *list )
+			{
+				ResourceNode& node = resources[resource];
+				node.firstUse = std::min( node.firstUse, i );
+				node.lastUse = i;
+			}
+		}
+	}
+	for ( Resource i = 0; i < resources.size(); i++ )
+	{
+		const ResourceNode& node = resources[i];
+		for ( uint32_t j = 0; j < node.writers.size(); j++ )
+		{
+			if ( passes[node.writers[j]].culled )
+				continue;
+			if ( node.writeModes[j] == WriteMode::Partial )
+			{
+				passes[node.writers[j]].clears.push_back( i );
+				statistics.clearCount++;
+			}
+			break;
+		}
+	}
+
+	AssignPhysical();
+	statistics.culledPassCount = statistics.passCount - static_cast<uint32_t>( order.size() );
+	return true;
+}
+
+void FrameGraph::Execute( const std::function<void( Resource resource )>& clear ) const
+{
+	for ( Pass pass : order )
+	{
+		for ( Resource resource : passes[pass].clears )
+			clear( resource );
+		if ( passes[pass].execute )
+			passes[pass].execute();
+	}
+}
+
+const std::vector<FrameGraph::Pass>& FrameGraph::GetOrder() const noexcept
+{
+	return order;
+}
+
+const std::vector<FrameGraph::Resource>& FrameGraph::GetClears( Pass pass ) const noexcept
+{
+	return passes[pass].clears;
+}
+
+bool FrameGraph::IsCulled( Pass pass ) const noexcept
+{
+	return passes[pass].culled;
+}
+
+const std::string& FrameGraph::GetPassName( Pass pass ) const noexcept
+{
+	return passes[pass].name;
+}
+
+const std::string& FrameGraph::GetResourceName( Resource resource ) const noexcept
+{
+	return resources[resource].name;
+}
+
+const FrameResourceDesc& FrameGraph::GetDesc( Resource resource ) const noexcept
+{
+	return resources[resource].desc;
+}
+
+bool FrameGraph::IsImported( Resource resource ) const noexcept
+{
+	return resources[resource].imported;
+}
+
+// transient resources sharing an index share memory, imported and unused ones have none
+uint32_t FrameGraph::GetPhysical( Resource resource ) const noexcept
+{
+	return resources[resource].physical;
+}
+
+uint32_t FrameGraph::GetFirstUse( Resource resource ) const noexcept
+{
+	return resources[resource].firstUse;
+}
+
+uint32_t FrameGraph::GetLastUse( Resource resource ) const noexcept
+{
+	return resources[resource].lastUse;
+}
+
+uint32_t FrameGraph::GetResourceCount() const noexcept
+{
+	return static_cast<uint32_t>( resources.size() );
+}
+
+uint32_t FrameGraph::GetPassCount() const noexcept
+{
+	return static_cast<uint32_t>( passes.size() );
+}
+
+const FrameGraphStatistics& FrameGraph::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+const std::string& FrameGraph::GetError() const noexcept
+{
+	return error;
+}
+
+FrameGraph::Resource FrameGraph::AddResource( const std::string& name, const FrameResourceDesc& desc, bool imported )
+{
+	ResourceNode resource;
+	resource.name = name;
+	resource.desc = desc;
+	resource.imported = imported;
+	resources.push_back( std::move( resource ) );
+	return static_cast<Resource>( resources.size() - 1 );
+}
+
+// keeps the writers that produce a resource's contents as seen just before writer 'before'
+// nothing written ahead of a full write is visible, so the search stops there
+void FrameGraph::KeepWriters( Resource resource, uint32_t before, std::vector<Pass>& stack )
+{
+	const ResourceNode& node = resources[resource];
+	for ( uint32_t i = before; i-- > 0; )
+	{
+		const Pass writer = node.writers[i];
+		if ( passes[writer].culled )
+		{
+			passes[writer].culled = false;
+			stack.push_back( writer );
+		}
+		if ( node.writeModes[i] == WriteMode::Full )
+			break;
+	}
+}
+
+// topological order of the kept passes, ties go to whichever was declared first
+// writers of a resource are chained, each read follows the last write before it and precedes the next one
+bool FrameGraph::SortPasses()
+{
+	std::vector<std::vector<Pass>> edges( passes.size() );
+	std::vector<uint32_t> incoming( passes.size(), 0u );
+	auto addEdge = [&edges, &incoming]( Pass from, Pass to )
+	{
+		edges[from].push_back( to );
+		incoming[to]++;
+	};
+	for ( const ResourceNode& node : resources )
+	{
+		Pass previous = INVALID;
+		for ( Pass writer : node.writers )
+		{
+			if ( passes[writer].culled || writer == previous )
+				continue;
+			if ( previous != INVALID )
+				addEdge( previous, writer );
+			previous = writer;
+		}
+	}
+	for ( Pass reader = 0; reader < passes.size(); reader++ )
+	{
+		const PassNode& pass = passes[reader];
+		if ( pass.culled )
+			continue;
+		for ( uint32_t i = 0; i < pass.reads.size(); i++ )
+		{
+			const ResourceNode& node = resources[pass.reads[i]];
+			const uint32_t version = pass.readVersions[i];
+			for ( uint32_t j = version; j-- > 0; )
+			{
+				if ( passes[node.writers[j]].culled )
+					continue;
+				if ( node.writers[j] != reader )
+					addEdge( node.writers[j], reader );
+				break;
+			}
+			for ( uint32_t j = version; j < node.writers.size(); j++ )
+			{
+				if ( passes[node.writers[j]].culled )
+					continue;
+				if ( node.writers[j] != reader )
+					addEdge( reader, node.writers[j] );
+				break;
+			}
+		}
+	}
+
+	std::priority_queue<Pass, std::vector<Pass>, std::greater<Pass>> ready;
+	uint32_t keptCount = 0;
+	for ( Pass i = 0; i < passes.size(); i++ )
+	{
+		if ( passes[i].culled )
+			continue;
+		keptCount++;
+		if ( incoming[i] == 0u )
+			ready.push( i );
+	}
+	while ( !ready.empty() )
+	{
+		const Pass pass = ready.top();
+		ready.pop();
+		order.push_back( pass );
+		for ( Pass next : edges[pass] )
+			if ( --incoming[next] == 0u )
+				ready.push( next );
+	}
+	if ( order.size() != keptCount )
+	{
+		for ( Pass i = 0; i < passes.size(); i++ )
+			if ( !passes[i].culled && incoming[i] > 0u )
+				return Fail( "'" + passes[i].name + "' is part of a dependency cycle" );
+	}
+	return true;
+}
+
+// first fit in order of first use, a physical resource is free once the pass that last used it has run
+void FrameGraph::AssignPhysical()
+{
+	std::vector<Resource> transients;
+	for ( Resource i = 0; i < resources.size(); i++ )
+		if ( !resources[i].imported && resources[i].firstUse != INVALID )
+			transients.push_back( i );
+	std::stable_sort( transients.begin(), transients.end(),
+		[this]( Resource a, Resource b ) { return resources[a].firstUse < resources[b].firstUse; } );
+
+	struct Physical
+	{
+		FrameResourceDesc desc;
+		uint32_t lastUse;
+	};
+	std::vector<Physical> physicals;
+	for ( Resource resource : transients )
+	{
+		ResourceNode& node = resources[resource];
+		uint32_t chosen = INVALID;
+		for ( uint32_t i = 0; i < physicals.size() && chosen == INVALID; i++ )
+			if ( physicals[i].desc == node.desc && physicals[i].lastUse < node.firstUse )
+				chosen = i;
+		if ( chosen == INVALID )
+		{
+			chosen = static_cast<uint32_t>( physicals.size() );
+			physicals.push_back( { node.desc, node.lastUse } );
+			statistics.allocatedBytes += node.desc.GetSize();
+		}
+		physicals[chosen].lastUse = node.lastUse;
+		node.physical = chosen;
+		statistics.transientBytes += node.desc.GetSize();
+	}
+	statistics.transientCount = static_cast<uint32_t>( transients.size() );
+	statistics.physicalCount = static_cast<uint32_t>( physicals.size() );
+	statistics.savedBytes = statistics.transientBytes - statistics.allocatedBytes;
+}
+
+bool FrameGraph::Fail( const std::string& error )
+{
+	this->error = error;
+	order.clear();
+	return false;
+}
\ No newline at end of file
@@ -0,0 +1,123 @@
+#pragma once
+#ifndef FRAMEGRAPH_H
+#define FRAMEGRAPH_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <functional>
+
+// formats the graph needs to tell apart, it never creates a texture itself
+enum class FrameFormat : uint32_t
+{
+	Color,
+	DepthStencil
+};
+
+struct FrameResourceDesc
+{
+	uint32_t width = 0;
+	uint32_t height = 0;
+	FrameFormat format = FrameFormat::Color;
+	uint64_t GetSize() const noexcept { return static_cast<uint64_t>( width ) * height * 4u; }
+	bool operator==( const FrameResourceDesc& other ) const noexcept
+	{
+		return width == other.width && height == other.height && format == other.format;
+	}
+};
+
+struct FrameGraphStatistics
+{
+	uint32_t passCount = 0;
+	uint32_t culledPassCount = 0;
+	uint32_t clearCount = 0;
+	uint32_t transientCount = 0;
+	uint32_t physicalCount = 0;
+	uint64_t transientBytes = 0;
+	uint64_t allocatedBytes = 0;
+	uint64_t savedBytes = 0;
+};
+
+// passes declare the resources they read and write, Compile decides which passes run, in what order,
+// which memory each transient resource lives in and where clears are needed
+// pure c++, the caller maps physical resources to textures and performs the clears
+//  - a read sees the writes declared before it, so it runs after the last of them and before the next one
+//    writers of a resource keep their declaration order, which lets passes ping-pong between two resources
+//  - a pass is culled unless it has a side effect or feeds an imported resource, directly or through other passes
+//  - a write covering every pixel hides earlier writes, which are culled too
+//  - transient resources with equal descriptions and disjoint lifetimes share one physical resource
+//  - a resource is cleared before its first write unless that write covers every pixel
+class FrameGraph
+{
+public:
+	using Resource = uint32_t;
+	using Pass = uint32_t;
+	static constexpr uint32_t INVALID = UINT32_MAX;
+	enum class WriteMode
+	{
+		Partial,
+		Full
+	};
+
+	void Reset();
+	Resource Import( const std::string& name, const FrameResourceDesc& desc );
+	Resource Create( const std::string& name, const FrameResourceDesc& desc );
+	Pass AddPass( const std::string& name, std::function<void()> execute );
+	void Read( Pass pass, Resource resource );
+	void Write( Pass pass, Resource resource, WriteMode mode = WriteMode::Partial );
+	void SetSideEffect( Pass pass );
+	bool Compile();
+	void Execute( const std::function<void( Resource resource )>& clear ) const;
+
+	const std::vector<Pass>& GetOrder() const noexcept;
+	const std::vector<Resource>& GetClears( Pass pass ) const noexcept;
+	bool IsCulled( Pass pass ) const noexcept;
+	const std::string& GetPassName( Pass pass ) const noexcept;
+	const std::string& GetResourceName( Resource resource ) const noexcept;
+	const FrameResourceDesc& GetDesc( Resource resource ) const noexcept;
+	bool IsImported( Resource resource ) const noexcept;
+	uint32_t GetPhysical( Resource resource ) const noexcept;
+	uint32_t GetFirstUse( Resource resource ) const noexcept;
+	uint32_t GetLastUse( Resource resource ) const noexcept;
+	uint32_t GetResourceCount() const noexcept;
+	uint32_t GetPassCount() const noexcept;
+	const FrameGraphStatistics& GetStatistics() const noexcept;
+	const std::string& GetError() const noexcept;
+private:
+	struct ResourceNode
+	{
+		std::string name;
+		FrameResourceDesc desc;
+		bool imported = false;
+		std::vector<Pass> writers;
+		std::vector<WriteMode> writeModes;
+		uint32_t physical = INVALID;
+		uint32_t firstUse = INVALID;
+		uint32_t lastUse = INVALID;
+	};
+	struct PassNode
+	{
+		std::string name;
+		std::function<void()> execute;
+		std::vector<Resource> reads;
+		// how many writes of each read resource were declared before the read, the version it sees
+		std::vector<uint32_t> readVersions;
+		std::vector<Resource> writes;
+		std::vector<Resource> clears;
+		bool sideEffect = false;
+		bool culled = true;
+	};
+	Resource AddResource( const std::string& name, const FrameResourceDesc& desc, bool imported );
+	void KeepWriters( Resource resource, uint32_t before, std::vector<Pass>& stack );
+	bool SortPasses();
+	void AssignPhysical();
+	bool Fail( const std::string& error );
+private:
+	std::vector<ResourceNode> resources;
+	std::vector<PassNode> passes;
+	std::vector<Pass> order;
+	FrameGraphStatistics statistics;
+	std::string error;
+};
+
+#endif
\ No newline at end of file
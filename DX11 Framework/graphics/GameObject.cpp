@@ -1,28 +1,97 @@
 #include "GameObject.h"
 
-const XMVECTOR& GameObject::GetPositionVector() const noexcept
+GameObject::GameObject()
 {
-	return posVector;
+	transform = GetTransformStore().Allocate();
+	std::vector<GameObject*>& owners = GetOwners();
+	if ( transform >= owners.size() )
+		owners.resize( transform + 1, nullptr );
+	owners[transform] = this;
 }
 
-const XMFLOAT3& GameObject::GetPositionFloat3() const noexcept
+// a copy gets a transform of its own, starting where the original's was, resetting to where it would and under the same parent
+GameObject::GameObject( const GameObject& other ) : GameObject()
 {
-	return position;
+	*this = other;
 }
 
-const XMVECTOR& GameObject::GetRotationVector() const noexcept
+GameObject& GameObject::operator=( const GameObject& other )
 {
-	return rotVector;
+	if ( this == &other )
+		return *this;
+	GetTransformStore().Copy( transform, other.transform );
+	modelName = other.modelName;
+	return *this;
 }
 
-const XMFLOAT3& GameObject::GetRotationFloat3() const noexcept
+// a move hands the transform over, so children stay attached and the owner table follows the object
+// the moved-from object keeps no transform and may only be destroyed or assigned to
+GameObject::GameObject( GameObject&& other ) noexcept :
+	modelName( std::move( other.modelName ) ),
+	transform( other.transform )
 {
-	return rotation;
+	other.transform = TransformStore::INVALID;
+	if ( transform != TransformStore::INVALID )
+		GetOwners()[transform] = this;
 }
 
-const XMFLOAT3& GameObject::GetScaleFloat3() const noexcept
+GameObject& GameObject::operator=( GameObject&& other ) noexcept
 {
-	return { scale.x, scale.y, scale.z };
+	if ( this == &other )
+		return *this;
+	ReleaseTransform();
+	modelName = std::move( other.modelName );
+	transform = other.transform;
+	other.transform = TransformStore::INVALID;
+	if ( transform != TransformStore::INVALID )
+		GetOwners()[transform] = this;
+	return *this;
+}
+
+GameObject::~GameObject()
+{
+	ReleaseTransform();
+}
+
+void GameObject::ReleaseTransform() noexcept
+{
+	if ( transform == TransformStore::INVALID )
+		return;
+	GetOwners()[transform] = nullptr;
+	GetTransformStore().Release( transform );
+	transform = TransformStore::INVALID;
+}
+
+XMVECTOR GameObject::GetPositionVector() const noexcept
+{
+	const XMFLOAT3 position = GetPositionFloat3();
+	return XMLoadFloat3( &position );
+}
+
+XMFLOAT3 GameObject::GetPositionFloat3() const noexcept
+{
+	return GetTransformStore().GetPosition( transform );
+}
+
+XMVECTOR GameObject::GetRotationVector() const noexcept
+{
+	const XMFLOAT3 rotation = GetRotationFloat3();
+	return XMLoadFloat3( &rotation );
+}
+
+XMFLOAT3 GameObject::GetRotationFloat3() const noexcept
+{
+	return GetTransformStore().GetRotation( transform );
+}
+
+XMFLOAT3 GameObject::GetScaleFloat3() const noexcept
+{
+	return GetTransformStore().GetScale( transform );
+}
+
+TransformStore::Handle GameObject::GetTransformHandle() const noexcept
+{
+	return transform;
 }
 
 const std::string& GameObject::GetModelName() const noexcept
@@ -38,8 +107,7 @@ void GameObject::SetModelName( const std::string& name ) noexcept
 /// POSITIONS
 void GameObject::SetInitialPosition( const XMFLOAT3& pos ) noexcept
 {
-	initialPos = pos;
-	SetPosition( pos );
+	GetTransformStore().SetInitialPosition( transform, pos );
 }
 
 void GameObject::SetInitialPosition( float xPos, float yPos, float zPos ) noexcept
@@ -49,16 +117,14 @@ void GameObject::SetInitialPosition( float xPos, float yPos, float zPos ) noexce
 
 void GameObject::SetPosition( const XMVECTOR& pos ) noexcept
 {
+	XMFLOAT3 position;
 	XMStoreFloat3( &position, pos );
-	posVector = pos;
-	UpdateMatrix();
+	SetPosition( position );
 }
 
 void GameObject::SetPosition( const XMFLOAT3& pos ) noexcept
 {
-	position = pos;
-	posVector = XMLoadFloat3( &position );
-	UpdateMatrix();
+	GetTransformStore().SetPosition( transform, pos );
 }
 
 void GameObject::SetPosition( float xPos, float yPos, float zPos ) noexcept
@@ -68,18 +134,12 @@ void GameObject::SetPosition( float xPos, float yPos, float zPos ) noexcept
 
 void GameObject::AdjustPosition( const XMVECTOR& pos ) noexcept
 {
-	posVector += pos;
-	XMStoreFloat3( &position, posVector );
-	UpdateMatrix();
+	SetPosition( GetPositionVector() + pos );
 }
 
 void GameObject::AdjustPosition( const XMFLOAT3& pos ) noexcept
 {
-	position.x += pos.x;
-	position.y += pos.y;
-	position.z += pos.z;
-	posVector = XMLoadFloat3( &position );
-	UpdateMatrix();
+	GetTransformStore().AdjustPosition( transform, pos );
 }
 
 void GameObject::AdjustPosition( float xPos, float yPos, float zPos ) noexcept
@@ -89,15 +149,13 @@ void GameObject::AdjustPosition( float xPos, float yPos, float zPos ) noexcept
 
 void GameObject::ResetPosition() noexcept
 {
-	position = initialPos;
-	UpdateMatrix();
+	GetTransformStore().ResetPosition( transform );
 }
 
 /// ROTATIONS
 void GameObject::SetInitialRotation( const XMFLOAT3& rot ) noexcept
 {
-	initialRot = rot;
-	SetRotation( rot );
+	GetTransformStore().SetInitialRotation( transform, rot );
 }
 
 void GameObject::SetInitialRotation( float xRot, float yRot, float zRot ) noexcept
@@ -107,16 +165,14 @@ void GameObject::SetInitialRotation( float xRot, float yRot, float zRot ) noexce
 
 void GameObject::SetRotation( const XMVECTOR& rot ) noexcept
 {
-	rotVector = rot;
+	XMFLOAT3 rotation;
 	XMStoreFloat3( &rotation, rot );
-	UpdateMatrix();
+	SetRotation( rotation );
 }
 
 void GameObject::SetRotation( const XMFLOAT3& rot ) noexcept
 {
-	rotation = rot;
-	rotVector = XMLoadFloat3( &rotation );
-	UpdateMatrix();
+	GetTransformStore().SetRotation( transform, rot );
 }
 
 void GameObject::SetRotation( float xRot, float yRot, float zRot ) noexcept
@@ -126,25 +182,12 @@ void GameObject::SetRotation( float xRot, float yRot, float zRot ) noexcept
 
 void GameObject::AdjustRotation( const XMVECTOR& rot ) noexcept
 {
-	rotVector += rot;
-	XMStoreFloat3( &rotation, rotVector );
-	UpdateMatrix();
+	SetRotation( GetRotationVector() + rot );
 }
 
 void GameObject::AdjustRotation( const XMFLOAT3& rot ) noexcept
 {
-	rotation.x += rot.x;
-	rotation.y += rot.y;
-	rotation.z += rot.z;
-
-	if ( rotation.x >= XMConvertToRadians( 90.0f ) )
-		rotation.x = XMConvertToRadians( 90.0f );
-
-	if ( rotation.x <= XMConvertToRadians( -90.0f ) )
-		rotation.x = XMConvertToRadians( -90.0f );
-
-	rotVector = XMLoadFloat3( &rotation );
-	UpdateMatrix();
+	GetTransformStore().AdjustRotation( transform, rot );
 }
 
 void GameObject::AdjustRotation( float xRot, float yRot, float zRot ) noexcept
@@ -154,35 +197,96 @@ void GameObject::AdjustRotation( float xRot, float yRot, float zRot ) noexcept
 
 void GameObject::ResetRotation() noexcept
 {
-	rotation = initialRot;
-	UpdateMatrix();
+	GetTransformStore().ResetRotation( transform );
 }
 
 /// SCALE
 void GameObject::SetInitialScale( float xScale, float yScale, float zScale ) noexcept
 {
-	initialScale = { xScale, yScale, zScale };
-	SetScale( xScale, yScale, zScale );
+	GetTransformStore().SetInitialScale( transform, { xScale, yScale, zScale } );
 }
 
 void GameObject::SetScale( float xScale, float yScale, float zScale ) noexcept
 {
-	scale = { xScale, yScale, zScale };
-	UpdateMatrix();
+	GetTransformStore().SetScale( transform, { xScale, yScale, zScale } );
 }
 
 void GameObject::AdjustScale( float xScale, float yScale, float zScale ) noexcept
 {
-	scale.x += xScale;
-	scale.y += yScale;
-	scale.z += zScale;
-	UpdateMatrix();
+	GetTransformStore().AdjustScale( transform, { xScale, yScale, zScale } );
 }
 
 void GameObject::ResetScale() noexcept
 {
-	scale = initialScale;
-	UpdateMatrix();
+	GetTransformStore().ResetScale( transform );
+}
+
+/// TRANSFORMS
+// one batched pass over every transform changed since the last, then each owner refreshes what it derives from it
+void GameObject::UpdateTransforms()
+{
+	static std::vector<TransformStore::Handle> updated;
+	updated.clear();
+	GetTransformStore().UpdateWorldMatrices( &updated );
+	std::vector<GameObject*>& owners = GetOwners();
+	for ( TransformStore::Handle handle : updated )
+		if ( handle < owners.size() && owners[handle] != nullptr )
+			owners[handle]->UpdateMatrix();
+}
+
+const TransformStatistics& GameObject::GetTransformStatistics() noexcept
+{
+	return GetTransformStore().GetStatistics();
+}
+
+void GameObject::ResetTransformStatistics() noexcept
+{
+	GetTransformStore().ResetStatistics();
+}
+
+// constructed on first use, so objects with static storage can't get ahead of it
+TransformStore& GameObject::GetTransformStore() noexcept
+{
+	static TransformStore store;
+	return store;
+}
+
+std::vector<GameObject*>& GameObject::GetOwners() noexcept
+{
+	static std::vector<GameObject*> owners;
+	return owners;
+}
+
+GameObject* GameObject::GetOwner( TransformStore::Handle handle ) noexcept
+{
+	if ( handle == TransformStore::INVALID || handle >= GetOwners().size() )
+		return nullptr;
+	return GetOwners()[handle];
+}
+
+// derived state is refreshed through a const getter, only state the transform determines is touched
+// stale ancestors are resolved along the way, their owners refresh too
+void GameObject::ResolveTransform() const
+{
+	ResolveTransform( transform );
+}
+
+void GameObject::ResolveTransform( TransformStore::Handle handle )
+{
+	if ( !GetTransformStore().IsDirty( handle ) )
+		return;
+	std::vector<TransformStore::Handle> resolved;
+	GetTransformStore().UpdateWorldMatrix( handle, &resolved );
+	std::vector<GameObject*>& owners = GetOwners();
+	for ( TransformStore::Handle link : resolved )
+		if ( link < owners.size() && owners[link] != nullptr )
+			owners[link]->UpdateMatrix();
+}
+
+// scale, rotation, translation then the parent's world matrix, current once the transform is resolved
+XMMATRIX GameObject::GetTransformMatrix() const noexcept
+{
+	return XMLoadFloat4x4( &GetTransformStore().GetWorldMatrix( transform ) );
 }
 
 void GameObject::UpdateMatrix()
@@ -3,15 +3,29 @@
 #define GAMEOBJECT_H
 
 #include "Model.h"
+#include "TransformStore.h"
 
+// a handle into the shared transform store, setters only mark the transform dirty
+// UpdateMatrix refreshes whatever a subclass derives from its transform, either for every dirty object
+// in UpdateTransforms once a frame or for one object when something reads its derived state first
+// objects are created, moved and destroyed on the main thread only
+// the store also holds transforms owned by the scene's entities, those have no object to refresh
 class GameObject
 {
 public:
-	const XMVECTOR& GetPositionVector() const noexcept;
-	const XMFLOAT3& GetPositionFloat3() const noexcept;
-	const XMVECTOR& GetRotationVector() const noexcept;
-	const XMFLOAT3& GetRotationFloat3() const noexcept;
-	const XMFLOAT3& GetScaleFloat3() const noexcept;
+	GameObject();
+	GameObject( const GameObject& other );
+	GameObject& operator=( const GameObject& other );
+	GameObject( GameObject&& other ) noexcept;
+	GameObject& operator=( GameObject&& other ) noexcept;
+	virtual ~GameObject();
+
+	XMVECTOR GetPositionVector() const noexcept;
+	XMFLOAT3 GetPositionFloat3() const noexcept;
+	XMVECTOR GetRotationVector() const noexcept;
+	XMFLOAT3 GetRotationFloat3() const noexcept;
+	XMFLOAT3 GetScaleFloat3() const noexcept;
+	TransformStore::Handle GetTransformHandle() const noexcept;
 	
 	const std::string& GetModelName() const noexcept;
 	void SetModelName( const std::string& name ) noexcept;
@@ -40,13 +54,23 @@ public:
 	void SetScale( float xScale, float yScale, float zScale = 1.0f ) noexcept;
 	void AdjustScale( float xScale, float yScale, float zScale = 1.0f ) noexcept;
 	void ResetScale() noexcept;
+
+	static void UpdateTransforms();
+	static const TransformStatistics& GetTransformStatistics() noexcept;
+	static void ResetTransformStatistics() noexcept;
+	static TransformStore& GetTransformStore() noexcept;
+	// for transforms no object owns, any objects along the way still refresh
+	static void ResolveTransform( TransformStore::Handle handle );
 protected:
 	virtual void UpdateMatrix();
+	void ResolveTransform() const;
+	XMMATRIX GetTransformMatrix() const noexcept;
 	std::string modelName;
-	XMFLOAT3 initialPos, initialRot, initialScale;
-	XMVECTOR posVector, rotVector;
-	XMFLOAT3 position, rotation;
-	XMFLOAT3 scale;
+	TransformStore::Handle transform;
+	static GameObject* GetOwner( TransformStore::Handle handle ) noexcept;
+private:
+	static std::vector<GameObject*>& GetOwners() noexcept;
+	void ReleaseTransform() noexcept;
 };
 
 #endif
\ No newline at end of file
@@ -1,7 +1,9 @@
 #include "GameObject3D.h"
+#include <algorithm>
 
 void GameObject3D::SetLookAtPos( XMFLOAT3 lookAtPos ) noexcept
 {
+	const XMFLOAT3 position = GetPositionFloat3();
 	if ( lookAtPos.x == position.x &&
 		 lookAtPos.y == position.y &&
 		 lookAtPos.z == position.z ) return;
@@ -31,23 +33,103 @@ void GameObject3D::SetLookAtPos( float xPos, float yPos, float zPos ) noexcept
 	SetLookAtPos( { xPos, yPos, zPos } );
 }
 
+// keeping the world transform rewrites the local values so the object doesn't move, otherwise they carry over as they are
+// fails without changing anything if the parent is this object or one of its children
+bool GameObject3D::SetParent( GameObject3D* parent, bool keepWorldTransform ) noexcept
+{
+	return AttachTransform( transform, parent != nullptr ? parent->transform : TransformStore::INVALID, keepWorldTransform );
+}
+
+bool GameObject3D::SetParent( TransformStore::Handle parent, bool keepWorldTransform ) noexcept
+{
+	return AttachTransform( transform, parent, keepWorldTransform );
+}
+
+bool GameObject3D::AttachTransform( TransformStore::Handle handle, TransformStore::Handle parent, bool keepWorldTransform ) noexcept
+{
+	TransformStore& store = GetTransformStore();
+	XMMATRIX local = XMMatrixIdentity();
+	if ( keepWorldTransform )
+	{
+		ResolveTransform( handle );
+		local = XMLoadFloat4x4( &store.GetWorldMatrix( handle ) );
+		if ( parent != TransformStore::INVALID )
+		{
+			ResolveTransform( parent );
+			local *= XMMatrixInverse( nullptr, XMLoadFloat4x4( &store.GetWorldMatrix( parent ) ) );
+		}
+	}
+	if ( !store.SetParent( handle, parent ) )
+		return false;
+	if ( !keepWorldTransform )
+		return true;
+
+	// rotation back to the pitch, yaw and roll XMMatrixRotationRollPitchYaw takes
+	XMVECTOR scaleVector, rotationQuaternion, positionVector;
+	XMMatrixDecompose( &scaleVector, &rotationQuaternion, &positionVector, local );
+	XMFLOAT4X4 rotationMatrix;
+	XMStoreFloat4x4( &rotationMatrix, XMMatrixRotationQuaternion( rotationQuaternion ) );
+	const float pitch = asin( std::max( -1.0f, std::min( 1.0f, -rotationMatrix._32 ) ) );
+	const float yaw = atan2( rotationMatrix._31, rotationMatrix._33 );
+	const float roll = atan2( rotationMatrix._12, rotationMatrix._22 );
+
+	XMFLOAT3 position, scale;
+	XMStoreFloat3( &position, positionVector );
+	XMStoreFloat3( &scale, scaleVector );
+	store.SetPosition( handle, position );
+	store.SetRotation( handle, XMFLOAT3( pitch, yaw, roll ) );
+	store.SetScale( handle, scale );
+	return true;
+}
+
+GameObject3D* GameObject3D::GetParent() const noexcept
+{
+	return static_cast<GameObject3D*>( GetOwner( GetTransformStore().GetParent( transform ) ) );
+}
+
+// also true for a parent no object owns, which GetParent can't return
+bool GameObject3D::HasParent() const noexcept
+{
+	return GetTransformStore().GetParent( transform ) != TransformStore::INVALID;
+}
+
+// a root's world position is its position, only children need their transform resolved
+XMVECTOR GameObject3D::GetWorldPositionVector() const noexcept
+{
+	const XMFLOAT3 position = GetWorldPositionFloat3();
+	return XMLoadFloat3( &position );
+}
+
+XMFLOAT3 GameObject3D::GetWorldPositionFloat3() const noexcept
+{
+	if ( GetTransformStore().GetParent( transform ) == TransformStore::INVALID )
+		return GetPositionFloat3();
+	ResolveTransform();
+	const XMFLOAT4X4& world = GetTransformStore().GetWorldMatrix( transform );
+	return XMFLOAT3( world._41, world._42, world._43 );
+}
+
 const XMVECTOR& GameObject3D::GetForwardVector( bool omitY ) noexcept
 {
+	ResolveTransform();
 	return omitY ? vec_forward_noY : vec_forward;
 }
 
 const XMVECTOR& GameObject3D::GetBackwardVector( bool omitY ) noexcept
 {
+	ResolveTransform();
 	return omitY ? vec_backward_noY : vec_backward;
 }
 
 const XMVECTOR& GameObject3D::GetLeftVector( bool omitY ) noexcept
 {
+	ResolveTransform();
 	return omitY ? vec_left_noY : vec_left;
 }
 
 const XMVECTOR& GameObject3D::GetRightVector( bool omitY ) noexcept
 {
+	ResolveTransform();
 	return omitY ? vec_right_noY : vec_right;
 }
 
@@ -61,17 +143,17 @@ void GameObject3D::UpdateMatrix()
 	assert( "UpdateMatrix must be overridden!" && 0 );
 }
 
+// the store works them out, a child's from the world matrix its owner has just been refreshed with
 void GameObject3D::UpdateDirectionVectors()
 {
-	XMMATRIX vecRotationMatrix = XMMatrixRotationRollPitchYaw( rotation.x, rotation.y, 0.0f );
-	vec_forward = XMVector3TransformCoord( DEFAULT_FORWARD_VECTOR, vecRotationMatrix );
-	vec_backward = XMVector3TransformCoord( DEFAULT_BACKWARD_VECTOR, vecRotationMatrix );
-	vec_left = XMVector3TransformCoord( DEFAULT_LEFT_VECTOR, vecRotationMatrix );
-	vec_right = XMVector3TransformCoord( DEFAULT_RIGHT_VECTOR, vecRotationMatrix );
-
-	XMMATRIX vecRotationMatrix_noY = XMMatrixRotationRollPitchYaw( 0.0f, rotation.y, 0.0f );
-	vec_forward_noY = XMVector3TransformCoord( DEFAULT_FORWARD_VECTOR, vecRotationMatrix_noY );
-	vec_backward_noY = XMVector3TransformCoord( DEFAULT_BACKWARD_VECTOR, vecRotationMatrix_noY );
-	vec_left_noY = XMVector3TransformCoord( DEFAULT_LEFT_VECTOR, vecRotationMatrix_noY );
-	vec_right_noY = XMVector3TransformCoord( DEFAULT_RIGHT_VECTOR, vecRotationMatrix_noY );
+	const TransformDirections directions = GetTransformStore().GetDirections( transform );
+	vec_forward = directions.forward;
+	vec_backward = -vec_forward;
+	vec_right = directions.right;
+	vec_left = -vec_right;
+
+	vec_forward_noY = directions.forwardNoY;
+	vec_backward_noY = -vec_forward_noY;
+	vec_right_noY = directions.rightNoY;
+	vec_left_noY = -vec_right_noY;
 }
\ No newline at end of file
@@ -4,9 +4,18 @@
 
 #include "GameObject.h"
 
+// any 3d object can be parented to another, its position, rotation and scale are then relative to the parent
+// the getters and setters inherited from GameObject stay local, world placement comes from the transform
+// a parent may be any transform in the store, including one an entity owns
 class GameObject3D : public GameObject
 {
 public:
+	bool SetParent( GameObject3D* parent, bool keepWorldTransform = false ) noexcept;
+	bool SetParent( TransformStore::Handle parent, bool keepWorldTransform = false ) noexcept;
+	GameObject3D* GetParent() const noexcept;
+	bool HasParent() const noexcept;
+	XMVECTOR GetWorldPositionVector() const noexcept;
+	XMFLOAT3 GetWorldPositionFloat3() const noexcept;
 	void SetLookAtPos( XMFLOAT3 lookAtPos ) noexcept;
 	void SetLookAtPos( float xPos, float yPos, float zPos ) noexcept;
 	const XMVECTOR& GetForwardVector( bool omitY = false ) noexcept;
@@ -14,6 +23,7 @@ public:
 	const XMVECTOR& GetLeftVector( bool omitY = false ) noexcept;
 	const XMVECTOR& GetRightVector( bool omitY = false ) noexcept;
 	const XMVECTOR& GetUpVector() noexcept;
+	static bool AttachTransform( TransformStore::Handle handle, TransformStore::Handle parent, bool keepWorldTransform ) noexcept;
 protected:
 	virtual void UpdateMatrix();
 	void UpdateDirectionVectors();
@@ -0,0 +1,61 @@
+#include "GpuTimer.h"
+
+HRESULT GpuTimer::Initialize( ID3D11Device* device, ID3D11DeviceContext* context )
+{
+	this->context = context;
+	for ( UINT i = 0; i < LATENCY; i++ )
+	{
+		D3D11_QUERY_DESC queryDesc = { D3D11_QUERY_TIMESTAMP_DISJOINT, 0 };
+		HRESULT hr = device->CreateQuery( &queryDesc, frames[i].disjoint.ReleaseAndGetAddressOf() );
+		if ( FAILED( hr ) )
+			return hr;
+		queryDesc.Query = D3D11_QUERY_TIMESTAMP;
+		hr = device->CreateQuery( &queryDesc, frames[i].begin.ReleaseAndGetAddressOf() );
+		if ( FAILED( hr ) )
+			return hr;
+		hr = device->CreateQuery( &queryDesc, frames[i].end.ReleaseAndGetAddressOf() );
+		if ( FAILED( hr ) )
+			return hr;
+		frames[i].pending = false;
+	}
+	current = 0;
+	return S_OK;
+}
+
+void GpuTimer::Begin() noexcept
+{
+	Frame& frame = frames[current];
+	context->Begin( frame.disjoint.Get() );
+	context->End( frame.begin.Get() );
+}
+
+void GpuTimer::End() noexcept
+{
+	Frame& frame = frames[current];
+	context->End( frame.end.Get() );
+	context->End( frame.disjoint.Get() );
+	frame.pending = true;
+	current = ( current + 1 ) % LATENCY;
+}
+
+// the oldest frame in flight, the one the next Begin would overwrite
+bool GpuTimer::GetTime( float& milliseconds ) noexcept
+{
+	Frame& frame = frames[current];
+	if ( !frame.pending )
+		return false;
+
+	D3D11_QUERY_DATA_TIMESTAMP_DISJOINT disjoint;
+	if ( context->GetData( frame.disjoint.Get(), &disjoint, sizeof( disjoint ), D3D11_ASYNC_GETDATA_DONOTFLUSH ) != S_OK )
+		return false;
+	frame.pending = false;
+	if ( disjoint.Disjoint )
+		return false;
+
+	UINT64 begin = 0, end = 0;
+	if ( context->GetData( frame.begin.Get(), &begin, sizeof( begin ), D3D11_ASYNC_GETDATA_DONOTFLUSH ) != S_OK ||
+		context->GetData( frame.end.Get(), &end, sizeof( end ), D3D11_ASYNC_GETDATA_DONOTFLUSH ) != S_OK )
+		return false;
+	milliseconds = static_cast<float>( static_cast<double>( end - begin ) * 1000.0 / disjoint.Frequency );
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,31 @@
+#pragma once
+#ifndef GPUTIMER_H
+#define GPUTIMER_H
+
+#include <d3d11.h>
+#include <wrl/client.h>
+
+// gpu time between Begin and End, read back frames later so the cpu never waits on the gpu
+// a frame whose queries haven't finished by the time its slot comes round again is dropped
+class GpuTimer
+{
+public:
+	static constexpr UINT LATENCY = 3u;
+	HRESULT Initialize( ID3D11Device* device, ID3D11DeviceContext* context );
+	void Begin() noexcept;
+	void End() noexcept;
+	bool GetTime( float& milliseconds ) noexcept;
+private:
+	struct Frame
+	{
+		Microsoft::WRL::ComPtr<ID3D11Query> disjoint;
+		Microsoft::WRL::ComPtr<ID3D11Query> begin;
+		Microsoft::WRL::ComPtr<ID3D11Query> end;
+		bool pending = false;
+	};
+	Frame frames[LATENCY];
+	UINT current = 0;
+	ID3D11DeviceContext* context = nullptr;
+};
+
+#endif
\ No newline at end of file
@@ -15,7 +15,9 @@
 #include "../utility/Structs.h"
 #include "../utility/Collisions.h"
 #include "../utility/Billboarding.h"
+#include <cmath>
 #include <fstream>
+#include <algorithm>
 
 bool Graphics::Initialize( HWND hWnd, int width, int height )
 {
@@ -36,68 +38,184 @@ bool Graphics::Initialize( HWND hWnd, int width, int height )
 	return true;
 }
 
-void Graphics::BeginFrame()
+// the frame is declared as a graph of passes, compiling it culls passes nothing uses, orders the rest,
+// shares transient targets between passes and clears only targets that are partly drawn over
+void Graphics::RenderFrame()
 {
-	// clear render target
-    if ( ( viewportParams.useLeft && viewportParams.useSplit ) ||
-        ( viewportParams.useFull && !viewportParams.useSplit ) ||
-        ( sceneParams.multiView && !viewportParams.useSplit ) )
+    // anything moved since Update is resolved here, views recorded on other threads never resolve a transform
+    GameObject::UpdateTransforms();
+    SceneSystems::UpdateBounds( scene );
+
+    // timings arrive a few frames late, the controller allows for that
+    float gpuTime = 0.0f;
+    if ( gpuTimer.GetTime( gpuTime ) )
+        dynamicResolution.Update( gpuTime );
+    resolutionScale = dynamicResolution.GetScale();
+    SceneSystems::lodParams.viewportHeight = windowHeight * resolutionScale;
+
+    // the graph is only rebuilt and compiled when its shape changes, other frames just execute it
+    if ( viewportParams.useSplit )
+        cameraToUse = viewportParams.controlLeftSide ? "Main" : "Point";
+    const FrameGraphShape shape = {
+        viewportParams.useSplit,
+        gameState == GameState::EDIT,
+        windowWidth,
+        windowHeight,
+        static_cast<UINT>( std::floor( windowWidth * resolutionScale ) ),
+        static_cast<UINT>( std::floor( windowHeight * resolutionScale ) )
+    };
+    if ( !frameGraphCompiled || !( shape == frameGraphShape ) )
     {
-        renderTarget->BindAsTexture( *this, depthStencil.get(), sceneParams.clearColor );
-        depthStencil->ClearDepthStencil( *this );
+        frameGraphShape = shape;
+        frameGraphCompiled = BuildFrameGraph();
+        if ( !frameGraphCompiled )
+        {
+            ErrorLogger::Log( "Failed to compile frame graph! " + frameGraph.GetError() );
+            return;
+        }
     }
+    gpuTimer.Begin();
+    frameGraph.Execute( [this]( FrameGraph::Resource resource ) { ClearResource( resource ); } );
+    gpuTimer.End();
 
-	// set render state
-    sceneParams.rasterizerSolid ? rasterizerStates["Solid"]->Bind( *this ) : rasterizerStates["Wireframe"]->Bind( *this );
-	context->IASetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
-    stencilStates["Off"]->Bind( *this );
-    blendState->Bind( *this );
+    // unbind rtv and srv
+    backBuffer->BindAsNull( *this );
 
-    // setup viewports
-    if ( viewportParams.useFull )
-        viewports["Full"]->Bind( *this );
-    if ( viewportParams.useFull && viewportParams.useSplit )
-        cameraToUse = viewportParams.controlLeftSide ? "Main" : "Point";
-    if ( viewportParams.useLeft )
-    {
-        cameraToUse = "Main";
-        viewportParams.useLeft = false;
-        viewports["Left"]->Bind( *this );
-    }
-    if ( viewportParams.useRight )
+    // display frame
+	HRESULT hr = swapChain->GetSwapChain()->Present( 1, NULL );
+	if ( FAILED( hr ) )
+	{
+		hr == DXGI_ERROR_DEVICE_REMOVED ?
+            ErrorLogger::Log( device->GetDeviceRemovedReason(), "Swap Chain. Graphics device removed!" ) :
+            ErrorLogger::Log( hr, "Swap Chain failed to render frame!" );
+		exit( -1 );
+	}
+}
+
+// declares the passes for the current shape, their lambdas read the rest of the frame's state when they run
+bool Graphics::BuildFrameGraph()
+{
+    const FrameResourceDesc colorDesc = { frameGraphShape.width, frameGraphShape.height, FrameFormat::Color };
+    const FrameResourceDesc depthDesc = { frameGraphShape.width, frameGraphShape.height, FrameFormat::DepthStencil };
+    frameGraph.Reset();
+    const FrameGraph::Resource sceneColor = frameGraph.Create( "Scene Colour", colorDesc );
+    const FrameGraph::Resource sceneDepth = frameGraph.Create( "Scene Depth", depthDesc );
+    const FrameGraph::Resource backBufferColor = frameGraph.Import( "Back Buffer", colorDesc );
+
+    // both halves of split-screen are one pass so they can be recorded in parallel
+    const FrameGraph::Pass scenePass = frameGraphShape.useSplit ?
+        frameGraph.AddPass( "Split Scene", [this, sceneColor, sceneDepth]() { RenderSplitScene( sceneColor, sceneDepth ); } ) :
+        frameGraph.AddPass( "Scene", [this, sceneColor, sceneDepth]() { RenderScenePass( sceneColor, sceneDepth ); } );
+    frameGraph.Write( scenePass, sceneColor );
+    frameGraph.Write( scenePass, sceneDepth );
+
+    // the composite covers the whole back buffer, so it is never cleared
+    const FrameGraph::Pass compositePass = frameGraph.AddPass( "Composite", [this, sceneColor]() { RenderComposite( sceneColor ); } );
+    frameGraph.Read( compositePass, sceneColor );
+    frameGraph.Write( compositePass, backBufferColor, FrameGraph::WriteMode::Full );
+
+    const FrameGraph::Pass textPass = frameGraph.AddPass( "Text", [this]() { RenderText(); } );
+    frameGraph.Write( textPass, backBufferColor );
+
+    if ( frameGraphShape.showImGui )
     {
-        cameraToUse = "Point";
-        viewportParams.useRight = false;
-        viewports["Right"]->Bind( *this );
+        const FrameGraph::Pass imguiPass = frameGraph.AddPass( "ImGui", [this]() { RenderImGui(); } );
+        frameGraph.Write( imguiPass, backBufferColor );
     }
+    return frameGraph.Compile();
+}
 
-    // setup sampler
-    if ( samplerParams.useAnisotropic )
-        samplerStates["Anisotropic"]->Bind( *this );
-    else if ( samplerParams.useBilinear )
-        samplerStates["Bilinear"]->Bind( *this );
-    else if ( samplerParams.usePoint )
-        samplerStates["Point"]->Bind( *this );
+// binds the scene targets and the state every view starts from, clearing is left to the frame graph
+void Graphics::SetupView( FrameGraph::Resource color, FrameGraph::Resource depth, const std::string& viewport )
+{
+    GetRenderTarget( color ).BindAsTexture( *this, &GetDepthStencil( depth ) );
+
+	// set render state
+    sceneParams.rasterizerSolid ? rasterizerStates["Solid"]->Bind( *this ) : rasterizerStates["Wireframe"]->Bind( *this );
+	stateCache.SetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    stencilStates["Off"]->Bind( *this );
+    blendState->Bind( *this );
+    viewports[viewport]->Bind( *this, resolutionScale );
+    BindSampler();
 
     // setup constant buffers
     if ( !cb_vs_fog.ApplyChanges() ) return;
-	context->VSSetConstantBuffers( 1, 1, cb_vs_fog.GetAddressOf() );
-	context->PSSetConstantBuffers( 1, 1, cb_vs_fog.GetAddressOf() );
+	cb_vs_fog.BindVS( 1 );
+	cb_vs_fog.BindPS( 1 );
 
     cb_ps_light.data.useQuad = false;
     cb_ps_light.data.lightFlicker = lightParams.lightFlicker;
     cb_ps_light.data.flickerAmount = lightParams.flickerAmount;
-    light.UpdateConstantBuffer( cb_ps_light );
+    SceneSystems::ApplyLights( scene, cb_ps_light );
 	if ( !cb_ps_light.ApplyChanges() ) return;
-	context->PSSetConstantBuffers( 2, 1, cb_ps_light.GetAddressOf() );
+	cb_ps_light.BindPS( 2 );
 
     cb_ps_scene.data.alphaFactor = sceneParams.alphaFactor;
     cb_ps_scene.data.useTexture = sceneParams.useTexture;
     if ( !cb_ps_scene.ApplyChanges() ) return;
-	context->PSSetConstantBuffers( 3, 1, cb_ps_scene.GetAddressOf() );
+	cb_ps_scene.BindPS( 3 );
 }
 
-void Graphics::RenderFrame()
+void Graphics::BindSampler()
+{
+    if ( samplerParams.useAnisotropic )
+        samplerStates["Anisotropic"]->Bind( *this );
+    else if ( samplerParams.useBilinear )
+        samplerStates["Bilinear"]->Bind( *this );
+    else if ( samplerParams.usePoint )
+        samplerStates["Point"]->Bind( *this );
+}
+
+void Graphics::RenderScenePass( FrameGraph::Resource color, FrameGraph::Resource depth )
+{
+    SetupView( color, depth, "Full" );
+    RenderMask();
+    const Camera3D& camera = *cameras[cameraToUse];
+    const RenderView view = { 0, camera.GetViewMatrix(), camera.GetProjectionMatrix(), camera.GetFrustum(), &cb_vs_matrix, &cb_ps_light };
+    const bool lightVisible = RenderScene( renderQueue, sceneCulling, view );
+    RenderOverlays( view, camera, lightVisible );
+}
+
+// both halves of split-screen record into deferred contexts of their own, then execute left before right
+void Graphics::RenderSplitScene( FrameGraph::Resource color, FrameGraph::Resource depth )
+{
+    // per-view setup runs here in view order, it shares the frame's constant buffers and sprites
+    RenderView views[SPLIT_VIEW_COUNT];
+    for ( UINT i = 0; i < SPLIT_VIEW_COUNT; i++ )
+    {
+        splitBackend.BeginView( i );
+        SetupView( color, depth, i == 0 ? "Left" : "Right" );
+        RenderMask();
+        splitBackend.EndView( i );
+
+        SplitView& splitView = splitViews[i];
+        splitView.camera = cameras[i == 0 ? "Main" : "Point"].get();
+        splitView.cb_ps_light.data = cb_ps_light.data;
+        views[i] = { 1 + i, splitView.camera->GetViewMatrix(), splitView.camera->GetProjectionMatrix(),
+            splitView.camera->GetFrustum(), &splitView.cb_vs_matrix, &splitView.cb_ps_light };
+    }
+
+    // culling, queueing and the scene draws of each view are recorded in parallel
+    recorder.Record( splitBackend, SPLIT_VIEW_COUNT, [this, &views]( UINT i )
+    {
+        splitViews[i].lightVisible = RenderScene( splitViews[i].renderQueue, splitViews[i].culling, views[i] );
+        StateCache::FoldStatistics();
+        ConstantBufferRing::FoldStatistics();
+        CullingBatch::FoldStatistics();
+        RenderQueue::FoldStatistics();
+        SceneSystems::FoldLodStatistics();
+    } );
+
+    for ( UINT i = 0; i < SPLIT_VIEW_COUNT; i++ )
+    {
+        splitBackend.BeginView( i );
+        RenderOverlays( views[i], *splitViews[i].camera, splitViews[i].lightVisible );
+        splitBackend.EndView( i );
+    }
+    CommandRecorder::Execute( splitBackend, SPLIT_VIEW_COUNT );
+}
+
+void Graphics::RenderMask()
 {
     // setup sprite masking
     if ( sceneParams.useMask )
@@ -107,36 +225,47 @@ void Graphics::RenderFrame()
         sceneParams.circleMask ? circle.Draw( camera2D.GetWorldOrthoMatrix() ) : square.Draw( camera2D.GetWorldOrthoMatrix() );
         stencilStates["Write"]->Bind( *this );
     }
+}
 
-    // render models
-    Shaders::BindShaders( context.Get(), vertexShader_light, pixelShader_light );
-    for ( unsigned int i = 0; i < renderables.size(); i++ )
-        renderables[i].Draw( cameras[cameraToUse]->GetViewMatrix(), cameras[cameraToUse]->GetProjectionMatrix() );
-
-    // draw primitves
-    for ( unsigned int i = 0; i < cubes.size(); i++ )
-        cubes[i]->Draw( cb_vs_matrix, boxTexture.Get() );
-    ground.DrawInstanced( cb_vs_matrix, cb_ps_light, grassTexture.Get() );
+// only reads shared scene state, so views may be rendered from several threads at once
+bool Graphics::RenderScene( RenderQueue& queue, CullingBatch& culling, const RenderView& view )
+{
+    // frustum culling of the scene's entities
+    culling.Clear();
+    SceneSystems::Cull( scene, culling, view.frustum );
+
+    // primitives reuse the model matrices, which may all have been culled this view
+    view.cb_vs_matrix->data.viewMatrix = view.viewMatrix;
+    view.cb_vs_matrix->data.projectionMatrix = view.projectionMatrix;
+
+    // queue everything visible, drawn by pass then shader then material and front to back within them
+    queue.Clear();
+    const bool lightVisible = SceneSystems::Submit( scene, queue, culling, view );
+    queue.Sort();
+    queue.Execute( context.Get(), view );
+    return lightVisible;
+}
 
-    // point light with outlining
-    if ( lightParams.lightHover )
+void Graphics::RenderOverlays( const RenderView& view, const Camera3D& camera, bool lightVisible )
+{
+    // point light with outlining, the stencil sequence stays outside the queue
+    if ( lightParams.lightHover && lightVisible )
     {
         cb_ps_outline.data.outlineColor = outlineParams.outlineColor;
         if ( !cb_ps_outline.ApplyChanges() ) return;
-	    context->PSSetConstantBuffers( 1, 1, cb_ps_outline.GetAddressOf() );
+	    cb_ps_outline.BindPS( 1 );
 
+        Shaders::BindShaders( context.Get(), vertexShader_light, pixelShader_light );
         stencilStates["Write"]->Bind( *this );
-        light.Draw( cameras[cameraToUse]->GetViewMatrix(), cameras[cameraToUse]->GetProjectionMatrix() );
+        SceneSystems::Draw( scene, lightEntity, view );
 
         Shaders::BindShaders( context.Get(), vertexShader_color, pixelShader_color );
-        light.SetScale( outlineParams.outlineSize, outlineParams.outlineSize, outlineParams.outlineSize );
         stencilStates["Mask"]->Bind( *this );
-        light.Draw( cameras[cameraToUse]->GetViewMatrix(), cameras[cameraToUse]->GetProjectionMatrix() );
-    }
+        SceneSystems::Draw( scene, lightEntity, view, outlineParams.outlineSize );
 
-    Shaders::BindShaders( context.Get(), vertexShader_light, pixelShader_noLight );
-    light.SetScale( 1.0f, 1.0f, 1.0f );
-	light.Draw( cameras[cameraToUse]->GetViewMatrix(), cameras[cameraToUse]->GetProjectionMatrix() );
+        Shaders::BindShaders( context.Get(), vertexShader_light, pixelShader_noLight );
+        SceneSystems::Draw( scene, lightEntity, view );
+    }
 
     // menu systems
     if ( gameState == GameState::MENU || gameState == GameState::HELP )
@@ -146,7 +275,7 @@ void Graphics::RenderFrame()
         cb_ps_scene.data.alphaFactor = 0.9f;
         cb_ps_scene.data.useTexture = false;
         if ( !cb_ps_scene.ApplyChanges() ) return;
-	    context->PSSetConstantBuffers( 1, 1, cb_ps_scene.GetAddressOf() );
+	    cb_ps_scene.BindPS( 1 );
         menuBG.Draw( camera2D.GetWorldOrthoMatrix() );
 
         // render main menu
@@ -154,7 +283,7 @@ void Graphics::RenderFrame()
         {
             cb_ps_scene.data.useTexture = true;
             if ( !cb_ps_scene.ApplyChanges() ) return;
-	        context->PSSetConstantBuffers( 1, 1, cb_ps_scene.GetAddressOf() );
+	        cb_ps_scene.BindPS( 1 );
             menuLogo.Draw( camera2D.GetWorldOrthoMatrix() );
         }
 
@@ -163,7 +292,7 @@ void Graphics::RenderFrame()
         {
             cb_ps_scene.data.useTexture = true;
             if ( !cb_ps_scene.ApplyChanges() ) return;
-	        context->PSSetConstantBuffers( 1, 1, cb_ps_scene.GetAddressOf() );
+	        cb_ps_scene.BindPS( 1 );
             switch ( menuPage )
             {
                 case 0: menuCamera.Draw( camera2D.GetWorldOrthoMatrix() ); break;
@@ -177,26 +306,35 @@ void Graphics::RenderFrame()
     if ( cb_ps_light.data.usePointLight )
     {
         Shaders::BindShaders( context.Get(), vertexShader_light, pixelShader_light );
-        skybox->SetScale( 500.0f, 500.0f, 500.0f );
-        skybox->SetPosition( cameras[cameraToUse]->GetPositionFloat3() );
         stencilStates["Off"]->Bind( *this );
         rasterizerStates["Cubemap"]->Bind( *this );
-        skybox->Draw( cb_vs_matrix, starsTexture.Get() );
+        SceneSystems::DrawSkyboxes( scene, view, camera.GetWorldPositionFloat3() );
         sceneParams.rasterizerSolid ? rasterizerStates["Solid"]->Bind( *this ) : rasterizerStates["Wireframe"]->Bind( *this );
     }
 }
 
-void Graphics::EndFrame()
+void Graphics::RenderComposite( FrameGraph::Resource color )
 {
-    // set and clear back buffer
-    backBuffer->BindAsBuffer( *this, sceneParams.clearColor );
-
-    // render to fullscreen texture
+    // executed command lists leave the immediate context with default state
+    backBuffer->BindAsBuffer( *this );
+	stateCache.SetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY_TRIANGLELIST );
+    blendState->Bind( *this );
+    viewports["Full"]->Bind( *this );
+    BindSampler();
+
+    // render to fullscreen texture, sampling only the part the scene was rendered to
+    const float sceneWidth = std::floor( windowWidth * resolutionScale );
+    const float sceneHeight = std::floor( windowHeight * resolutionScale );
+    cb_vs_fullscreen.data.uvScale = { sceneWidth / windowWidth, sceneHeight / windowHeight };
+    cb_vs_fullscreen.data.uvMax = { ( sceneWidth - 0.5f ) / windowWidth, ( sceneHeight - 0.5f ) / windowHeight };
     fullscreen.SetupBuffers( vertexShader_full, pixelShader_full, cb_vs_fullscreen, sceneParams.multiView );
-    context->PSSetShaderResources( 0, 1, renderTarget->GetShaderResourceViewPtr() );
+    stateCache.SetPSShaderResource( 0, GetRenderTarget( color ).GetShaderResourceView() );
     Bind::Rasterizer::DrawSolid( *this, fullscreen.ib_full.IndexCount() ); // always draw as solid
+}
 
-    // render text
+void Graphics::RenderText()
+{
+    backBuffer->BindAsBuffer( *this );
     spriteBatch->Begin();
     static XMFLOAT2 fontPositionMode = { windowWidth - 350.0f, 0.0f };
     if ( gameState != GameState::MENU && gameState != GameState::HELP )
@@ -217,57 +355,139 @@ void Graphics::EndFrame()
         spriteFont->DrawString( spriteBatch.get(), L"Press 'F1' to switch to PLAY mode.", fontPositionMode,
             Colors::White, 0.0f, XMFLOAT2( 0.0f, 0.0f ), XMFLOAT2( 1.0f, 1.0f ) );
     spriteBatch->End();
+    stateCache.Invalidate();
+}
 
-    // display imgui
-    if ( gameState == GameState::EDIT )
+void Graphics::RenderImGui()
+{
+    backBuffer->BindAsBuffer( *this );
+    imgui.BeginRender();
+    imgui.RenderMainWindow( *this );
+    if ( spawnWindow.sceneWindow ) imgui.RenderSceneWindow( *this );
+    if ( spawnWindow.lightWindow ) imgui.RenderLightWindow( scene, cb_ps_light );
+    if ( spawnWindow.fogWindow ) imgui.RenderFogWindow( cb_vs_fog );
+    if ( spawnWindow.modelWindow ) imgui.RenderModelWindow( scene );
+    if ( spawnWindow.cameraWindow ) imgui.RenderCameraWindow( *this, *cameras[cameraToUse], cameraToUse );
+    if ( spawnWindow.stencilWindow ) imgui.RenderStencilWindow( *this );
+    imgui.EndRender();
+    stateCache.Invalidate();
+}
+
+void Graphics::ClearResource( FrameGraph::Resource resource )
+{
+    if ( frameGraph.IsImported( resource ) )
+        backBuffer->Clear( *this, sceneParams.clearColor );
+    else if ( frameGraph.GetDesc( resource ).format == FrameFormat::DepthStencil )
+        GetDepthStencil( resource ).ClearDepthStencil( *this );
+    else
+        GetRenderTarget( resource ).Clear( *this, sceneParams.clearColor );
+}
+
+// textures behind the graph's physical resources, kept across frames and only recreated when a description changes
+Graphics::TransientTarget& Graphics::GetTransientTarget( FrameGraph::Resource resource )
+{
+    const UINT physical = frameGraph.GetPhysical( resource );
+    const FrameResourceDesc& desc = frameGraph.GetDesc( resource );
+    if ( physical >= transientTargets.size() )
+        transientTargets.resize( physical + 1 );
+
+    TransientTarget& target = transientTargets[physical];
+    if ( !( target.desc == desc ) || ( !target.renderTarget && !target.depthStencil ) )
     {
-        imgui.BeginRender();
-        imgui.RenderMainWindow( *this );
-        if ( spawnWindow.sceneWindow ) imgui.RenderSceneWindow( *this );
-        if ( spawnWindow.lightWindow ) imgui.RenderLightWindow( light, cb_ps_light );
-        if ( spawnWindow.fogWindow ) imgui.RenderFogWindow( cb_vs_fog );
-        if ( spawnWindow.modelWindow ) imgui.RenderModelWindow( renderables );
-        if ( spawnWindow.cameraWindow ) imgui.RenderCameraWindow( *this, *cameras[cameraToUse], cameraToUse );
-        if ( spawnWindow.stencilWindow ) imgui.RenderStencilWindow( *this );
-        imgui.EndRender();
+        target.desc = desc;
+        target.renderTarget.reset();
+        target.depthStencil.reset();
+        if ( desc.format == FrameFormat::DepthStencil )
+            target.depthStencil = std::make_shared<Bind::DepthStencil>( *this, static_cast<float>( desc.width ), static_cast<float>( desc.height ) );
+        else
+            target.renderTarget = std::make_shared<Bind::RenderTarget>( *this, static_cast<float>( desc.width ), static_cast<float>( desc.height ) );
     }
+    return target;
+}
 
-    // unbind rtv and srv
-    renderTarget->BindAsNull( *this );
-    backBuffer->BindAsNull( *this );
+Bind::RenderTarget& Graphics::GetRenderTarget( FrameGraph::Resource resource )
+{
+    return *GetTransientTarget( resource ).renderTarget;
+}
 
-    // display frame
-	HRESULT hr = swapChain->GetSwapChain()->Present( 1, NULL );
-	if ( FAILED( hr ) )
-	{
-		hr == DXGI_ERROR_DEVICE_REMOVED ?
-            ErrorLogger::Log( device->GetDeviceRemovedReason(), "Swap Chain. Graphics device removed!" ) :
-            ErrorLogger::Log( hr, "Swap Chain failed to render frame!" );
-		exit( -1 );
-	}
+Bind::DepthStencil& Graphics::GetDepthStencil( FrameGraph::Resource resource )
+{
+    return *GetTransientTarget( resource ).depthStencil;
 }
 
 void Graphics::Update( float dt )
 {
+    // swap in models finished by the loader
+    ModelData::UpdateModelData( modelLoader, scene, modelEntities );
+    SceneSystems::ResetLodStatistics();
+    CullingBatch::ResetStatistics();
+    ConstantBufferRing::ResetStatistics();
+    StateCache::ResetStatistics();
+    RenderQueue::ResetStatistics();
+    GameObject::ResetTransformStatistics();
+    broadphase.ResetStatistics();
+    constantBufferRing.BeginFrame();
+    splitBackend.BeginFrame();
+
     // primitive transformations
-    for ( unsigned int i = 0; i < cubes.size(); i++ )
-        cubes[i]->AdjustRotation( 0.0f, 0.001f * dt, 0.0f );
-    ground.UpdateInstanced( 5, 6, 8, 60 );
+    SceneSystems::UpdateTransforms( scene, dt );
+    SceneSystems::UpdateTiles( scene );
 
-    // camera viewing
-    Camera3D::UpdateThirdPerson( cameras["Third"], renderables[0] );
-    Collisions::CheckCollision3D( cameras["Point"], renderables[0], 20.0f, 10.0f ) ?
-        sceneParams.cameraCollision = true : sceneParams.cameraCollision = false;
+    // camera viewing and nanosuit billboarding
+    if ( Transform* playerTransform = GetPlayerTransform() )
+    {
+        Collisions::CheckCollision3D( cameras["Point"], *playerTransform, 20.0f, 10.0f ) ?
+            sceneParams.cameraCollision = true : sceneParams.cameraCollision = false;
 
-    // nanosuit billboarding
-    float rotation = Billboarding::BillboardModel( cameras[cameraToUse], renderables[0] );
-    if ( sceneParams.useBillboarding && cameraToUse != "Third" )
-        renderables[0].SetRotation( 0.0f, rotation, 0.0f );
+        float rotation = Billboarding::BillboardModel( cameras[cameraToUse], *playerTransform );
+        if ( sceneParams.useBillboarding && cameraToUse != "Third" )
+            playerTransform->SetRotation( 0.0f, rotation, 0.0f );
+    }
 
     // point light equipping and flickering
-    light.UpdatePhysics();
-    light.UpdateFlicker( cb_ps_light );
-    Collisions::CheckCollision3D( cameras["Main"], light, 5.0f ) ? lightParams.isEquippable = true : lightParams.isEquippable = false;
+    SceneSystems::UpdateLights( scene, cb_ps_light, lightParams.lightHover );
+    if ( Transform* lightTransform = GetLightTransform() )
+        Collisions::CheckCollision3D( cameras["Main"]->GetWorldPositionFloat3(), lightTransform->GetWorldPositionFloat3(), 5.0f ) ?
+            lightParams.isEquippable = true : lightParams.isEquippable = false;
+    GameObject::UpdateTransforms();
+    SceneSystems::UpdateBounds( scene );
+    UpdateSceneBVH();
+
+    // sphere tests between the scene's objects, on broadphase candidates only
+    SceneSystems::UpdateColliders( scene, broadphase );
+    broadphase.FindCollisions( collisionCandidates, collisionResults, collisions );
+}
+
+// rebuilt when objects come or go, otherwise only the moved objects are refit
+void Graphics::UpdateSceneBVH()
+{
+    SceneSystems::GatherPickables( scene, sceneBounds, sceneEntities );
+    if ( sceneBVH.GetObjectCount() != sceneBounds.size() )
+    {
+        sceneBVH.Build( sceneBounds );
+        return;
+    }
+    for ( unsigned int i = 0; i < sceneBounds.size(); i++ )
+        sceneBVH.Update( i, sceneBounds[i] );
+    sceneBVH.Refit();
+}
+
+// the scene hierarchy narrows the ray to the objects whose bounds it enters, those are tested triangle by triangle
+TriangleHit Graphics::PickTriangle( const PickRay& ray ) const noexcept
+{
+    TriangleHit hit;
+    sceneBVH.Intersect( ray, [this, &ray, &hit]( UINT object, float boxDistance, float nearest )
+    {
+        PickRay objectRay = ray;
+        objectRay.maxDistance = nearest;
+        const TriangleHit objectHit = SceneSystems::Intersect( scene, sceneEntities[object], objectRay );
+        if ( !objectHit.IsHit() )
+            return FLT_MAX;
+        hit = objectHit;
+        hit.object = object;
+        return objectHit.distance;
+    } );
+    return hit;
 }
 
 bool Graphics::InitializeDirectX( HWND hWnd )
@@ -275,10 +495,10 @@ bool Graphics::InitializeDirectX( HWND hWnd )
     try
     {
         swapChain = std::make_shared<Bind::SwapChain>( *this, context.GetAddressOf(), device.GetAddressOf(), hWnd );
+        stateCache.Initialize( context.Get() );
+        stateCache.Attach();
         backBuffer = std::make_shared<Bind::RenderTarget>( *this, swapChain->GetSwapChain() );
-        renderTarget = std::make_shared<Bind::RenderTarget>( *this );
 
-        depthStencil = std::make_shared<Bind::DepthStencil>( *this );
         blendState = std::make_shared<Bind::Blender>( *this );
 
         viewports.emplace( "Full", std::make_shared<Bind::Viewport>( *this, Bind::Viewport::Side::Full ) );
@@ -297,6 +517,19 @@ bool Graphics::InitializeDirectX( HWND hWnd )
         samplerStates.emplace( "Bilinear", std::make_shared<Bind::Sampler>( *this, Bind::Sampler::Type::Bilinear ) );
         samplerStates.emplace( "Point", std::make_shared<Bind::Sampler>( *this, Bind::Sampler::Type::Point ) );
 
+        // per-draw constants are sub-allocated from one buffer where the driver can bind with offsets
+        HRESULT hr = constantBufferRing.Initialize( device.Get(), context.Get() );
+        COM_ERROR_IF_FAILED( hr, "Failed to create constant buffer ring!" );
+        ConstantBufferRing::SetActive( &constantBufferRing );
+
+        // split-screen views are recorded into deferred contexts, the calling thread records one of them itself
+        hr = splitBackend.Initialize( device.Get(), context.Get(), SPLIT_VIEW_COUNT );
+        COM_ERROR_IF_FAILED( hr, "Failed to create split-screen deferred contexts!" );
+        recorder.Start( std::min( SPLIT_VIEW_COUNT, CommandRecorder::GetDefaultThreadCount() ) );
+
+        hr = gpuTimer.Initialize( device.Get(), context.Get() );
+        COM_ERROR_IF_FAILED( hr, "Failed to create gpu timer queries!" );
+
         spriteBatch = std::make_unique<SpriteBatch>( context.Get() );
         spriteFont = std::make_unique<SpriteFont>( device.Get(), L"res\\fonts\\open_sans_ms_16.spritefont" );
     }
@@ -316,10 +549,24 @@ bool Graphics::InitializeShaders()
         /*   MODELS   */
         HRESULT hr = vertexShader_light.Initialize( device, L"res\\shaders\\Model.fx", IPL::layoutPosTexNrm, ARRAYSIZE( IPL::layoutPosTexNrm ) );
 		COM_ERROR_IF_FAILED( hr, "Failed to create light vertex shader!" );
+        hr = vertexShader_lightQuantized.Initialize( device, L"res\\shaders\\Model.fx", IPL::layoutPosTexNrmQuantized, ARRAYSIZE( IPL::layoutPosTexNrmQuantized ), "VS_Quantized" );
+		COM_ERROR_IF_FAILED( hr, "Failed to create quantized light vertex shader!" );
+        Model::SetVertexShaders( vertexShader_light, vertexShader_lightQuantized );
+        hr = vertexShader_lightInstanced.Initialize( device, L"res\\shaders\\Model.fx", IPL::layoutPosTexNrmInstanced, ARRAYSIZE( IPL::layoutPosTexNrmInstanced ), "VS_Instanced" );
+		COM_ERROR_IF_FAILED( hr, "Failed to create instanced light vertex shader!" );
 	    hr = pixelShader_light.Initialize( device, L"res\\shaders\\Model.fx" );
 		COM_ERROR_IF_FAILED( hr, "Failed to create light pixel shader!" );
 	    hr = pixelShader_noLight.Initialize( device, L"res\\shaders\\Model_NoLight.fx" );
 		COM_ERROR_IF_FAILED( hr, "Failed to create no light pixel shader!" );
+        RenderQueue* queues[1 + SPLIT_VIEW_COUNT] = { &renderQueue, &splitViews[0].renderQueue, &splitViews[1].renderQueue };
+        for ( RenderQueue* queue : queues )
+        {
+            queue->SetShaders( ShaderId::Lit, vertexShader_light, pixelShader_light );
+            queue->SetShaders( ShaderId::LitQuantized, vertexShader_lightQuantized, pixelShader_light );
+            queue->SetShaders( ShaderId::LitInstanced, vertexShader_lightInstanced, pixelShader_light );
+            queue->SetShaders( ShaderId::Unlit, vertexShader_light, pixelShader_noLight );
+            queue->SetShaders( ShaderId::UnlitQuantized, vertexShader_lightQuantized, pixelShader_noLight );
+        }
 
         hr = vertexShader_color.Initialize( device, L"res\\shaders\\Primitive.fx", IPL::layoutPosCol, ARRAYSIZE( IPL::layoutPosCol ) );
         COM_ERROR_IF_FAILED( hr, "Failed to create colour vertex shader!" );
@@ -356,12 +603,11 @@ bool Graphics::InitializeScene()
         /*   MODELS   */
         if ( !ModelData::LoadModelData( "res\\objects.json" ) )
             return false;
-        if ( !ModelData::InitializeModelData( context.Get(), device.Get(), cb_vs_matrix, renderables ) )
+        scene.Clear();
+        modelEntities.clear();
+        if ( !ModelData::InitializeModelData( context.Get(), device.Get(), cb_vs_matrix, scene, modelEntities, modelLoader ) )
             return false;
-
-        light.SetScale( 1.0f, 1.0f, 1.0f );
-		if ( !light.Initialize( device.Get(), context.Get(), cb_vs_matrix ) )
-			return false;
+        player = modelEntities.empty() ? Entity() : modelEntities[0];
 
         /*   SPRITES   */
         if ( !menuBG.Initialize( device.Get(), context.Get(), windowWidth, windowHeight, "res\\textures\\Transparency.png", cb_vs_matrix_2d ) )
@@ -395,6 +641,7 @@ bool Graphics::InitializeScene()
         /*   OBJECTS   */
         XMFLOAT2 aspectRatio = { static_cast<float>( windowWidth ), static_cast<float>( windowHeight ) };
         camera2D.SetProjectionValues( aspectRatio.x, aspectRatio.y, 0.0f, 1.0f );
+        SceneSystems::lodParams.viewportHeight = aspectRatio.y;
 
         cameras.emplace( "Main", std::make_shared<Camera3D>( 0.0f, 9.0f, -20.0f ) );
         cameras["Main"]->SetProjectionValues( 70.0f, aspectRatio.x / aspectRatio.y, 0.1f, 1000.0f );
@@ -402,41 +649,22 @@ bool Graphics::InitializeScene()
         cameras.emplace( "Point", std::make_shared<Camera3D>( 0.0f, 9.0f, -55.0f ) );
         cameras["Point"]->SetProjectionValues( 70.0f, aspectRatio.x / aspectRatio.y, 0.1f, 1000.0f );
 
-        cameras.emplace( "Third", std::make_shared<Camera3D>( renderables[0].GetPositionFloat3() ) );
+        // rides along behind the nanosuit's shoulder, looking the way it faces
+        cameras.emplace( "Third", std::make_shared<Camera3D>( -2.5f, 13.0f, 5.0f ) );
         cameras["Third"]->SetProjectionValues( 70.0f, aspectRatio.x / aspectRatio.y, 0.1f, 1000.0f );
+        cameras["Third"]->SetRotation( 0.0f, XM_PI, 0.0f );
+        if ( Transform* playerTransform = GetPlayerTransform() )
+            cameras["Third"]->SetParent( playerTransform->GetHandle() );
 
-        XMVECTOR lightPosition = cameras["Main"]->GetPositionVector() + cameras["Main"]->GetForwardVector();
-		light.SetPosition( XMVectorGetX( lightPosition ), 5.25f, XMVectorGetZ( lightPosition ) + 5.0f );
-		light.SetRotation( cameras["Main"]->GetRotationFloat3() );
-
-        /*   VERTEX/INDEX   */
-        for ( unsigned int i = 0; i < CUBE_AMOUNT; i++ )
-        {
-            std::unique_ptr<Cube> cube = std::make_unique<Cube>( context.Get(), device.Get() );
-            cube->SetInitialPosition( -5.0f + ( i * 5.0f ), 9.0f, 0.0f );
-            cubes.push_back( std::move( cube ) );
-        }
-
-        skybox = std::make_unique<Cube>( context.Get(), device.Get() );
-
-        if ( !fullscreen.Initialize( context.Get(), device.Get() ) )
+        /*   ENTITIES   */
+        if ( !InitializeEntities() )
             return false;
 
-        if ( !ground.InitializeInstanced( context.Get(), device.Get(), 400 ) )
+        if ( !fullscreen.Initialize( context.Get(), device.Get() ) )
             return false;
 
-        /*   TEXTURES   */
-        HRESULT hr = CreateWICTextureFromFile( device.Get(), L"res\\textures\\CrashBox.png", nullptr, boxTexture.GetAddressOf() );
-        COM_ERROR_IF_FAILED( hr, "Failed to create box texture from file!" );
-
-        hr = CreateWICTextureFromFile( device.Get(), L"res\\textures\\grass.jpg", nullptr, grassTexture.GetAddressOf() );
-        COM_ERROR_IF_FAILED( hr, "Failed to create grass texture from file!" );
-
-        hr = CreateWICTextureFromFile( device.Get(), L"res\\textures\\stars.jpg", nullptr, starsTexture.GetAddressOf() );
-        COM_ERROR_IF_FAILED( hr, "Failed to create stars texture from file!" );
-
         /*   CONSTANT BUFFERS   */
-        hr = cb_vs_fog.Initialize( device.Get(), context.Get() );
+        HRESULT hr = cb_vs_fog.Initialize( device.Get(), context.Get() );
 		COM_ERROR_IF_FAILED( hr, "Failed to initialize 'cb_vs_fog' Constant Buffer!" );
         cb_vs_fog.data.fogColor = { 0.2f, 0.2f, 0.2f };
         cb_vs_fog.data.fogStart = 10.0f;
@@ -455,6 +683,14 @@ bool Graphics::InitializeScene()
 		hr = cb_ps_light.Initialize( device.Get(), context.Get() );
 		COM_ERROR_IF_FAILED( hr, "Failed to initialize 'cb_ps_light' Constant Buffer!" );
 
+        for ( UINT i = 0; i < SPLIT_VIEW_COUNT; i++ )
+        {
+            hr = splitViews[i].cb_vs_matrix.Initialize( device.Get(), context.Get() );
+            COM_ERROR_IF_FAILED( hr, "Failed to initialize split view 'cb_vs_matrix' Constant Buffer!" );
+            hr = splitViews[i].cb_ps_light.Initialize( device.Get(), context.Get() );
+            COM_ERROR_IF_FAILED( hr, "Failed to initialize split view 'cb_ps_light' Constant Buffer!" );
+        }
+
         hr = cb_ps_scene.Initialize( device.Get(), context.Get() );
 		COM_ERROR_IF_FAILED( hr, "Failed to initialize 'cb_ps_scene' Constant Buffer!" );
 
@@ -467,4 +703,86 @@ bool Graphics::InitializeScene()
         return false;
     }
     return true;
+}
+
+// a unit cube textured from disk, as the crates and the skybox are drawn
+static MeshData GetCubeMeshData( const std::string& texturePath )
+{
+    MeshData meshData = ModelLoader::GetPlaceholderMeshData();
+    meshData.textures.clear();
+    MaterialTexture texture;
+    texture.type = aiTextureType_DIFFUSE;
+    texture.storageType = TextureStorageType::Disk;
+    texture.filePath = texturePath;
+    meshData.textures.push_back( texture );
+    return meshData;
+}
+
+// created after the models, cubes and then the light, so the pickable order keeps models first
+// every cube shares one model, each entity only brings its own transform, bounds and levels of detail
+bool Graphics::InitializeEntities()
+{
+    /*   CUBES   */
+    std::shared_ptr<Model> cubeModel = std::make_shared<Model>();
+    if ( !cubeModel->Initialize( { GetCubeMeshData( "res\\textures\\CrashBox.png" ) }, device.Get(), context.Get(), cb_vs_matrix ) )
+        return false;
+    for ( unsigned int i = 0; i < CUBE_AMOUNT; i++ )
+    {
+        const Entity entity = scene.Create();
+        scene.Add<Transform>( entity ).SetInitialPosition( XMFLOAT3( -5.0f + ( i * 5.0f ), 9.0f, 0.0f ) );
+        scene.Add<MeshRenderer>( entity ).model = cubeModel;
+        scene.Add<Bounds>( entity ).local = cubeModel->GetBoundingBox();
+        scene.Add<Lod>( entity );
+        scene.Add<Collider>( entity );
+        scene.Add<Spin>( entity ).rate = { 0.0f, 0.001f, 0.0f };
+    }
+
+    /*   LIGHT   */
+    std::shared_ptr<Model> lightModel = std::make_shared<Model>();
+    if ( !lightModel->Initialize( "res\\models\\light.fbx", device.Get(), context.Get(), cb_vs_matrix ) )
+        return false;
+    lightEntity = scene.Create();
+    Transform& lightTransform = scene.Add<Transform>( lightEntity );
+    XMVECTOR lightPosition = cameras["Main"]->GetPositionVector() + cameras["Main"]->GetForwardVector();
+    lightTransform.SetPosition( XMVectorGetX( lightPosition ), 5.25f, XMVectorGetZ( lightPosition ) + 5.0f );
+    lightTransform.SetRotation( cameras["Main"]->GetRotationFloat3() );
+    MeshRenderer& lightRenderer = scene.Add<MeshRenderer>( lightEntity );
+    lightRenderer.model = lightModel;
+    lightRenderer.pass = RenderPass::Unlit;
+    scene.Add<Bounds>( lightEntity ).local = lightModel->GetBoundingBox();
+    scene.Add<Lod>( lightEntity );
+    scene.Add<Collider>( lightEntity );
+    scene.Add<PointLight>( lightEntity );
+
+    /*   GROUND   */
+    std::shared_ptr<PlaneInstanced> groundPlane = std::make_shared<PlaneInstanced>();
+    if ( !groundPlane->InitializeInstanced( context.Get(), device.Get(), 400 ) )
+        return false;
+    try
+    {
+        Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> grassTexture;
+        HRESULT hr = CreateWICTextureFromFile( device.Get(), L"res\\textures\\grass.jpg", nullptr, grassTexture.GetAddressOf() );
+        COM_ERROR_IF_FAILED( hr, "Failed to create grass texture from file!" );
+        groundPlane->SetTexture( grassTexture.Get() );
+    }
+    catch ( COMException& exception )
+    {
+        ErrorLogger::Log( exception );
+        return false;
+    }
+    TileGrid& ground = scene.Add<TileGrid>( scene.Create() );
+    ground.plane = groundPlane;
+    ground.tileSize = 5;
+    ground.tileOffset = 6;
+    ground.worldOffsetX = 8;
+    ground.worldOffsetY = 60;
+
+    /*   SKYBOX   */
+    std::shared_ptr<Model> skyboxModel = std::make_shared<Model>();
+    if ( !skyboxModel->Initialize( { GetCubeMeshData( "res\\textures\\stars.jpg" ) }, device.Get(), context.Get(), cb_vs_matrix ) )
+        return false;
+    const Entity skybox = scene.Create();
+    scene.Add<MeshRenderer>( skybox ).model = skyboxModel;
+    scene.Add<Skybox>( skybox );
+    return true;
 }
\ No newline at end of file
@@ -3,13 +3,19 @@
 #define GRAPHICS_H
 
 #include <map>
-#include "Cube.h"
 #include "Plane.h"
 #include "Sprite.h"
 #include "Shaders.h"
 #include "Camera2D.h"
+#include "RenderQueue.h"
+#include "GpuTimer.h"
+#include "FrameGraph.h"
+#include "DynamicResolution.h"
+#include "BoundingVolumeHierarchy.h"
+#include "CommandRecorder.h"
+#include "ModelLoader.h"
+#include "SceneSystems.h"
 #include "ImGuiManager.h"
-#include "RenderableGameObject.h"
 #include <dxtk/SpriteFont.h>
 #include <dxtk/SpriteBatch.h>
 #include <dxtk/WICTextureLoader.h>
@@ -42,38 +48,60 @@ public:
 
 	virtual ~Graphics( void ) = default;
 	bool Initialize( HWND hWnd, int width, int height );
-	void BeginFrame();
 	void RenderFrame();
-	void EndFrame();
 	void Update( float dt );
 	UINT GetWidth() const noexcept { return windowWidth; }
 	UINT GetHeight() const noexcept { return windowHeight; }
+	const ModelLoader& GetModelLoader() const noexcept { return modelLoader; }
+	const FrameGraph& GetFrameGraph() const noexcept { return frameGraph; }
+	DynamicResolution& GetDynamicResolution() noexcept { return dynamicResolution; }
+	float GetResolutionScale() const noexcept { return resolutionScale; }
+	// pickable objects are the scene's renderable entities in query order
+	const BoundingVolumeHierarchy& GetSceneBVH() const noexcept { return sceneBVH; }
+	UINT GetLightObjectIndex() const noexcept { return scene.Get<Bounds>( lightEntity )->index; }
+	World& GetScene() noexcept { return scene; }
+	const World& GetScene() const noexcept { return scene; }
+	// the nanosuit the player steers and the point light, null until the scene is initialized
+	Transform* GetPlayerTransform() noexcept { return scene.Get<Transform>( player ); }
+	Transform* GetLightTransform() noexcept { return scene.Get<Transform>( lightEntity ); }
+	Broadphase& GetBroadphase() noexcept { return broadphase; }
+	UINT GetCollisionCount() const noexcept { return static_cast<UINT>( collisions.size() ); }
+	TriangleHit PickTriangle( const PickRay& ray ) const noexcept;
 
-	Light light;
 	int menuPage;
 	Sprite circle;
 	Sprite square;
 	bool flyCamera = true;
 	std::string cameraToUse = "Main";
-	std::vector<RenderableGameObject> renderables;
 	std::map<std::string, std::shared_ptr<Camera3D>> cameras;
 	std::map<std::string, std::shared_ptr<Bind::Viewport>> viewports;
 private:
 	bool InitializeDirectX( HWND hWnd );
 	bool InitializeShaders();
 	bool InitializeScene();
+	bool InitializeEntities();
+	void UpdateSceneBVH();
+
+	// frame graph passes
+	bool BuildFrameGraph();
+	void SetupView( FrameGraph::Resource color, FrameGraph::Resource depth, const std::string& viewport );
+	void BindSampler();
+	void RenderScenePass( FrameGraph::Resource color, FrameGraph::Resource depth );
+	void RenderSplitScene( FrameGraph::Resource color, FrameGraph::Resource depth );
+	void RenderComposite( FrameGraph::Resource color );
+	void RenderText();
+	void RenderImGui();
+	void ClearResource( FrameGraph::Resource resource );
+	void RenderMask();
+	bool RenderScene( RenderQueue& queue, CullingBatch& culling, const RenderView& view );
+	void RenderOverlays( const RenderView& view, const Camera3D& camera, bool lightVisible );
 
 	Microsoft::WRL::ComPtr<ID3D11Device> device;
 	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> boxTexture;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> grassTexture;
-	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> starsTexture;
 
 	std::shared_ptr<Bind::Blender> blendState;
 	std::shared_ptr<Bind::SwapChain> swapChain;
-	std::shared_ptr<Bind::DepthStencil> depthStencil;
 	std::shared_ptr<Bind::RenderTarget> backBuffer;
-	std::shared_ptr<Bind::RenderTarget> renderTarget;
 	std::map<std::string, std::shared_ptr<Bind::Sampler>> samplerStates;
 	std::map<std::string, std::shared_ptr<Bind::Stencil>> stencilStates;
 	std::map<std::string, std::shared_ptr<Bind::Rasterizer>> rasterizerStates;
@@ -82,6 +110,8 @@ private:
 	VertexShader vertexShader_full;
 	VertexShader vertexShader_color;
 	VertexShader vertexShader_light;
+	VertexShader vertexShader_lightQuantized;
+	VertexShader vertexShader_lightInstanced;
 	VertexShader vertexShader_skybox;
 	VertexShader vertexShader_noLight;
 
@@ -100,10 +130,14 @@ private:
 	ConstantBuffer<CB_PS_outline> cb_ps_outline;
 	ConstantBuffer<CB_VS_matrix_2D> cb_vs_matrix_2d;
 	ConstantBuffer<CB_VS_fullscreen> cb_vs_fullscreen;
+	ConstantBufferRing constantBufferRing;
+	StateCache stateCache;
+	RenderQueue renderQueue;
 
 	UINT windowWidth;
 	UINT windowHeight;
 	ImGuiManager imgui;
+	ModelLoader modelLoader;
 
 	Sprite menuBG;
 	Sprite menuLogo;
@@ -111,12 +145,78 @@ private:
 	Sprite menuScene;
 	Sprite menuCamera;
 	Camera2D camera2D;
-	PlaneInstanced ground;
 	PlaneFullscreen fullscreen;
-	std::unique_ptr<Cube> skybox;
 	std::unique_ptr<SpriteFont> spriteFont;
 	std::unique_ptr<SpriteBatch> spriteBatch;
-	std::vector<std::unique_ptr<Cube>> cubes;
+	CullingBatch sceneCulling;
+	BoundingVolumeHierarchy sceneBVH;
+	std::vector<BoundingBox> sceneBounds;
+	std::vector<Entity> sceneEntities;
+
+	// models, cubes, the light, ground and skybox are entities holding their own state, only the sprites are drawn on their own
+	// models come first, then cubes, then the light, so the pickable order matches the order they were created in
+	World scene;
+	Entity player;
+	Entity lightEntity;
+	std::vector<Entity> modelEntities;
+
+	// bounding spheres of the scene's entities, only the candidate pairs the broadphase finds are tested
+	Broadphase broadphase = Broadphase( BroadphaseMode::SpatialHash, 16.0f );
+	std::vector<Broadphase::Pair> collisionCandidates;
+	std::vector<uint8_t> collisionResults;
+	std::vector<Broadphase::Pair> collisions;
+
+	// each half of split-screen is recorded on its own thread, so it gets its own queue, culling and per-draw constants
+	struct SplitView
+	{
+		const Camera3D* camera = nullptr;
+		RenderQueue renderQueue;
+		CullingBatch culling;
+		ConstantBuffer<CB_VS_matrix> cb_vs_matrix;
+		ConstantBuffer<CB_PS_light> cb_ps_light;
+		bool lightVisible = false;
+	};
+	static constexpr UINT SPLIT_VIEW_COUNT = 2u;
+	SplitView splitViews[SPLIT_VIEW_COUNT];
+	CommandRecorder recorder;
+	DeferredRecordingBackend splitBackend;
+
+	// transient targets are created on demand for the physical resources the frame graph assigns
+	struct TransientTarget
+	{
+		FrameResourceDesc desc;
+		std::shared_ptr<Bind::RenderTarget> renderTarget;
+		std::shared_ptr<Bind::DepthStencil> depthStencil;
+	};
+	TransientTarget& GetTransientTarget( FrameGraph::Resource resource );
+	Bind::RenderTarget& GetRenderTarget( FrameGraph::Resource resource );
+	Bind::DepthStencil& GetDepthStencil( FrameGraph::Resource resource );
+	FrameGraph frameGraph;
+	std::vector<TransientTarget> transientTargets;
+
+	// everything the graph's passes and descriptions depend on, a change rebuilds and recompiles it
+	// the scene's scaled size is included, so a change of dynamic resolution recompiles it too
+	struct FrameGraphShape
+	{
+		bool useSplit = false;
+		bool showImGui = false;
+		UINT width = 0u;
+		UINT height = 0u;
+		UINT sceneWidth = 0u;
+		UINT sceneHeight = 0u;
+		bool operator==( const FrameGraphShape& other ) const noexcept
+		{
+			return useSplit == other.useSplit && showImGui == other.showImGui && width == other.width &&
+				height == other.height && sceneWidth == other.sceneWidth && sceneHeight == other.sceneHeight;
+		}
+	};
+	FrameGraphShape frameGraphShape;
+	bool frameGraphCompiled = false;
+
+	// the scene targets stay at window size, the scene renders into a scaled corner of them and the composite stretches it back out
+	GpuTimer gpuTimer;
+	DynamicResolution dynamicResolution;
+	float resolutionScale = 1.0f;
 };
 
 #endif
\ No newline at end of file
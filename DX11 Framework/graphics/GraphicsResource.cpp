@@ -1,11 +1,17 @@
 #include "GraphicsResource.h"
 
+// the context being recorded on this thread, which is a deferred one while a view is recorded
 ID3D11DeviceContext* GraphicsResource::GetContext( Graphics& gfx ) noexcept
 {
-	return gfx.context.Get();
+	return StateCache::Get( gfx.context.Get() ).GetContext();
 }
 
 ID3D11Device* GraphicsResource::GetDevice( Graphics& gfx ) noexcept
 {
 	return gfx.device.Get();
+}
+
+StateCache& GraphicsResource::GetStateCache( Graphics& gfx ) noexcept
+{
+	return StateCache::Get( gfx.context.Get() );
 }
\ No newline at end of file
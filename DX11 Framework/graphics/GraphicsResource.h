@@ -10,6 +10,7 @@ class GraphicsResource
 protected:
 	static ID3D11DeviceContext* GetContext( Graphics& gfx ) noexcept;
 	static ID3D11Device* GetDevice( Graphics& gfx ) noexcept;
+	static StateCache& GetStateCache( Graphics& gfx ) noexcept;
 	virtual void Bind( Graphics& gfx ) noexcept = 0;
 	virtual ~GraphicsResource() = default;
 };
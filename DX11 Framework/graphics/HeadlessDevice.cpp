@@ -0,0 +1,11 @@
+#include "HeadlessDevice.h"
+
+bool HeadlessDevice::Create( Microsoft::WRL::ComPtr<ID3D11Device>& device, Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context )
+{
+	HRESULT hr = D3D11CreateDevice( nullptr, D3D_DRIVER_TYPE_HARDWARE, nullptr, 0, nullptr, 0,
+		D3D11_SDK_VERSION, device.GetAddressOf(), nullptr, context.GetAddressOf() );
+	if ( FAILED( hr ) )
+		hr = D3D11CreateDevice( nullptr, D3D_DRIVER_TYPE_WARP, nullptr, 0, nullptr, 0,
+			D3D11_SDK_VERSION, device.GetAddressOf(), nullptr, context.GetAddressOf() );
+	return SUCCEEDED( hr );
+}
\ No newline at end of file
@@ -0,0 +1,16 @@
+#pragma once
+#ifndef HEADLESSDEVICE_H
+#define HEADLESSDEVICE_H
+
+#include <d3d11.h>
+#include <wrl/client.h>
+
+// a device and immediate context without a window or swap chain, for the tools and benchmarks
+// falls back to warp where there is no hardware device
+class HeadlessDevice
+{
+public:
+	static bool Create( Microsoft::WRL::ComPtr<ID3D11Device>& device, Microsoft::WRL::ComPtr<ID3D11DeviceContext>& context );
+};
+
+#endif
\ No newline at end of file
@@ -2,7 +2,8 @@
 #include "Viewport.h"
 #include "ModelData.h"
 #include "GraphicsResource.h"
-#include "RenderableGameObject.h"
+#include "SceneSystems.h"
+#include "Culling.h"
 #include "../utility/Structs.h"
 #include "imgui/imgui.h"
 #include "imgui/imgui_impl_dx11.h"
@@ -66,6 +67,50 @@ void ImGuiManager::RenderMainWindow( Graphics& gfx )
 			ImGui::Text( "OEM ID: %u", siSysInfo.dwOemId );
 			ImGui::NewLine();
 			ImGui::Text( "Frametime: %.3f / Framerate: (%.1f FPS)", 1000.0f / ImGui::GetIO().Framerate, ImGui::GetIO().Framerate );
+			ImGui::Text( "Models Loaded: %u / %u (%u threads)", gfx.GetModelLoader().GetLoadedCount(),
+				gfx.GetModelLoader().GetTotalCount(), gfx.GetModelLoader().GetThreadCount() );
+			TextureCacheStats textureStats = TextureCache::GetStats();
+			ImGui::Text( "Textures: %u unique, %u references", textureStats.textureCount, textureStats.referenceCount );
+			ImGui::Text( "Texture Cache: %u hits / %u misses, %.2f MB resident, %.2f MB saved", textureStats.hits, textureStats.misses,
+				textureStats.residentBytes / ( 1024.0f * 1024.0f ), textureStats.savedBytes / ( 1024.0f * 1024.0f ) );
+			const CullingStatistics cullingStats = CullingBatch::GetStatistics();
+			ImGui::Text( "Frustum Culling: %u visible / %u culled", cullingStats.visibleCount, cullingStats.culledCount );
+			const LodStatistics lodStats = SceneSystems::GetLodStatistics();
+			ImGui::Text( "LOD Triangles: %u / %u (%.1f%%)", lodStats.drawnTriangleCount, lodStats.fullTriangleCount,
+				lodStats.fullTriangleCount > 0 ? 100.0f * lodStats.drawnTriangleCount / lodStats.fullTriangleCount : 100.0f );
+			ImGui::Text( "LOD Objects: %u / %u / %u / %u / %u", lodStats.lodObjectCounts[0], lodStats.lodObjectCounts[1],
+				lodStats.lodObjectCounts[2], lodStats.lodObjectCounts[3], lodStats.lodObjectCounts[4] );
+			const ConstantUploadStatistics uploadStats = ConstantBufferRing::GetStatistics();
+			ImGui::Text( "Constant Uploads: %.1f KB, %u maps (%u ring, %u overflowed)", uploadStats.bytesUploaded / 1024.0f,
+				uploadStats.mapCount, uploadStats.ringAllocationCount, uploadStats.ringOverflowCount );
+			ImGui::Text( "Constant Uploads Skipped: %u unchanged, %.1f KB saved", uploadStats.skippedCount, uploadStats.bytesSkipped / 1024.0f );
+			const StateCacheStatistics stateStats = StateCache::GetStatistics();
+			ImGui::Text( "State Binds: %u issued / %u filtered, %u draws", stateStats.issuedCount, stateStats.filteredCount, stateStats.drawCount );
+			const RenderQueueStatistics queueStats = RenderQueue::GetStatistics();
+			ImGui::Text( "Render Queue: %u packets, %u shader / %u material changes", queueStats.packetCount,
+				queueStats.shaderChangeCount, queueStats.materialChangeCount );
+			const FrameGraphStatistics& graphStats = gfx.GetFrameGraph().GetStatistics();
+			ImGui::Text( "Frame Graph: %u passes (%u culled), %u clears, %.2f MB transient, %.2f MB saved by aliasing",
+				graphStats.passCount, graphStats.culledPassCount, graphStats.clearCount,
+				graphStats.transientBytes / ( 1024.0f * 1024.0f ), graphStats.savedBytes / ( 1024.0f * 1024.0f ) );
+			const DynamicResolutionStatistics& resolutionStats = gfx.GetDynamicResolution().GetStatistics();
+			ImGui::Text( "Resolution Scale: %.2f (%u x %u), GPU %.2f ms / %.2f ms budget, %u changes", gfx.GetResolutionScale(),
+				static_cast<UINT>( gfx.GetWidth() * gfx.GetResolutionScale() ), static_cast<UINT>( gfx.GetHeight() * gfx.GetResolutionScale() ),
+				resolutionStats.lastFrameTime, gfx.GetDynamicResolution().GetSettings().frameBudget, resolutionStats.changeCount );
+			const TransformStatistics& transformStats = GameObject::GetTransformStatistics();
+			ImGui::Text( "Transforms: %u, %u rebuilt in batch, %u resolved early", transformStats.transformCount,
+				transformStats.batchedCount, transformStats.resolvedCount );
+			ImGui::Text( "Hierarchy: %u attached, depth %u, %u propagated", transformStats.attachedCount,
+				transformStats.depth, transformStats.propagatedCount );
+			ImGui::Text( "Entities: %u in %u archetypes", gfx.GetScene().GetEntityCount(), gfx.GetScene().GetArchetypeCount() );
+			const BroadphaseStatistics& broadphaseStats = gfx.GetBroadphase().GetStatistics();
+			ImGui::Text( "Broadphase: %u spheres in %u cells, %u rebucketed, %u candidates, %u colliding", broadphaseStats.proxyCount,
+				broadphaseStats.cellCount, broadphaseStats.rebucketedCount, broadphaseStats.candidateCount, gfx.GetCollisionCount() );
+			ImGui::Text( "Intersection: %s kernels, %s supported", Intersection::GetPathName( Intersection::GetPath() ),
+				Intersection::GetPathName( Intersection::GetSupportedPath() ) );
+			const BVHStatistics& bvhStats = gfx.GetSceneBVH().GetStatistics();
+			ImGui::Text( "Scene BVH: %u objects, %u nodes, depth %u, %u builds, %u nodes refit", gfx.GetSceneBVH().GetObjectCount(),
+				bvhStats.nodeCount, bvhStats.depth, bvhStats.buildCount, bvhStats.refitNodeCount );
             ImGui::PopStyleColor();
 		    ImGui::TreePop();
         }
@@ -101,6 +146,34 @@ void ImGuiManager::RenderSceneWindow( Graphics& gfx )
 
         ImGui::Checkbox( "Enable Textures", &sceneParams.useTexture );
         ImGui::Checkbox( "Nanosuit Billboarding", &sceneParams.useBillboarding );
+        ImGui::Checkbox( "Triangle Picking", &sceneParams.precisePicking );
+
+        ImGui::Checkbox( "Use LODs", &SceneSystems::lodParams.useLods );
+        ImGui::SliderFloat( "LOD Pixel Error", &SceneSystems::lodParams.pixelError, 0.25f, 16.0f );
+        ImGui::SliderFloat( "LOD Hysteresis", &SceneSystems::lodParams.hysteresis, 0.0f, 0.9f );
+
+        DynamicResolutionSettings& resolutionSettings = gfx.GetDynamicResolution().GetSettings();
+        ImGui::Checkbox( "Dynamic Resolution", &resolutionSettings.enabled );
+        ImGui::SliderFloat( "GPU Budget (ms)", &resolutionSettings.frameBudget, 2.0f, 33.0f );
+        ImGui::SliderFloat( "Minimum Scale", &resolutionSettings.minScale, 0.25f, 1.0f );
+
+        Broadphase& broadphase = gfx.GetBroadphase();
+        int broadphaseMode = static_cast<int>( broadphase.GetMode() );
+        float cellSize = broadphase.GetCellSize();
+        ImGui::RadioButton( "Spatial Hash", &broadphaseMode, static_cast<int>( BroadphaseMode::SpatialHash ) );
+        ImGui::SameLine();
+        ImGui::RadioButton( "Loose Octree", &broadphaseMode, static_cast<int>( BroadphaseMode::LooseOctree ) );
+        ImGui::SliderFloat( "Broadphase Cell Size", &cellSize, 1.0f, 64.0f );
+        broadphase.SetMode( static_cast<BroadphaseMode>( broadphaseMode ), cellSize );
+
+        // paths the cpu lacks fall back to the widest it has
+        int intersectionPath = static_cast<int>( Intersection::GetPath() );
+        ImGui::RadioButton( "Scalar", &intersectionPath, static_cast<int>( IntersectionPath::Scalar ) );
+        ImGui::SameLine();
+        ImGui::RadioButton( "SSE", &intersectionPath, static_cast<int>( IntersectionPath::SSE ) );
+        ImGui::SameLine();
+        ImGui::RadioButton( "AVX2", &intersectionPath, static_cast<int>( IntersectionPath::AVX2 ) );
+        Intersection::SetPath( static_cast<IntersectionPath>( intersectionPath ) );
 
         static int activeSampler = 0;
         static bool selectedSampler[3];
@@ -176,7 +249,7 @@ void ImGuiManager::RenderSceneWindow( Graphics& gfx )
     } ImGui::End();
 }
 
-void ImGuiManager::RenderLightWindow( Light& light, ConstantBuffer<CB_PS_light>& cb_ps_light )
+void ImGuiManager::RenderLightWindow( World& scene, ConstantBuffer<CB_PS_light>& cb_ps_light )
 {
 	if ( ImGui::Begin( "Light Controls", FALSE, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove ) )
 	{
@@ -256,8 +329,11 @@ void ImGuiManager::RenderLightWindow( Light& light, ConstantBuffer<CB_PS_light>&
                 ImGui::TreePop();
             }
         }
-        light.SetConstantBuffer( cb_ps_light );
-        light.UpdateConstantBuffer( cb_ps_light );
+        scene.Each<PointLight>( [&cb_ps_light]( Entity, PointLight& pointLight )
+        {
+            pointLight.ReadFrom( cb_ps_light.data );
+        } );
+        SceneSystems::ApplyLights( scene, cb_ps_light );
         ImGui::PopStyleColor();
 	} ImGui::End();
 }
@@ -266,7 +342,9 @@ void ImGuiManager::RenderFogWindow( ConstantBuffer<CB_VS_fog>& cb_vs_fog )
 {
     if ( ImGui::Begin( "Fog Controls", FALSE, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove ) )
     {
-        ImGui::Checkbox( "Enable Fog", &cb_vs_fog.data.fogEnable );
+        bool fogEnable = cb_vs_fog.data.fogEnable;
+        if ( ImGui::Checkbox( "Enable Fog", &fogEnable ) )
+            cb_vs_fog.data.fogEnable = fogEnable;
         if ( cb_vs_fog.data.fogEnable )
         {
             ImGui::ColorEdit3( "Fog Colour", &cb_vs_fog.data.fogColor.x );
@@ -276,19 +354,19 @@ void ImGuiManager::RenderFogWindow( ConstantBuffer<CB_VS_fog>& cb_vs_fog )
     } ImGui::End();
 }
 
-void ImGuiManager::RenderModelWindow( std::vector<RenderableGameObject>& models )
+void ImGuiManager::RenderModelWindow( World& scene )
 {
     if ( ImGui::Begin( "Models", FALSE, ImGuiWindowFlags_AlwaysAutoResize | ImGuiWindowFlags_NoMove ) )
     {
-        for ( unsigned int i = 0; i < models.size(); i++ )
+        scene.Each<const Name, Transform>( []( Entity, const Name& name, Transform& transform )
         {
             ImGui::PushStyleColor( ImGuiCol_Text, { 0.8f, 1.0f, 0.5f, 1.0f } );
-            if ( ImGui::TreeNode( models[i].GetModelName().c_str() ) )
+            if ( ImGui::TreeNode( name.value.c_str() ) )
             {
                 ImGui::PushStyleColor( ImGuiCol_Text, { 1.0f, 1.0f, 1.0f, 1.0f } );
                 if ( ImGui::TreeNode( "Position" ) )
                 {
-                    static DirectX::XMFLOAT3 positions = { models[i].GetPositionFloat3() };
+                    static DirectX::XMFLOAT3 positions = { transform.GetPositionFloat3() };
                     ImGui::SliderFloat( "X", &positions.x, -40.0f, 40.0f, "%.1f" );
                     ImGui::SliderFloat( "Y", &positions.y, -40.0f, 40.0f, "%.1f" );
                     ImGui::SliderFloat( "Z", &positions.z, -40.0f, 40.0f, "%.1f" );
@@ -297,11 +375,11 @@ void ImGuiManager::RenderModelWindow( std::vector<RenderableGameObject>& models
                     positions.y = XMConvertToRadians( positions.y );
                     positions.z = XMConvertToRadians( positions.z );
 
-                    models[i].AdjustPosition( positions );
+                    transform.AdjustPosition( positions );
 
                     ImGui::PushStyleColor( ImGuiCol_Button, ImVec4( 1.0f, 0.5f, 0.5f, 1.0f ) );
                     if ( ImGui::Button( "Reset Position" ) )
-                        models[i].ResetPosition();
+                        transform.ResetPosition();
                     ImGui::PopStyleColor();
 
                     ImGui::TreePop();
@@ -309,7 +387,7 @@ void ImGuiManager::RenderModelWindow( std::vector<RenderableGameObject>& models
 
                 if ( ImGui::TreeNode( "Orientation" ) )
                 {
-                    static DirectX::XMFLOAT3 rotations = { models[i].GetRotationFloat3() };
+                    static DirectX::XMFLOAT3 rotations = { transform.GetRotationFloat3() };
                     ImGui::SliderFloat( "Pitch", &rotations.x, -2.0f, 2.0f, "%.1f" );
                     ImGui::SliderFloat( "Yaw", &rotations.y, -2.0f, 2.0f, "%.1f" );
                     ImGui::SliderFloat( "Roll", &rotations.z, -2.0f, 2.0f, "%.1f" );
@@ -318,11 +396,11 @@ void ImGuiManager::RenderModelWindow( std::vector<RenderableGameObject>& models
                     rotations.y = XMConvertToRadians( rotations.y );
                     rotations.z = XMConvertToRadians( rotations.z );
 
-                    models[i].AdjustRotation( rotations );
+                    transform.AdjustRotation( rotations );
 
                     ImGui::PushStyleColor( ImGuiCol_Button, ImVec4( 1.0f, 0.5f, 0.5f, 1.0f ) );
                     if ( ImGui::Button( "Reset Rotation" ) )
-                        models[i].ResetRotation();
+                        transform.ResetRotation();
                     ImGui::PopStyleColor();
 
                     ImGui::TreePop();
@@ -330,7 +408,7 @@ void ImGuiManager::RenderModelWindow( std::vector<RenderableGameObject>& models
 
                 if ( ImGui::TreeNode( "Scaling" ) )
                 {
-                    static DirectX::XMFLOAT3 scales = { models[i].GetScaleFloat3() };
+                    static DirectX::XMFLOAT3 scales = { transform.GetScaleFloat3() };
                     ImGui::SliderFloat( "X", &scales.x, -2.0f, 2.0f, "%.001f" );
                     ImGui::SliderFloat( "Y", &scales.y, -2.0f, 2.0f, "%.001f" );
                     ImGui::SliderFloat( "Z", &scales.z, -2.0f, 2.0f, "%.001f" );
@@ -339,11 +417,11 @@ void ImGuiManager::RenderModelWindow( std::vector<RenderableGameObject>& models
                     scales.y = XMConvertToRadians( scales.y );
                     scales.z = XMConvertToRadians( scales.z );
 
-                    models[i].AdjustScale( scales.x, scales.y, scales.z );
+                    transform.AdjustScale( scales.x, scales.y, scales.z );
 
                     ImGui::PushStyleColor( ImGuiCol_Button, ImVec4( 1.0f, 0.5f, 0.5f, 1.0f ) );
                     if ( ImGui::Button( "Reset Scale" ) )
-                        models[i].ResetScale();
+                        transform.ResetScale();
                     ImGui::PopStyleColor();
 
                     ImGui::TreePop();
@@ -352,7 +430,7 @@ void ImGuiManager::RenderModelWindow( std::vector<RenderableGameObject>& models
                 ImGui::TreePop();
             }
             ImGui::PopStyleColor();
-        }
+        } );
     } ImGui::End();
 }
 
@@ -2,13 +2,13 @@
 #ifndef IMGUIMANAGER_H
 #define IMGUIMANAGER_H
 
-#include "Light.h"
 #include "Camera3D.h"
+#include "ConstantBuffer.h"
 #include <d3d11.h>
 #include <map>
 
 namespace Bind { class Viewport; }
-struct RenderableGameObject;
+class World;
 struct SpawnWindow;
 struct Drawable;
 class Graphics;
@@ -23,9 +23,9 @@ public:
 	void EndRender() const noexcept;
 	void RenderMainWindow( Graphics& gfx );
 	void RenderSceneWindow( Graphics& gfx );
-	void RenderLightWindow( Light& light, ConstantBuffer<CB_PS_light>& cb_ps_light );
+	void RenderLightWindow( World& scene, ConstantBuffer<CB_PS_light>& cb_ps_light );
 	void RenderFogWindow( ConstantBuffer<CB_VS_fog>& cb_vs_fog );
-	void RenderModelWindow( std::vector<RenderableGameObject>& models );
+	void RenderModelWindow( World& scene );
 	void RenderCameraWindow( Graphics& gfx, Camera3D& camera3D, std::string& cameraToUse );
 	void RenderStencilWindow( Graphics& gfx );
 private:
@@ -5,16 +5,24 @@
 #include <memory>
 #include <d3d11.h>
 #include <wrl/client.h>
+#include <type_traits>
 
+// T is the index width, WORD for 16-bit and DWORD for 32-bit indices
+template<class T>
 class IndexBuffer
 {
+	static_assert( std::is_same_v<T, WORD> || std::is_same_v<T, DWORD>, "Index buffers must use WORD or DWORD indices!" );
 private:
-	IndexBuffer( const IndexBuffer& rhs ) {}
+	IndexBuffer( const IndexBuffer<T>& rhs ) {}
 private:
 	Microsoft::WRL::ComPtr<ID3D11Buffer> buffer;
 	UINT indexCount = 0;
 public:
 	IndexBuffer() {}
+	static constexpr DXGI_FORMAT Format() noexcept
+	{
+		return sizeof( T ) == sizeof( WORD ) ? DXGI_FORMAT_R16_UINT : DXGI_FORMAT_R32_UINT;
+	}
 	ID3D11Buffer* Get() const noexcept
 	{
 		return buffer.Get();
@@ -27,7 +35,7 @@ public:
 	{
 		return indexCount;
 	}
-	HRESULT Initialize( ID3D11Device* device, WORD* data, UINT indexCount )
+	HRESULT Initialize( ID3D11Device* device, const T* data, UINT indexCount )
 	{
 		if ( buffer.Get() != nullptr )
 			buffer.Reset();
@@ -36,7 +44,7 @@ public:
 
 		D3D11_BUFFER_DESC indexBufferDesc = { 0 };
 		indexBufferDesc.Usage = D3D11_USAGE_DEFAULT;
-		indexBufferDesc.ByteWidth = sizeof( WORD ) * indexCount;
+		indexBufferDesc.ByteWidth = sizeof( T ) * indexCount;
 		indexBufferDesc.BindFlags = D3D11_BIND_INDEX_BUFFER;
 		indexBufferDesc.CPUAccessFlags = 0;
 		indexBufferDesc.MiscFlags = 0;
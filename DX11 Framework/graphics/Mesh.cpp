@@ -1,22 +1,66 @@
 #include "Mesh.h"
+#include <algorithm>
 
 Mesh::Mesh( ID3D11Device* device,
 	ID3D11DeviceContext* context,
-	std::vector<Vertex3D>& vertices,
-	std::vector<WORD>& indices,
-	std::vector<Texture>& textures,
-	const DirectX::XMMATRIX& transformMatrix )
+	const MeshData& meshData )
 {
 	try
 	{
 		this->context = context;
-		this->textures = textures;
-		this->transformMatrix = transformMatrix;
+		this->transformMatrix = DirectX::XMLoadFloat4x4( &meshData.transformMatrix );
+		if ( meshData.lods.empty() )
+			lods.push_back( { 0, meshData.GetIndexCount(), 0.0f } );
+		else
+			lods = meshData.lods;
+		for ( unsigned int i = 0; i < meshData.textures.size(); i++ )
+			textures.push_back( TextureCache::GetTexture( device, meshData.textures[i] ) );
 
-		HRESULT hr = vertexBuffer.Initialize( device, vertices.data(), vertices.size() );
-		COM_ERROR_IF_FAILED( hr, "Failed to initialize vertex buffer for mesh!" );
+		// quantized positions are already relative to the mesh bounds
+		if ( meshData.IsQuantized() )
+		{
+			const DirectX::XMVECTOR offset = DirectX::XMLoadFloat3( &meshData.quantization.positionOffset );
+			const DirectX::XMVECTOR scale = DirectX::XMLoadFloat3( &meshData.quantization.positionScale );
+			DirectX::BoundingBox::CreateFromPoints( boundingBox, offset, DirectX::XMVectorAdd( offset, scale ) );
+		}
+		else if ( meshData.GetVertexCount() > 0 )
+		{
+			DirectX::BoundingBox::CreateFromPoints( boundingBox, meshData.GetVertexCount(),
+				&meshData.GetVertices()[0].pos, sizeof( Vertex3D ) );
+		}
+		triangleBVH = meshData.triangleBVH;
+		if ( triangleBVH == nullptr )
+		{
+			auto bvh = std::make_shared<TriangleBVH>();
+			bvh->Build( meshData );
+			triangleBVH = bvh;
+		}
+
+		HRESULT hr = S_OK;
+		if ( meshData.IsQuantized() )
+		{
+			hr = quantizedVertexBuffer.Initialize( device, meshData.GetQuantizedVertices(), meshData.GetVertexCount() );
+			COM_ERROR_IF_FAILED( hr, "Failed to initialize quantized vertex buffer for mesh!" );
+
+			// decode constants never change, upload them once
+			cb_vs_quantization = std::make_shared<ConstantBuffer<CB_VS_quantization>>();
+			hr = cb_vs_quantization->Initialize( device, context, false );
+			COM_ERROR_IF_FAILED( hr, "Failed to initialize quantization constant buffer for mesh!" );
+			cb_vs_quantization->data.positionOffset = meshData.quantization.positionOffset;
+			cb_vs_quantization->data.positionScale = meshData.quantization.positionScale;
+			if ( !cb_vs_quantization->ApplyChanges() )
+				return;
+		}
+		else
+		{
+			hr = vertexBuffer.Initialize( device, meshData.GetVertices(), meshData.GetVertexCount() );
+			COM_ERROR_IF_FAILED( hr, "Failed to initialize vertex buffer for mesh!" );
+		}
 
-		hr = indexBuffer.Initialize( device, indices.data(), indices.size() );
+		if ( meshData.HasLargeIndices() )
+			hr = indexBuffer32.Initialize( device, meshData.GetIndices32(), meshData.GetIndexCount() );
+		else
+			hr = indexBuffer.Initialize( device, meshData.GetIndices(), meshData.GetIndexCount() );
 		COM_ERROR_IF_FAILED( hr, "Failed to initialize index buffer for mesh!" );
 	}
 	catch ( COMException& exception )
@@ -35,29 +79,85 @@ Mesh::Mesh( const Mesh& mesh )
 {
 	context = mesh.context;
 	vertexBuffer = mesh.vertexBuffer;
+	quantizedVertexBuffer = mesh.quantizedVertexBuffer;
+	cb_vs_quantization = mesh.cb_vs_quantization;
 	indexBuffer = mesh.indexBuffer;
+	indexBuffer32 = mesh.indexBuffer32;
+	lods = mesh.lods;
 	textures = mesh.textures;
 	transformMatrix = mesh.transformMatrix;
+	boundingBox = mesh.boundingBox;
+	triangleBVH = mesh.triangleBVH;
+}
+
+UINT Mesh::GetLodCount() const noexcept
+{
+	return static_cast<UINT>( lods.size() );
+}
+
+const MeshLod& Mesh::GetLod( UINT lod ) const noexcept
+{
+	return lods[std::min( lod, GetLodCount() - 1 )];
 }
 
-void Mesh::Draw()
+bool Mesh::IsQuantized() const noexcept
 {
+	return cb_vs_quantization != nullptr;
+}
+
+// the texture Draw binds first, which is what tells two meshes' materials apart
+ID3D11ShaderResourceView* Mesh::GetMaterial() const noexcept
+{
+	for ( int i = 0; i < textures.size(); i++ )
+		if ( textures[i]->GetType() == aiTextureType_DIFFUSE || textures[i]->GetType() == aiTextureType_SPECULAR )
+			return textures[i]->GetTextureResourceView();
+	return nullptr;
+}
+
+const DirectX::BoundingBox& Mesh::GetBoundingBox() const noexcept
+{
+	return boundingBox;
+}
+
+// mesh space, before the node transform
+const TriangleBVH& Mesh::GetTriangleBVH() const noexcept
+{
+	return *triangleBVH;
+}
+
+void Mesh::Draw( UINT lod )
+{
+	StateCache& stateCache = StateCache::Get( context );
 	for ( int i = 0; i < textures.size(); i++ )
 	{
-		if ( textures[i].GetType() == aiTextureType_DIFFUSE )
+		if ( textures[i]->GetType() == aiTextureType_DIFFUSE )
 		{
-			context->PSSetShaderResources( 0, 1, textures[i].GetTextureResourceViewAddress() );
+			stateCache.SetPSShaderResource( 0, textures[i]->GetTextureResourceView() );
 			break;
 		}
-		if ( textures[i].GetType() == aiTextureType_SPECULAR )
+		if ( textures[i]->GetType() == aiTextureType_SPECULAR )
 		{
-			context->PSSetShaderResources( 1, 1, textures[i].GetTextureResourceViewAddress() );
+			stateCache.SetPSShaderResource( 1, textures[i]->GetTextureResourceView() );
 			break;
 		}
 	}
 
 	UINT offset = 0;
-	context->IASetVertexBuffers( 0, 1, vertexBuffer.GetAddressOf(), vertexBuffer.StridePtr(), &offset );
-	context->IASetIndexBuffer( indexBuffer.Get(), DXGI_FORMAT_R16_UINT, 0 );
-	context->DrawIndexed( indexBuffer.IndexCount(), 0, 0 );
+	if ( IsQuantized() )
+	{
+		stateCache.SetVertexBuffers( 0, 1, quantizedVertexBuffer.GetAddressOf(), quantizedVertexBuffer.StridePtr(), &offset );
+		cb_vs_quantization->BindVS( 4 );
+	}
+	else
+	{
+		stateCache.SetVertexBuffers( 0, 1, vertexBuffer.GetAddressOf(), vertexBuffer.StridePtr(), &offset );
+	}
+	if ( indexBuffer32.Get() != nullptr )
+		stateCache.SetIndexBuffer( indexBuffer32.Get(), indexBuffer32.Format(), 0 );
+	else
+		stateCache.SetIndexBuffer( indexBuffer.Get(), indexBuffer.Format(), 0 );
+
+	// coarser levels than the mesh has fall back to its coarsest
+	const MeshLod& meshLod = GetLod( lod );
+	stateCache.DrawIndexed( meshLod.indexCount, meshLod.indexOffset, 0 );
 }
\ No newline at end of file
@@ -3,33 +3,126 @@
 #define MESH_H
 
 #include "Vertex.h"
-#include "Texture.h"
+#include "TextureCache.h"
 #include "VertexBuffer.h"
 #include "IndexBuffer.h"
 #include "ConstantBuffer.h"
+#include "TriangleBVH.h"
 #include <assimp/Importer.hpp>
 #include <assimp/postprocess.h>
 #include <assimp/scene.h>
+#include <DirectXCollision.h>
 #include <vector>
 
+// range of the index buffer drawn at one level of detail
+// error is the simplification error in mesh space
+struct MeshLod
+{
+	UINT indexOffset = 0;
+	UINT indexCount = 0;
+	float error = 0.0f;
+};
+
+// cpu-side mesh streams, either owned or viewed directly from a mapped model cache
+// indices are 16-bit where every vertex can be addressed by them, otherwise 32-bit
+// vertices are either full precision or quantized, never both
+struct MeshData
+{
+	const Vertex3D* GetVertices() const noexcept
+	{
+		return mappedVertices != nullptr ? mappedVertices : vertices.data();
+	}
+	const Vertex3DQuantized* GetQuantizedVertices() const noexcept
+	{
+		return mappedQuantizedVertices != nullptr ? mappedQuantizedVertices : quantizedVertices.data();
+	}
+	const void* GetVertexData() const noexcept
+	{
+		if ( IsQuantized() )
+			return GetQuantizedVertices();
+		return GetVertices();
+	}
+	UINT GetVertexStride() const noexcept
+	{
+		return IsQuantized() ? sizeof( Vertex3DQuantized ) : sizeof( Vertex3D );
+	}
+	const WORD* GetIndices() const noexcept
+	{
+		return mappedIndices != nullptr ? mappedIndices : indices.data();
+	}
+	const DWORD* GetIndices32() const noexcept
+	{
+		return mappedIndices32 != nullptr ? mappedIndices32 : indices32.data();
+	}
+	UINT GetVertexCount() const noexcept
+	{
+		if ( mappedVertices != nullptr || mappedQuantizedVertices != nullptr )
+			return mappedVertexCount;
+		return IsQuantized() ? static_cast<UINT>( quantizedVertices.size() ) : static_cast<UINT>( vertices.size() );
+	}
+	UINT GetIndexCount() const noexcept
+	{
+		if ( mappedIndices != nullptr || mappedIndices32 != nullptr )
+			return mappedIndexCount;
+		return HasLargeIndices() ? static_cast<UINT>( indices32.size() ) : static_cast<UINT>( indices.size() );
+	}
+	UINT GetIndex( UINT i ) const noexcept
+	{
+		return HasLargeIndices() ? GetIndices32()[i] : GetIndices()[i];
+	}
+	bool HasLargeIndices() const noexcept
+	{
+		return mappedIndices32 != nullptr || !indices32.empty();
+	}
+	bool IsQuantized() const noexcept
+	{
+		return mappedQuantizedVertices != nullptr || !quantizedVertices.empty();
+	}
+	std::vector<Vertex3D> vertices;
+	std::vector<Vertex3DQuantized> quantizedVertices;
+	VertexQuantization quantization;
+	std::vector<WORD> indices;
+	std::vector<DWORD> indices32;
+	const Vertex3D* mappedVertices = nullptr;
+	const Vertex3DQuantized* mappedQuantizedVertices = nullptr;
+	const WORD* mappedIndices = nullptr;
+	const DWORD* mappedIndices32 = nullptr;
+	UINT mappedVertexCount = 0;
+	UINT mappedIndexCount = 0;
+	std::vector<MeshLod> lods;
+	std::vector<MaterialTexture> textures;
+	DirectX::XMFLOAT4X4 transformMatrix;
+	// built by the loader threads, meshes build their own when it is missing
+	std::shared_ptr<const TriangleBVH> triangleBVH;
+};
+
 class Mesh
 {
 public:
 	Mesh( ID3D11Device* device,
 		ID3D11DeviceContext* context,
-		std::vector<Vertex3D>& vertices,
-		std::vector<WORD>& indices,
-		std::vector<Texture>& textures,
-		const DirectX::XMMATRIX& transformMatrix );
+		const MeshData& meshData );
 	const DirectX::XMMATRIX& GetTransformMatrix();
 	Mesh( const Mesh& mesh );
-	void Draw();
+	void Draw( UINT lod = 0 );
+	UINT GetLodCount() const noexcept;
+	const MeshLod& GetLod( UINT lod ) const noexcept;
+	bool IsQuantized() const noexcept;
+	ID3D11ShaderResourceView* GetMaterial() const noexcept;
+	const DirectX::BoundingBox& GetBoundingBox() const noexcept;
+	const TriangleBVH& GetTriangleBVH() const noexcept;
 private:
 	VertexBuffer<Vertex3D> vertexBuffer;
-	IndexBuffer indexBuffer;
+	VertexBuffer<Vertex3DQuantized> quantizedVertexBuffer;
+	std::shared_ptr<ConstantBuffer<CB_VS_quantization>> cb_vs_quantization;
+	IndexBuffer<WORD> indexBuffer;
+	IndexBuffer<DWORD> indexBuffer32;
 	ID3D11DeviceContext* context;
-	std::vector<Texture> textures;
+	std::vector<MeshLod> lods;
+	std::vector<std::shared_ptr<Texture>> textures;
 	DirectX::XMMATRIX transformMatrix;
+	DirectX::BoundingBox boundingBox;
+	std::shared_ptr<const TriangleBVH> triangleBVH;
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,373 @@
+#include "MeshOptimizer.h"
+#include "Model.h"
+#include <algorithm>
+#include <numeric>
+#include <cmath>
+
+namespace
+{
+	// forsyth scoring, "Linear-Speed Vertex Cache Optimisation"
+	constexpr UINT FORSYTH_CACHE_SIZE = 32;
+	constexpr float CACHE_DECAY_POWER = 1.5f;
+	constexpr float LAST_TRIANGLE_SCORE = 0.75f;
+	constexpr float VALENCE_BOOST_SCALE = 2.0f;
+	constexpr float VALENCE_BOOST_POWER = 0.5f;
+
+	float GetVertexScore( int cachePosition, UINT remainingTriangles ) noexcept
+	{
+		if ( remainingTriangles == 0 )
+			return -1.0f;
+
+		float score = 0.0f;
+		if ( cachePosition >= 0 )
+		{
+			// the last triangle's vertices score the same so the order within it doesn't matter
+			if ( cachePosition < 3 )
+				score = LAST_TRIANGLE_SCORE;
+			else
+				score = powf( 1.0f - ( cachePosition - 3 ) / static_cast<float>( FORSYTH_CACHE_SIZE - 3 ), CACHE_DECAY_POWER );
+		}
+		return score + VALENCE_BOOST_SCALE * powf( static_cast<float>( remainingTriangles ), -VALENCE_BOOST_POWER );
+	}
+
+	bool IsVertexEqual( const Vertex3D& a, const Vertex3D& b ) noexcept
+	{
+		return memcmp( &a, &b, sizeof( Vertex3D ) ) == 0;
+	}
+
+	UINT64 HashVertex( const Vertex3D& vertex ) noexcept
+	{
+		// 64-bit FNV-1a
+		const BYTE* data = reinterpret_cast<const BYTE*>( &vertex );
+		UINT64 hash = 14695981039346656037ull;
+		for ( size_t i = 0; i < sizeof( Vertex3D ); i++ )
+		{
+			hash ^= data[i];
+			hash *= 1099511628211ull;
+		}
+		return hash;
+	}
+}
+
+void MeshOptimizer::Optimize( MeshData& meshData )
+{
+	// mapped streams are read-only, lod chains share the index buffer and quantized meshes have no full precision vertices
+	if ( meshData.mappedVertices != nullptr || meshData.mappedIndices != nullptr || meshData.mappedIndices32 != nullptr ||
+		!meshData.lods.empty() || meshData.IsQuantized() )
+		return;
+
+	DeduplicateVertices( meshData );
+	OptimizeVertexCache( meshData );
+	OptimizeOverdraw( meshData );
+	OptimizeVertexFetch( meshData );
+}
+
+UINT MeshOptimizer::DeduplicateVertices( MeshData& meshData )
+{
+	const UINT vertexCount = static_cast<UINT>( meshData.vertices.size() );
+	if ( vertexCount == 0 )
+		return 0;
+
+	// open addressing table of unique vertex indices
+	UINT tableSize = 1;
+	while ( tableSize < vertexCount * 2 )
+		tableSize *= 2;
+	std::vector<UINT> table( tableSize, UINT_MAX );
+
+	std::vector<UINT> remap( vertexCount );
+	UINT uniqueCount = 0;
+	for ( UINT i = 0; i < vertexCount; i++ )
+	{
+		UINT slot = static_cast<UINT>( HashVertex( meshData.vertices[i] ) ) & ( tableSize - 1 );
+		while ( table[slot] != UINT_MAX && !IsVertexEqual( meshData.vertices[table[slot]], meshData.vertices[i] ) )
+			slot = ( slot + 1 ) & ( tableSize - 1 );
+
+		if ( table[slot] == UINT_MAX )
+		{
+			table[slot] = i;
+			remap[i] = uniqueCount++;
+		}
+		else
+		{
+			remap[i] = remap[table[slot]];
+		}
+	}
+
+	const UINT removed = vertexCount - uniqueCount;
+	if ( removed > 0 )
+		RemapVertices( meshData, remap, uniqueCount );
+	return removed;
+}
+
+void MeshOptimizer::OptimizeVertexCache( MeshData& meshData )
+{
+	std::vector<UINT> indices = GetIndices( meshData );
+	OptimizeVertexCache( indices, meshData.GetVertexCount() );
+	SetIndices( meshData, indices );
+}
+
+void MeshOptimizer::OptimizeVertexCache( std::vector<UINT>& indices, UINT vertexCount )
+{
+	const UINT triangleCount = static_cast<UINT>( indices.size() / 3 );
+	if ( triangleCount < 2 )
+		return;
+
+	// triangles adjacent to each vertex, live triangles are kept at the front of each range
+	std::vector<UINT> remaining( vertexCount, 0 );
+	for ( UINT i = 0; i < triangleCount * 3; i++ )
+		remaining[indices[i]]++;
+	std::vector<UINT> offsets( vertexCount + 1, 0 );
+	for ( UINT i = 0; i < vertexCount; i++ )
+		offsets[i + 1] = offsets[i] + remaining[i];
+	std::vector<UINT> adjacency( triangleCount * 3 );
+	std::vector<UINT> fill( offsets.begin(), offsets.end() - 1 );
+	for ( UINT i = 0; i < triangleCount * 3; i++ )
+		adjacency[fill[indices[i]]++] = i / 3;
+
+	std::vector<int> cachePosition( vertexCount, -1 );
+	std::vector<float> vertexScores( vertexCount );
+	for ( UINT i = 0; i < vertexCount; i++ )
+		vertexScores[i] = GetVertexScore( -1, remaining[i] );
+
+	std::vector<float> triangleScores( triangleCount );
+	std::vector<bool> emitted( triangleCount, false );
+	for ( UINT i = 0; i < triangleCount; i++ )
+		triangleScores[i] = vertexScores[indices[i * 3]] + vertexScores[indices[i * 3 + 1]] + vertexScores[indices[i * 3 + 2]];
+
+	std::vector<UINT> output;
+	output.reserve( indices.size() );
+	std::vector<UINT> cache, newCache;
+	cache.reserve( FORSYTH_CACHE_SIZE + 3 );
+	newCache.reserve( FORSYTH_CACHE_SIZE + 3 );
+
+	UINT bestTriangle = static_cast<UINT>( std::max_element( triangleScores.begin(), triangleScores.end() ) - triangleScores.begin() );
+	UINT scanCursor = 0;
+	while ( bestTriangle != UINT_MAX )
+	{
+		emitted[bestTriangle] = true;
+		const UINT* triangle = &indices[bestTriangle * 3];
+		for ( UINT i = 0; i < 3; i++ )
+		{
+			const UINT vertex = triangle[i];
+			output.push_back( vertex );
+
+			// move the triangle out of the live range
+			UINT* begin = &adjacency[offsets[vertex]];
+			UINT* end = begin + remaining[vertex];
+			UINT* it = std::find( begin, end, bestTriangle );
+			std::swap( *it, *( end - 1 ) );
+			remaining[vertex]--;
+		}
+
+		// emitted vertices go to the front of the cache
+		newCache.assign( triangle, triangle + 3 );
+		for ( UINT i = 0; i < cache.size(); i++ )
+			if ( cache[i] != triangle[0] && cache[i] != triangle[1] && cache[i] != triangle[2] )
+				newCache.push_back( cache[i] );
+		for ( UINT i = FORSYTH_CACHE_SIZE; i < newCache.size(); i++ )
+		{
+			cachePosition[newCache[i]] = -1;
+			vertexScores[newCache[i]] = GetVertexScore( -1, remaining[newCache[i]] );
+		}
+		if ( newCache.size() > FORSYTH_CACHE_SIZE )
+			newCache.resize( FORSYTH_CACHE_SIZE );
+		cache.swap( newCache );
+
+		for ( UINT i = 0; i < cache.size(); i++ )
+		{
+			cachePosition[cache[i]] = static_cast<int>( i );
+			vertexScores[cache[i]] = GetVertexScore( static_cast<int>( i ), remaining[cache[i]] );
+		}
+
+		// only triangles touching the cache can change score
+		bestTriangle = UINT_MAX;
+		float bestScore = -1.0f;
+		for ( UINT i = 0; i < cache.size(); i++ )
+		{
+			const UINT vertex = cache[i];
+			for ( UINT j = 0; j < remaining[vertex]; j++ )
+			{
+				const UINT t = adjacency[offsets[vertex] + j];
+				triangleScores[t] = vertexScores[indices[t * 3]] + vertexScores[indices[t * 3 + 1]] + vertexScores[indices[t * 3 + 2]];
+				if ( triangleScores[t] > bestScore )
+				{
+					bestScore = triangleScores[t];
+					bestTriangle = t;
+				}
+			}
+		}
+
+		// nothing left around the cache, continue with the next unconnected triangle
+		if ( bestTriangle == UINT_MAX )
+		{
+			while ( scanCursor < triangleCount && emitted[scanCursor] )
+				scanCursor++;
+			if ( scanCursor < triangleCount )
+				bestTriangle = scanCursor;
+		}
+	}
+
+	indices.swap( output );
+}
+
+void MeshOptimizer::OptimizeOverdraw( MeshData& meshData )
+{
+	std::vector<UINT> indices = GetIndices( meshData );
+	const UINT vertexCount = meshData.GetVertexCount();
+	const UINT triangleCount = static_cast<UINT>( indices.size() / 3 );
+	if ( triangleCount < 2 )
+		return;
+
+	// split into clusters at hard cache boundaries, where every vertex of a triangle misses,
+	// so reordering the clusters leaves the cache efficiency almost unchanged
+	std::vector<UINT> clusters;
+	std::vector<UINT> timestamps( vertexCount, 0 );
+	UINT time = CACHE_SIZE + 1;
+	for ( UINT i = 0; i < triangleCount; i++ )
+	{
+		UINT misses = 0;
+		for ( UINT j = 0; j < 3; j++ )
+		{
+			const UINT vertex = indices[i * 3 + j];
+			if ( time - timestamps[vertex] > CACHE_SIZE )
+			{
+				timestamps[vertex] = time++;
+				misses++;
+			}
+		}
+		if ( i == 0 || misses == 3 )
+			clusters.push_back( i );
+	}
+	if ( clusters.size() < 2 )
+		return;
+	clusters.push_back( triangleCount );
+
+	// area weighted centroid and normal of the mesh and of each cluster
+	const Vertex3D* vertices = meshData.GetVertices();
+	const size_t clusterCount = clusters.size() - 1;
+	std::vector<XMFLOAT3> clusterCentroids( clusterCount );
+	std::vector<XMFLOAT3> clusterNormals( clusterCount );
+	XMVECTOR meshCentroid = XMVectorZero();
+	float meshArea = 0.0f;
+	for ( size_t c = 0; c < clusterCount; c++ )
+	{
+		XMVECTOR centroid = XMVectorZero();
+		XMVECTOR normal = XMVectorZero();
+		float area = 0.0f;
+		for ( UINT i = clusters[c]; i < clusters[c + 1]; i++ )
+		{
+			XMVECTOR p0 = XMLoadFloat3( &vertices[indices[i * 3]].pos );
+			XMVECTOR p1 = XMLoadFloat3( &vertices[indices[i * 3 + 1]].pos );
+			XMVECTOR p2 = XMLoadFloat3( &vertices[indices[i * 3 + 2]].pos );
+			XMVECTOR n = XMVector3Cross( p1 - p0, p2 - p0 );
+			float triangleArea = XMVectorGetX( XMVector3Length( n ) ) * 0.5f;
+			centroid += ( p0 + p1 + p2 ) * ( triangleArea / 3.0f );
+			normal += n;
+			area += triangleArea;
+		}
+		meshCentroid += centroid;
+		meshArea += area;
+		XMStoreFloat3( &clusterCentroids[c], area > 0.0f ? centroid / area : centroid );
+		XMStoreFloat3( &clusterNormals[c], XMVector3Normalize( normal ) );
+	}
+	if ( meshArea > 0.0f )
+		meshCentroid /= meshArea;
+
+	// clusters facing away from the centre are likely to occlude the rest, draw them first
+	std::vector<float> sortKeys( clusterCount );
+	for ( size_t c = 0; c < clusterCount; c++ )
+		sortKeys[c] = XMVectorGetX( XMVector3Dot( XMLoadFloat3( &clusterCentroids[c] ) - meshCentroid, XMLoadFloat3( &clusterNormals[c] ) ) );
+	std::vector<UINT> order( clusterCount );
+	std::iota( order.begin(), order.end(), 0 );
+	std::stable_sort( order.begin(), order.end(), [&sortKeys]( UINT a, UINT b ) { return sortKeys[a] > sortKeys[b]; } );
+
+	std::vector<UINT> output;
+	output.reserve( indices.size() );
+	for ( size_t c = 0; c < clusterCount; c++ )
+		output.insert( output.end(), indices.begin() + clusters[order[c]] * 3, indices.begin() + clusters[order[c] + 1] * 3 );
+	SetIndices( meshData, output );
+}
+
+void MeshOptimizer::OptimizeVertexFetch( MeshData& meshData )
+{
+	std::vector<UINT> indices = GetIndices( meshData );
+	const UINT vertexCount = meshData.GetVertexCount();
+
+	// vertices in the order they are first referenced, unreferenced vertices are dropped
+	std::vector<UINT> remap( vertexCount, UINT_MAX );
+	UINT nextVertex = 0;
+	for ( UINT i = 0; i < indices.size(); i++ )
+		if ( remap[indices[i]] == UINT_MAX )
+			remap[indices[i]] = nextVertex++;
+
+	RemapVertices( meshData, remap, nextVertex );
+}
+
+MeshStatistics MeshOptimizer::Analyze( const MeshData& meshData, UINT cacheSize )
+{
+	MeshStatistics statistics;
+	const UINT indexCount = meshData.lods.empty() ? meshData.GetIndexCount() : meshData.lods[0].indexCount;
+	statistics.triangleCount = indexCount / 3;
+	if ( statistics.triangleCount == 0 )
+		return statistics;
+
+	// fifo cache, a vertex is resident while fewer than cacheSize misses have happened since it was loaded
+	std::vector<UINT> timestamps( meshData.GetVertexCount(), 0 );
+	UINT time = cacheSize + 1;
+	UINT misses = 0;
+	for ( UINT i = 0; i < statistics.triangleCount * 3; i++ )
+	{
+		const UINT vertex = meshData.GetIndex( i );
+		if ( timestamps[vertex] == 0 )
+			statistics.vertexCount++;
+		if ( time - timestamps[vertex] > cacheSize )
+		{
+			timestamps[vertex] = time++;
+			misses++;
+		}
+	}
+
+	statistics.acmr = misses / static_cast<float>( statistics.triangleCount );
+	statistics.atvr = statistics.vertexCount > 0 ? misses / static_cast<float>( statistics.vertexCount ) : 0.0f;
+	return statistics;
+}
+
+std::vector<UINT> MeshOptimizer::GetIndices( const MeshData& meshData )
+{
+	std::vector<UINT> indices( meshData.GetIndexCount() );
+	for ( UINT i = 0; i < indices.size(); i++ )
+		indices[i] = meshData.GetIndex( i );
+	return indices;
+}
+
+void MeshOptimizer::SetIndices( MeshData& meshData, const std::vector<UINT>& indices )
+{
+	// the vertex count may have dropped far enough for 16-bit indices
+	meshData.indices.clear();
+	meshData.indices32.clear();
+	if ( meshData.GetVertexCount() <= Model::MAX_SHORT_INDEX_VERTICES )
+	{
+		meshData.indices.resize( indices.size() );
+		for ( UINT i = 0; i < indices.size(); i++ )
+			meshData.indices[i] = static_cast<WORD>( indices[i] );
+	}
+	else
+	{
+		meshData.indices32.assign( indices.begin(), indices.end() );
+	}
+}
+
+void MeshOptimizer::RemapVertices( MeshData& meshData, const std::vector<UINT>& remap, UINT vertexCount )
+{
+	std::vector<Vertex3D> vertices( vertexCount );
+	for ( UINT i = 0; i < remap.size(); i++ )
+		if ( remap[i] != UINT_MAX )
+			vertices[remap[i]] = meshData.vertices[i];
+
+	std::vector<UINT> indices = GetIndices( meshData );
+	for ( UINT i = 0; i < indices.size(); i++ )
+		indices[i] = remap[indices[i]];
+
+	meshData.vertices.swap( vertices );
+	SetIndices( meshData, indices );
+}
\ No newline at end of file
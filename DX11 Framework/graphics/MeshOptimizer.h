@@ -0,0 +1,40 @@
+#pragma once
+#ifndef MESHOPTIMIZER_H
+#define MESHOPTIMIZER_H
+
+#include "Mesh.h"
+
+// post-transform cache statistics from a simulated fifo cache
+//  acmr - average cache miss ratio, vertex shader invocations per triangle (0.5 is ideal for large regular meshes)
+//  atvr - average transformed vertex ratio, vertex shader invocations per vertex (1.0 is ideal)
+struct MeshStatistics
+{
+	UINT vertexCount = 0;
+	UINT triangleCount = 0;
+	float acmr = 0.0f;
+	float atvr = 0.0f;
+};
+
+// import time mesh optimization, run on owned (not mapped) mesh data before any lod chain is generated
+//  1. vertex deduplication
+//  2. triangle reordering for post-transform cache locality (forsyth)
+//  3. overdraw-aware ordering of the resulting triangle clusters (tipsify style)
+//  4. vertex reordering in first-use order for pre-transform fetch locality
+class MeshOptimizer
+{
+public:
+	static constexpr UINT CACHE_SIZE = 16;
+	static void Optimize( MeshData& meshData );
+	static UINT DeduplicateVertices( MeshData& meshData );
+	static void OptimizeVertexCache( MeshData& meshData );
+	static void OptimizeVertexCache( std::vector<UINT>& indices, UINT vertexCount );
+	static void OptimizeOverdraw( MeshData& meshData );
+	static void OptimizeVertexFetch( MeshData& meshData );
+	static MeshStatistics Analyze( const MeshData& meshData, UINT cacheSize = CACHE_SIZE );
+private:
+	static std::vector<UINT> GetIndices( const MeshData& meshData );
+	static void SetIndices( MeshData& meshData, const std::vector<UINT>& indices );
+	static void RemapVertices( MeshData& meshData, const std::vector<UINT>& remap, UINT vertexCount );
+};
+
+#endif
\ No newline at end of file
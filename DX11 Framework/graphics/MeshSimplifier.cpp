@@ -0,0 +1,320 @@
+#include "MeshSimplifier.h"
+#include "MeshOptimizer.h"
+#include <queue>
+#include <cmath>
+#include <cfloat>
+#include <algorithm>
+#include <unordered_map>
+
+using namespace DirectX;
+
+namespace
+{
+	// boundary edges are held in place by an extra plane through the edge
+	constexpr double BOUNDARY_WEIGHT = 10.0;
+
+	struct Quadric
+	{
+		double a2 = 0.0, ab = 0.0, ac = 0.0, ad = 0.0;
+		double b2 = 0.0, bc = 0.0, bd = 0.0;
+		double c2 = 0.0, cd = 0.0;
+		double d2 = 0.0;
+		void AddPlane( double a, double b, double c, double d, double weight ) noexcept
+		{
+			a2 += a * a * weight; ab += a * b * weight; ac += a * c * weight; ad += a * d * weight;
+			b2 += b * b * weight; bc += b * c * weight; bd += b * d * weight;
+			c2 += c * c * weight; cd += c * d * weight;
+			d2 += d * d * weight;
+		}
+		Quadric& operator+=( const Quadric& rhs ) noexcept
+		{
+			a2 += rhs.a2; ab += rhs.ab; ac += rhs.ac; ad += rhs.ad;
+			b2 += rhs.b2; bc += rhs.bc; bd += rhs.bd;
+			c2 += rhs.c2; cd += rhs.cd;
+			d2 += rhs.d2;
+			return *this;
+		}
+		// sum of squared distances from the point to every accumulated plane
+		double Evaluate( const XMFLOAT3& p ) const noexcept
+		{
+			const double x = p.x, y = p.y, z = p.z;
+			return a2 * x * x + 2.0 * ab * x * y + 2.0 * ac * x * z + 2.0 * ad * x +
+				b2 * y * y + 2.0 * bc * y * z + 2.0 * bd * y +
+				c2 * z * z + 2.0 * cd * z + d2;
+		}
+	};
+
+	struct Collapse
+	{
+		double cost;
+		UINT from;
+		UINT to;
+		UINT fromVersion;
+		UINT toVersion;
+		bool operator>( const Collapse& rhs ) const noexcept
+		{
+			return cost > rhs.cost;
+		}
+	};
+
+	UINT64 GetEdgeKey( UINT a, UINT b ) noexcept
+	{
+		return a < b ? ( static_cast<UINT64>( a ) << 32 ) | b : ( static_cast<UINT64>( b ) << 32 ) | a;
+	}
+
+	XMVECTOR GetTriangleNormal( const XMFLOAT3& p0, const XMFLOAT3& p1, const XMFLOAT3& p2 ) noexcept
+	{
+		XMVECTOR v0 = XMLoadFloat3( &p0 );
+		return XMVector3Cross( XMLoadFloat3( &p1 ) - v0, XMLoadFloat3( &p2 ) - v0 );
+	}
+}
+
+void MeshSimplifier::GenerateLods( MeshData& meshData, UINT lodCount, float reduction )
+{
+	if ( meshData.mappedVertices != nullptr || meshData.mappedIndices != nullptr || meshData.mappedIndices32 != nullptr ||
+		!meshData.lods.empty() || meshData.IsQuantized() )
+		return;
+
+	const UINT vertexCount = meshData.GetVertexCount();
+	std::vector<UINT> current( meshData.GetIndexCount() );
+	for ( UINT i = 0; i < current.size(); i++ )
+		current[i] = meshData.GetIndex( i );
+
+	// every level is appended to the index buffer after the full detail mesh
+	std::vector<UINT> chain = current;
+	meshData.lods.push_back( { 0, static_cast<UINT>( current.size() ), 0.0f } );
+	float error = 0.0f;
+	for ( UINT i = 1; i < std::min( lodCount, MAX_LOD_COUNT ); i++ )
+	{
+		const UINT targetIndexCount = static_cast<UINT>( current.size() / 3 * reduction ) * 3;
+		if ( targetIndexCount < MIN_LOD_TRIANGLES * 3 )
+			break;
+
+		// stop once the simplifier can no longer make much progress
+		std::vector<UINT> next;
+		float levelError = Simplify( meshData.GetVertices(), vertexCount, current, targetIndexCount, next );
+		if ( next.empty() || next.size() > current.size() * ( 1.0f + reduction ) / 2.0f )
+			break;
+
+		// each level is simplified from the last, so their errors add up
+		MeshOptimizer::OptimizeVertexCache( next, vertexCount );
+		error += levelError;
+		meshData.lods.push_back( { static_cast<UINT>( chain.size() ), static_cast<UINT>( next.size() ), error } );
+		chain.insert( chain.end(), next.begin(), next.end() );
+		current.swap( next );
+	}
+
+	if ( meshData.HasLargeIndices() )
+	{
+		meshData.indices32.swap( chain );
+	}
+	else
+	{
+		meshData.indices.resize( chain.size() );
+		for ( UINT i = 0; i < chain.size(); i++ )
+			meshData.indices[i] = static_cast<WORD>( chain[i] );
+	}
+}
+
+float MeshSimplifier::Simplify( const Vertex3D* vertices, UINT vertexCount, const std::vector<UINT>& indices,
+	UINT targetIndexCount, std::vector<UINT>& result )
+{
+	result = indices;
+	const UINT triangleCount = static_cast<UINT>( indices.size() / 3 );
+	if ( indices.size() <= targetIndexCount || triangleCount == 0 )
+		return 0.0f;
+
+	// weld vertices sharing a position, so attribute seams aren't treated as open boundaries
+	std::vector<UINT> weld( vertexCount );
+	UINT tableSize = 1;
+	while ( tableSize < vertexCount * 2 )
+		tableSize *= 2;
+	std::vector<UINT> table( tableSize, UINT_MAX );
+	for ( UINT i = 0; i < vertexCount; i++ )
+	{
+		const BYTE* data = reinterpret_cast<const BYTE*>( &vertices[i].pos );
+		UINT64 hash = 14695981039346656037ull;
+		for ( size_t j = 0; j < sizeof( XMFLOAT3 ); j++ )
+		{
+			hash ^= data[j];
+			hash *= 1099511628211ull;
+		}
+
+		UINT slot = static_cast<UINT>( hash ) & ( tableSize - 1 );
+		while ( table[slot] != UINT_MAX && memcmp( &vertices[table[slot]].pos, &vertices[i].pos, sizeof( XMFLOAT3 ) ) != 0 )
+			slot = ( slot + 1 ) & ( tableSize - 1 );
+		if ( table[slot] == UINT_MAX )
+			table[slot] = i;
+		weld[i] = table[slot];
+	}
+
+	// vertices belonging to each welded position
+	std::vector<UINT> groupOffsets( vertexCount + 1, 0 );
+	for ( UINT i = 0; i < vertexCount; i++ )
+		groupOffsets[weld[i] + 1]++;
+	for ( UINT i = 0; i < vertexCount; i++ )
+		groupOffsets[i + 1] += groupOffsets[i];
+	std::vector<UINT> groupVertices( vertexCount );
+	std::vector<UINT> groupFill( groupOffsets.begin(), groupOffsets.end() - 1 );
+	for ( UINT i = 0; i < vertexCount; i++ )
+		groupVertices[groupFill[weld[i]]++] = i;
+
+	// face quadrics, triangle adjacency and edge use counts
+	std::vector<UINT> corners = indices;
+	std::vector<bool> alive( triangleCount, true );
+	std::vector<Quadric> quadrics( vertexCount );
+	std::vector<std::vector<UINT>> adjacency( vertexCount );
+	std::unordered_map<UINT64, UINT> edges;
+	UINT liveIndexCount = 0;
+	for ( UINT t = 0; t < triangleCount; t++ )
+	{
+		const UINT w[3] = { weld[corners[t * 3]], weld[corners[t * 3 + 1]], weld[corners[t * 3 + 2]] };
+		if ( w[0] == w[1] || w[1] == w[2] || w[0] == w[2] )
+		{
+			alive[t] = false;
+			continue;
+		}
+
+		XMFLOAT3 normal;
+		XMStoreFloat3( &normal, XMVector3Normalize( GetTriangleNormal( vertices[w[0]].pos, vertices[w[1]].pos, vertices[w[2]].pos ) ) );
+		const double d = -( normal.x * vertices[w[0]].pos.x + normal.y * vertices[w[0]].pos.y + normal.z * vertices[w[0]].pos.z );
+		for ( UINT k = 0; k < 3; k++ )
+		{
+			quadrics[w[k]].AddPlane( normal.x, normal.y, normal.z, d, 1.0 );
+			adjacency[w[k]].push_back( t );
+			edges[GetEdgeKey( w[k], w[( k + 1 ) % 3] )]++;
+		}
+		liveIndexCount += 3;
+	}
+
+	for ( UINT t = 0; t < triangleCount; t++ )
+	{
+		if ( !alive[t] )
+			continue;
+		const UINT w[3] = { weld[corners[t * 3]], weld[corners[t * 3 + 1]], weld[corners[t * 3 + 2]] };
+		XMVECTOR normal = GetTriangleNormal( vertices[w[0]].pos, vertices[w[1]].pos, vertices[w[2]].pos );
+		for ( UINT k = 0; k < 3; k++ )
+		{
+			const UINT a = w[k], b = w[( k + 1 ) % 3];
+			if ( edges[GetEdgeKey( a, b )] != 1 )
+				continue;
+
+			// plane through the boundary edge, perpendicular to the face
+			XMVECTOR pa = XMLoadFloat3( &vertices[a].pos );
+			XMFLOAT3 plane;
+			XMStoreFloat3( &plane, XMVector3Normalize( XMVector3Cross( XMLoadFloat3( &vertices[b].pos ) - pa, normal ) ) );
+			const double d = -( plane.x * vertices[a].pos.x + plane.y * vertices[a].pos.y + plane.z * vertices[a].pos.z );
+			quadrics[a].AddPlane( plane.x, plane.y, plane.z, d, BOUNDARY_WEIGHT );
+			quadrics[b].AddPlane( plane.x, plane.y, plane.z, d, BOUNDARY_WEIGHT );
+		}
+	}
+
+	// cheapest direction of every edge collapse
+	std::vector<UINT> versions( vertexCount, 0 );
+	std::vector<bool> removed( vertexCount, false );
+	std::priority_queue<Collapse, std::vector<Collapse>, std::greater<Collapse>> collapses;
+	auto pushCollapse = [&]( UINT a, UINT b )
+	{
+		Quadric quadric = quadrics[a];
+		quadric += quadrics[b];
+		const double costAB = quadric.Evaluate( vertices[b].pos );
+		const double costBA = quadric.Evaluate( vertices[a].pos );
+		if ( costAB <= costBA )
+			collapses.push( { costAB, a, b, versions[a], versions[b] } );
+		else
+			collapses.push( { costBA, b, a, versions[b], versions[a] } );
+	};
+	for ( auto it = edges.begin(); it != edges.end(); ++it )
+		pushCollapse( static_cast<UINT>( it->first >> 32 ), static_cast<UINT>( it->first & 0xFFFFFFFF ) );
+
+	double maxCost = 0.0;
+	while ( liveIndexCount > targetIndexCount && !collapses.empty() )
+	{
+		const Collapse collapse = collapses.top();
+		collapses.pop();
+		const UINT from = collapse.from, to = collapse.to;
+		if ( removed[from] || removed[to] || versions[from] != collapse.fromVersion || versions[to] != collapse.toVersion )
+			continue;
+
+		// reject collapses that would flip a remaining triangle
+		bool flips = false;
+		for ( UINT i = 0; i < adjacency[from].size() && !flips; i++ )
+		{
+			const UINT t = adjacency[from][i];
+			if ( !alive[t] )
+				continue;
+			UINT w[3] = { weld[corners[t * 3]], weld[corners[t * 3 + 1]], weld[corners[t * 3 + 2]] };
+			if ( w[0] == to || w[1] == to || w[2] == to )
+				continue;
+			XMVECTOR before = GetTriangleNormal( vertices[w[0]].pos, vertices[w[1]].pos, vertices[w[2]].pos );
+			for ( UINT k = 0; k < 3; k++ )
+				if ( w[k] == from )
+					w[k] = to;
+			XMVECTOR after = GetTriangleNormal( vertices[w[0]].pos, vertices[w[1]].pos, vertices[w[2]].pos );
+			flips = XMVectorGetX( XMVector3Dot( before, after ) ) <= 0.0f;
+		}
+		if ( flips )
+			continue;
+
+		for ( UINT i = 0; i < adjacency[from].size(); i++ )
+		{
+			const UINT t = adjacency[from][i];
+			if ( !alive[t] )
+				continue;
+			UINT* corner = &corners[t * 3];
+			if ( weld[corner[0]] == to || weld[corner[1]] == to || weld[corner[2]] == to )
+			{
+				alive[t] = false;
+				liveIndexCount -= 3;
+				continue;
+			}
+
+			// move each corner onto the vertex at the new position with the closest attributes
+			for ( UINT k = 0; k < 3; k++ )
+			{
+				if ( weld[corner[k]] != from )
+					continue;
+				const Vertex3D& source = vertices[corner[k]];
+				float bestScore = -FLT_MAX;
+				for ( UINT j = groupOffsets[to]; j < groupOffsets[to + 1]; j++ )
+				{
+					const Vertex3D& target = vertices[groupVertices[j]];
+					const float du = target.texCoord.x - source.texCoord.x;
+					const float dv = target.texCoord.y - source.texCoord.y;
+					const float score = target.normals.x * source.normals.x + target.normals.y * source.normals.y +
+						target.normals.z * source.normals.z - sqrtf( du * du + dv * dv );
+					if ( score > bestScore )
+					{
+						bestScore = score;
+						corner[k] = groupVertices[j];
+					}
+				}
+			}
+			adjacency[to].push_back( t );
+		}
+
+		removed[from] = true;
+		adjacency[from].clear();
+		quadrics[to] += quadrics[from];
+		versions[to]++;
+		maxCost = std::max( maxCost, collapse.cost );
+
+		// drop dead triangles and queue the new edges around the kept vertex
+		std::vector<UINT>& around = adjacency[to];
+		around.erase( std::remove_if( around.begin(), around.end(), [&alive]( UINT t ) { return !alive[t]; } ), around.end() );
+		std::sort( around.begin(), around.end() );
+		around.erase( std::unique( around.begin(), around.end() ), around.end() );
+		for ( UINT i = 0; i < around.size(); i++ )
+			for ( UINT k = 0; k < 3; k++ )
+				if ( weld[corners[around[i] * 3 + k]] != to )
+					pushCollapse( to, weld[corners[around[i] * 3 + k]] );
+	}
+
+	result.clear();
+	result.reserve( liveIndexCount );
+	for ( UINT t = 0; t < triangleCount; t++ )
+		if ( alive[t] )
+			result.insert( result.end(), corners.begin() + t * 3, corners.begin() + t * 3 + 3 );
+
+	return static_cast<float>( sqrt( std::max( maxCost, 0.0 ) ) );
+}
\ No newline at end of file
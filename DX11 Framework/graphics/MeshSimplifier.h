@@ -0,0 +1,21 @@
+#pragma once
+#ifndef MESHSIMPLIFIER_H
+#define MESHSIMPLIFIER_H
+
+#include "Mesh.h"
+
+// quadric error metric simplification by edge collapse (garland & heckbert)
+// vertices are only ever collapsed onto other existing vertices, so every level of detail
+// is a new set of indices into the same vertex buffer
+class MeshSimplifier
+{
+public:
+	static constexpr UINT MAX_LOD_COUNT = 5;
+	static constexpr UINT MIN_LOD_TRIANGLES = 32;
+	static constexpr float LOD_REDUCTION = 0.5f;
+	static void GenerateLods( MeshData& meshData, UINT lodCount = MAX_LOD_COUNT, float reduction = LOD_REDUCTION );
+	static float Simplify( const Vertex3D* vertices, UINT vertexCount, const std::vector<UINT>& indices,
+		UINT targetIndexCount, std::vector<UINT>& result );
+};
+
+#endif
\ No newline at end of file
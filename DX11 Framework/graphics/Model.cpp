@@ -1,4 +1,10 @@
 #include "Model.h"
+#include "ModelCache.h"
+#include "MeshOptimizer.h"
+#include "MeshSimplifier.h"
+#include "VertexQuantizer.h"
+#include <algorithm>
+#include <assimp/config.h>
 
 bool Model::Initialize(
 	const std::string& filePath,
@@ -24,50 +30,296 @@ bool Model::Initialize(
 	return true;
 }
 
-void Model::Draw( const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix )
+bool Model::Initialize(
+	const std::vector<MeshData>& meshData,
+	ID3D11Device* device,
+	ID3D11DeviceContext* context,
+	ConstantBuffer<CB_VS_matrix>& cb_vs_vertexshader )
 {
-	cb_vs_vertexshader->data.viewMatrix = viewMatrix;
-	cb_vs_vertexshader->data.projectionMatrix = projectionMatrix;
-	context->VSSetConstantBuffers( 0, 1, cb_vs_vertexshader->GetAddressOf() );
-	
+	this->device = device;
+	this->context = context;
+	this->cb_vs_vertexshader = &cb_vs_vertexshader;
+	return SwapMeshes( meshData );
+}
+
+bool Model::SwapMeshes( const std::vector<MeshData>& meshData )
+{
+	// build the new meshes first so a failure leaves the current ones drawable
+	Model model;
+	model.device = device;
+	model.context = context;
+	try
+	{
+		model.CreateMeshes( meshData );
+	}
+	catch ( COMException& exception )
+	{
+		ErrorLogger::Log( exception );
+		return false;
+	}
+
+	meshes.swap( model.meshes );
+	lodErrors.swap( model.lodErrors );
+	boundingBox = model.boundingBox;
+	boundingSphere = model.boundingSphere;
+	meshBVH = std::move( model.meshBVH );
+	inverseMeshTransforms.swap( model.inverseMeshTransforms );
+	return true;
+}
+
+void Model::Draw( const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, UINT lod )
+{
+	Draw( *cb_vs_vertexshader, worldMatrix, viewMatrix, projectionMatrix, lod );
+}
+
+// views recorded on other threads bring their own constant buffer
+void Model::Draw( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix,
+	const XMMATRIX& projectionMatrix, UINT lod )
+{
+	// quantized meshes need their own vertex shader and input layout, the standard one is bound on entry and exit
+	bool quantizedBound = false;
 	for ( int i = 0; i < meshes.size(); i++ )
 	{
-		cb_vs_vertexshader->data.worldMatrix = meshes[i].GetTransformMatrix() * worldMatrix;
-		cb_vs_vertexshader->ApplyChanges();
-		meshes[i].Draw();
+		if ( meshes[i].IsQuantized() != quantizedBound )
+		{
+			if ( quantizedVertexShader == nullptr || standardVertexShader == nullptr )
+				continue;
+			quantizedBound = meshes[i].IsQuantized();
+			const VertexShader* vertexShader = quantizedBound ? quantizedVertexShader : standardVertexShader;
+			StateCache::Get( context ).SetVertexShader( vertexShader->GetShader() );
+			StateCache::Get( context ).SetInputLayout( vertexShader->GetInputLayout() );
+		}
+
+		DrawMesh( cb_vs_matrix, i, worldMatrix, viewMatrix, projectionMatrix, lod );
+	}
+
+	if ( quantizedBound )
+	{
+		StateCache::Get( context ).SetVertexShader( standardVertexShader->GetShader() );
+		StateCache::Get( context ).SetInputLayout( standardVertexShader->GetInputLayout() );
 	}
 }
 
+// one mesh with whatever shaders are bound, the render queue picks them per mesh
+void Model::DrawMesh( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, UINT index, const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix,
+	const XMMATRIX& projectionMatrix, UINT lod )
+{
+	cb_vs_matrix.data.viewMatrix = viewMatrix;
+	cb_vs_matrix.data.projectionMatrix = projectionMatrix;
+	cb_vs_matrix.data.worldMatrix = meshes[index].GetTransformMatrix() * worldMatrix;
+	cb_vs_matrix.ApplyChanges();
+	cb_vs_matrix.BindVS( 0 );
+	meshes[index].Draw( lod );
+}
+
+void Model::ExecutePacket( const DrawPacket& packet, const RenderView& view )
+{
+	DrawMesh( *view.cb_vs_matrix, packet.index, XMLoadFloat4x4( packet.worldMatrix ), view.viewMatrix, view.projectionMatrix, packet.lod );
+}
+
+UINT Model::GetMeshCount() const noexcept
+{
+	return static_cast<UINT>( meshes.size() );
+}
+
+const Mesh& Model::GetMesh( UINT index ) const noexcept
+{
+	return meshes[index];
+}
+
+UINT Model::GetLodCount() const noexcept
+{
+	return static_cast<UINT>( lodErrors.size() );
+}
+
+float Model::GetLodError( UINT lod ) const noexcept
+{
+	return lodErrors.empty() ? 0.0f : lodErrors[std::min( lod, GetLodCount() - 1 )];
+}
+
+const BoundingBox& Model::GetBoundingBox() const noexcept
+{
+	return boundingBox;
+}
+
+const BoundingSphere& Model::GetBoundingSphere() const noexcept
+{
+	return boundingSphere;
+}
+
+// model space ray, meshes are visited nearest box first and each is tested in its own space
+TriangleHit Model::Intersect( const PickRay& ray ) const noexcept
+{
+	TriangleHit hit;
+	meshBVH.Intersect( ray, [this, &ray, &hit]( UINT mesh, float boxDistance, float nearest )
+	{
+		PickRay meshRay = TransformPickRay( ray, XMLoadFloat4x4( &inverseMeshTransforms[mesh] ) );
+		meshRay.maxDistance = nearest;
+		const TriangleHit meshHit = meshes[mesh].GetTriangleBVH().Intersect( meshRay );
+		if ( !meshHit.IsHit() )
+			return FLT_MAX;
+		hit = meshHit;
+		hit.mesh = mesh;
+		return meshHit.distance;
+	} );
+	return hit;
+}
+
+UINT Model::GetTriangleCount( UINT lod ) const noexcept
+{
+	UINT triangleCount = 0;
+	for ( unsigned int i = 0; i < meshes.size(); i++ )
+		triangleCount += meshes[i].GetLod( lod ).indexCount / 3;
+	return triangleCount;
+}
+
 bool Model::LoadModel( const std::string& filePath )
 {
-	directory = StringConverter::GetDirectoryFromPath( filePath );
+	std::vector<MeshData> meshData;
 	Assimp::Importer importer;
-	const aiScene* pScene = importer.ReadFile( filePath,
-		aiProcess_Triangulate | aiProcess_ConvertToLeftHanded );
+	ModelCache cache;
+	if ( !LoadMeshData( filePath, importer, cache, meshData ) )
+		return false;
+	CreateMeshes( meshData );
+	return true;
+}
+
+bool Model::LoadMeshData( const std::string& filePath, Assimp::Importer& importer, ModelCache& cache,
+	std::vector<MeshData>& meshData, bool useCache )
+{
+	// warm start straight from the mapped model cache
+	if ( useCache && cache.Open( filePath, GetImportSettings() ) && cache.GetMeshData( meshData ) )
+		return true;
+	cache.Close();
+	meshData.clear();
+
+	// mesh data may reference memory owned by the importer
+	if ( !ImportModel( filePath, importer, meshData ) )
+		return false;
+	if ( useCache )
+		ModelCache::Write( filePath, GetImportSettings(), meshData );
+	return true;
+}
+
+bool Model::ImportModel( const std::string& filePath, Assimp::Importer& importer, std::vector<MeshData>& meshData )
+{
+	// split meshes are kept small enough for 16-bit indices
+	importer.SetPropertyInteger( AI_CONFIG_PP_SLM_VERTEX_LIMIT, MAX_SHORT_INDEX_VERTICES );
+	const aiScene* pScene = importer.ReadFile( filePath, GetImportFlags() );
 	if ( pScene == nullptr )
 		return false;
-	ProcessNode( pScene->mRootNode, pScene, XMMatrixIdentity() );
+	ProcessNode( pScene->mRootNode, pScene, XMMatrixIdentity(), StringConverter::GetDirectoryFromPath( filePath ), meshData );
+
+	if ( optimizeMeshes )
+		for ( unsigned int i = 0; i < meshData.size(); i++ )
+			MeshOptimizer::Optimize( meshData[i] );
+	if ( generateLods )
+		for ( unsigned int i = 0; i < meshData.size(); i++ )
+			MeshSimplifier::GenerateLods( meshData[i] );
+	if ( quantizeVertices )
+		for ( unsigned int i = 0; i < meshData.size(); i++ )
+			VertexQuantizer::Quantize( meshData[i] );
 	return true;
 }
 
-void Model::ProcessNode( aiNode* node, const aiScene* scene, const XMMATRIX& parentTransformMatrix )
+UINT Model::GetImportFlags() noexcept
+{
+	return splitLargeMeshes ? IMPORT_FLAGS | aiProcess_SplitLargeMeshes : IMPORT_FLAGS;
+}
+
+UINT64 Model::GetImportSettings() noexcept
+{
+	// import flags plus the processing done after import, for validating the model cache
+	UINT64 settings = GetImportFlags();
+	if ( optimizeMeshes )
+		settings |= IMPORT_OPTIMIZE_MESHES;
+	if ( generateLods )
+		settings |= IMPORT_GENERATE_LODS;
+	if ( quantizeVertices )
+		settings |= IMPORT_QUANTIZE_VERTICES;
+	return settings;
+}
+
+void Model::SetSplitLargeMeshes( bool split ) noexcept
+{
+	splitLargeMeshes = split;
+}
+
+void Model::SetOptimizeMeshes( bool optimize ) noexcept
+{
+	optimizeMeshes = optimize;
+}
+
+void Model::SetGenerateLods( bool generate ) noexcept
+{
+	generateLods = generate;
+}
+
+void Model::SetQuantizeVertices( bool quantize ) noexcept
+{
+	quantizeVertices = quantize;
+}
+
+void Model::SetVertexShaders( VertexShader& standard, VertexShader& quantized ) noexcept
+{
+	standardVertexShader = &standard;
+	quantizedVertexShader = &quantized;
+}
+
+void Model::CreateMeshes( const std::vector<MeshData>& meshData )
+{
+	for ( unsigned int i = 0; i < meshData.size(); i++ )
+		meshes.push_back( Mesh( device, context, meshData[i] ) );
+
+	// model space error of each level, the largest of any mesh after its node transform
+	lodErrors.clear();
+	for ( unsigned int i = 0; i < meshes.size(); i++ )
+	{
+		const XMMATRIX& transform = meshes[i].GetTransformMatrix();
+		const float scale = std::max( { XMVectorGetX( XMVector3Length( transform.r[0] ) ),
+			XMVectorGetX( XMVector3Length( transform.r[1] ) ), XMVectorGetX( XMVector3Length( transform.r[2] ) ) } );
+		if ( lodErrors.size() < meshes[i].GetLodCount() )
+			lodErrors.resize( meshes[i].GetLodCount(), 0.0f );
+		for ( UINT j = 0; j < lodErrors.size(); j++ )
+			lodErrors[j] = std::max( lodErrors[j], meshes[i].GetLod( j ).error * scale );
+	}
+
+	// model space bounds, every mesh box after its node transform
+	std::vector<BoundingBox> meshBoxes( meshes.size() );
+	inverseMeshTransforms.resize( meshes.size() );
+	for ( unsigned int i = 0; i < meshes.size(); i++ )
+	{
+		meshes[i].GetBoundingBox().Transform( meshBoxes[i], meshes[i].GetTransformMatrix() );
+		XMStoreFloat4x4( &inverseMeshTransforms[i], XMMatrixInverse( nullptr, meshes[i].GetTransformMatrix() ) );
+		if ( i == 0 )
+			boundingBox = meshBoxes[i];
+		else
+			BoundingBox::CreateMerged( boundingBox, boundingBox, meshBoxes[i] );
+	}
+	BoundingSphere::CreateFromBoundingBox( boundingSphere, boundingBox );
+	meshBVH.Build( meshBoxes );
+}
+
+void Model::ProcessNode( aiNode* node, const aiScene* scene, const XMMATRIX& parentTransformMatrix,
+	const std::string& directory, std::vector<MeshData>& meshData )
 {
 	XMMATRIX nodeTransformMatrix = XMMatrixTranspose( static_cast<XMMATRIX>( &node->mTransformation.a1 ) ) * parentTransformMatrix;
 	
 	for ( UINT i = 0; i < node->mNumMeshes; i++ )
 	{
 		aiMesh* mesh = scene->mMeshes[node->mMeshes[i]];
-		meshes.push_back( ProcessMesh( mesh, scene, nodeTransformMatrix ) );
+		meshData.push_back( ProcessMesh( mesh, scene, nodeTransformMatrix, directory ) );
 	}
 
 	for ( UINT i = 0; i < node->mNumChildren; i++ )
-		ProcessNode( node->mChildren[i], scene, nodeTransformMatrix );
+		ProcessNode( node->mChildren[i], scene, nodeTransformMatrix, directory, meshData );
 }
 
-Mesh Model::ProcessMesh( aiMesh* mesh, const aiScene* scene, const XMMATRIX& transformMatrix )
+MeshData Model::ProcessMesh( aiMesh* mesh, const aiScene* scene, const XMMATRIX& transformMatrix, const std::string& directory )
 {
-	std::vector<Vertex3D> vertices;
-	std::vector<WORD> indices;
+	MeshData meshData;
+	std::vector<Vertex3D>& vertices = meshData.vertices;
+	vertices.reserve( mesh->mNumVertices );
 
 	// get vertices
 	for ( UINT i = 0; i < mesh->mNumVertices; i++ )
@@ -91,21 +343,36 @@ Mesh Model::ProcessMesh( aiMesh* mesh, const aiScene* scene, const XMMATRIX& tra
 		vertices.push_back( vertex );
 	}
 
-	for ( UINT i = 0; i < mesh->mNumFaces; i++ )
+	// 16-bit indices where they can address every vertex
+	if ( mesh->mNumVertices <= MAX_SHORT_INDEX_VERTICES )
+	{
+		meshData.indices.reserve( mesh->mNumFaces * 3 );
+		for ( UINT i = 0; i < mesh->mNumFaces; i++ )
+		{
+			const aiFace& face = mesh->mFaces[i];
+			for ( UINT j = 0; j < face.mNumIndices; j++ )
+				meshData.indices.push_back( static_cast<WORD>( face.mIndices[j] ) );
+		}
+	}
+	else
 	{
-		aiFace face = mesh->mFaces[i];
-		for ( UINT j = 0; j < face.mNumIndices; j++ )
-			indices.push_back( face.mIndices[j] );
+		meshData.indices32.reserve( mesh->mNumFaces * 3 );
+		for ( UINT i = 0; i < mesh->mNumFaces; i++ )
+		{
+			const aiFace& face = mesh->mFaces[i];
+			for ( UINT j = 0; j < face.mNumIndices; j++ )
+				meshData.indices32.push_back( face.mIndices[j] );
+		}
 	}
 
-	std::vector<Texture> textures;
 	aiMaterial* material = scene->mMaterials[mesh->mMaterialIndex];
-	std::vector<Texture> diffuseTextures = LoadMaterialTextures( material, aiTextureType_DIFFUSE, scene );
-	textures.insert( textures.end(), diffuseTextures.begin(), diffuseTextures.end() );
-	std::vector<Texture> specularTextures = LoadMaterialTextures( material, aiTextureType_SPECULAR, scene );
-	textures.insert( textures.end(), specularTextures.begin(), specularTextures.end() );
+	std::vector<MaterialTexture> diffuseTextures = LoadMaterialTextures( material, aiTextureType_DIFFUSE, scene, directory );
+	meshData.textures.insert( meshData.textures.end(), diffuseTextures.begin(), diffuseTextures.end() );
+	std::vector<MaterialTexture> specularTextures = LoadMaterialTextures( material, aiTextureType_SPECULAR, scene, directory );
+	meshData.textures.insert( meshData.textures.end(), specularTextures.begin(), specularTextures.end() );
 
-	return Mesh( device, context, vertices, indices, textures, transformMatrix );
+	XMStoreFloat4x4( &meshData.transformMatrix, transformMatrix );
+	return meshData;
 }
 
 TextureStorageType Model::GetTextureStorageType( const aiScene* pScene, aiMaterial* pMaterial, unsigned int index, aiTextureType textureType )
@@ -147,15 +414,17 @@ TextureStorageType Model::GetTextureStorageType( const aiScene* pScene, aiMateri
 	return TextureStorageType::None;
 }
 
-std::vector<Texture> Model::LoadMaterialTextures( aiMaterial* pMaterial, aiTextureType textureType, const aiScene* pScene )
+std::vector<MaterialTexture> Model::LoadMaterialTextures( aiMaterial* pMaterial, aiTextureType textureType,
+	const aiScene* pScene, const std::string& directory )
 {
-	std::vector<Texture> materialTextures;
-	TextureStorageType storeType = TextureStorageType::Invalid;
+	std::vector<MaterialTexture> materialTextures;
 	unsigned int textureCount = pMaterial->GetTextureCount( textureType );
 
 	if ( textureCount == 0 )
 	{
-		storeType = TextureStorageType::None;
+		MaterialTexture colourTexture;
+		colourTexture.type = textureType;
+		colourTexture.storageType = TextureStorageType::None;
 		aiColor3D aiColor( 0.0f, 0.0f, 0.0f );
 		switch ( textureType )
 		{
@@ -163,19 +432,23 @@ std::vector<Texture> Model::LoadMaterialTextures( aiMaterial* pMaterial, aiTextu
 			pMaterial->Get( AI_MATKEY_COLOR_DIFFUSE, aiColor );
 			if ( aiColor.IsBlack() )
 			{
-				materialTextures.push_back( Texture( device, Colours::UnloadedTextureColour, textureType ) );
+				colourTexture.colour = Colours::UnloadedTextureColour;
+				materialTextures.push_back( colourTexture );
 				return materialTextures;
 			}
-			materialTextures.push_back( Texture( device, Colour( aiColor.r * 255, aiColor.g * 255, aiColor.b * 255 ), textureType ) );
+			colourTexture.colour = Colour( aiColor.r * 255, aiColor.g * 255, aiColor.b * 255 );
+			materialTextures.push_back( colourTexture );
 			return materialTextures;
 		case aiTextureType_SPECULAR:
 			pMaterial->Get( AI_MATKEY_COLOR_SPECULAR, aiColor );
 			if ( aiColor.IsBlack() )
 			{
-				materialTextures.push_back( Texture( device, Colours::UnloadedTextureColour, textureType ) );
+				colourTexture.colour = Colours::UnloadedTextureColour;
+				materialTextures.push_back( colourTexture );
 				return materialTextures;
 			}
-			materialTextures.push_back( Texture( device, Colour( aiColor.r * 255, aiColor.g * 255, aiColor.b * 255 ), textureType ) );
+			colourTexture.colour = Colour( aiColor.r * 255, aiColor.g * 255, aiColor.b * 255 );
+			materialTextures.push_back( colourTexture );
 			return materialTextures;
 		}
 	}
@@ -185,30 +458,31 @@ std::vector<Texture> Model::LoadMaterialTextures( aiMaterial* pMaterial, aiTextu
 		{
 			aiString path;
 			pMaterial->GetTexture( textureType, i, &path );
-			TextureStorageType storageType = GetTextureStorageType( pScene, pMaterial, i, textureType );
-			switch ( storageType )
+			MaterialTexture materialTexture;
+			materialTexture.type = textureType;
+			materialTexture.storageType = GetTextureStorageType( pScene, pMaterial, i, textureType );
+			switch ( materialTexture.storageType )
 			{
 				case TextureStorageType::Disk:
 				{
-					std::string fileName = directory + '\\' + path.C_Str();
-					Texture diskTexture( device, fileName, textureType );
-					materialTextures.push_back( diskTexture );
+					materialTexture.filePath = directory + '\\' + path.C_Str();
+					materialTextures.push_back( materialTexture );
 					break;
 				}
 				case TextureStorageType::EmbeddedCompressed:
 				{
 					const aiTexture* pTexture = pScene->GetEmbeddedTexture( path.C_Str() );
-					Texture embeddedTexture( device, reinterpret_cast<uint8_t*>( pTexture->pcData ),
-						pTexture->mWidth, textureType );
-					materialTextures.push_back( embeddedTexture );
+					materialTexture.pData = reinterpret_cast<uint8_t*>( pTexture->pcData );
+					materialTexture.size = pTexture->mWidth;
+					materialTextures.push_back( materialTexture );
 					break;
 				}
 				case TextureStorageType::EmbeddedIndexCompressed:
 				{
 					int index = GetTextureIndex( &path );
-					Texture embeddedTextureIndexed( device, reinterpret_cast<uint8_t*>( pScene->mTextures[index]->pcData ),
-						pScene->mTextures[index]->mWidth, textureType );
-					materialTextures.push_back( embeddedTextureIndexed );
+					materialTexture.pData = reinterpret_cast<uint8_t*>( pScene->mTextures[index]->pcData );
+					materialTexture.size = pScene->mTextures[index]->mWidth;
+					materialTextures.push_back( materialTexture );
 					break;
 				}
 			}
@@ -216,7 +490,12 @@ std::vector<Texture> Model::LoadMaterialTextures( aiMaterial* pMaterial, aiTextu
 	}
 
 	if ( materialTextures.size() == 0 )
-		materialTextures.push_back( Texture( device, Colours::UnhandledTextureColour, aiTextureType_DIFFUSE ) );
+	{
+		MaterialTexture unhandledTexture;
+		unhandledTexture.type = aiTextureType_DIFFUSE;
+		unhandledTexture.colour = Colours::UnhandledTextureColour;
+		materialTextures.push_back( unhandledTexture );
+	}
 
 	return materialTextures;
 }
@@ -3,27 +3,79 @@
 #define MODEL_H
 
 #include "Mesh.h"
+#include "Shaders.h"
+#include "RenderQueue.h"
 using namespace DirectX;
 
-class Model
+class ModelCache;
+
+// shared by every entity drawing the same meshes, packets bring the world matrix and level of detail
+class Model : public PacketSource
 {
 public:
+	static constexpr UINT IMPORT_FLAGS = aiProcess_Triangulate | aiProcess_ConvertToLeftHanded;
+	static constexpr UINT MAX_SHORT_INDEX_VERTICES = 0xFFFF;
+	static constexpr UINT64 IMPORT_OPTIMIZE_MESHES = 1ull << 32;
+	static constexpr UINT64 IMPORT_GENERATE_LODS = 1ull << 33;
+	static constexpr UINT64 IMPORT_QUANTIZE_VERTICES = 1ull << 34;
+	static UINT GetImportFlags() noexcept;
+	static UINT64 GetImportSettings() noexcept;
+	static void SetSplitLargeMeshes( bool split ) noexcept;
+	static void SetOptimizeMeshes( bool optimize ) noexcept;
+	static void SetGenerateLods( bool generate ) noexcept;
+	static void SetQuantizeVertices( bool quantize ) noexcept;
+	static void SetVertexShaders( VertexShader& standard, VertexShader& quantized ) noexcept;
 	bool Initialize(
 		const std::string& filePath,
 		ID3D11Device* device,
 		ID3D11DeviceContext* context,
 		ConstantBuffer<CB_VS_matrix>& cb_vs_vertexshader );
-	void Draw( const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix );
+	bool Initialize(
+		const std::vector<MeshData>& meshData,
+		ID3D11Device* device,
+		ID3D11DeviceContext* context,
+		ConstantBuffer<CB_VS_matrix>& cb_vs_vertexshader );
+	bool SwapMeshes( const std::vector<MeshData>& meshData );
+	void Draw( const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix, const XMMATRIX& projectionMatrix, UINT lod = 0 );
+	void Draw( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix,
+		const XMMATRIX& projectionMatrix, UINT lod = 0 );
+	void DrawMesh( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, UINT index, const XMMATRIX& worldMatrix, const XMMATRIX& viewMatrix,
+		const XMMATRIX& projectionMatrix, UINT lod = 0 );
+	void ExecutePacket( const DrawPacket& packet, const RenderView& view ) override;
+	UINT GetMeshCount() const noexcept;
+	const Mesh& GetMesh( UINT index ) const noexcept;
+	UINT GetLodCount() const noexcept;
+	float GetLodError( UINT lod ) const noexcept;
+	UINT GetTriangleCount( UINT lod ) const noexcept;
+	const BoundingBox& GetBoundingBox() const noexcept;
+	const BoundingSphere& GetBoundingSphere() const noexcept;
+	TriangleHit Intersect( const PickRay& ray ) const noexcept;
+	static bool LoadMeshData( const std::string& filePath, Assimp::Importer& importer, ModelCache& cache,
+		std::vector<MeshData>& meshData, bool useCache = true );
+	static bool ImportModel( const std::string& filePath, Assimp::Importer& importer, std::vector<MeshData>& meshData );
 private:
 	bool LoadModel( const std::string& filePath );
-	void ProcessNode( aiNode* node, const aiScene* scene, const XMMATRIX& parentTransformMatrix );
-	Mesh ProcessMesh( aiMesh* mesh, const aiScene* scene, const XMMATRIX& transformMatrix );
-	TextureStorageType GetTextureStorageType( const aiScene* pScene, aiMaterial* pMaterial, unsigned int index, aiTextureType textureType );
-	std::vector<Texture> LoadMaterialTextures( aiMaterial* pMaterial, aiTextureType textureType, const aiScene* pScene );
-	int GetTextureIndex( aiString* pStr );
+	void CreateMeshes( const std::vector<MeshData>& meshData );
+	static void ProcessNode( aiNode* node, const aiScene* scene, const XMMATRIX& parentTransformMatrix,
+		const std::string& directory, std::vector<MeshData>& meshData );
+	static MeshData ProcessMesh( aiMesh* mesh, const aiScene* scene, const XMMATRIX& transformMatrix, const std::string& directory );
+	static TextureStorageType GetTextureStorageType( const aiScene* pScene, aiMaterial* pMaterial, unsigned int index, aiTextureType textureType );
+	static std::vector<MaterialTexture> LoadMaterialTextures( aiMaterial* pMaterial, aiTextureType textureType,
+		const aiScene* pScene, const std::string& directory );
+	static int GetTextureIndex( aiString* pStr );
 private:
-	std::string directory = "";
+	static inline bool splitLargeMeshes = false;
+	static inline bool optimizeMeshes = true;
+	static inline bool generateLods = true;
+	static inline bool quantizeVertices = true;
+	static inline VertexShader* standardVertexShader = nullptr;
+	static inline VertexShader* quantizedVertexShader = nullptr;
 	std::vector<Mesh> meshes;
+	std::vector<float> lodErrors;
+	BoundingBox boundingBox;
+	BoundingSphere boundingSphere;
+	BoundingVolumeHierarchy meshBVH;
+	std::vector<XMFLOAT4X4> inverseMeshTransforms;
 	ID3D11Device* device = nullptr;
 	ID3D11DeviceContext* context = nullptr;
 	ConstantBuffer<CB_VS_matrix>* cb_vs_vertexshader = nullptr;
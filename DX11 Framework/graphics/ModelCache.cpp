@@ -0,0 +1,346 @@
+#include "ModelCache.h"
+#include "Model.h"
+#include <fstream>
+
+namespace
+{
+	constexpr UINT32 CACHE_MAGIC = 0x434D5844; // "DXMC"
+	constexpr UINT64 CACHE_ALIGNMENT = 16;
+
+	struct CacheHeader
+	{
+		UINT32 magic;
+		UINT32 version;
+		UINT64 sourceHash;
+		UINT64 sourceSize;
+		UINT64 sourceWriteTime;
+		UINT64 importSettings;
+		UINT32 vertexStride;
+		UINT32 meshCount;
+		UINT32 textureCount;
+		UINT32 lodCount;
+		UINT64 meshTableOffset;
+		UINT64 textureTableOffset;
+		UINT64 lodTableOffset;
+		UINT64 fileSize;
+	};
+
+	struct CacheMesh
+	{
+		DirectX::XMFLOAT4X4 transformMatrix;
+		UINT64 vertexOffset;
+		UINT64 indexOffset;
+		UINT32 vertexCount;
+		UINT32 indexCount;
+		UINT32 firstTexture;
+		UINT32 textureCount;
+		UINT32 indexSize;
+		UINT32 firstLod;
+		UINT32 lodCount;
+		UINT32 quantized;
+		DirectX::XMFLOAT3 positionOffset;
+		DirectX::XMFLOAT3 positionScale;
+	};
+
+	struct CacheTexture
+	{
+		UINT32 type;
+		UINT32 storageType;
+		UINT32 colour;
+		UINT32 reserved;
+		UINT64 dataOffset;
+		UINT64 dataSize;
+	};
+
+	struct CacheLod
+	{
+		UINT32 indexOffset;
+		UINT32 indexCount;
+		float error;
+		UINT32 reserved;
+	};
+
+	UINT64 AppendData( std::vector<BYTE>& blob, const void* data, size_t size )
+	{
+		UINT64 offset = ( blob.size() + CACHE_ALIGNMENT - 1 ) & ~( CACHE_ALIGNMENT - 1 );
+		blob.resize( static_cast<size_t>( offset ) + size, 0 );
+		if ( size > 0 )
+			memcpy( blob.data() + offset, data, size );
+		return offset;
+	}
+
+	bool InRange( UINT64 offset, UINT64 size, size_t fileSize ) noexcept
+	{
+		return offset <= fileSize && size <= fileSize - offset;
+	}
+
+	// size and last write time of the source, cheap enough to check on every start
+	bool GetSourceStamp( const std::string& filePath, UINT64& size, UINT64& writeTime ) noexcept
+	{
+		WIN32_FILE_ATTRIBUTE_DATA attributes;
+		if ( !GetFileAttributesExA( filePath.c_str(), GetFileExInfoStandard, &attributes ) )
+			return false;
+		size = ( static_cast<UINT64>( attributes.nFileSizeHigh ) << 32 ) | attributes.nFileSizeLow;
+		writeTime = ( static_cast<UINT64>( attributes.ftLastWriteTime.dwHighDateTime ) << 32 ) | attributes.ftLastWriteTime.dwLowDateTime;
+		return true;
+	}
+}
+
+bool ModelCache::Open( const std::string& filePath, UINT64 importSettings )
+{
+	if ( !cacheFile.Open( GetCachePath( filePath ) ) )
+		return false;
+
+	// validate the cache against the current source file
+	const CacheHeader* header = reinterpret_cast<const CacheHeader*>( cacheFile.GetData() );
+	UINT64 sourceSize = 0, sourceWriteTime = 0;
+	if ( cacheFile.GetSize() < sizeof( CacheHeader ) ||
+		header->magic != CACHE_MAGIC ||
+		header->version != CACHE_VERSION ||
+		header->vertexStride != sizeof( Vertex3D ) ||
+		header->importSettings != importSettings ||
+		header->fileSize != cacheFile.GetSize() ||
+		!GetSourceStamp( filePath, sourceSize, sourceWriteTime ) ||
+		header->sourceSize != sourceSize )
+	{
+		Close();
+		return false;
+	}
+
+	// an unchanged stamp skips reading the source, otherwise the contents decide
+	if ( header->sourceWriteTime == sourceWriteTime )
+		return true;
+	if ( header->sourceHash != HashFile( filePath ) )
+	{
+		Close();
+		return false;
+	}
+
+	// same contents with a new write time (e.g. a fresh checkout), store the stamp so the next start skips the hash
+	Close();
+	{
+		std::fstream file( GetCachePath( filePath ), std::ios::binary | std::ios::in | std::ios::out );
+		if ( file.is_open() )
+		{
+			file.seekp( offsetof( CacheHeader, sourceWriteTime ) );
+			file.write( reinterpret_cast<const char*>( &sourceWriteTime ), sizeof( sourceWriteTime ) );
+		}
+	}
+	return cacheFile.Open( GetCachePath( filePath ) );
+}
+
+bool ModelCache::GetMeshData( std::vector<MeshData>& meshData ) const
+{
+	if ( !cacheFile.IsOpen() )
+		return false;
+
+	const BYTE* data = cacheFile.GetData();
+	const size_t size = cacheFile.GetSize();
+	const CacheHeader* header = reinterpret_cast<const CacheHeader*>( data );
+	if ( !InRange( header->meshTableOffset, sizeof( CacheMesh ) * static_cast<UINT64>( header->meshCount ), size ) ||
+		!InRange( header->textureTableOffset, sizeof( CacheTexture ) * static_cast<UINT64>( header->textureCount ), size ) ||
+		!InRange( header->lodTableOffset, sizeof( CacheLod ) * static_cast<UINT64>( header->lodCount ), size ) )
+		return false;
+
+	const CacheMesh* meshTable = reinterpret_cast<const CacheMesh*>( data + header->meshTableOffset );
+	const CacheTexture* textureTable = reinterpret_cast<const CacheTexture*>( data + header->textureTableOffset );
+	const CacheLod* lodTable = reinterpret_cast<const CacheLod*>( data + header->lodTableOffset );
+
+	meshData.reserve( meshData.size() + header->meshCount );
+	for ( UINT i = 0; i < header->meshCount; i++ )
+	{
+		const CacheMesh& cacheMesh = meshTable[i];
+		const UINT64 vertexStride = cacheMesh.quantized ? sizeof( Vertex3DQuantized ) : sizeof( Vertex3D );
+		if ( !InRange( cacheMesh.vertexOffset, vertexStride * cacheMesh.vertexCount, size ) ||
+			( cacheMesh.indexSize != sizeof( WORD ) && cacheMesh.indexSize != sizeof( DWORD ) ) ||
+			!InRange( cacheMesh.indexOffset, cacheMesh.indexSize * static_cast<UINT64>( cacheMesh.indexCount ), size ) ||
+			static_cast<UINT64>( cacheMesh.firstTexture ) + cacheMesh.textureCount > header->textureCount ||
+			static_cast<UINT64>( cacheMesh.firstLod ) + cacheMesh.lodCount > header->lodCount )
+			return false;
+
+		// vertex and index streams are used in place, no per-vertex copy
+		MeshData mesh;
+		mesh.transformMatrix = cacheMesh.transformMatrix;
+		if ( cacheMesh.quantized )
+		{
+			mesh.mappedQuantizedVertices = reinterpret_cast<const Vertex3DQuantized*>( data + cacheMesh.vertexOffset );
+			mesh.quantization.positionOffset = cacheMesh.positionOffset;
+			mesh.quantization.positionScale = cacheMesh.positionScale;
+		}
+		else
+		{
+			mesh.mappedVertices = reinterpret_cast<const Vertex3D*>( data + cacheMesh.vertexOffset );
+		}
+		if ( cacheMesh.indexSize == sizeof( DWORD ) )
+			mesh.mappedIndices32 = reinterpret_cast<const DWORD*>( data + cacheMesh.indexOffset );
+		else
+			mesh.mappedIndices = reinterpret_cast<const WORD*>( data + cacheMesh.indexOffset );
+		mesh.mappedVertexCount = cacheMesh.vertexCount;
+		mesh.mappedIndexCount = cacheMesh.indexCount;
+
+		for ( UINT j = 0; j < cacheMesh.lodCount; j++ )
+		{
+			const CacheLod& cacheLod = lodTable[cacheMesh.firstLod + j];
+			if ( static_cast<UINT64>( cacheLod.indexOffset ) + cacheLod.indexCount > cacheMesh.indexCount )
+				return false;
+			mesh.lods.push_back( { cacheLod.indexOffset, cacheLod.indexCount, cacheLod.error } );
+		}
+
+		for ( UINT j = 0; j < cacheMesh.textureCount; j++ )
+		{
+			const CacheTexture& cacheTexture = textureTable[cacheMesh.firstTexture + j];
+			if ( !InRange( cacheTexture.dataOffset, cacheTexture.dataSize, size ) )
+				return false;
+
+			MaterialTexture texture;
+			texture.type = static_cast<aiTextureType>( cacheTexture.type );
+			texture.storageType = static_cast<TextureStorageType>( cacheTexture.storageType );
+			texture.colour = Colour( cacheTexture.colour );
+			if ( texture.storageType == TextureStorageType::Disk )
+			{
+				texture.filePath.assign( reinterpret_cast<const char*>( data + cacheTexture.dataOffset ),
+					static_cast<size_t>( cacheTexture.dataSize ) );
+			}
+			else if ( cacheTexture.dataSize > 0 )
+			{
+				texture.pData = data + cacheTexture.dataOffset;
+				texture.size = static_cast<size_t>( cacheTexture.dataSize );
+			}
+			mesh.textures.push_back( texture );
+		}
+
+		meshData.push_back( std::move( mesh ) );
+	}
+
+	return true;
+}
+
+void ModelCache::Close() noexcept
+{
+	cacheFile.Close();
+}
+
+size_t ModelCache::GetSize() const noexcept
+{
+	return cacheFile.GetSize();
+}
+
+bool ModelCache::Write( const std::string& filePath, UINT64 importSettings, const std::vector<MeshData>& meshData )
+{
+	std::vector<CacheMesh> meshTable( meshData.size() );
+	std::vector<CacheTexture> textureTable;
+	std::vector<CacheLod> lodTable;
+	std::vector<BYTE> blob( sizeof( CacheHeader ), 0 );
+
+	// data section
+	for ( unsigned int i = 0; i < meshData.size(); i++ )
+	{
+		CacheMesh& cacheMesh = meshTable[i];
+		cacheMesh.transformMatrix = meshData[i].transformMatrix;
+		cacheMesh.vertexCount = meshData[i].GetVertexCount();
+		cacheMesh.indexCount = meshData[i].GetIndexCount();
+		cacheMesh.vertexOffset = AppendData( blob, meshData[i].GetVertexData(), meshData[i].GetVertexStride() * static_cast<size_t>( cacheMesh.vertexCount ) );
+		cacheMesh.quantized = meshData[i].IsQuantized() ? 1 : 0;
+		cacheMesh.positionOffset = meshData[i].quantization.positionOffset;
+		cacheMesh.positionScale = meshData[i].quantization.positionScale;
+		if ( meshData[i].HasLargeIndices() )
+		{
+			cacheMesh.indexSize = sizeof( DWORD );
+			cacheMesh.indexOffset = AppendData( blob, meshData[i].GetIndices32(), sizeof( DWORD ) * cacheMesh.indexCount );
+		}
+		else
+		{
+			cacheMesh.indexSize = sizeof( WORD );
+			cacheMesh.indexOffset = AppendData( blob, meshData[i].GetIndices(), sizeof( WORD ) * cacheMesh.indexCount );
+		}
+		cacheMesh.firstTexture = static_cast<UINT32>( textureTable.size() );
+		cacheMesh.textureCount = static_cast<UINT32>( meshData[i].textures.size() );
+		cacheMesh.firstLod = static_cast<UINT32>( lodTable.size() );
+		cacheMesh.lodCount = static_cast<UINT32>( meshData[i].lods.size() );
+
+		for ( const MeshLod& lod : meshData[i].lods )
+			lodTable.push_back( { lod.indexOffset, lod.indexCount, lod.error, 0 } );
+
+		for ( unsigned int j = 0; j < meshData[i].textures.size(); j++ )
+		{
+			const MaterialTexture& texture = meshData[i].textures[j];
+			CacheTexture cacheTexture = { 0 };
+			cacheTexture.type = static_cast<UINT32>( texture.type );
+			cacheTexture.storageType = static_cast<UINT32>( texture.storageType );
+			cacheTexture.colour = texture.colour.GetColour();
+			if ( texture.storageType == TextureStorageType::Disk )
+			{
+				cacheTexture.dataOffset = AppendData( blob, texture.filePath.data(), texture.filePath.size() );
+				cacheTexture.dataSize = texture.filePath.size();
+			}
+			else if ( texture.pData != nullptr )
+			{
+				cacheTexture.dataOffset = AppendData( blob, texture.pData, texture.size );
+				cacheTexture.dataSize = texture.size;
+			}
+			textureTable.push_back( cacheTexture );
+		}
+	}
+
+	// tables and header
+	CacheHeader header = { 0 };
+	header.magic = CACHE_MAGIC;
+	header.version = CACHE_VERSION;
+	header.sourceHash = HashFile( filePath );
+	GetSourceStamp( filePath, header.sourceSize, header.sourceWriteTime );
+	header.importSettings = importSettings;
+	header.vertexStride = sizeof( Vertex3D );
+	header.meshCount = static_cast<UINT32>( meshTable.size() );
+	header.textureCount = static_cast<UINT32>( textureTable.size() );
+	header.lodCount = static_cast<UINT32>( lodTable.size() );
+	header.meshTableOffset = AppendData( blob, meshTable.data(), sizeof( CacheMesh ) * meshTable.size() );
+	header.textureTableOffset = AppendData( blob, textureTable.data(), sizeof( CacheTexture ) * textureTable.size() );
+	header.lodTableOffset = AppendData( blob, lodTable.data(), sizeof( CacheLod ) * lodTable.size() );
+	header.fileSize = blob.size();
+	memcpy( blob.data(), &header, sizeof( CacheHeader ) );
+
+	// write to a temporary file first so a partial write is never picked up
+	const std::string cachePath = GetCachePath( filePath );
+	const std::string tempPath = cachePath + ".tmp";
+	{
+		std::ofstream file( tempPath, std::ios::binary | std::ios::trunc );
+		if ( !file.is_open() )
+			return false;
+		file.write( reinterpret_cast<const char*>( blob.data() ), blob.size() );
+		if ( !file.good() )
+			return false;
+	}
+
+	return MoveFileExA( tempPath.c_str(), cachePath.c_str(), MOVEFILE_REPLACE_EXISTING ) != FALSE;
+}
+
+bool ModelCache::Cook( const std::string& filePath )
+{
+	std::vector<MeshData> meshData;
+	Assimp::Importer importer;
+	if ( !Model::ImportModel( filePath, importer, meshData ) )
+		return false;
+	return Write( filePath, Model::GetImportSettings(), meshData );
+}
+
+std::string ModelCache::GetCachePath( const std::string& filePath )
+{
+	return filePath + ".dxmc";
+}
+
+UINT64 ModelCache::HashFile( const std::string& filePath )
+{
+	MappedFile sourceFile;
+	if ( !sourceFile.Open( filePath ) )
+		return 0;
+
+	// 64-bit FNV-1a
+	UINT64 hash = 14695981039346656037ull;
+	const BYTE* data = sourceFile.GetData();
+	for ( size_t i = 0; i < sourceFile.GetSize(); i++ )
+	{
+		hash ^= data[i];
+		hash *= 1099511628211ull;
+	}
+	return hash;
+}
\ No newline at end of file
@@ -0,0 +1,38 @@
+#pragma once
+#ifndef MODELCACHE_H
+#define MODELCACHE_H
+
+#include "Mesh.h"
+#include "../utility/MappedFile.h"
+
+/*
+	Binary model cache stored alongside the source model as "<model>.dxmc".
+
+	[header]         magic, version, source file hash, size and write time, import settings, vertex stride, table offsets
+	[mesh table]     transform matrix, vertex/index stream offsets and counts, index width, texture and lod range,
+	                 vertex format and position decode for quantized meshes
+	[texture table]  texture type, storage type, colour, data offset/size
+	[lod table]      index range into the mesh index stream and simplification error per level
+	[data]           16-byte aligned vertex streams (Vertex3D or Vertex3DQuantized), index streams, texture paths and embedded images
+
+	A cache is only used when its version, vertex stride, import settings and source file size match
+	and either the source write time or, failing that, the hash of the source file matches,
+	otherwise the model is re-imported through Assimp and rewritten.
+*/
+class ModelCache
+{
+public:
+	static constexpr UINT CACHE_VERSION = 6;
+	bool Open( const std::string& filePath, UINT64 importSettings );
+	bool GetMeshData( std::vector<MeshData>& meshData ) const;
+	void Close() noexcept;
+	size_t GetSize() const noexcept;
+	static bool Write( const std::string& filePath, UINT64 importSettings, const std::vector<MeshData>& meshData );
+	static bool Cook( const std::string& filePath );
+	static std::string GetCachePath( const std::string& filePath );
+	static UINT64 HashFile( const std::string& filePath );
+private:
+	MappedFile cacheFile;
+};
+
+#endif
\ No newline at end of file
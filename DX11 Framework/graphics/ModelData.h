@@ -5,7 +5,8 @@
 #include <fstream>
 #include <filesystem>
 #include "nlohmann/json.hpp"
-#include "RenderableGameObject.h"
+#include "ModelLoader.h"
+#include "SceneSystems.h"
 using json = nlohmann::json;
 
 struct Drawable
@@ -48,21 +49,72 @@ public:
         return true;
     }
     static bool InitializeModelData( ID3D11DeviceContext* context, ID3D11Device* device,
-        ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, std::vector<RenderableGameObject>& renderables )
+        ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, World& scene, std::vector<Entity>& entities, ModelLoader& loader )
     {
+        // show placeholders straight away, real models are swapped in as the loader completes them
+        std::vector<std::string> files;
+        entities.reserve( entities.size() + drawables.size() );
         for ( unsigned int i = 0; i < drawables.size(); i++ )
         {
-            RenderableGameObject model;
-            model.SetInitialScale( drawables[i].scale.x, drawables[i].scale.y, drawables[i].scale.z );
-            if ( !model.Initialize( "res\\models\\" + drawables[i].fileName, device, context, cb_vs_matrix ) )
+            std::vector<MeshData> placeholder = { ModelLoader::GetPlaceholderMeshData() };
+            XMStoreFloat4x4( &placeholder[0].transformMatrix, XMMatrixScaling(
+                1.0f / drawables[i].scale.x, 1.0f / drawables[i].scale.y, 1.0f / drawables[i].scale.z ) );
+
+            std::shared_ptr<Model> model = std::make_shared<Model>();
+            if ( !model->Initialize( placeholder, device, context, cb_vs_matrix ) )
                 return false;
-            model.SetInitialPosition( drawables[i].position );
-            model.SetInitialRotation( drawables[i].rotation );
-            model.SetModelName( drawables[i].modelName );
-            renderables.push_back( model );
+
+            const Entity entity = scene.Create();
+            Transform& transform = scene.Add<Transform>( entity );
+            transform.SetInitialScale( drawables[i].scale.x, drawables[i].scale.y, drawables[i].scale.z );
+            transform.SetInitialPosition( drawables[i].position );
+            transform.SetInitialRotation( drawables[i].rotation );
+            scene.Add<Name>( entity ).value = drawables[i].modelName;
+            scene.Add<MeshRenderer>( entity ).model = model;
+            scene.Add<Bounds>( entity ).local = model->GetBoundingBox();
+            scene.Add<Lod>( entity );
+            scene.Add<Collider>( entity );
+            entities.push_back( entity );
+            files.push_back( "res\\models\\" + drawables[i].fileName );
         }
+        loader.Start( files, ModelLoader::GetDefaultThreadCount() );
         return true;
     }
+    static void UpdateModelData( ModelLoader& loader, World& scene, const std::vector<Entity>& entities )
+    {
+        // buffer creation stays on the device thread
+        std::vector<LoadedModel> completed;
+        if ( !loader.GetCompleted( completed ) )
+            return;
+
+        for ( unsigned int i = 0; i < completed.size(); i++ )
+        {
+            if ( !completed[i].success )
+            {
+                ErrorLogger::Log( "Failed to load model: " + completed[i].filePath );
+                continue;
+            }
+            for ( unsigned int j = 0; j < completed[i].indices.size(); j++ )
+            {
+                if ( completed[i].indices[j] >= entities.size() )
+                    continue;
+                const Entity entity = entities[completed[i].indices[j]];
+                MeshRenderer* renderer = scene.Get<MeshRenderer>( entity );
+                if ( renderer == nullptr || !renderer->model->SwapMeshes( completed[i].meshData ) )
+                    continue;
+                if ( Lod* lod = scene.Get<Lod>( entity ) )
+                    *lod = Lod();
+                if ( Bounds* bounds = scene.Get<Bounds>( entity ) )
+                {
+                    bounds->local = renderer->model->GetBoundingBox();
+                    bounds->version = 0;
+                }
+            }
+        }
+
+        // drop textures only the placeholders were using
+        TextureCache::ReleaseUnused();
+    }
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include "ModelLoader.h"
+#include "Model.h"
+#include "TextureCache.h"
+#include "../utility/Timer.h"
+#include <algorithm>
+#include <filesystem>
+
+ModelLoader::~ModelLoader()
+{
+	Stop();
+}
+
+void ModelLoader::Start( const std::vector<std::string>& files, UINT threadCount, bool useCache )
+{
+	Stop();
+	this->useCache = useCache;
+	stopping = false;
+	loadedCount = 0;
+	completed.clear();
+	pending.clear();
+
+	// each file is only loaded once, however many drawables use it
+	for ( UINT i = 0; i < files.size(); i++ )
+	{
+		auto it = std::find_if( pending.begin(), pending.end(),
+			[&files, i]( const LoadedModel& model ) { return model.filePath == files[i]; } );
+		if ( it != pending.end() )
+		{
+			it->indices.push_back( i );
+			continue;
+		}
+		LoadedModel model;
+		model.filePath = files[i];
+		model.indices.push_back( i );
+		pending.push_back( std::move( model ) );
+	}
+	totalCount = static_cast<UINT>( pending.size() );
+
+	// workers take from the back, so the largest files start first
+	std::vector<std::pair<uintmax_t, size_t>> sizes;
+	for ( size_t i = 0; i < pending.size(); i++ )
+	{
+		std::error_code error;
+		uintmax_t size = std::filesystem::file_size( pending[i].filePath, error );
+		sizes.emplace_back( error ? 0 : size, i );
+	}
+	std::sort( sizes.begin(), sizes.end() );
+	std::vector<LoadedModel> sorted;
+	sorted.reserve( pending.size() );
+	for ( size_t i = 0; i < sizes.size(); i++ )
+		sorted.push_back( std::move( pending[sizes[i].second] ) );
+	pending.swap( sorted );
+
+	threadCount = std::clamp( threadCount, 1u, std::max( totalCount, 1u ) );
+	for ( UINT i = 0; i < threadCount; i++ )
+		workers.emplace_back( &ModelLoader::WorkerThread, this );
+}
+
+void ModelLoader::Stop()
+{
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		stopping = true;
+		pending.clear();
+	}
+	condition.notify_all();
+	for ( unsigned int i = 0; i < workers.size(); i++ )
+		workers[i].join();
+	workers.clear();
+}
+
+bool ModelLoader::GetCompleted( std::vector<LoadedModel>& completed )
+{
+	std::lock_guard<std::mutex> lock( mutex );
+	if ( this->completed.empty() )
+		return false;
+	for ( unsigned int i = 0; i < this->completed.size(); i++ )
+		completed.push_back( std::move( this->completed[i] ) );
+	this->completed.clear();
+	return true;
+}
+
+bool ModelLoader::IsFinished() const noexcept
+{
+	return loadedCount == totalCount;
+}
+
+UINT ModelLoader::GetLoadedCount() const noexcept
+{
+	return loadedCount;
+}
+
+UINT ModelLoader::GetTotalCount() const noexcept
+{
+	return totalCount;
+}
+
+UINT ModelLoader::GetThreadCount() const noexcept
+{
+	return static_cast<UINT>( workers.size() );
+}
+
+UINT ModelLoader::GetDefaultThreadCount() noexcept
+{
+	// leave a core for the device thread
+	UINT cores = std::thread::hardware_concurrency();
+	return cores > 1 ? cores - 1 : 1;
+}
+
+MeshData ModelLoader::GetPlaceholderMeshData()
+{
+	// unit cube shown until the real model has been loaded
+	static const XMFLOAT3 normals[6] = {
+		{ 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f }, { -1.0f, 0.0f, 0.0f },
+		{ 1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f }, { 0.0f, -1.0f, 0.0f }
+	};
+
+	MeshData meshData;
+	for ( WORD i = 0; i < 6; i++ )
+	{
+		XMVECTOR normal = XMLoadFloat3( &normals[i] );
+		XMVECTOR up = fabsf( normals[i].y ) > 0.5f ? XMVectorSet( 0.0f, 0.0f, 1.0f, 0.0f ) : XMVectorSet( 0.0f, 1.0f, 0.0f, 0.0f );
+		XMVECTOR right = XMVector3Cross( up, normal );
+		for ( int j = 0; j < 4; j++ )
+		{
+			float u = ( j & 1 ) ? 1.0f : 0.0f;
+			float v = ( j & 2 ) ? 1.0f : 0.0f;
+			Vertex3D vertex;
+			XMStoreFloat3( &vertex.pos, ( normal + right * ( u * 2.0f - 1.0f ) - up * ( v * 2.0f - 1.0f ) ) * 0.5f );
+			vertex.texCoord = { u, v };
+			vertex.normals = normals[i];
+			meshData.vertices.push_back( vertex );
+		}
+		const WORD base = i * 4;
+		meshData.indices.insert( meshData.indices.end(), { base, WORD( base + 1 ), WORD( base + 2 ), WORD( base + 2 ), WORD( base + 1 ), WORD( base + 3 ) } );
+	}
+
+	MaterialTexture texture;
+	texture.type = aiTextureType_DIFFUSE;
+	meshData.textures.push_back( texture );
+	XMStoreFloat4x4( &meshData.transformMatrix, XMMatrixIdentity() );
+	return meshData;
+}
+
+void ModelLoader::WorkerThread()
+{
+	// wic decoding needs com on this thread
+	HRESULT hr = CoInitializeEx( nullptr, COINIT_MULTITHREADED );
+
+	for ( ;; )
+	{
+		LoadedModel model;
+		{
+			std::unique_lock<std::mutex> lock( mutex );
+			if ( stopping || pending.empty() )
+				break;
+			model = std::move( pending.back() );
+			pending.pop_back();
+		}
+
+		LoadModel( model );
+
+		{
+			std::lock_guard<std::mutex> lock( mutex );
+			if ( stopping )
+				break;
+			completed.push_back( std::move( model ) );
+		}
+		loadedCount++;
+	}
+
+	if ( SUCCEEDED( hr ) )
+		CoUninitialize();
+}
+
+void ModelLoader::LoadModel( LoadedModel& model )
+{
+	Timer timer;
+	timer.Start();
+
+	Assimp::Importer importer;
+	model.cache = std::make_unique<ModelCache>();
+	model.success = Model::LoadMeshData( model.filePath, importer, *model.cache, model.meshData, useCache );
+
+	// picking structures are built here rather than on the main thread when the meshes are created
+	for ( unsigned int i = 0; i < model.meshData.size(); i++ )
+	{
+		auto triangleBVH = std::make_shared<TriangleBVH>();
+		triangleBVH->Build( model.meshData[i] );
+		model.meshData[i].triangleBVH = triangleBVH;
+	}
+
+	// decode images here, embedded data owned by the importer is released on return
+	for ( unsigned int i = 0; i < model.meshData.size(); i++ )
+	{
+		for ( unsigned int j = 0; j < model.meshData[i].textures.size(); j++ )
+		{
+			// textures already resident are shared rather than decoded again
+			MaterialTexture& texture = model.meshData[i].textures[j];
+			texture.cacheKey = TextureCache::GetKey( texture );
+			if ( texture.storageType == TextureStorageType::Disk && StringConverter::GetFileExtension( texture.filePath ) == "dds" )
+				continue;
+			if ( !TextureCache::Contains( texture.cacheKey ) && !Texture::Decode( texture ) &&
+				texture.storageType != TextureStorageType::None )
+			{
+				texture.storageType = TextureStorageType::None;
+				texture.colour = Colours::UnloadedTextureColour;
+			}
+			texture.pData = nullptr;
+			texture.size = 0;
+		}
+	}
+
+	model.loadTime = timer.GetMilliSecondsElapsed();
+}
\ No newline at end of file
@@ -0,0 +1,57 @@
+#pragma once
+#ifndef MODELLOADER_H
+#define MODELLOADER_H
+
+#include "ModelCache.h"
+#include <mutex>
+#include <atomic>
+#include <memory>
+#include <thread>
+#include <condition_variable>
+
+// cpu-side result of loading one model file, shared by every drawable that uses it
+struct LoadedModel
+{
+	std::string filePath;
+	std::vector<UINT> indices;
+	std::vector<MeshData> meshData;
+	std::unique_ptr<ModelCache> cache;
+	bool success = false;
+	double loadTime = 0.0;
+};
+
+// loads models on a pool of worker threads
+// assimp import, vertex conversion, cache writes and image decoding all happen on the workers,
+// completed models are collected on the device thread where their buffers are created
+class ModelLoader
+{
+public:
+	ModelLoader() = default;
+	ModelLoader( const ModelLoader& ) = delete;
+	ModelLoader& operator=( const ModelLoader& ) = delete;
+	~ModelLoader();
+	void Start( const std::vector<std::string>& files, UINT threadCount, bool useCache = true );
+	void Stop();
+	bool GetCompleted( std::vector<LoadedModel>& completed );
+	bool IsFinished() const noexcept;
+	UINT GetLoadedCount() const noexcept;
+	UINT GetTotalCount() const noexcept;
+	UINT GetThreadCount() const noexcept;
+	static UINT GetDefaultThreadCount() noexcept;
+	static MeshData GetPlaceholderMeshData();
+private:
+	void WorkerThread();
+	void LoadModel( LoadedModel& model );
+private:
+	bool useCache = true;
+	bool stopping = false;
+	UINT totalCount = 0;
+	std::atomic<UINT> loadedCount = 0;
+	std::vector<LoadedModel> pending;
+	std::vector<LoadedModel> completed;
+	std::vector<std::thread> workers;
+	std::condition_variable condition;
+	mutable std::mutex mutex;
+};
+
+#endif
\ No newline at end of file
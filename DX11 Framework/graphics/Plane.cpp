@@ -25,11 +25,10 @@ bool Plane::Initialize( ID3D11DeviceContext* context, ID3D11Device* device )
         COM_ERROR_IF_FAILED( hr, "Failed to create quad vertex buffer!" );
         hr = ib_plane.Initialize( device, indicesQuad, ARRAYSIZE( indicesQuad ) );
         COM_ERROR_IF_FAILED( hr, "Failed to create quad index buffer!" );
-
         SetPosition( XMFLOAT3( 0.0f, 0.0f, 0.0f ) );
         SetRotation( XMFLOAT3( 0.0f, 0.0f, 0.0f ) );
         SetScale( 1.0f, 1.0f );
-        UpdateMatrix();
+        ResolveTransform();
     }
     catch ( COMException& exception )
     {
@@ -43,27 +42,85 @@ bool Plane::Initialize( ID3D11DeviceContext* context, ID3D11Device* device )
 void Plane::Draw( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, ID3D11ShaderResourceView* texture ) noexcept
 {
     UINT offset = 0;
-    context->IASetVertexBuffers( 0, 1, vb_plane.GetAddressOf(), vb_plane.StridePtr(), &offset );
-    context->IASetIndexBuffer( ib_plane.Get(), DXGI_FORMAT_R16_UINT, 0 );
-    context->PSSetShaderResources( 0, 1, &texture );
+    StateCache& stateCache = StateCache::Get( context );
+    stateCache.SetVertexBuffers( 0, 1, vb_plane.GetAddressOf(), vb_plane.StridePtr(), &offset );
+    stateCache.SetIndexBuffer( ib_plane.Get(), ib_plane.Format(), 0 );
+    stateCache.SetPSShaderResource( 0, texture );
     cb_vs_matrix.data.worldMatrix = XMMatrixIdentity() * worldMatrix;
     if ( !cb_vs_matrix.ApplyChanges() ) return;
-    context->VSSetConstantBuffers( 0, 1, cb_vs_matrix.GetAddressOf() );
-    context->DrawIndexed( ib_plane.IndexCount(), 0, 0 );
+    cb_vs_matrix.BindVS( 0 );
+    stateCache.DrawIndexed( ib_plane.IndexCount(), 0, 0 );
+}
+
+void Plane::UpdateMatrix()
+{
+    worldMatrix = GetTransformMatrix();
+    UpdateDirectionVectors();
 }
 
 /// INSTANCED PLANE
+bool TileLayout::operator==( const TileLayout& other ) const noexcept
+{
+    return tileSize == other.tileSize && tileOffset == other.tileOffset &&
+        worldOffsetX == other.worldOffsetX && worldOffsetY == other.worldOffsetY && tileCount == other.tileCount;
+}
+
+bool TileLayout::operator!=( const TileLayout& other ) const noexcept
+{
+    return !( *this == other );
+}
+
 bool PlaneInstanced::InitializeInstanced( ID3D11DeviceContext* context, ID3D11Device* device, int planeAmount )
 {
     this->context = context;
     this->planeAmount = planeAmount;
 
+    localBoundingBox = BoundingBox( XMFLOAT3( 0.0f, 0.0f, 0.0f ), XMFLOAT3( 3.0f, 3.0f, 0.0f ) );
+    XMFLOAT4X4 identity;
+    XMStoreFloat4x4( &identity, XMMatrixIdentity() );
+    worldMatrices.assign( planeAmount, identity );
+    tileBounds.assign( planeAmount, localBoundingBox );
+    tileCulling.Clear();
+    for ( int i = 0; i < planeAmount; i++ )
+        tileCulling.Add( localBoundingBox );
+    for ( TileView& tileView : tileViews )
+    {
+        tileView.visibility.resize( planeAmount );
+        tileView.visibleTiles.reserve( planeAmount );
+    }
+    layout = TileLayout();
+
     try
     {
         HRESULT hr = vb_plane.Initialize( device, verticesQuad, ARRAYSIZE( verticesQuad ) );
         COM_ERROR_IF_FAILED( hr, "Failed to create instanced quad vertex buffer!" );
         hr = ib_plane.Initialize( device, indicesQuad, ARRAYSIZE( indicesQuad ) );
         COM_ERROR_IF_FAILED( hr, "Failed to create instanced quad index buffer!" );
+        for ( TileView& tileView : tileViews )
+        {
+            hr = tileView.vb_instances.Initialize( device, planeAmount );
+            COM_ERROR_IF_FAILED( hr, "Failed to create quad instance buffer!" );
+        }
+
+        D3D11_BUFFER_DESC matrixBufferDesc = { 0 };
+        matrixBufferDesc.Usage = D3D11_USAGE_DEFAULT;
+        matrixBufferDesc.ByteWidth = sizeof( XMFLOAT4X4 ) * planeAmount;
+        matrixBufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
+        matrixBufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
+        matrixBufferDesc.StructureByteStride = sizeof( XMFLOAT4X4 );
+
+        D3D11_SUBRESOURCE_DATA matrixBufferData = { 0 };
+        matrixBufferData.pSysMem = worldMatrices.data();
+        hr = device->CreateBuffer( &matrixBufferDesc, &matrixBufferData, matrixBuffer.GetAddressOf() );
+        COM_ERROR_IF_FAILED( hr, "Failed to create quad instance matrix buffer!" );
+
+        D3D11_SHADER_RESOURCE_VIEW_DESC matrixViewDesc = {};
+        matrixViewDesc.Format = DXGI_FORMAT_UNKNOWN;
+        matrixViewDesc.ViewDimension = D3D11_SRV_DIMENSION_BUFFER;
+        matrixViewDesc.Buffer.FirstElement = 0;
+        matrixViewDesc.Buffer.NumElements = planeAmount;
+        hr = device->CreateShaderResourceView( matrixBuffer.Get(), &matrixViewDesc, matrixBufferView.GetAddressOf() );
+        COM_ERROR_IF_FAILED( hr, "Failed to create quad instance matrix view!" );
     }
     catch ( COMException& exception )
     {
@@ -71,49 +128,118 @@ bool PlaneInstanced::InitializeInstanced( ID3D11DeviceContext* context, ID3D11De
         return false;
     }
 
-    for ( int i = 0; i < planeAmount; i++ )
-    {
-        XMFLOAT4X4 worldMatrix;
-        XMStoreFloat4x4( &worldMatrix, XMMatrixIdentity() );
-        worldMatrices.push_back( worldMatrix );
-    }
-
     return true;
 }
 
 void PlaneInstanced::DrawInstanced( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, ConstantBuffer<CB_PS_light>& cb_ps_light,
-    ID3D11ShaderResourceView* texture ) noexcept
+    ID3D11ShaderResourceView* texture, const Frustum& frustum, UINT viewIndex ) noexcept
 {
-	UINT offset = 0;
-    context->IASetVertexBuffers( 0, 1, vb_plane.GetAddressOf(), vb_plane.StridePtr(), &offset );
-    context->IASetIndexBuffer( ib_plane.Get(), DXGI_FORMAT_R16_UINT, 0 );
-    context->PSSetShaderResources( 0, 1, &texture );
+    TileView& tileView = tileViews[viewIndex];
+    if ( tileCulling.Cull( frustum, tileView.visibility.data() ) == 0 )
+        return;
+
+    // the indices of the visible tiles are the only per-view upload
+    tileView.visibleTiles.clear();
+    for ( int i = 0; i < planeAmount; i++ )
+        if ( tileView.visibility[i] != 0 )
+            tileView.visibleTiles.push_back( i );
+    StateCache& stateCache = StateCache::Get( context );
+    if ( FAILED( tileView.vb_instances.Update( stateCache.GetContext(), tileView.visibleTiles.data(), static_cast<UINT>( tileView.visibleTiles.size() ) ) ) )
+        return;
+
+    ID3D11Buffer* buffers[] = { vb_plane.Get(), tileView.vb_instances.Get() };
+    UINT strides[] = { vb_plane.Stride(), tileView.vb_instances.Stride() };
+    UINT offsets[] = { 0, 0 };
+    stateCache.SetVertexBuffers( 0, 2, buffers, strides, offsets );
+    stateCache.SetIndexBuffer( ib_plane.Get(), ib_plane.Format(), 0 );
+    stateCache.SetPSShaderResource( 0, texture );
+    stateCache.SetVSShaderResource( 0, matrixBufferView.Get() );
     cb_ps_light.data.useQuad = true;
     if ( !cb_ps_light.ApplyChanges() ) return;
-    context->PSSetConstantBuffers( 2, 1, cb_ps_light.GetAddressOf() );
-    for ( int i = 0; i < planeAmount; i++ )
-    {
-        cb_vs_matrix.data.worldMatrix = XMLoadFloat4x4( &worldMatrices[i] );
-        if ( !cb_vs_matrix.ApplyChanges() ) return;
-        context->VSSetConstantBuffers( 0, 1, cb_vs_matrix.GetAddressOf() );
-        context->DrawIndexed( ib_plane.IndexCount(), 0, 0 );
-    }
+    cb_ps_light.BindPS( 2 );
+    cb_vs_matrix.data.worldMatrix = XMMatrixIdentity();
+    if ( !cb_vs_matrix.ApplyChanges() ) return;
+    cb_vs_matrix.BindVS( 0 );
+    stateCache.DrawIndexedInstanced( ib_plane.IndexCount(), static_cast<UINT>( tileView.visibleTiles.size() ), 0, 0, 0 );
 }
 
 void PlaneInstanced::UpdateInstanced( int tileSize, int tileOffset, int worldOffsetX, int worldOffsetY ) noexcept
 {
-    int count = 0;
-    for ( int row = 0; row < sqrt( planeAmount ); row++ )
+    // tiles only move when the layout does
+    const TileLayout newLayout = { tileSize, tileOffset, worldOffsetX, worldOffsetY, planeAmount };
+    if ( newLayout == layout )
+        return;
+    layout = newLayout;
+
+    BuildTiles( layout, localBoundingBox, worldMatrices.data(), tileBounds.data() );
+    for ( int i = 0; i < planeAmount; i++ )
+        tileCulling.Set( i, tileBounds[i] );
+    context->UpdateSubresource( matrixBuffer.Get(), 0, nullptr, worldMatrices.data(), 0, 0 );
+}
+
+void PlaneInstanced::SetTexture( ID3D11ShaderResourceView* texture ) noexcept
+{
+    this->texture = texture;
+}
+
+// every tile goes out as one instanced packet, visible tiles are culled when it executes
+void PlaneInstanced::Submit( RenderQueue& queue, const RenderView& view, RenderPass pass )
+{
+    queue.Submit( pass, ShaderId::LitInstanced, queue.GetMaterialId( texture.Get() ), 0.0f, this );
+}
+
+void PlaneInstanced::ExecutePacket( const DrawPacket& packet, const RenderView& view )
+{
+    DrawInstanced( *view.cb_vs_matrix, *view.cb_ps_light, texture.Get(), view.frustum, view.index );
+}
+
+void PlaneInstanced::BuildTiles( const TileLayout& layout, const BoundingBox& localBounds,
+    XMFLOAT4X4* matrices, BoundingBox* bounds ) noexcept
+{
+    if ( layout.tileCount <= 0 )
+        return;
+
+    // every tile shares its scale and rotation, so only the translation differs between them
+    XMMATRIX tileMatrix = XMMatrixScaling( static_cast<float>( layout.tileSize ), static_cast<float>( layout.tileSize ), 0.0f ) *
+        XMMatrixRotationX( XMConvertToRadians( 90.0f ) );
+    BoundingBox tileBox;
+    localBounds.Transform( tileBox, tileMatrix );
+
+    // tile i sits at row i / side and column i % side, positions are computed four tiles at a time
+    const int side = static_cast<int>( ceil( sqrt( static_cast<double>( layout.tileCount ) ) ) );
+    const float spacing = static_cast<float>( layout.tileOffset * layout.tileSize );
+    const XMVECTOR step = XMVectorReplicate( spacing );
+    const XMVECTOR originX = XMVectorReplicate( static_cast<float>( layout.worldOffsetX + layout.worldOffsetY * layout.tileSize ) );
+    const XMVECTOR originZ = XMVectorReplicate( static_cast<float>( layout.worldOffsetY * layout.tileSize ) );
+    const XMVECTOR height = XMVectorReplicate( TILE_HEIGHT );
+    const XMVECTOR boxCenter = XMLoadFloat3( &tileBox.Center );
+    for ( int i = 0; i < layout.tileCount; i += 4 )
     {
-        for ( int col = 0; col < sqrt( planeAmount ); col++ )
+        const XMVECTOR rows = XMVectorSet( static_cast<float>( i / side ), static_cast<float>( ( i + 1 ) / side ),
+            static_cast<float>( ( i + 2 ) / side ), static_cast<float>( ( i + 3 ) / side ) );
+        const XMVECTOR cols = XMVectorSet( static_cast<float>( i % side ), static_cast<float>( ( i + 1 ) % side ),
+            static_cast<float>( ( i + 2 ) % side ), static_cast<float>( ( i + 3 ) % side ) );
+        const XMVECTOR x = XMVectorMultiplyAdd( rows, step, -originX );
+        const XMVECTOR z = XMVectorMultiplyAdd( cols, step, -originZ );
+
+        // transpose the x, y and z lanes into one translation per tile
+        const XMVECTOR xy0 = XMVectorMergeXY( x, height );
+        const XMVECTOR xy1 = XMVectorMergeZW( x, height );
+        const XMVECTOR zw0 = XMVectorMergeXY( z, g_XMOne );
+        const XMVECTOR zw1 = XMVectorMergeZW( z, g_XMOne );
+        const XMVECTOR translations[4] = {
+            XMVectorPermute<0, 1, 4, 5>( xy0, zw0 ),
+            XMVectorPermute<2, 3, 6, 7>( xy0, zw0 ),
+            XMVectorPermute<0, 1, 4, 5>( xy1, zw1 ),
+            XMVectorPermute<2, 3, 6, 7>( xy1, zw1 )
+        };
+
+        for ( int k = 0; k < 4 && i + k < layout.tileCount; k++ )
         {
-            XMStoreFloat4x4( &worldMatrices[count],
-                XMMatrixScaling( tileSize, tileSize, 0.0f ) *
-                XMMatrixRotationX( XMConvertToRadians( 90.0f ) ) *
-                XMMatrixTranslation(
-                    ( row * tileOffset * tileSize ) - ( worldOffsetX + worldOffsetY * tileSize ),
-                    4.7f, ( col * tileOffset * tileSize ) - worldOffsetY * tileSize ) );
-            count++;
+            tileMatrix.r[3] = translations[k];
+            XMStoreFloat4x4( &matrices[i + k], tileMatrix );
+            XMStoreFloat3( &bounds[i + k].Center, XMVectorAdd( boxCenter, translations[k] ) );
+            bounds[i + k].Extents = tileBox.Extents;
         }
     }
 }
@@ -157,9 +283,11 @@ void PlaneFullscreen::SetupBuffers( VertexShader& vs_full, PixelShader& ps_full,
 {
     UINT offset = 0;
     Shaders::BindShaders( context, vs_full, ps_full );
-    context->IASetVertexBuffers( 0, 1, vb_full.GetAddressOf(), vb_full.StridePtr(), &offset );
-    context->IASetIndexBuffer( ib_full.Get(), DXGI_FORMAT_R16_UINT, 0 );
+    StateCache& stateCache = StateCache::Get( context );
+    stateCache.SetVertexBuffers( 0, 1, vb_full.GetAddressOf(), vb_full.StridePtr(), &offset );
+    stateCache.SetIndexBuffer( ib_full.Get(), ib_full.Format(), 0 );
     cb_vs_full.data.multiView = multiView;
     if ( !cb_vs_full.ApplyChanges() ) return;
-    context->VSSetConstantBuffers( 0, 1, cb_vs_full.GetAddressOf() );
+    cb_vs_full.BindVS( 0 );
+    cb_vs_full.BindPS( 0 );
 }
\ No newline at end of file
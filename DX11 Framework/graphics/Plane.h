@@ -3,41 +3,80 @@
 #define PLANE_H
 
 #include "Shaders.h"
-#include "RenderableGameObject.h"
+#include "Culling.h"
+#include "RenderQueue.h"
+#include "GameObject3D.h"
 
-class Plane : public RenderableGameObject
+class Plane : public GameObject3D
 {
 public:
 	bool Initialize( ID3D11DeviceContext* context, ID3D11Device* device );
 	void Draw( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, ID3D11ShaderResourceView* texture ) noexcept;
 private:
+	void UpdateMatrix() override;
 	ID3D11DeviceContext* context;
+	XMMATRIX worldMatrix = XMMatrixIdentity();
 	VertexBuffer<Vertex3D> vb_plane;
-	IndexBuffer ib_plane;
+	IndexBuffer<WORD> ib_plane;
 };
 
-class PlaneInstanced : public RenderableGameObject
+// placement of the instanced ground tiles, laid out row by row in a square grid
+struct TileLayout
+{
+	int tileSize = 0;
+	int tileOffset = 0;
+	int worldOffsetX = 0;
+	int worldOffsetY = 0;
+	int tileCount = 0;
+	bool operator==( const TileLayout& other ) const noexcept;
+	bool operator!=( const TileLayout& other ) const noexcept;
+};
+
+// every visible tile is drawn with one DrawIndexedInstanced
+// tile world matrices live in a structured buffer written only when the tile layout changes,
+// the per-instance stream holds the indices of the tiles that survived culling, one stream per view
+class PlaneInstanced : public PacketSource
 {
 public:
 	bool InitializeInstanced( ID3D11DeviceContext* context, ID3D11Device* device, int planeAmount );
 	void DrawInstanced( ConstantBuffer<CB_VS_matrix>& cb_vs_matrix, ConstantBuffer<CB_PS_light>& cb_ps_light,
-		ID3D11ShaderResourceView* texture ) noexcept;
+		ID3D11ShaderResourceView* texture, const Frustum& frustum, UINT viewIndex = 0 ) noexcept;
 	void UpdateInstanced( int tileSize, int tileOffset, int worldOffsetX, int worldOffsetY ) noexcept;
+	void SetTexture( ID3D11ShaderResourceView* texture ) noexcept;
+	void Submit( RenderQueue& queue, const RenderView& view, RenderPass pass );
+	void ExecutePacket( const DrawPacket& packet, const RenderView& view ) override;
+	static void BuildTiles( const TileLayout& layout, const DirectX::BoundingBox& localBounds,
+		XMFLOAT4X4* matrices, DirectX::BoundingBox* bounds ) noexcept;
+	static constexpr float TILE_HEIGHT = 4.7f;
 private:
 	ID3D11DeviceContext* context;
 	std::vector<XMFLOAT4X4> worldMatrices;
+	std::vector<DirectX::BoundingBox> tileBounds;
+	struct TileView
+	{
+		std::vector<BYTE> visibility;
+		std::vector<UINT> visibleTiles;
+		VertexBuffer<UINT> vb_instances;
+	};
+	TileView tileViews[RenderView::MAX_VIEWS];
+	CullingBatch tileCulling;
 	VertexBuffer<Vertex3D> vb_plane;
-	IndexBuffer ib_plane;
+	IndexBuffer<WORD> ib_plane;
+	Microsoft::WRL::ComPtr<ID3D11Buffer> matrixBuffer;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> matrixBufferView;
 	int planeAmount;
+	TileLayout layout;
+	DirectX::BoundingBox localBoundingBox;
+	Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> texture;
 };
 
-class PlaneFullscreen : public RenderableGameObject
+class PlaneFullscreen
 {
 public:
 	bool Initialize( ID3D11DeviceContext* context, ID3D11Device* device );
 	void SetupBuffers( VertexShader& vs_full, PixelShader& ps_full, ConstantBuffer<CB_VS_fullscreen>& cb_vs_full, bool& multiView ) noexcept;
 public:
-	IndexBuffer ib_full;
+	IndexBuffer<WORD> ib_full;
 private:
 	ID3D11DeviceContext* context;
 	VertexBuffer<Vertex_Pos> vb_full;
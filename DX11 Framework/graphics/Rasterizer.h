@@ -46,19 +46,19 @@ namespace Bind
 		}
 		void Bind( Graphics& gfx ) noexcept override
 		{
-			GetContext( gfx )->RSSetState( pRasterizer.Get() );
+			GetStateCache( gfx ).SetRasterizerState( pRasterizer.Get() );
 		}
 		static void DrawSolid( Graphics& gfx, UINT indexCount ) noexcept
 		{
 			Microsoft::WRL::ComPtr<ID3D11RasterizerState> pRasterizer_Solid;
-			GetContext( gfx )->RSSetState( pRasterizer_Solid.Get() );
-			GetContext( gfx )->DrawIndexed( indexCount, 0, 0 );
+			GetStateCache( gfx ).SetRasterizerState( pRasterizer_Solid.Get() );
+			GetStateCache( gfx ).DrawIndexed( indexCount, 0, 0 );
 		}
 		static void DrawWireframe( Graphics& gfx, UINT indexCount ) noexcept
 		{
 			Microsoft::WRL::ComPtr<ID3D11RasterizerState> pRasterizer_Wireframe;
-			GetContext( gfx )->RSSetState( pRasterizer_Wireframe.Get() );
-			GetContext( gfx )->DrawIndexed( indexCount, 0, 0 );
+			GetStateCache( gfx ).SetRasterizerState( pRasterizer_Wireframe.Get() );
+			GetStateCache( gfx ).DrawIndexed( indexCount, 0, 0 );
 		}
 	private:
 		bool isSolid;
@@ -0,0 +1,153 @@
+#include "RenderQueue.h"
+#include <algorithm>
+#include <cstring>
+
+void RenderQueue::SetShaders( ShaderId id, VertexShader& vs, PixelShader& ps ) noexcept
+{
+	shaders[static_cast<UINT>( id )] = { &vs, &ps };
+}
+
+UINT RenderQueue::GetMaterialId( const void* material )
+{
+	// ids are handed out in first-seen order and kept, so a material sorts the same way every frame
+	auto it = materialIds.find( material );
+	if ( it != materialIds.end() )
+		return it->second;
+	const UINT id = static_cast<UINT>( materialIds.size() ) & MATERIAL_MASK;
+	materialIds.emplace( material, id );
+	return id;
+}
+
+void RenderQueue::Clear() noexcept
+{
+	packets.clear();
+}
+
+void RenderQueue::Submit( RenderPass pass, ShaderId shader, UINT material, float depth, PacketSource* source, UINT index,
+	const XMFLOAT4X4* worldMatrix, UINT lod )
+{
+	DrawPacket packet;
+	packet.key = MakeKey( pass, shader, material, depth );
+	packet.source = source;
+	packet.index = index;
+	packet.lod = lod;
+	packet.worldMatrix = worldMatrix;
+	packets.push_back( packet );
+}
+
+void RenderQueue::Sort()
+{
+	entries.resize( packets.size() );
+	for ( UINT i = 0; i < packets.size(); i++ )
+		entries[i] = { packets[i].key, i };
+	RadixSort( entries, scratch );
+}
+
+void RenderQueue::Execute( ID3D11DeviceContext* context, const RenderView& view )
+{
+	UINT currentShader = UINT_MAX;
+	UINT currentMaterial = UINT_MAX;
+	for ( UINT i = 0; i < entries.size(); i++ )
+	{
+		const DrawPacket& packet = packets[entries[i].index];
+		const UINT shader = static_cast<UINT>( packet.key >> SHADER_SHIFT ) & 0xFFu;
+		const UINT material = static_cast<UINT>( packet.key >> MATERIAL_SHIFT ) & MATERIAL_MASK;
+		if ( shader != currentShader )
+		{
+			currentShader = shader;
+			Statistics::Local().shaderChangeCount++;
+			Shaders::BindShaders( context, *shaders[shader].vs, *shaders[shader].ps );
+		}
+		if ( material != currentMaterial )
+		{
+			currentMaterial = material;
+			Statistics::Local().materialChangeCount++;
+		}
+		packet.source->ExecutePacket( packet, view );
+	}
+	Statistics::Local().packetCount += static_cast<UINT>( entries.size() );
+}
+
+UINT RenderQueue::GetCount() const noexcept
+{
+	return static_cast<UINT>( packets.size() );
+}
+
+// packets in execution order, valid after Sort
+const DrawPacket& RenderQueue::GetSortedPacket( UINT index ) const noexcept
+{
+	return packets[entries[index].index];
+}
+
+UINT64 RenderQueue::MakeKey( RenderPass pass, ShaderId shader, UINT material, float depth ) noexcept
+{
+	depth = std::max( depth, 0.0f );
+	UINT depthBits;
+	std::memcpy( &depthBits, &depth, sizeof( depthBits ) );
+	return static_cast<UINT64>( pass ) << PASS_SHIFT |
+		static_cast<UINT64>( shader ) << SHADER_SHIFT |
+		static_cast<UINT64>( material & MATERIAL_MASK ) << MATERIAL_SHIFT |
+		depthBits;
+}
+
+float RenderQueue::GetViewDepth( const XMMATRIX& viewMatrix, const XMFLOAT3& position ) noexcept
+{
+	return XMVectorGetZ( XMVector3TransformCoord( XMLoadFloat3( &position ), viewMatrix ) );
+}
+
+void RenderQueue::RadixSort( std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch )
+{
+	const size_t count = entries.size();
+	if ( count < 2 )
+		return;
+	scratch.resize( count );
+
+	// one pass over the keys builds the histogram of every byte
+	UINT histograms[8][256] = {};
+	for ( size_t i = 0; i < count; i++ )
+	{
+		const UINT64 key = entries[i].key;
+		for ( UINT byte = 0; byte < 8; byte++ )
+			histograms[byte][( key >> ( byte * 8u ) ) & 0xFFu]++;
+	}
+
+	// least significant byte first, a byte every key shares can't change the order and is skipped
+	SortEntry* source = entries.data();
+	SortEntry* destination = scratch.data();
+	for ( UINT byte = 0; byte < 8; byte++ )
+	{
+		UINT* histogram = histograms[byte];
+		const UINT shift = byte * 8u;
+		if ( histogram[( source[0].key >> shift ) & 0xFFu] == count )
+			continue;
+
+		UINT offset = 0;
+		for ( UINT bucket = 0; bucket < 256; bucket++ )
+		{
+			const UINT bucketCount = histogram[bucket];
+			histogram[bucket] = offset;
+			offset += bucketCount;
+		}
+		for ( size_t i = 0; i < count; i++ )
+			destination[histogram[( source[i].key >> shift ) & 0xFFu]++] = source[i];
+		std::swap( source, destination );
+	}
+
+	if ( source != entries.data() )
+		entries.swap( scratch );
+}
+
+RenderQueueStatistics RenderQueue::GetStatistics()
+{
+	return Statistics::Get();
+}
+
+void RenderQueue::FoldStatistics()
+{
+	Statistics::Fold();
+}
+
+void RenderQueue::ResetStatistics()
+{
+	Statistics::Reset();
+}
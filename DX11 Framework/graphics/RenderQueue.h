@@ -0,0 +1,123 @@
+#pragma once
+#ifndef RENDERQUEUE_H
+#define RENDERQUEUE_H
+
+#include "Shaders.h"
+#include "Culling.h"
+#include "ConstantBuffer.h"
+#include <unordered_map>
+#include <vector>
+
+// passes execute in this order, every packet of one pass is drawn before the next begins
+enum class RenderPass : UINT
+{
+	Opaque,
+	Flat,
+	Unlit,
+	Count
+};
+
+// shader pairs a packet can ask for, registered once by Graphics
+enum class ShaderId : UINT
+{
+	Lit,
+	LitQuantized,
+	LitInstanced,
+	Unlit,
+	UnlitQuantized,
+	Count
+};
+
+// everything a packet needs to draw itself into one view
+// views may be recorded on different threads, so per-view object state is indexed by the view
+struct RenderView
+{
+	static constexpr UINT MAX_VIEWS = 4u;
+	UINT index = 0;
+	XMMATRIX viewMatrix;
+	XMMATRIX projectionMatrix;
+	Frustum frustum;
+	ConstantBuffer<CB_VS_matrix>* cb_vs_matrix = nullptr;
+	ConstantBuffer<CB_PS_light>* cb_ps_light = nullptr;
+};
+
+struct DrawPacket;
+
+// anything that can draw the packets it submitted, the packet carries everything that differs between them
+class PacketSource
+{
+public:
+	virtual ~PacketSource() = default;
+	virtual void ExecutePacket( const DrawPacket& packet, const RenderView& view ) = 0;
+};
+
+// key bits from most to least significant: pass 4 | shader 8 | material 20 | depth 32
+// depth is the view space distance as float bits, which sort like the floats themselves while positive
+// the world matrix and level of detail are read when the packet executes, so they must outlive the queue's execution
+struct DrawPacket
+{
+	UINT64 key = 0;
+	PacketSource* source = nullptr;
+	UINT index = 0;
+	UINT lod = 0;
+	const XMFLOAT4X4* worldMatrix = nullptr;
+};
+
+struct RenderQueueStatistics
+{
+	UINT packetCount = 0;
+	UINT shaderChangeCount = 0;
+	UINT materialChangeCount = 0;
+	RenderQueueStatistics& operator+=( const RenderQueueStatistics& other ) noexcept
+	{
+		packetCount += other.packetCount;
+		shaderChangeCount += other.shaderChangeCount;
+		materialChangeCount += other.materialChangeCount;
+		return *this;
+	}
+};
+
+// draws of one view, sorted by key to group shader and material changes and draw opaque geometry front to back
+class RenderQueue
+{
+public:
+	struct SortEntry
+	{
+		UINT64 key;
+		UINT index;
+	};
+	static constexpr UINT PASS_SHIFT = 60u;
+	static constexpr UINT SHADER_SHIFT = 52u;
+	static constexpr UINT MATERIAL_SHIFT = 32u;
+	static constexpr UINT MATERIAL_MASK = ( 1u << 20u ) - 1u;
+
+	void SetShaders( ShaderId id, VertexShader& vs, PixelShader& ps ) noexcept;
+	UINT GetMaterialId( const void* material );
+	void Clear() noexcept;
+	void Submit( RenderPass pass, ShaderId shader, UINT material, float depth, PacketSource* source, UINT index = 0,
+		const XMFLOAT4X4* worldMatrix = nullptr, UINT lod = 0 );
+	void Sort();
+	void Execute( ID3D11DeviceContext* context, const RenderView& view );
+	UINT GetCount() const noexcept;
+	const DrawPacket& GetSortedPacket( UINT index ) const noexcept;
+	static UINT64 MakeKey( RenderPass pass, ShaderId shader, UINT material, float depth ) noexcept;
+	static float GetViewDepth( const XMMATRIX& viewMatrix, const XMFLOAT3& position ) noexcept;
+	static void RadixSort( std::vector<SortEntry>& entries, std::vector<SortEntry>& scratch );
+	static RenderQueueStatistics GetStatistics();
+	static void FoldStatistics();
+	static void ResetStatistics();
+private:
+	struct ShaderPair
+	{
+		VertexShader* vs = nullptr;
+		PixelShader* ps = nullptr;
+	};
+	ShaderPair shaders[static_cast<UINT>( ShaderId::Count )];
+	std::unordered_map<const void*, UINT> materialIds;
+	std::vector<DrawPacket> packets;
+	std::vector<SortEntry> entries;
+	std::vector<SortEntry> scratch;
+	using Statistics = ThreadStatistics<RenderQueueStatistics>;
+};
+
+#endif
@@ -72,22 +72,25 @@ namespace Bind
 			}
 		}
 		void Bind( Graphics& gfx ) noexcept override {}
-		void BindAsBuffer( Graphics& gfx, float clearColor[4] ) noexcept
+		// binding never clears, the frame graph decides which targets need it
+		void BindAsBuffer( Graphics& gfx ) noexcept
 		{
 			GetContext( gfx )->OMSetRenderTargets( 1, backBuffer.GetAddressOf(), nullptr );
-			GetContext( gfx )->ClearRenderTargetView( backBuffer.Get(), clearColor );
 		}
-		void BindAsTexture( Graphics& gfx, DepthStencil* depthStencil, float clearColor[4] ) noexcept
+		void BindAsTexture( Graphics& gfx, DepthStencil* depthStencil ) noexcept
 		{
 			GetContext( gfx )->OMSetRenderTargets( 1, renderTargetView.GetAddressOf(), depthStencil->GetDepthStencilView() );
-			GetContext( gfx )->ClearRenderTargetView( renderTargetView.Get(), clearColor );
+		}
+		void Clear( Graphics& gfx, float clearColor[4] ) noexcept
+		{
+			GetContext( gfx )->ClearRenderTargetView( backBuffer ? backBuffer.Get() : renderTargetView.Get(), clearColor );
 		}
 		void BindAsNull( Graphics& gfx ) noexcept
 		{
 			Microsoft::WRL::ComPtr<ID3D11RenderTargetView> nullRenderTarget = nullptr;
 			GetContext( gfx )->OMSetRenderTargets( 1, nullRenderTarget.GetAddressOf(), nullptr );
 			Microsoft::WRL::ComPtr<ID3D11ShaderResourceView> nullShaderResourceView = nullptr;
-			GetContext( gfx )->PSSetShaderResources( 0, 1, nullShaderResourceView.GetAddressOf() );
+			GetStateCache( gfx ).SetPSShaderResource( 0, nullShaderResourceView.Get() );
 		}
 		ID3D11ShaderResourceView* GetShaderResourceView() noexcept
 		{
@@ -53,7 +53,7 @@ namespace Bind
 		}
 		void Bind( Graphics& gfx ) noexcept override
 		{
-			GetContext( gfx )->PSSetSamplers( slot, 1u, pSampler.GetAddressOf() );
+			GetStateCache( gfx ).SetPSSampler( slot, pSampler.Get() );
 		}
 	private:
 		Microsoft::WRL::ComPtr<ID3D11SamplerState> pSampler;
@@ -0,0 +1,302 @@
+#include "SceneSystems.h"
+#include "../utility/Structs.h"
+#include <algorithm>
+#include <cstdlib>
+
+void PointLight::ReadFrom( const CB_PS_light& data ) noexcept
+{
+	ambientColor = data.ambientLightColor;
+	ambientStrength = data.ambientLightStrength;
+	lightColor = data.dynamicLightColor;
+	lightStrength = data.dynamicLightStrength;
+	specularColor = data.specularLightColor;
+	specularIntensity = data.specularLightIntensity;
+	specularPower = data.specularLightPower;
+	constant = data.lightConstant;
+	linear = data.lightLinear;
+	quadratic = data.lightQuadratic;
+
+	directionalLightColor = data.directionalLightColor;
+	directionalLightPosition = data.directionalLightPosition;
+	directionalLightIntensity = data.directionalLightIntensity;
+	quadIntensity = data.quadIntensity;
+}
+
+void PointLight::WriteTo( CB_PS_light& data ) const noexcept
+{
+	data.ambientLightColor = ambientColor;
+	data.ambientLightStrength = ambientStrength;
+	data.dynamicLightColor = lightColor;
+	data.dynamicLightStrength = lightStrength;
+	data.specularLightColor = specularColor;
+	data.specularLightIntensity = specularIntensity;
+	data.specularLightPower = specularPower;
+	data.lightConstant = constant;
+	data.lightLinear = linear;
+	data.lightQuadratic = quadratic;
+
+	data.directionalLightColor = directionalLightColor;
+	data.directionalLightPosition = directionalLightPosition;
+	data.directionalLightIntensity = directionalLightIntensity;
+	data.quadIntensity = quadIntensity;
+}
+
+// runs before transforms are resolved, the rotations are batched with everything else that moved
+void SceneSystems::UpdateTransforms( World& scene, float dt )
+{
+	scene.Each<Transform, const Spin>( [dt]( Entity, Transform& transform, const Spin& spin )
+	{
+		transform.AdjustRotation( spin.rate.x * dt, spin.rate.y * dt, spin.rate.z * dt );
+	} );
+}
+
+void SceneSystems::UpdateTiles( World& scene )
+{
+	scene.Each<const TileGrid>( []( Entity, const TileGrid& grid )
+	{
+		grid.plane->UpdateInstanced( grid.tileSize, grid.tileOffset, grid.worldOffsetX, grid.worldOffsetY );
+	} );
+}
+
+// world bounds follow the resolved world matrices, only entities whose transform was rebuilt since are touched
+// also runs every query the render threads use, so their match lists are current before the views are recorded
+void SceneSystems::UpdateBounds( World& scene )
+{
+	UINT index = 0;
+	scene.Each<Bounds>( [&index]( Entity, Bounds& bounds )
+	{
+		bounds.index = index++;
+	} );
+
+	const TransformStore& store = GameObject::GetTransformStore();
+	scene.Each<const Transform, Bounds>( [&store]( Entity, const Transform& transform, Bounds& bounds )
+	{
+		const UINT64 version = store.GetVersion( transform.GetHandle() );
+		if ( version == bounds.version )
+			return;
+		bounds.version = version;
+		const XMMATRIX worldMatrix = XMLoadFloat4x4( &store.GetWorldMatrix( transform.GetHandle() ) );
+		BoundingSphere localSphere;
+		BoundingSphere::CreateFromBoundingBox( localSphere, bounds.local );
+		bounds.local.Transform( bounds.world, worldMatrix );
+		localSphere.Transform( bounds.sphere, worldMatrix );
+	} );
+
+	scene.Count<const Transform, const MeshRenderer, const Bounds, Lod>();
+	scene.Count<const Bounds, const PointLight>();
+	scene.Count<const TileGrid>();
+}
+
+// spheres only change cell in the broadphase when they cross into another
+void SceneSystems::UpdateColliders( World& scene, Broadphase& broadphase )
+{
+	scene.Each<const Bounds, Collider>( [&broadphase]( Entity, const Bounds& bounds, Collider& collider )
+	{
+		if ( collider.proxy == Broadphase::INVALID )
+			collider.proxy = broadphase.Add( bounds.sphere.Center, bounds.sphere.Radius );
+		else
+			broadphase.Move( collider.proxy, bounds.sphere.Center, bounds.sphere.Radius );
+	} );
+}
+
+// a light nobody holds falls back down to the ground, the flicker is shared by every light
+void SceneSystems::UpdateLights( World& scene, ConstantBuffer<CB_PS_light>& cb_ps_light, bool hidden )
+{
+	scene.Each<Transform, PointLight, MeshRenderer>( [&cb_ps_light, hidden]( Entity, Transform& transform, PointLight& pointLight, MeshRenderer& renderer )
+	{
+		if ( !lightParams.lightStuck )
+		{
+			if ( transform.GetPositionFloat3().y > 5.25f )
+			{
+				pointLight.fallSpeed += 0.1f;
+				transform.AdjustPosition( XMFLOAT3( 0.0f, -0.1f * pointLight.fallSpeed, 0.0f ) );
+			}
+			if ( transform.GetPositionFloat3().y <= 5.25f )
+				pointLight.fallSpeed = 0.0f;
+		}
+
+		pointLight.flickerTimer -= 1.0f;
+		if ( pointLight.flickerTimer <= 0.0f )
+			pointLight.flickerTimer = 200.0f;
+		cb_ps_light.data.lightTimer = pointLight.flickerTimer;
+		cb_ps_light.data.randLightAmount = static_cast<float>( ( rand() % 5000 ) + 1 );
+		renderer.visible = !hidden;
+	} );
+}
+
+// the shaders take a single point light, with several the last one wins
+void SceneSystems::ApplyLights( World& scene, ConstantBuffer<CB_PS_light>& cb_ps_light )
+{
+	scene.Each<const Transform, const PointLight>( [&cb_ps_light]( Entity, const Transform& transform, const PointLight& pointLight )
+	{
+		pointLight.WriteTo( cb_ps_light.data );
+		cb_ps_light.data.dynamicLightPosition = transform.GetWorldPositionFloat3();
+	} );
+}
+
+void SceneSystems::Cull( World& scene, CullingBatch& culling, const Frustum& frustum )
+{
+	scene.Each<const Bounds>( [&culling]( Entity, const Bounds& bounds )
+	{
+		culling.Add( bounds.world );
+	} );
+	culling.Cull( frustum );
+}
+
+// only reads shared state, levels of detail are kept per view, so views may submit from several threads at once
+// one packet per mesh, the level of detail is chosen now and reused when the packets execute
+// returns whether any point light is in view, hidden ones included
+bool SceneSystems::Submit( World& scene, RenderQueue& queue, const CullingBatch& culling, const RenderView& view )
+{
+	const TransformStore& store = GameObject::GetTransformStore();
+	scene.Each<const Transform, const MeshRenderer, const Bounds, Lod>( [&store, &queue, &culling, &view](
+		Entity, const Transform& transform, const MeshRenderer& renderer, const Bounds& bounds, Lod& lod )
+	{
+		if ( !renderer.visible || !culling.IsVisible( bounds.index ) )
+			return;
+		Model& model = *renderer.model;
+		const XMFLOAT4X4& worldMatrix = store.GetWorldMatrix( transform.GetHandle() );
+		const UINT level = SelectLod( model, lod, worldMatrix, view );
+		RecordLodStatistics( model, level );
+
+		const float depth = RenderQueue::GetViewDepth( view.viewMatrix, bounds.sphere.Center );
+		for ( UINT i = 0; i < model.GetMeshCount(); i++ )
+		{
+			const Mesh& mesh = model.GetMesh( i );
+			ShaderId shader;
+			if ( renderer.pass == RenderPass::Unlit )
+				shader = mesh.IsQuantized() ? ShaderId::UnlitQuantized : ShaderId::Unlit;
+			else
+				shader = mesh.IsQuantized() ? ShaderId::LitQuantized : ShaderId::Lit;
+			queue.Submit( renderer.pass, shader, queue.GetMaterialId( mesh.GetMaterial() ), depth, &model, i, &worldMatrix, level );
+		}
+	} );
+
+	scene.Each<const TileGrid>( [&queue, &view]( Entity, const TileGrid& grid )
+	{
+		grid.plane->Submit( queue, view, grid.pass );
+	} );
+
+	bool lightVisible = false;
+	scene.Each<const Bounds, const PointLight>( [&culling, &lightVisible]( Entity, const Bounds& bounds, const PointLight& )
+	{
+		lightVisible = lightVisible || culling.IsVisible( bounds.index );
+	} );
+	return lightVisible;
+}
+
+// drawn straight away with whatever shaders are bound, scaled about its own origin
+void SceneSystems::Draw( World& scene, Entity entity, const RenderView& view, float scale )
+{
+	const Transform* transform = scene.Get<Transform>( entity );
+	const MeshRenderer* renderer = scene.Get<MeshRenderer>( entity );
+	Lod* lod = scene.Get<Lod>( entity );
+	if ( transform == nullptr || renderer == nullptr || lod == nullptr )
+		return;
+
+	const XMFLOAT4X4& worldMatrix = GameObject::GetTransformStore().GetWorldMatrix( transform->GetHandle() );
+	const UINT level = SelectLod( *renderer->model, *lod, worldMatrix, view );
+	RecordLodStatistics( *renderer->model, level );
+	const XMMATRIX drawMatrix = scale == 1.0f ? XMLoadFloat4x4( &worldMatrix ) :
+		XMMatrixScaling( scale, scale, scale ) * XMLoadFloat4x4( &worldMatrix );
+	renderer->model->Draw( *view.cb_vs_matrix, drawMatrix, view.viewMatrix, view.projectionMatrix, level );
+}
+
+// centred on the camera, so they never come any closer
+void SceneSystems::DrawSkyboxes( World& scene, const RenderView& view, const XMFLOAT3& cameraPosition )
+{
+	scene.Each<const MeshRenderer, const Skybox>( [&view, &cameraPosition]( Entity, const MeshRenderer& renderer, const Skybox& skybox )
+	{
+		if ( !renderer.visible )
+			return;
+		const XMMATRIX worldMatrix = XMMatrixScaling( skybox.scale, skybox.scale, skybox.scale ) *
+			XMMatrixTranslation( cameraPosition.x, cameraPosition.y, cameraPosition.z );
+		renderer.model->Draw( *view.cb_vs_matrix, worldMatrix, view.viewMatrix, view.projectionMatrix );
+	} );
+}
+
+void SceneSystems::GatherPickables( World& scene, std::vector<BoundingBox>& bounds, std::vector<Entity>& entities )
+{
+	bounds.clear();
+	entities.clear();
+	scene.Each<const Bounds>( [&bounds, &entities]( Entity entity, const Bounds& entityBounds )
+	{
+		bounds.push_back( entityBounds.world );
+		entities.push_back( entity );
+	} );
+}
+
+// world space ray against the full detail triangles, entities without meshes of their own are hit on their bounds
+TriangleHit SceneSystems::Intersect( const World& scene, Entity entity, const PickRay& ray ) noexcept
+{
+	TriangleHit hit;
+	const Bounds* bounds = scene.Get<Bounds>( entity );
+	const Transform* transform = scene.Get<Transform>( entity );
+	const MeshRenderer* renderer = scene.Get<MeshRenderer>( entity );
+	if ( bounds == nullptr )
+		return hit;
+	if ( transform == nullptr || renderer == nullptr || renderer->model->GetMeshCount() == 0 )
+	{
+		float distance;
+		const XMVECTOR direction = XMLoadFloat3( &ray.direction );
+		const float length = XMVectorGetX( XMVector3Length( direction ) );
+		if ( length > 0.0f && bounds->world.Intersects( XMLoadFloat3( &ray.origin ), direction / length, distance ) &&
+			distance / length < ray.maxDistance )
+			hit.distance = distance / length;
+		return hit;
+	}
+	return renderer->model->Intersect( TransformPickRay( ray, XMMatrixInverse( nullptr, transform->GetWorldMatrix() ) ) );
+}
+
+LodStatistics SceneSystems::GetLodStatistics()
+{
+	return LodStatisticsCounter::Get();
+}
+
+void SceneSystems::FoldLodStatistics()
+{
+	LodStatisticsCounter::Fold();
+}
+
+void SceneSystems::ResetLodStatistics()
+{
+	LodStatisticsCounter::Reset();
+}
+
+void SceneSystems::RecordLodStatistics( const Model& model, UINT lod ) noexcept
+{
+	LodStatistics& lodStats = LodStatisticsCounter::Local();
+	lodStats.objectCount++;
+	lodStats.fullTriangleCount += model.GetTriangleCount( 0 );
+	lodStats.drawnTriangleCount += model.GetTriangleCount( lod );
+	lodStats.lodObjectCounts[std::min( lod, MeshSimplifier::MAX_LOD_COUNT - 1 )]++;
+}
+
+UINT SceneSystems::SelectLod( const Model& model, Lod& lod, const XMFLOAT4X4& worldMatrix, const RenderView& view ) noexcept
+{
+	UINT& currentLod = lod.levels[view.index];
+	const UINT lodCount = model.GetLodCount();
+	if ( !lodParams.useLods || lodCount <= 1 )
+	{
+		currentLod = 0;
+		return currentLod;
+	}
+	currentLod = std::min( currentLod, lodCount - 1 );
+
+	// pixels covered by one unit of world-space error at the entity's distance
+	const XMMATRIX world = XMLoadFloat4x4( &worldMatrix );
+	const XMVECTOR cameraPosition = XMMatrixInverse( nullptr, view.viewMatrix ).r[3];
+	const float distance = XMVectorGetX( XMVector3Length( world.r[3] - cameraPosition ) );
+	const float worldScale = std::max( { XMVectorGetX( XMVector3Length( world.r[0] ) ),
+		XMVectorGetX( XMVector3Length( world.r[1] ) ), XMVectorGetX( XMVector3Length( world.r[2] ) ) } );
+	const float pixelsPerUnit = XMVectorGetY( view.projectionMatrix.r[1] ) * lodParams.viewportHeight * 0.5f /
+		std::max( distance, 0.001f );
+	const float threshold = lodParams.pixelError / ( worldScale * pixelsPerUnit );
+
+	// coarsen only once the next level is well inside the threshold, refine as soon as the current one exceeds it
+	while ( currentLod > 0 && model.GetLodError( currentLod ) > threshold )
+		currentLod--;
+	while ( currentLod + 1 < lodCount && model.GetLodError( currentLod + 1 ) <= threshold * ( 1.0f - lodParams.hysteresis ) )
+		currentLod++;
+	return currentLod;
+}
\ No newline at end of file
@@ -0,0 +1,151 @@
+#pragma once
+#ifndef SCENESYSTEMS_H
+#define SCENESYSTEMS_H
+
+#include "Plane.h"
+#include "Transform.h"
+#include "MeshSimplifier.h"
+#include "../ecs/World.h"
+#include "../utility/Broadphase.h"
+#include <memory>
+#include <string>
+
+// lod selection, a level is used while its error projects to at most pixelError pixels
+// hysteresis widens the band an entity must cross before switching back to a finer level
+struct LodParameters
+{
+	bool useLods = true;
+	float pixelError = 1.0f;
+	float hysteresis = 0.25f;
+	float viewportHeight = 720.0f;
+};
+
+struct LodStatistics
+{
+	UINT objectCount = 0;
+	UINT fullTriangleCount = 0;
+	UINT drawnTriangleCount = 0;
+	UINT lodObjectCounts[MeshSimplifier::MAX_LOD_COUNT] = { 0 };
+	LodStatistics& operator+=( const LodStatistics& other ) noexcept
+	{
+		objectCount += other.objectCount;
+		fullTriangleCount += other.fullTriangleCount;
+		drawnTriangleCount += other.drawnTriangleCount;
+		for ( UINT i = 0; i < MeshSimplifier::MAX_LOD_COUNT; i++ )
+			lodObjectCounts[i] += other.lodObjectCounts[i];
+		return *this;
+	}
+};
+
+// components of the scene's entities, Graphics keeps only the entities themselves
+struct Name
+{
+	std::string value;
+};
+
+// models are shared between entities drawing the same meshes, the skybox is drawn without being culled or queued
+struct MeshRenderer
+{
+	std::shared_ptr<Model> model;
+	RenderPass pass = RenderPass::Opaque;
+	bool visible = true;
+};
+
+// world bounds are only rebuilt when the transform's version moves on, a version of 0 forces the next rebuild
+// index is the entity's place in culling and picking, refreshed by UpdateBounds
+struct Bounds
+{
+	BoundingBox local;
+	BoundingBox world;
+	BoundingSphere sphere;
+	UINT64 version = 0;
+	UINT index = 0;
+};
+
+// each view keeps its own level, its hysteresis band depends on where that view has been
+struct Lod
+{
+	UINT levels[RenderView::MAX_VIEWS] = { 0 };
+};
+
+// radians per millisecond about each axis
+struct Spin
+{
+	XMFLOAT3 rate = { 0.0f, 0.0f, 0.0f };
+};
+
+// the entity's bounding sphere in the broadphase
+struct Collider
+{
+	Broadphase::Proxy proxy = Broadphase::INVALID;
+};
+
+// the settings of a point light and the directional light it carries along, its position is the entity's
+struct PointLight
+{
+	XMFLOAT3 ambientColor = { 1.0f, 1.0f, 1.0f };
+	float ambientStrength = 0.1f;
+	XMFLOAT3 lightColor = { 1.0f, 1.0f, 1.0f };
+	float lightStrength = 0.3f;
+	XMFLOAT3 specularColor = { 1.0f, 1.0f, 1.0f };
+	float specularIntensity = 4.0f;
+	float specularPower = 10.0f;
+	float constant = 1.0f;
+	float linear = 0.045f;
+	float quadratic = 0.0075f;
+	XMFLOAT3 directionalLightColor = { 1.0f, 1.0f, 1.0f };
+	XMFLOAT3 directionalLightPosition = { 50.0f, 50.0f, -10.0f };
+	float directionalLightIntensity = 1.0f;
+	float quadIntensity = 1.0f;
+	float fallSpeed = 0.0f;
+	float flickerTimer = 200.0f;
+	void ReadFrom( const CB_PS_light& data ) noexcept;
+	void WriteTo( CB_PS_light& data ) const noexcept;
+};
+
+// drawn around the camera at this scale, after the scene
+struct Skybox
+{
+	float scale = 500.0f;
+};
+
+// instanced ground tiles, the plane only rebuilds them when the layout changes
+struct TileGrid
+{
+	std::shared_ptr<PlaneInstanced> plane;
+	int tileSize = 0;
+	int tileOffset = 0;
+	int worldOffsetX = 0;
+	int worldOffsetY = 0;
+	RenderPass pass = RenderPass::Flat;
+};
+
+// the per-frame work on the scene's entities, each a query over the components it needs
+// culling and picking index entities in the order UpdateBounds visits them
+// systems run from the render threads only read the store's world matrices, they never resolve a transform
+class SceneSystems
+{
+public:
+	static void UpdateTransforms( World& scene, float dt );
+	static void UpdateTiles( World& scene );
+	static void UpdateBounds( World& scene );
+	static void UpdateColliders( World& scene, Broadphase& broadphase );
+	static void UpdateLights( World& scene, ConstantBuffer<CB_PS_light>& cb_ps_light, bool hidden );
+	static void ApplyLights( World& scene, ConstantBuffer<CB_PS_light>& cb_ps_light );
+	static void Cull( World& scene, CullingBatch& culling, const Frustum& frustum );
+	static bool Submit( World& scene, RenderQueue& queue, const CullingBatch& culling, const RenderView& view );
+	static void Draw( World& scene, Entity entity, const RenderView& view, float scale = 1.0f );
+	static void DrawSkyboxes( World& scene, const RenderView& view, const XMFLOAT3& cameraPosition );
+	static void GatherPickables( World& scene, std::vector<BoundingBox>& bounds, std::vector<Entity>& entities );
+	static TriangleHit Intersect( const World& scene, Entity entity, const PickRay& ray ) noexcept;
+	static LodStatistics GetLodStatistics();
+	static void FoldLodStatistics();
+	static void ResetLodStatistics();
+	static inline LodParameters lodParams;
+private:
+	static UINT SelectLod( const Model& model, Lod& lod, const XMFLOAT4X4& worldMatrix, const RenderView& view ) noexcept;
+	static void RecordLodStatistics( const Model& model, UINT lod ) noexcept;
+	using LodStatisticsCounter = ThreadStatistics<LodStatistics>;
+};
+
+#endif
\ No newline at end of file
@@ -1,9 +1,9 @@
 #include "Shaders.h"
 
-HRESULT VertexShader::Initialize( Microsoft::WRL::ComPtr<ID3D11Device>& device, std::wstring shaderPath, D3D11_INPUT_ELEMENT_DESC* layoutDesc, UINT numElements )
+HRESULT VertexShader::Initialize( Microsoft::WRL::ComPtr<ID3D11Device>& device, std::wstring shaderPath, D3D11_INPUT_ELEMENT_DESC* layoutDesc, UINT numElements, LPCSTR entryPoint )
 {
     // Compile the vertex shader
-    HRESULT hr = CompileShaderFromFile( shaderPath.c_str(), "VS", "vs_5_0", shaderBuffer.GetAddressOf()  );
+    HRESULT hr = CompileShaderFromFile( shaderPath.c_str(), entryPoint, "vs_5_0", shaderBuffer.GetAddressOf()  );
     if ( FAILED( hr ) )
     {
         ErrorLogger::Log(
@@ -48,9 +48,10 @@ HRESULT VertexShader::Initialize( Microsoft::WRL::ComPtr<ID3D11Device>& device,
 
 void Shaders::BindShaders( ID3D11DeviceContext* context, VertexShader& vs, PixelShader& ps ) noexcept
 {
-    context->VSSetShader( vs.GetShader(), NULL, 0 );
-	context->IASetInputLayout( vs.GetInputLayout() );
-	context->PSSetShader( ps.GetShader(), NULL, 0 );
+    StateCache& stateCache = StateCache::Get( context );
+    stateCache.SetVertexShader( vs.GetShader() );
+	stateCache.SetInputLayout( vs.GetInputLayout() );
+	stateCache.SetPixelShader( ps.GetShader() );
 }
 
 ID3D11VertexShader* VertexShader::GetShader() const noexcept
@@ -5,6 +5,7 @@
 #include <d3d11.h>
 #include <wrl/client.h>
 #include <d3dcompiler.h>
+#include "StateCache.h"
 #include "../utility/ErrorLogger.h"
 
 class VertexShader;
@@ -29,7 +30,8 @@ public:
 		Microsoft::WRL::ComPtr<ID3D11Device> &device,
 		std::wstring shaderPath,
 		D3D11_INPUT_ELEMENT_DESC* layoutDesc,
-		UINT numElements
+		UINT numElements,
+		LPCSTR entryPoint = "VS"
 	);
 	ID3D11VertexShader* GetShader() const noexcept;
 	ID3D10Blob* GetBuffer() const noexcept;
@@ -41,30 +41,35 @@ bool Sprite::Initialize( ID3D11Device* device, ID3D11DeviceContext* context,
 void Sprite::Draw( XMMATRIX orthoMatrix )
 {
 	XMMATRIX wvpMatrix = this->worldMatrix * orthoMatrix;
-	this->context->VSSetConstantBuffers( 0, 1, cb_vs_matrix_2d->GetAddressOf() );
 	cb_vs_matrix_2d->data.wvpMatrix = wvpMatrix;
 	cb_vs_matrix_2d->ApplyChanges();
-	this->context->PSSetShaderResources( 0, 1, this->texture->GetTextureResourceViewAddress() );
+	cb_vs_matrix_2d->BindVS( 0 );
+	StateCache& stateCache = StateCache::Get( this->context );
+	stateCache.SetPSShaderResource( 0, this->texture->GetTextureResourceView() );
 
 	const UINT offsets = 0;
-	this->context->IASetVertexBuffers( 0, 1, this->vertices.GetAddressOf(), this->vertices.StridePtr(), &offsets );
-	this->context->IASetIndexBuffer( this->indices.Get(), DXGI_FORMAT_R16_UINT, 0 );
-	this->context->DrawIndexed( this->indices.IndexCount(), 0, 0 );
+	stateCache.SetVertexBuffers( 0, 1, this->vertices.GetAddressOf(), this->vertices.StridePtr(), &offsets );
+	stateCache.SetIndexBuffer( this->indices.Get(), this->indices.Format(), 0 );
+	stateCache.DrawIndexed( this->indices.IndexCount(), 0, 0 );
 }
 
 float Sprite::GetWidth() const noexcept
 {
-	return this->scale.x;
+	return GetScaleFloat3().x;
 }
 
 float Sprite::GetHeight() const noexcept
 {
-	return this->scale.y;
+	return GetScaleFloat3().y;
 }
 
 void Sprite::UpdateMatrix()
 {
-	this->worldMatrix = XMMatrixScaling( this->scale.x, this->scale.y, 1.0f ) *
-		XMMatrixRotationRollPitchYaw( this->rotation.x, this->rotation.y, this->rotation.z ) *
-		XMMatrixTranslation( this->position.x + this->scale.x / 2.0f, this->position.y + this->scale.y / 2.0f, this->position.z );
+	// sprites are placed by their corner and never scaled in depth, so the store's matrix doesn't fit
+	const XMFLOAT3 position = GetPositionFloat3();
+	const XMFLOAT3 rotation = GetRotationFloat3();
+	const XMFLOAT3 scale = GetScaleFloat3();
+	this->worldMatrix = XMMatrixScaling( scale.x, scale.y, 1.0f ) *
+		XMMatrixRotationRollPitchYaw( rotation.x, rotation.y, rotation.z ) *
+		XMMatrixTranslation( position.x + scale.x / 2.0f, position.y + scale.y / 2.0f, position.z );
 }
\ No newline at end of file
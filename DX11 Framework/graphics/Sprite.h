@@ -26,7 +26,7 @@ private:
 	XMMATRIX worldMatrix = XMMatrixIdentity();
 	ConstantBuffer<CB_VS_matrix_2D>* cb_vs_matrix_2d = nullptr;
 	VertexBuffer<Vertex2D> vertices;
-	IndexBuffer indices;
+	IndexBuffer<WORD> indices;
 };
 
 #endif
\ No newline at end of file
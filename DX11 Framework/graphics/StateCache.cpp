@@ -0,0 +1,8 @@
+#include "StateCache.h"
+
+void D3D11StateTarget::Reset( ID3D11DeviceContext* context )
+{
+	this->context = context;
+	context1.Reset();
+	context->QueryInterface( __uuidof( ID3D11DeviceContext1 ), reinterpret_cast<void**>( context1.GetAddressOf() ) );
+}
\ No newline at end of file
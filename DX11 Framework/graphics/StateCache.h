@@ -0,0 +1,78 @@
+#pragma once
+#ifndef STATECACHE_H
+#define STATECACHE_H
+
+#include <d3d11_1.h>
+#include <wrl/client.h>
+#include "BasicStateCache.h"
+
+// issues the binds a state cache lets through to a d3d 11 context
+// blocks of the upload ring are bound through the 11.1 context, where there is one
+class D3D11StateTarget
+{
+public:
+	using Context = ID3D11DeviceContext;
+	using VertexShader = ID3D11VertexShader;
+	using PixelShader = ID3D11PixelShader;
+	using InputLayout = ID3D11InputLayout;
+	using Topology = D3D11_PRIMITIVE_TOPOLOGY;
+	using Buffer = ID3D11Buffer;
+	using Format = DXGI_FORMAT;
+	using ShaderResourceView = ID3D11ShaderResourceView;
+	using SamplerState = ID3D11SamplerState;
+	using RasterizerState = ID3D11RasterizerState;
+	using DepthStencilState = ID3D11DepthStencilState;
+	using BlendState = ID3D11BlendState;
+	using Viewport = D3D11_VIEWPORT;
+
+	static constexpr UINT MAX_VERTEX_BUFFERS = D3D11_IA_VERTEX_INPUT_RESOURCE_SLOT_COUNT;
+	static constexpr UINT MAX_CONSTANT_BUFFERS = D3D11_COMMONSHADER_CONSTANT_BUFFER_API_SLOT_COUNT;
+	static constexpr UINT MAX_SAMPLERS = D3D11_COMMONSHADER_SAMPLER_SLOT_COUNT;
+
+	void Reset( ID3D11DeviceContext* context );
+	ID3D11DeviceContext* GetContext() const noexcept { return context; }
+
+	void SetVertexShader( ID3D11VertexShader* shader ) noexcept { context->VSSetShader( shader, NULL, 0 ); }
+	void SetPixelShader( ID3D11PixelShader* shader ) noexcept { context->PSSetShader( shader, NULL, 0 ); }
+	void SetInputLayout( ID3D11InputLayout* inputLayout ) noexcept { context->IASetInputLayout( inputLayout ); }
+	void SetPrimitiveTopology( D3D11_PRIMITIVE_TOPOLOGY topology ) noexcept { context->IASetPrimitiveTopology( topology ); }
+	void SetVertexBuffers( UINT startSlot, UINT count, ID3D11Buffer* const* buffers, const UINT* strides, const UINT* offsets ) noexcept
+	{
+		context->IASetVertexBuffers( startSlot, count, buffers, strides, offsets );
+	}
+	void SetIndexBuffer( ID3D11Buffer* buffer, DXGI_FORMAT format, UINT offset ) noexcept { context->IASetIndexBuffer( buffer, format, offset ); }
+	void SetVSConstantBuffer( UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT constantCount ) noexcept
+	{
+		if ( constantCount > 0u && context1 )
+			context1->VSSetConstantBuffers1( slot, 1, &buffer, &firstConstant, &constantCount );
+		else
+			context->VSSetConstantBuffers( slot, 1, &buffer );
+	}
+	void SetPSConstantBuffer( UINT slot, ID3D11Buffer* buffer, UINT firstConstant, UINT constantCount ) noexcept
+	{
+		if ( constantCount > 0u && context1 )
+			context1->PSSetConstantBuffers1( slot, 1, &buffer, &firstConstant, &constantCount );
+		else
+			context->PSSetConstantBuffers( slot, 1, &buffer );
+	}
+	void SetVSShaderResource( UINT slot, ID3D11ShaderResourceView* view ) noexcept { context->VSSetShaderResources( slot, 1, &view ); }
+	void SetPSShaderResource( UINT slot, ID3D11ShaderResourceView* view ) noexcept { context->PSSetShaderResources( slot, 1, &view ); }
+	void SetPSSampler( UINT slot, ID3D11SamplerState* sampler ) noexcept { context->PSSetSamplers( slot, 1, &sampler ); }
+	void SetRasterizerState( ID3D11RasterizerState* state ) noexcept { context->RSSetState( state ); }
+	void SetDepthStencilState( ID3D11DepthStencilState* state, UINT stencilRef ) noexcept { context->OMSetDepthStencilState( state, stencilRef ); }
+	void SetBlendState( ID3D11BlendState* state ) noexcept { context->OMSetBlendState( state, NULL, 0xFFFFFFFF ); }
+	void SetViewport( const D3D11_VIEWPORT& viewport ) noexcept { context->RSSetViewports( 1u, &viewport ); }
+	void Draw( UINT vertexCount, UINT startVertex ) noexcept { context->Draw( vertexCount, startVertex ); }
+	void DrawIndexed( UINT indexCount, UINT startIndex, INT baseVertex ) noexcept { context->DrawIndexed( indexCount, startIndex, baseVertex ); }
+	void DrawIndexedInstanced( UINT indexCount, UINT instanceCount, UINT startIndex, INT baseVertex, UINT startInstance ) noexcept
+	{
+		context->DrawIndexedInstanced( indexCount, instanceCount, startIndex, baseVertex, startInstance );
+	}
+private:
+	ID3D11DeviceContext* context = nullptr;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext1> context1;
+};
+
+using StateCache = BasicStateCache<D3D11StateTarget>;
+
+#endif
\ No newline at end of file
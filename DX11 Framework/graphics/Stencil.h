@@ -63,7 +63,7 @@ namespace Bind
 		}
 		void Bind( Graphics& gfx ) noexcept override
 		{
-			GetContext( gfx )->OMSetDepthStencilState( pStencil.Get(), 0 );
+			GetStateCache( gfx ).SetDepthStencilState( pStencil.Get(), 0 );
 		}
 	private:
 		Mode mode;
@@ -2,6 +2,7 @@
 #include "../utility/ErrorLogger.h"
 #include <dxtk/WICTextureLoader.h>
 #include <dxtk/DDSTextureLoader.h>
+#include <wincodec.h>
 
 Texture::Texture( ID3D11Device* device, const Colour& color, aiTextureType type )
 {
@@ -16,7 +17,7 @@ Texture::Texture( ID3D11Device* device, const Colour* colorData, UINT width, UIN
 Texture::Texture( ID3D11Device* device, const std::string& filePath, aiTextureType type )
 {
 	this->type = type;
-	if ( StringConverter::GetFileExtension( filePath ) == ".dds" )
+	if ( StringConverter::GetFileExtension( filePath ) == "dds" )
 	{
 		HRESULT hr = DirectX::CreateDDSTextureFromFile( device,
 			StringConverter::StringToWide( filePath ).c_str(),
@@ -46,11 +47,100 @@ Texture::Texture( ID3D11Device* device, const uint8_t* pData, size_t size, aiTex
 	COM_ERROR_IF_FAILED( hr, "Failed to create texture from memory!" );
 }
 
+Texture::Texture( ID3D11Device* device, const MaterialTexture& material )
+{
+	// already decoded off the device thread
+	if ( !material.pixels.empty() )
+	{
+		InitializeColourTexture( device, material.pixels.data(), material.width, material.height, material.type );
+		return;
+	}
+
+	switch ( material.storageType )
+	{
+	case TextureStorageType::Disk:
+		*this = Texture( device, material.filePath, material.type );
+		break;
+	case TextureStorageType::EmbeddedCompressed:
+	case TextureStorageType::EmbeddedIndexCompressed:
+		*this = Texture( device, material.pData, material.size, material.type );
+		break;
+	default:
+		Initialize1x1ColourTexture( device, material.colour, material.type );
+		break;
+	}
+}
+
+bool Texture::Decode( MaterialTexture& material )
+{
+	// only wic images are decoded here, dds files are uploaded as stored
+	if ( material.storageType == TextureStorageType::Disk && StringConverter::GetFileExtension( material.filePath ) == "dds" )
+		return false;
+	if ( material.storageType != TextureStorageType::Disk &&
+		material.storageType != TextureStorageType::EmbeddedCompressed &&
+		material.storageType != TextureStorageType::EmbeddedIndexCompressed )
+		return false;
+
+	// the calling thread must have initialized COM
+	Microsoft::WRL::ComPtr<IWICImagingFactory> factory;
+	HRESULT hr = CoCreateInstance( CLSID_WICImagingFactory, nullptr, CLSCTX_INPROC_SERVER, IID_PPV_ARGS( factory.GetAddressOf() ) );
+	if ( FAILED( hr ) )
+		return false;
+
+	Microsoft::WRL::ComPtr<IWICBitmapDecoder> decoder;
+	Microsoft::WRL::ComPtr<IWICStream> stream;
+	if ( material.storageType == TextureStorageType::Disk )
+	{
+		hr = factory->CreateDecoderFromFilename( StringConverter::StringToWide( material.filePath ).c_str(),
+			nullptr, GENERIC_READ, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf() );
+	}
+	else
+	{
+		hr = factory->CreateStream( stream.GetAddressOf() );
+		if ( SUCCEEDED( hr ) )
+			hr = stream->InitializeFromMemory( const_cast<BYTE*>( material.pData ), static_cast<DWORD>( material.size ) );
+		if ( SUCCEEDED( hr ) )
+			hr = factory->CreateDecoderFromStream( stream.Get(), nullptr, WICDecodeMetadataCacheOnDemand, decoder.GetAddressOf() );
+	}
+	if ( FAILED( hr ) )
+		return false;
+
+	Microsoft::WRL::ComPtr<IWICBitmapFrameDecode> frame;
+	Microsoft::WRL::ComPtr<IWICFormatConverter> converter;
+	UINT width = 0, height = 0;
+	hr = decoder->GetFrame( 0, frame.GetAddressOf() );
+	if ( SUCCEEDED( hr ) )
+		hr = frame->GetSize( &width, &height );
+	if ( SUCCEEDED( hr ) )
+		hr = factory->CreateFormatConverter( converter.GetAddressOf() );
+	if ( SUCCEEDED( hr ) )
+		hr = converter->Initialize( frame.Get(), GUID_WICPixelFormat32bppRGBA,
+			WICBitmapDitherTypeNone, nullptr, 0.0, WICBitmapPaletteTypeCustom );
+	if ( FAILED( hr ) || width == 0 || height == 0 )
+		return false;
+
+	std::vector<Colour> pixels( static_cast<size_t>( width ) * height );
+	const UINT stride = width * sizeof( Colour );
+	hr = converter->CopyPixels( nullptr, stride, stride * height, reinterpret_cast<BYTE*>( pixels.data() ) );
+	if ( FAILED( hr ) )
+		return false;
+
+	material.pixels = std::move( pixels );
+	material.width = width;
+	material.height = height;
+	return true;
+}
+
 aiTextureType Texture::GetType()
 {
 	return type;
 }
 
+ID3D11Resource* Texture::GetTexture()
+{
+	return texture.Get();
+}
+
 ID3D11ShaderResourceView* Texture::GetTextureResourceView()
 {
 	return textureView.Get();
@@ -73,7 +163,7 @@ void Texture::InitializeColourTexture(  ID3D11Device* device, const Colour* colo
 	
 	D3D11_SUBRESOURCE_DATA initialData = { 0 };
 	initialData.pSysMem = colorData;
-	initialData.SysMemPitch = sizeof( Colour );
+	initialData.SysMemPitch = width * sizeof( Colour );
 
 	ID3D11Texture2D* p2DTexture = nullptr;
 	HRESULT hr = device->CreateTexture2D( &textureDesc, &initialData, &p2DTexture );
@@ -3,6 +3,8 @@
 #define TEXTURE_H
 
 #include "Colour.h"
+#include <string>
+#include <vector>
 #include <d3d11.h>
 #include <wrl/client.h>
 #include <assimp/material.h>
@@ -18,6 +20,22 @@ enum class TextureStorageType
 	EmbeddedIndexNonCompressed,
 };
 
+// cpu-side description of a material texture, resolved at import time
+// so that it can be cached or decoded away from the device
+struct MaterialTexture
+{
+	aiTextureType type = aiTextureType_UNKNOWN;
+	TextureStorageType storageType = TextureStorageType::None;
+	Colour colour = Colours::UnloadedTextureColour;
+	std::string filePath = "";
+	const uint8_t* pData = nullptr;
+	size_t size = 0;
+	std::vector<Colour> pixels;
+	UINT width = 0;
+	UINT height = 0;
+	std::string cacheKey = "";
+};
+
 class Texture
 {
 public:
@@ -25,7 +43,10 @@ public:
 	Texture( ID3D11Device* device, const Colour* colourData, UINT width, UINT height, aiTextureType type );
 	Texture( ID3D11Device* device, const std::string& filePath, aiTextureType type );
 	Texture( ID3D11Device* device, const uint8_t* pData, size_t size, aiTextureType type );
+	Texture( ID3D11Device* device, const MaterialTexture& material );
+	static bool Decode( MaterialTexture& material );
 	aiTextureType GetType();
+	ID3D11Resource* GetTexture();
 	ID3D11ShaderResourceView* GetTextureResourceView();
 	ID3D11ShaderResourceView** GetTextureResourceViewAddress();
 private:
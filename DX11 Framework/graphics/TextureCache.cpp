@@ -0,0 +1,166 @@
+#include "TextureCache.h"
+#include <filesystem>
+#include <algorithm>
+
+std::unordered_map<std::string, TextureCache::Entry> TextureCache::textures;
+TextureCacheStats TextureCache::stats;
+std::mutex TextureCache::mutex;
+
+std::shared_ptr<Texture> TextureCache::GetTexture( ID3D11Device* device, const MaterialTexture& material )
+{
+	const std::string key = GetKey( material );
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		auto it = textures.find( key );
+		if ( it != textures.end() )
+		{
+			stats.hits++;
+			stats.savedBytes += it->second.size;
+			return it->second.texture;
+		}
+	}
+
+	// embedded data is dropped once decoded, so a released entry can't be rebuilt from it
+	std::shared_ptr<Texture> texture;
+	const bool hasData = material.storageType == TextureStorageType::Disk || material.storageType == TextureStorageType::None ||
+		material.pData != nullptr || !material.pixels.empty();
+	if ( hasData )
+		texture = std::make_shared<Texture>( device, material );
+	else
+		texture = std::make_shared<Texture>( device, Colours::UnloadedTextureColour, material.type );
+
+	Entry entry;
+	entry.texture = texture;
+	entry.size = GetTextureSize( texture->GetTexture() );
+
+	std::lock_guard<std::mutex> lock( mutex );
+	stats.misses++;
+	stats.residentBytes += entry.size;
+	textures.emplace( key, entry );
+	return texture;
+}
+
+std::string TextureCache::GetKey( const MaterialTexture& material )
+{
+	if ( !material.cacheKey.empty() )
+		return material.cacheKey;
+
+	std::string key = std::to_string( material.type ) + ':';
+	switch ( material.storageType )
+	{
+	case TextureStorageType::Disk:
+	{
+		// the same file can be reached through different relative paths
+		std::error_code error;
+		std::filesystem::path path = std::filesystem::weakly_canonical( material.filePath, error );
+		std::string filePath = error ? material.filePath : path.string();
+		std::replace( filePath.begin(), filePath.end(), '/', '\\' );
+		std::transform( filePath.begin(), filePath.end(), filePath.begin(),
+			[]( char c ) { return static_cast<char>( tolower( static_cast<unsigned char>( c ) ) ); } );
+		return key + "file:" + filePath;
+	}
+	case TextureStorageType::EmbeddedCompressed:
+	case TextureStorageType::EmbeddedIndexCompressed:
+	{
+		// 64-bit FNV-1a of the compressed image
+		UINT64 hash = 14695981039346656037ull;
+		for ( size_t i = 0; i < material.size; i++ )
+		{
+			hash ^= material.pData[i];
+			hash *= 1099511628211ull;
+		}
+		return key + "data:" + std::to_string( hash ) + ':' + std::to_string( material.size );
+	}
+	default:
+		return key + "colour:" + std::to_string( material.colour.GetColour() );
+	}
+}
+
+bool TextureCache::Contains( const std::string& key )
+{
+	std::lock_guard<std::mutex> lock( mutex );
+	return textures.find( key ) != textures.end();
+}
+
+UINT TextureCache::ReleaseUnused()
+{
+	std::lock_guard<std::mutex> lock( mutex );
+	UINT released = 0;
+	for ( auto it = textures.begin(); it != textures.end(); )
+	{
+		if ( it->second.texture.use_count() == 1 )
+		{
+			stats.residentBytes -= it->second.size;
+			it = textures.erase( it );
+			released++;
+		}
+		else
+		{
+			++it;
+		}
+	}
+	return released;
+}
+
+void TextureCache::Clear()
+{
+	std::lock_guard<std::mutex> lock( mutex );
+	textures.clear();
+	stats = TextureCacheStats();
+}
+
+TextureCacheStats TextureCache::GetStats()
+{
+	std::lock_guard<std::mutex> lock( mutex );
+	TextureCacheStats current = stats;
+	current.textureCount = static_cast<UINT>( textures.size() );
+	current.referenceCount = 0;
+	for ( auto it = textures.begin(); it != textures.end(); ++it )
+		current.referenceCount += static_cast<UINT>( it->second.texture.use_count() - 1 );
+	return current;
+}
+
+size_t TextureCache::GetTextureSize( ID3D11Resource* resource )
+{
+	Microsoft::WRL::ComPtr<ID3D11Texture2D> texture2D;
+	if ( resource == nullptr || FAILED( resource->QueryInterface( IID_PPV_ARGS( texture2D.GetAddressOf() ) ) ) )
+		return 0;
+
+	D3D11_TEXTURE2D_DESC desc;
+	texture2D->GetDesc( &desc );
+
+	// bits per texel, block compressed formats are counted per 4x4 block
+	size_t bitsPerTexel = 32;
+	bool blockCompressed = false;
+	switch ( desc.Format )
+	{
+	case DXGI_FORMAT_BC1_UNORM: case DXGI_FORMAT_BC1_UNORM_SRGB:
+	case DXGI_FORMAT_BC4_UNORM: case DXGI_FORMAT_BC4_SNORM:
+		bitsPerTexel = 4; blockCompressed = true; break;
+	case DXGI_FORMAT_BC2_UNORM: case DXGI_FORMAT_BC2_UNORM_SRGB:
+	case DXGI_FORMAT_BC3_UNORM: case DXGI_FORMAT_BC3_UNORM_SRGB:
+	case DXGI_FORMAT_BC5_UNORM: case DXGI_FORMAT_BC5_SNORM:
+	case DXGI_FORMAT_BC6H_UF16: case DXGI_FORMAT_BC6H_SF16:
+	case DXGI_FORMAT_BC7_UNORM: case DXGI_FORMAT_BC7_UNORM_SRGB:
+		bitsPerTexel = 8; blockCompressed = true; break;
+	case DXGI_FORMAT_R8_UNORM: case DXGI_FORMAT_A8_UNORM:
+		bitsPerTexel = 8; break;
+	case DXGI_FORMAT_R16G16B16A16_FLOAT: case DXGI_FORMAT_R16G16B16A16_UNORM:
+		bitsPerTexel = 64; break;
+	case DXGI_FORMAT_R32G32B32A32_FLOAT:
+		bitsPerTexel = 128; break;
+	}
+
+	size_t size = 0;
+	UINT width = desc.Width, height = desc.Height;
+	for ( UINT i = 0; i < std::max( desc.MipLevels, 1u ); i++ )
+	{
+		size_t texels = blockCompressed ?
+			static_cast<size_t>( ( width + 3 ) / 4 * 4 ) * ( ( height + 3 ) / 4 * 4 ) :
+			static_cast<size_t>( width ) * height;
+		size += texels * bitsPerTexel / 8;
+		width = std::max( width / 2, 1u );
+		height = std::max( height / 2, 1u );
+	}
+	return size * std::max( desc.ArraySize, 1u );
+}
\ No newline at end of file
@@ -0,0 +1,43 @@
+#pragma once
+#ifndef TEXTURECACHE_H
+#define TEXTURECACHE_H
+
+#include "Texture.h"
+#include <memory>
+#include <mutex>
+#include <unordered_map>
+
+struct TextureCacheStats
+{
+	UINT hits = 0;
+	UINT misses = 0;
+	UINT textureCount = 0;
+	UINT referenceCount = 0;
+	size_t residentBytes = 0;
+	size_t savedBytes = 0;
+};
+
+// shared textures keyed by canonical file path, content hash of embedded data or colour
+// textures are handed out as shared handles, an entry is only released once no mesh references it
+class TextureCache
+{
+public:
+	static std::shared_ptr<Texture> GetTexture( ID3D11Device* device, const MaterialTexture& material );
+	static std::string GetKey( const MaterialTexture& material );
+	static bool Contains( const std::string& key );
+	static UINT ReleaseUnused();
+	static void Clear();
+	static TextureCacheStats GetStats();
+private:
+	struct Entry
+	{
+		std::shared_ptr<Texture> texture;
+		size_t size = 0;
+	};
+	static size_t GetTextureSize( ID3D11Resource* resource );
+	static std::unordered_map<std::string, Entry> textures;
+	static TextureCacheStats stats;
+	static std::mutex mutex;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,44 @@
+#pragma once
+#ifndef THREADSTATISTICS_H
+#define THREADSTATISTICS_H
+
+#include <mutex>
+
+// per-frame counters that any thread may bump without locking
+// each thread counts into its own block, recording threads fold theirs into the shared totals when they finish a view
+// T is a plain struct of counters with an operator+=
+template<class T>
+class ThreadStatistics
+{
+public:
+	static T& Local() noexcept
+	{
+		return local;
+	}
+	// everything folded so far plus the calling thread's own counts
+	static T Get()
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		T total = folded;
+		total += local;
+		return total;
+	}
+	static void Fold()
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		folded += local;
+		local = T();
+	}
+	static void Reset()
+	{
+		std::lock_guard<std::mutex> lock( mutex );
+		folded = T();
+		local = T();
+	}
+private:
+	static inline thread_local T local;
+	static inline T folded;
+	static inline std::mutex mutex;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,193 @@
+#include "Transform.h"
+
+Transform::Transform()
+{
+	handle = GameObject::GetTransformStore().Allocate();
+}
+
+Transform::Transform( Transform&& other ) noexcept :
+	handle( other.handle )
+{
+	other.handle = TransformStore::INVALID;
+}
+
+Transform& Transform::operator=( Transform&& other ) noexcept
+{
+	if ( this == &other )
+		return *this;
+	Release();
+	handle = other.handle;
+	other.handle = TransformStore::INVALID;
+	return *this;
+}
+
+Transform::~Transform()
+{
+	Release();
+}
+
+void Transform::Release() noexcept
+{
+	if ( handle == TransformStore::INVALID )
+		return;
+	GameObject::GetTransformStore().Release( handle );
+	handle = TransformStore::INVALID;
+}
+
+TransformStore::Handle Transform::GetHandle() const noexcept
+{
+	return handle;
+}
+
+XMFLOAT3 Transform::GetPositionFloat3() const noexcept
+{
+	return GameObject::GetTransformStore().GetPosition( handle );
+}
+
+XMFLOAT3 Transform::GetRotationFloat3() const noexcept
+{
+	return GameObject::GetTransformStore().GetRotation( handle );
+}
+
+XMFLOAT3 Transform::GetScaleFloat3() const noexcept
+{
+	return GameObject::GetTransformStore().GetScale( handle );
+}
+
+// a root's world position is its position, only children need their transform resolved
+XMFLOAT3 Transform::GetWorldPositionFloat3() const noexcept
+{
+	if ( GetParent() == TransformStore::INVALID )
+		return GetPositionFloat3();
+	GameObject::ResolveTransform( handle );
+	const XMFLOAT4X4& world = GameObject::GetTransformStore().GetWorldMatrix( handle );
+	return XMFLOAT3( world._41, world._42, world._43 );
+}
+
+// resolved first, so only for the main thread, views read the store directly
+XMMATRIX Transform::GetWorldMatrix() const noexcept
+{
+	GameObject::ResolveTransform( handle );
+	return XMLoadFloat4x4( &GameObject::GetTransformStore().GetWorldMatrix( handle ) );
+}
+
+// the same directions GameObject3D keeps, worked out when asked for
+// a child's come from its world matrix, so that is resolved first
+XMVECTOR Transform::GetForwardVector( bool omitY ) const noexcept
+{
+	if ( GetParent() != TransformStore::INVALID )
+		GameObject::ResolveTransform( handle );
+	const TransformDirections directions = GameObject::GetTransformStore().GetDirections( handle );
+	return omitY ? directions.forwardNoY : directions.forward;
+}
+
+XMVECTOR Transform::GetRightVector( bool omitY ) const noexcept
+{
+	if ( GetParent() != TransformStore::INVALID )
+		GameObject::ResolveTransform( handle );
+	const TransformDirections directions = GameObject::GetTransformStore().GetDirections( handle );
+	return omitY ? directions.rightNoY : directions.right;
+}
+
+/// POSITIONS
+void Transform::SetInitialPosition( const XMFLOAT3& pos ) noexcept
+{
+	GameObject::GetTransformStore().SetInitialPosition( handle, pos );
+}
+
+void Transform::SetPosition( const XMVECTOR& pos ) noexcept
+{
+	XMFLOAT3 position;
+	XMStoreFloat3( &position, pos );
+	SetPosition( position );
+}
+
+void Transform::SetPosition( const XMFLOAT3& pos ) noexcept
+{
+	GameObject::GetTransformStore().SetPosition( handle, pos );
+}
+
+void Transform::SetPosition( float xPos, float yPos, float zPos ) noexcept
+{
+	SetPosition( XMFLOAT3( xPos, yPos, zPos ) );
+}
+
+void Transform::AdjustPosition( const XMVECTOR& pos ) noexcept
+{
+	const XMFLOAT3 position = GetPositionFloat3();
+	SetPosition( XMLoadFloat3( &position ) + pos );
+}
+
+void Transform::AdjustPosition( const XMFLOAT3& pos ) noexcept
+{
+	GameObject::GetTransformStore().AdjustPosition( handle, pos );
+}
+
+void Transform::ResetPosition() noexcept
+{
+	GameObject::GetTransformStore().ResetPosition( handle );
+}
+
+/// ROTATIONS
+void Transform::SetInitialRotation( const XMFLOAT3& rot ) noexcept
+{
+	GameObject::GetTransformStore().SetInitialRotation( handle, rot );
+}
+
+void Transform::SetRotation( const XMFLOAT3& rot ) noexcept
+{
+	GameObject::GetTransformStore().SetRotation( handle, rot );
+}
+
+void Transform::SetRotation( float xRot, float yRot, float zRot ) noexcept
+{
+	SetRotation( XMFLOAT3( xRot, yRot, zRot ) );
+}
+
+void Transform::AdjustRotation( const XMFLOAT3& rot ) noexcept
+{
+	GameObject::GetTransformStore().AdjustRotation( handle, rot );
+}
+
+void Transform::AdjustRotation( float xRot, float yRot, float zRot ) noexcept
+{
+	AdjustRotation( XMFLOAT3( xRot, yRot, zRot ) );
+}
+
+void Transform::ResetRotation() noexcept
+{
+	GameObject::GetTransformStore().ResetRotation( handle );
+}
+
+/// SCALE
+void Transform::SetInitialScale( float xScale, float yScale, float zScale ) noexcept
+{
+	GameObject::GetTransformStore().SetInitialScale( handle, { xScale, yScale, zScale } );
+}
+
+void Transform::SetScale( float xScale, float yScale, float zScale ) noexcept
+{
+	GameObject::GetTransformStore().SetScale( handle, { xScale, yScale, zScale } );
+}
+
+void Transform::AdjustScale( float xScale, float yScale, float zScale ) noexcept
+{
+	GameObject::GetTransformStore().AdjustScale( handle, { xScale, yScale, zScale } );
+}
+
+void Transform::ResetScale() noexcept
+{
+	GameObject::GetTransformStore().ResetScale( handle );
+}
+
+/// HIERARCHY
+// fails without changing anything if the parent is this transform or one of its children
+bool Transform::SetParent( TransformStore::Handle parent, bool keepWorldTransform ) noexcept
+{
+	return GameObject3D::AttachTransform( handle, parent, keepWorldTransform );
+}
+
+TransformStore::Handle Transform::GetParent() const noexcept
+{
+	return GameObject::GetTransformStore().GetParent( handle );
+}
\ No newline at end of file
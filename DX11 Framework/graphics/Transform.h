@@ -0,0 +1,56 @@
+#pragma once
+#ifndef TRANSFORM_H
+#define TRANSFORM_H
+
+#include "GameObject3D.h"
+
+// an entity's own transform in the shared store, released with the component
+// positions, rotations and scales are local, parents may be entities or objects alike
+// moves hand the handle over, so the world may shift components between archetypes freely
+class Transform
+{
+public:
+	Transform();
+	Transform( const Transform& ) = delete;
+	Transform& operator=( const Transform& ) = delete;
+	Transform( Transform&& other ) noexcept;
+	Transform& operator=( Transform&& other ) noexcept;
+	~Transform();
+
+	TransformStore::Handle GetHandle() const noexcept;
+	XMFLOAT3 GetPositionFloat3() const noexcept;
+	XMFLOAT3 GetRotationFloat3() const noexcept;
+	XMFLOAT3 GetScaleFloat3() const noexcept;
+	XMFLOAT3 GetWorldPositionFloat3() const noexcept;
+	XMMATRIX GetWorldMatrix() const noexcept;
+	XMVECTOR GetForwardVector( bool omitY = false ) const noexcept;
+	XMVECTOR GetRightVector( bool omitY = false ) const noexcept;
+
+	void SetInitialPosition( const XMFLOAT3& pos ) noexcept;
+	void SetPosition( const XMVECTOR& pos ) noexcept;
+	void SetPosition( const XMFLOAT3& pos ) noexcept;
+	void SetPosition( float xPos, float yPos, float zPos ) noexcept;
+	void AdjustPosition( const XMVECTOR& pos ) noexcept;
+	void AdjustPosition( const XMFLOAT3& pos ) noexcept;
+	void ResetPosition() noexcept;
+
+	void SetInitialRotation( const XMFLOAT3& rot ) noexcept;
+	void SetRotation( const XMFLOAT3& rot ) noexcept;
+	void SetRotation( float xRot, float yRot, float zRot ) noexcept;
+	void AdjustRotation( const XMFLOAT3& rot ) noexcept;
+	void AdjustRotation( float xRot, float yRot, float zRot ) noexcept;
+	void ResetRotation() noexcept;
+
+	void SetInitialScale( float xScale, float yScale, float zScale = 1.0f ) noexcept;
+	void SetScale( float xScale, float yScale, float zScale = 1.0f ) noexcept;
+	void AdjustScale( float xScale, float yScale, float zScale = 1.0f ) noexcept;
+	void ResetScale() noexcept;
+
+	bool SetParent( TransformStore::Handle parent, bool keepWorldTransform = false ) noexcept;
+	TransformStore::Handle GetParent() const noexcept;
+private:
+	void Release() noexcept;
+	TransformStore::Handle handle;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,468 @@
+#include "TransformStore.h"
+#include <algorithm>
+
+// released handles are reused before the streams grow
+TransformStore::Handle TransformStore::Allocate()
+{
+	Handle handle;
+	if ( !freeHandles.empty() )
+	{
+		handle = freeHandles.back();
+		freeHandles.pop_back();
+	}
+	else
+	{
+		handle = static_cast<Handle>( worldMatrices.size() );
+		for ( UINT axis = 0; axis < 3; axis++ )
+		{
+			position[axis].push_back( 0.0f );
+			rotation[axis].push_back( 0.0f );
+			scale[axis].push_back( 1.0f );
+		}
+		initialPositions.emplace_back();
+		initialRotations.emplace_back();
+		initialScales.emplace_back();
+		worldMatrices.emplace_back();
+		localMatrices.emplace_back();
+		parents.push_back( INVALID );
+		childCounts.push_back( 0u );
+		versions.push_back( 1u );
+		parentVersions.push_back( 0u );
+		if ( handle / 64u >= dirty.size() )
+			dirty.push_back( 0u );
+	}
+
+	for ( UINT axis = 0; axis < 3; axis++ )
+	{
+		position[axis][handle] = 0.0f;
+		rotation[axis][handle] = 0.0f;
+		scale[axis][handle] = 1.0f;
+	}
+	initialPositions[handle] = { 0.0f, 0.0f, 0.0f };
+	initialRotations[handle] = { 0.0f, 0.0f, 0.0f };
+	initialScales[handle] = { 1.0f, 1.0f, 1.0f };
+	parentVersions[handle] = 0u;
+	MarkDirty( handle );
+	statistics.transformCount++;
+	return handle;
+}
+
+// children of a released transform become roots, placed by their local values alone
+void TransformStore::Release( Handle handle ) noexcept
+{
+	for ( Handle child = 0; child < parents.size() && childCounts[handle] > 0u; child++ )
+		if ( parents[child] == handle )
+			SetParent( child, INVALID );
+	SetParent( handle, INVALID );
+	dirty[handle / 64u] &= ~( 1ull << ( handle % 64u ) );
+	freeHandles.push_back( handle );
+	statistics.transformCount--;
+}
+
+void TransformStore::SetPosition( Handle handle, const DirectX::XMFLOAT3& value ) noexcept
+{
+	position[0][handle] = value.x;
+	position[1][handle] = value.y;
+	position[2][handle] = value.z;
+	MarkDirty( handle );
+}
+
+void TransformStore::SetRotation( Handle handle, const DirectX::XMFLOAT3& value ) noexcept
+{
+	rotation[0][handle] = value.x;
+	rotation[1][handle] = value.y;
+	rotation[2][handle] = value.z;
+	MarkDirty( handle );
+}
+
+void TransformStore::SetScale( Handle handle, const DirectX::XMFLOAT3& value ) noexcept
+{
+	scale[0][handle] = value.x;
+	scale[1][handle] = value.y;
+	scale[2][handle] = value.z;
+	MarkDirty( handle );
+}
+
+void TransformStore::SetInitialPosition( Handle handle, const DirectX::XMFLOAT3& value ) noexcept
+{
+	initialPositions[handle] = value;
+	SetPosition( handle, value );
+}
+
+void TransformStore::SetInitialRotation( Handle handle, const DirectX::XMFLOAT3& value ) noexcept
+{
+	initialRotations[handle] = value;
+	SetRotation( handle, value );
+}
+
+void TransformStore::SetInitialScale( Handle handle, const DirectX::XMFLOAT3& value ) noexcept
+{
+	initialScales[handle] = value;
+	SetScale( handle, value );
+}
+
+void TransformStore::AdjustPosition( Handle handle, const DirectX::XMFLOAT3& offset ) noexcept
+{
+	SetPosition( handle, { position[0][handle] + offset.x, position[1][handle] + offset.y, position[2][handle] + offset.z } );
+}
+
+// pitch stops at straight up and straight down
+void TransformStore::AdjustRotation( Handle handle, const DirectX::XMFLOAT3& offset ) noexcept
+{
+	const float limit = DirectX::XMConvertToRadians( 90.0f );
+	const float pitch = std::clamp( rotation[0][handle] + offset.x, -limit, limit );
+	SetRotation( handle, { pitch, rotation[1][handle] + offset.y, rotation[2][handle] + offset.z } );
+}
+
+void TransformStore::AdjustScale( Handle handle, const DirectX::XMFLOAT3& offset ) noexcept
+{
+	SetScale( handle, { scale[0][handle] + offset.x, scale[1][handle] + offset.y, scale[2][handle] + offset.z } );
+}
+
+void TransformStore::ResetPosition( Handle handle ) noexcept
+{
+	SetPosition( handle, initialPositions[handle] );
+}
+
+void TransformStore::ResetRotation( Handle handle ) noexcept
+{
+	SetRotation( handle, initialRotations[handle] );
+}
+
+void TransformStore::ResetScale( Handle handle ) noexcept
+{
+	SetScale( handle, initialScales[handle] );
+}
+
+// local and initial values and the parent, so the copy starts where the source is and resets to where it would
+void TransformStore::Copy( Handle handle, Handle source ) noexcept
+{
+	SetPosition( handle, GetPosition( source ) );
+	SetRotation( handle, GetRotation( source ) );
+	SetScale( handle, GetScale( source ) );
+	initialPositions[handle] = initialPositions[source];
+	initialRotations[handle] = initialRotations[source];
+	initialScales[handle] = initialScales[source];
+	SetParent( handle, parents[source] );
+}
+
+// fails if the parent is the transform itself or one of its descendants, only possible once it has children
+bool TransformStore::SetParent( Handle handle, Handle parent ) noexcept
+{
+	if ( parent == parents[handle] )
+		return true;
+	if ( parent == handle )
+		return false;
+	for ( Handle ancestor = parent; ancestor != INVALID && childCounts[handle] > 0u; ancestor = parents[ancestor] )
+		if ( ancestor == handle )
+			return false;
+
+	if ( parents[handle] != INVALID )
+	{
+		childCounts[parents[handle]]--;
+		statistics.attachedCount--;
+	}
+	if ( parent != INVALID )
+	{
+		childCounts[parent]++;
+		statistics.attachedCount++;
+	}
+	parents[handle] = parent;
+	parentVersions[handle] = 0u;
+	orderDirty = true;
+	MarkDirty( handle );
+	return true;
+}
+
+TransformStore::Handle TransformStore::GetParent( Handle handle ) const noexcept
+{
+	return parents[handle];
+}
+
+DirectX::XMFLOAT3 TransformStore::GetPosition( Handle handle ) const noexcept
+{
+	return { position[0][handle], position[1][handle], position[2][handle] };
+}
+
+DirectX::XMFLOAT3 TransformStore::GetRotation( Handle handle ) const noexcept
+{
+	return { rotation[0][handle], rotation[1][handle], rotation[2][handle] };
+}
+
+DirectX::XMFLOAT3 TransformStore::GetScale( Handle handle ) const noexcept
+{
+	return { scale[0][handle], scale[1][handle], scale[2][handle] };
+}
+
+// stale if the entry or any of its ancestors changed since its world matrix was built
+bool TransformStore::IsDirty( Handle handle ) const noexcept
+{
+	for ( ;; )
+	{
+		if ( IsMarked( handle ) )
+			return true;
+		const Handle parent = parents[handle];
+		if ( parent == INVALID )
+			return false;
+		if ( parentVersions[handle] != versions[parent] )
+			return true;
+		handle = parent;
+	}
+}
+
+// only current while the entry isn't dirty
+const DirectX::XMFLOAT4X4& TransformStore::GetWorldMatrix( Handle handle ) const noexcept
+{
+	return worldMatrices[handle];
+}
+
+// a child's come from its world matrix, whose rows are its right, up and forward axes with the parent's rotation applied,
+// so they are only current while the entry isn't dirty, roll is left out of a root's as the camera has none
+TransformDirections TransformStore::GetDirections( Handle handle ) const noexcept
+{
+	using namespace DirectX;
+	TransformDirections directions;
+	if ( parents[handle] != INVALID )
+	{
+		const XMMATRIX world = XMLoadFloat4x4( &worldMatrices[handle] );
+		directions.forward = XMVector3Normalize( world.r[2] );
+		directions.right = XMVector3Normalize( world.r[0] );
+		directions.rightNoY = XMVector3Normalize( XMVectorSelect( directions.right, XMVectorZero(), g_XMSelect0100 ) );
+		directions.forwardNoY = XMVector3Cross( directions.rightNoY, XMVectorSet( 0.0f, 1.0f, 0.0f, 0.0f ) );
+		return directions;
+	}
+
+	const XMVECTOR defaultForward = XMVectorSet( 0.0f, 0.0f, 1.0f, 0.0f );
+	const XMVECTOR defaultRight = XMVectorSet( 1.0f, 0.0f, 0.0f, 0.0f );
+	const XMMATRIX rotationMatrix = XMMatrixRotationRollPitchYaw( rotation[0][handle], rotation[1][handle], 0.0f );
+	directions.forward = XMVector3TransformCoord( defaultForward, rotationMatrix );
+	directions.right = XMVector3TransformCoord( defaultRight, rotationMatrix );
+	const XMMATRIX rotationMatrixNoY = XMMatrixRotationRollPitchYaw( 0.0f, rotation[1][handle], 0.0f );
+	directions.forwardNoY = XMVector3TransformCoord( defaultForward, rotationMatrixNoY );
+	directions.rightNoY = XMVector3TransformCoord( defaultRight, rotationMatrixNoY );
+	return directions;
+}
+
+// moves on every time the world matrix is rebuilt, never repeats for a handle even once it is reused
+UINT64 TransformStore::GetVersion( Handle handle ) const noexcept
+{
+	return versions[handle];
+}
+
+// brings the entry and any stale ancestors up to date, top down
+// handles whose world matrix was rebuilt are appended to updated, parents first
+void TransformStore::UpdateWorldMatrix( Handle handle, std::vector<Handle>* updated )
+{
+	using namespace DirectX;
+	chain.clear();
+	for ( Handle link = handle; link != INVALID; link = parents[link] )
+		chain.push_back( link );
+	for ( size_t i = chain.size(); i-- > 0; )
+	{
+		const Handle link = chain[i];
+		const Handle parent = parents[link];
+		const bool changed = IsMarked( link );
+		if ( !changed && ( parent == INVALID || parentVersions[link] == versions[parent] ) )
+			continue;
+		if ( changed )
+		{
+			const XMMATRIX local = XMMatrixScaling( scale[0][link], scale[1][link], scale[2][link] ) *
+				XMMatrixRotationRollPitchYaw( rotation[0][link], rotation[1][link], rotation[2][link] ) *
+				XMMatrixTranslation( position[0][link], position[1][link], position[2][link] );
+			XMStoreFloat4x4( parent == INVALID ? &worldMatrices[link] : &localMatrices[link], local );
+			dirty[link / 64u] &= ~( 1ull << ( link % 64u ) );
+		}
+		if ( parent != INVALID )
+			UpdateChild( link );
+		else
+			versions[link]++;
+		statistics.resolvedCount++;
+		if ( updated != nullptr )
+			updated->push_back( link );
+	}
+}
+
+// walks the dirty bits a word at a time so clean stretches cost almost nothing, then propagates to children
+// returns how many world matrices were rebuilt, their handles are appended to updated with parents ahead of children
+UINT TransformStore::UpdateWorldMatrices( std::vector<Handle>* updated )
+{
+	Handle group[4];
+	UINT groupSize = 0;
+	UINT batchedCount = 0;
+	UINT updatedCount = 0;
+	for ( UINT word = 0; word < dirty.size(); word++ )
+	{
+		UINT64 bits = dirty[word];
+		dirty[word] = 0u;
+		for ( UINT bit = 0; bits != 0u; bit++, bits >>= 1 )
+		{
+			if ( ( bits & 1u ) == 0u )
+				continue;
+			const Handle handle = word * 64u + bit;
+			group[groupSize++] = handle;
+			if ( groupSize == 4u )
+			{
+				UpdateGroup( group );
+				groupSize = 0;
+			}
+			batchedCount++;
+
+			// a root's world matrix is final here, a child's waits for its parent
+			if ( parents[handle] == INVALID )
+			{
+				versions[handle]++;
+				updatedCount++;
+				if ( updated != nullptr )
+					updated->push_back( handle );
+			}
+			else
+				parentVersions[handle] = 0u;
+		}
+	}
+
+	// a short last group repeats its final entry, writing the same matrix more than once is harmless
+	if ( groupSize > 0u )
+	{
+		for ( UINT i = groupSize; i < 4u; i++ )
+			group[i] = group[groupSize - 1];
+		UpdateGroup( group );
+	}
+	statistics.batchedCount += batchedCount;
+
+	// every parent comes earlier in the order, so the world matrix read here is already current
+	if ( orderDirty )
+		UpdateOrder();
+	for ( Handle handle : order )
+	{
+		if ( parentVersions[handle] == versions[parents[handle]] )
+			continue;
+		UpdateChild( handle );
+		statistics.propagatedCount++;
+		updatedCount++;
+		if ( updated != nullptr )
+			updated->push_back( handle );
+	}
+	return updatedCount;
+}
+
+UINT TransformStore::GetCount() const noexcept
+{
+	return statistics.transformCount;
+}
+
+const TransformStatistics& TransformStore::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+void TransformStore::ResetStatistics() noexcept
+{
+	statistics.batchedCount = 0;
+	statistics.resolvedCount = 0;
+	statistics.propagatedCount = 0;
+}
+
+void TransformStore::MarkDirty( Handle handle ) noexcept
+{
+	dirty[handle / 64u] |= 1ull << ( handle % 64u );
+}
+
+bool TransformStore::IsMarked( Handle handle ) const noexcept
+{
+	return ( dirty[handle / 64u] >> ( handle % 64u ) & 1u ) != 0u;
+}
+
+// four world matrices at once, one lane per transform
+// the rotation matches XMMatrixRotationRollPitchYaw, roll about z, then pitch about x, then yaw about y
+void TransformStore::UpdateGroup( const Handle* handles ) noexcept
+{
+	using namespace DirectX;
+	auto gather = [handles]( const std::vector<float>& stream )
+	{
+		return XMVectorSet( stream[handles[0]], stream[handles[1]], stream[handles[2]], stream[handles[3]] );
+	};
+	XMVECTOR sp, cp, sy, cy, sr, cr;
+	XMVectorSinCos( &sp, &cp, gather( rotation[0] ) );
+	XMVectorSinCos( &sy, &cy, gather( rotation[1] ) );
+	XMVectorSinCos( &sr, &cr, gather( rotation[2] ) );
+
+	const XMVECTOR srsp = XMVectorMultiply( sr, sp );
+	const XMVECTOR crsp = XMVectorMultiply( cr, sp );
+	const XMVECTOR scaleX = gather( scale[0] );
+	const XMVECTOR scaleY = gather( scale[1] );
+	const XMVECTOR scaleZ = gather( scale[2] );
+
+	// each matrix holds one row of all four transforms, transposing it gives that row of each transform
+	XMMATRIX rows[4];
+	rows[0].r[0] = XMVectorMultiply( scaleX, XMVectorMultiplyAdd( srsp, sy, XMVectorMultiply( cr, cy ) ) );
+	rows[0].r[1] = XMVectorMultiply( scaleX, XMVectorMultiply( sr, cp ) );
+	rows[0].r[2] = XMVectorMultiply( scaleX, XMVectorNegativeMultiplySubtract( cr, sy, XMVectorMultiply( srsp, cy ) ) );
+	rows[0].r[3] = XMVectorZero();
+	rows[1].r[0] = XMVectorMultiply( scaleY, XMVectorNegativeMultiplySubtract( sr, cy, XMVectorMultiply( crsp, sy ) ) );
+	rows[1].r[1] = XMVectorMultiply( scaleY, XMVectorMultiply( cr, cp ) );
+	rows[1].r[2] = XMVectorMultiply( scaleY, XMVectorMultiplyAdd( sr, sy, XMVectorMultiply( crsp, cy ) ) );
+	rows[1].r[3] = XMVectorZero();
+	rows[2].r[0] = XMVectorMultiply( scaleZ, XMVectorMultiply( cp, sy ) );
+	rows[2].r[1] = XMVectorMultiply( scaleZ, XMVectorNegate( sp ) );
+	rows[2].r[2] = XMVectorMultiply( scaleZ, XMVectorMultiply( cp, cy ) );
+	rows[2].r[3] = XMVectorZero();
+	rows[3].r[0] = gather( position[0] );
+	rows[3].r[1] = gather( position[1] );
+	rows[3].r[2] = gather( position[2] );
+	rows[3].r[3] = XMVectorSplatOne();
+	for ( UINT i = 0; i < 4; i++ )
+		rows[i] = XMMatrixTranspose( rows[i] );
+
+	// a child's matrix is local until its parent's world matrix is applied
+	for ( UINT i = 0; i < 4; i++ )
+	{
+		XMMATRIX matrix;
+		matrix.r[0] = rows[0].r[i];
+		matrix.r[1] = rows[1].r[i];
+		matrix.r[2] = rows[2].r[i];
+		matrix.r[3] = rows[3].r[i];
+		const Handle handle = handles[i];
+		XMStoreFloat4x4( parents[handle] == INVALID ? &worldMatrices[handle] : &localMatrices[handle], matrix );
+	}
+}
+
+void TransformStore::UpdateChild( Handle handle ) noexcept
+{
+	using namespace DirectX;
+	const Handle parent = parents[handle];
+	XMStoreFloat4x4( &worldMatrices[handle], XMLoadFloat4x4( &localMatrices[handle] ) * XMLoadFloat4x4( &worldMatrices[parent] ) );
+	parentVersions[handle] = versions[parent];
+	versions[handle]++;
+}
+
+// children only, each after its parent and otherwise in ascending handles
+// objects made after their parents, the usual case, are then walked straight through memory
+void TransformStore::UpdateOrder()
+{
+	std::vector<UINT> depths( parents.size(), 0u );
+	UINT maxDepth = 0;
+	order.clear();
+	for ( Handle handle = 0; handle < parents.size(); handle++ )
+	{
+		if ( parents[handle] == INVALID || depths[handle] != 0u )
+			continue;
+
+		// up to a root or a transform already placed, then place the rest on the way back down
+		chain.clear();
+		Handle link = handle;
+		while ( parents[link] != INVALID && depths[link] == 0u )
+		{
+			chain.push_back( link );
+			link = parents[link];
+		}
+		UINT depth = depths[link];
+		for ( size_t i = chain.size(); i-- > 0; )
+		{
+			depths[chain[i]] = ++depth;
+			order.push_back( chain[i] );
+		}
+		maxDepth = std::max( maxDepth, depth );
+	}
+	statistics.depth = maxDepth;
+	orderDirty = false;
+}
\ No newline at end of file
@@ -0,0 +1,97 @@
+#pragma once
+#ifndef TRANSFORMSTORE_H
+#define TRANSFORMSTORE_H
+
+#include <Windows.h>
+#include <DirectXMath.h>
+#include <vector>
+
+struct TransformStatistics
+{
+	UINT transformCount = 0;
+	UINT batchedCount = 0;
+	UINT resolvedCount = 0;
+	UINT propagatedCount = 0;
+	UINT attachedCount = 0;
+	UINT depth = 0;
+};
+
+// the directions a transform faces, from its rotation or, once it has a parent, from its world matrix
+// the ones without y stay level, backward and left are these negated
+struct TransformDirections
+{
+	DirectX::XMVECTOR forward;
+	DirectX::XMVECTOR right;
+	DirectX::XMVECTOR forwardNoY;
+	DirectX::XMVECTOR rightNoY;
+};
+
+// positions, euler rotations and scales of every transform, each component in its own contiguous stream
+// setters only mark an entry dirty, world matrices are rebuilt four at a time by UpdateWorldMatrices,
+// or one at a time by UpdateWorldMatrix when one is read before the batch runs
+// world matrices are scale, then roll pitch yaw, then translation, then the parent's world matrix
+// children are propagated after the batch, parents first, only those whose parent's world matrix moved on
+// since they were last built are rebuilt, so a still subtree costs one comparison per transform
+class TransformStore
+{
+public:
+	using Handle = UINT;
+	static constexpr Handle INVALID = UINT_MAX;
+	Handle Allocate();
+	void Release( Handle handle ) noexcept;
+	void SetPosition( Handle handle, const DirectX::XMFLOAT3& position ) noexcept;
+	void SetRotation( Handle handle, const DirectX::XMFLOAT3& rotation ) noexcept;
+	void SetScale( Handle handle, const DirectX::XMFLOAT3& scale ) noexcept;
+	// the values a reset returns to, setting them sets the transform as well
+	void SetInitialPosition( Handle handle, const DirectX::XMFLOAT3& position ) noexcept;
+	void SetInitialRotation( Handle handle, const DirectX::XMFLOAT3& rotation ) noexcept;
+	void SetInitialScale( Handle handle, const DirectX::XMFLOAT3& scale ) noexcept;
+	void AdjustPosition( Handle handle, const DirectX::XMFLOAT3& offset ) noexcept;
+	void AdjustRotation( Handle handle, const DirectX::XMFLOAT3& offset ) noexcept;
+	void AdjustScale( Handle handle, const DirectX::XMFLOAT3& offset ) noexcept;
+	void ResetPosition( Handle handle ) noexcept;
+	void ResetRotation( Handle handle ) noexcept;
+	void ResetScale( Handle handle ) noexcept;
+	void Copy( Handle handle, Handle source ) noexcept;
+	bool SetParent( Handle handle, Handle parent ) noexcept;
+	Handle GetParent( Handle handle ) const noexcept;
+	DirectX::XMFLOAT3 GetPosition( Handle handle ) const noexcept;
+	DirectX::XMFLOAT3 GetRotation( Handle handle ) const noexcept;
+	DirectX::XMFLOAT3 GetScale( Handle handle ) const noexcept;
+	bool IsDirty( Handle handle ) const noexcept;
+	const DirectX::XMFLOAT4X4& GetWorldMatrix( Handle handle ) const noexcept;
+	TransformDirections GetDirections( Handle handle ) const noexcept;
+	UINT64 GetVersion( Handle handle ) const noexcept;
+	void UpdateWorldMatrix( Handle handle, std::vector<Handle>* updated = nullptr );
+	UINT UpdateWorldMatrices( std::vector<Handle>* updated = nullptr );
+	UINT GetCount() const noexcept;
+	const TransformStatistics& GetStatistics() const noexcept;
+	void ResetStatistics() noexcept;
+private:
+	void MarkDirty( Handle handle ) noexcept;
+	bool IsMarked( Handle handle ) const noexcept;
+	void UpdateGroup( const Handle* handles ) noexcept;
+	void UpdateChild( Handle handle ) noexcept;
+	void UpdateOrder();
+private:
+	std::vector<float> position[3];
+	std::vector<float> rotation[3];
+	std::vector<float> scale[3];
+	std::vector<DirectX::XMFLOAT3> initialPositions;
+	std::vector<DirectX::XMFLOAT3> initialRotations;
+	std::vector<DirectX::XMFLOAT3> initialScales;
+	std::vector<DirectX::XMFLOAT4X4> worldMatrices;
+	std::vector<DirectX::XMFLOAT4X4> localMatrices;
+	std::vector<UINT64> dirty;
+	std::vector<Handle> freeHandles;
+	std::vector<Handle> parents;
+	std::vector<UINT> childCounts;
+	std::vector<UINT64> versions;
+	std::vector<UINT64> parentVersions;
+	std::vector<Handle> order;
+	std::vector<Handle> chain;
+	bool orderDirty = false;
+	TransformStatistics statistics;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,146 @@
+#include "TriangleBVH.h"
+#include "VertexQuantizer.h"
+#include <algorithm>
+
+void TriangleBVH::Build( const MeshData& meshData )
+{
+	// level zero is the full detail mesh, coarser levels sit further along the same index buffer
+	const UINT indexCount = meshData.lods.empty() ? meshData.GetIndexCount() : meshData.lods[0].indexCount;
+	const UINT indexOffset = meshData.lods.empty() ? 0u : meshData.lods[0].indexOffset;
+	const UINT triangleCount = indexCount / 3;
+
+	std::vector<DirectX::XMFLOAT3> positions( meshData.GetVertexCount() );
+	for ( UINT i = 0; i < positions.size(); i++ )
+	{
+		if ( meshData.IsQuantized() )
+			positions[i] = VertexQuantizer::Decode( meshData.GetQuantizedVertices()[i], meshData.quantization ).pos;
+		else
+			positions[i] = meshData.GetVertices()[i].pos;
+	}
+
+	std::vector<DirectX::BoundingBox> bounds( triangleCount );
+	for ( UINT i = 0; i < triangleCount; i++ )
+	{
+		const DirectX::XMVECTOR a = DirectX::XMLoadFloat3( &positions[meshData.GetIndex( indexOffset + i * 3 )] );
+		const DirectX::XMVECTOR b = DirectX::XMLoadFloat3( &positions[meshData.GetIndex( indexOffset + i * 3 + 1 )] );
+		const DirectX::XMVECTOR c = DirectX::XMLoadFloat3( &positions[meshData.GetIndex( indexOffset + i * 3 + 2 )] );
+		DirectX::BoundingBox::CreateFromPoints( bounds[i], DirectX::XMVectorMin( a, DirectX::XMVectorMin( b, c ) ),
+			DirectX::XMVectorMax( a, DirectX::XMVectorMax( b, c ) ) );
+	}
+	bvh.Build( bounds );
+
+	// a leaf's last group of four may run past it, the padding keeps those loads inside the streams
+	const std::vector<UINT>& order = bvh.GetObjectOrder();
+	triangles = order;
+	for ( UINT axis = 0; axis < 3; axis++ )
+	{
+		vertex[axis].assign( triangleCount + 3, 0.0f );
+		edge1[axis].assign( triangleCount + 3, 0.0f );
+		edge2[axis].assign( triangleCount + 3, 0.0f );
+	}
+	for ( UINT i = 0; i < triangleCount; i++ )
+	{
+		const UINT first = indexOffset + order[i] * 3;
+		const DirectX::XMFLOAT3& a = positions[meshData.GetIndex( first )];
+		const DirectX::XMFLOAT3& b = positions[meshData.GetIndex( first + 1 )];
+		const DirectX::XMFLOAT3& c = positions[meshData.GetIndex( first + 2 )];
+		const float pa[3] = { a.x, a.y, a.z };
+		const float pb[3] = { b.x, b.y, b.z };
+		const float pc[3] = { c.x, c.y, c.z };
+		for ( UINT axis = 0; axis < 3; axis++ )
+		{
+			vertex[axis][i] = pa[axis];
+			edge1[axis][i] = pb[axis] - pa[axis];
+			edge2[axis][i] = pc[axis] - pa[axis];
+		}
+	}
+}
+
+TriangleHit TriangleBVH::Intersect( const PickRay& ray ) const noexcept
+{
+	TriangleHit hit;
+	bvh.IntersectLeaves( ray, [this, &ray, &hit]( UINT first, UINT count, float& nearest )
+	{
+		IntersectTriangles( first, count, ray, nearest, hit );
+	} );
+	return hit;
+}
+
+UINT TriangleBVH::GetTriangleCount() const noexcept
+{
+	return static_cast<UINT>( triangles.size() );
+}
+
+const BVHStatistics& TriangleBVH::GetStatistics() const noexcept
+{
+	return bvh.GetStatistics();
+}
+
+// moller trumbore four triangles at a time, lanes past the range or further than nearest are masked off
+// a ray in the triangle's plane has a zero determinant, the nans that follow fail every comparison
+void TriangleBVH::IntersectTriangles( UINT first, UINT count, const PickRay& ray, float& nearest, TriangleHit& hit ) const noexcept
+{
+	using namespace DirectX;
+	const XMVECTOR dx = XMVectorReplicate( ray.direction.x );
+	const XMVECTOR dy = XMVectorReplicate( ray.direction.y );
+	const XMVECTOR dz = XMVectorReplicate( ray.direction.z );
+	const XMVECTOR zero = XMVectorZero();
+	const XMVECTOR one = XMVectorSplatOne();
+	const XMVECTOR lanes = XMVectorSet( 0.0f, 1.0f, 2.0f, 3.0f );
+	for ( UINT i = first; i < first + count; i += 4 )
+	{
+		const XMVECTOR e1x = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &edge1[0][i] ) );
+		const XMVECTOR e1y = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &edge1[1][i] ) );
+		const XMVECTOR e1z = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &edge1[2][i] ) );
+		const XMVECTOR e2x = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &edge2[0][i] ) );
+		const XMVECTOR e2y = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &edge2[1][i] ) );
+		const XMVECTOR e2z = XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &edge2[2][i] ) );
+
+		// p = d x e2, det = e1 . p
+		const XMVECTOR px = XMVectorSubtract( XMVectorMultiply( dy, e2z ), XMVectorMultiply( dz, e2y ) );
+		const XMVECTOR py = XMVectorSubtract( XMVectorMultiply( dz, e2x ), XMVectorMultiply( dx, e2z ) );
+		const XMVECTOR pz = XMVectorSubtract( XMVectorMultiply( dx, e2y ), XMVectorMultiply( dy, e2x ) );
+		const XMVECTOR det = XMVectorMultiplyAdd( e1x, px, XMVectorMultiplyAdd( e1y, py, XMVectorMultiply( e1z, pz ) ) );
+		const XMVECTOR inverseDet = XMVectorReciprocal( det );
+
+		// s = o - v0, q = s x e1
+		const XMVECTOR sx = XMVectorSubtract( XMVectorReplicate( ray.origin.x ), XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &vertex[0][i] ) ) );
+		const XMVECTOR sy = XMVectorSubtract( XMVectorReplicate( ray.origin.y ), XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &vertex[1][i] ) ) );
+		const XMVECTOR sz = XMVectorSubtract( XMVectorReplicate( ray.origin.z ), XMLoadFloat4( reinterpret_cast<const XMFLOAT4*>( &vertex[2][i] ) ) );
+		const XMVECTOR u = XMVectorMultiply( XMVectorMultiplyAdd( sx, px, XMVectorMultiplyAdd( sy, py, XMVectorMultiply( sz, pz ) ) ), inverseDet );
+		const XMVECTOR qx = XMVectorSubtract( XMVectorMultiply( sy, e1z ), XMVectorMultiply( sz, e1y ) );
+		const XMVECTOR qy = XMVectorSubtract( XMVectorMultiply( sz, e1x ), XMVectorMultiply( sx, e1z ) );
+		const XMVECTOR qz = XMVectorSubtract( XMVectorMultiply( sx, e1y ), XMVectorMultiply( sy, e1x ) );
+		const XMVECTOR v = XMVectorMultiply( XMVectorMultiplyAdd( dx, qx, XMVectorMultiplyAdd( dy, qy, XMVectorMultiply( dz, qz ) ) ), inverseDet );
+		const XMVECTOR t = XMVectorMultiply( XMVectorMultiplyAdd( e2x, qx, XMVectorMultiplyAdd( e2y, qy, XMVectorMultiply( e2z, qz ) ) ), inverseDet );
+
+		XMVECTOR inside = XMVectorAndInt( XMVectorGreaterOrEqual( u, zero ), XMVectorGreaterOrEqual( v, zero ) );
+		inside = XMVectorAndInt( inside, XMVectorLessOrEqual( XMVectorAdd( u, v ), one ) );
+		inside = XMVectorAndInt( inside, XMVectorGreaterOrEqual( t, zero ) );
+		inside = XMVectorAndInt( inside, XMVectorLess( t, XMVectorReplicate( nearest ) ) );
+		inside = XMVectorAndInt( inside, XMVectorLess( lanes, XMVectorReplicate( static_cast<float>( first + count - i ) ) ) );
+
+		XMUINT4 mask;
+		XMStoreUInt4( &mask, inside );
+		if ( ( mask.x | mask.y | mask.z | mask.w ) == 0u )
+			continue;
+		const UINT hits[4] = { mask.x, mask.y, mask.z, mask.w };
+		XMFLOAT4 distances, us, vs;
+		XMStoreFloat4( &distances, t );
+		XMStoreFloat4( &us, u );
+		XMStoreFloat4( &vs, v );
+		const float laneDistances[4] = { distances.x, distances.y, distances.z, distances.w };
+		const float laneUs[4] = { us.x, us.y, us.z, us.w };
+		const float laneVs[4] = { vs.x, vs.y, vs.z, vs.w };
+		for ( UINT k = 0; k < 4; k++ )
+		{
+			if ( hits[k] == 0u || laneDistances[k] >= nearest )
+				continue;
+			nearest = laneDistances[k];
+			hit.triangle = triangles[i + k];
+			hit.distance = laneDistances[k];
+			hit.u = laneUs[k];
+			hit.v = laneVs[k];
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,42 @@
+#pragma once
+#ifndef TRIANGLEBVH_H
+#define TRIANGLEBVH_H
+
+#include "BoundingVolumeHierarchy.h"
+
+struct MeshData;
+
+// closest triangle along a ray, u and v weight the triangle's second and third vertices
+// object and mesh are filled in by whoever tested more than one triangle set
+struct TriangleHit
+{
+	UINT object = UINT_MAX;
+	UINT mesh = UINT_MAX;
+	UINT triangle = UINT_MAX;
+	float distance = FLT_MAX;
+	float u = 0.0f;
+	float v = 0.0f;
+	bool IsHit() const noexcept { return distance != FLT_MAX; }
+};
+
+// mesh space hierarchy over the full detail triangles of one mesh, built once when the mesh is loaded
+// triangles are stored by leaf as a vertex and two edges in separate x, y and z streams
+// so a leaf's triangles are tested four at a time, both faces count as a hit
+class TriangleBVH
+{
+public:
+	void Build( const MeshData& meshData );
+	TriangleHit Intersect( const PickRay& ray ) const noexcept;
+	UINT GetTriangleCount() const noexcept;
+	const BVHStatistics& GetStatistics() const noexcept;
+private:
+	void IntersectTriangles( UINT first, UINT count, const PickRay& ray, float& nearest, TriangleHit& hit ) const noexcept;
+private:
+	BoundingVolumeHierarchy bvh;
+	std::vector<float> vertex[3];
+	std::vector<float> edge1[3];
+	std::vector<float> edge2[3];
+	std::vector<UINT> triangles;
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,54 @@
+#include "UploadRingAllocator.h"
+
+void UploadRingAllocator::Reset( uint32_t capacity ) noexcept
+{
+	this->capacity = capacity - capacity % ALIGNMENT;
+	head = 0;
+	discardPending = true;
+}
+
+void UploadRingAllocator::BeginFrame() noexcept
+{
+	discardPending = true;
+	generation++;
+}
+
+bool UploadRingAllocator::Allocate( uint32_t size, Allocation& allocation ) noexcept
+{
+	// capacity is a multiple of the alignment, so a size that fits still fits once aligned and can't overflow
+	if ( size == 0 || size > capacity )
+		return false;
+	const uint32_t alignedSize = AlignSize( size );
+	if ( discardPending )
+		head = 0;
+	else if ( alignedSize > capacity - head )
+		return false;
+
+	// discarding hands back a fresh buffer, so last frame's blocks can never be overwritten while still in flight
+	allocation.discard = discardPending;
+	allocation.offset = head;
+	allocation.size = alignedSize;
+	head += alignedSize;
+	discardPending = false;
+	return true;
+}
+
+uint32_t UploadRingAllocator::GetCapacity() const noexcept
+{
+	return capacity;
+}
+
+uint32_t UploadRingAllocator::GetHead() const noexcept
+{
+	return head;
+}
+
+uint32_t UploadRingAllocator::GetGeneration() const noexcept
+{
+	return generation;
+}
+
+uint32_t UploadRingAllocator::AlignSize( uint32_t size ) noexcept
+{
+	return ( size + ALIGNMENT - 1 ) & ~( ALIGNMENT - 1 );
+}
\ No newline at end of file
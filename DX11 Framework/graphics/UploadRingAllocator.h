@@ -0,0 +1,35 @@
+#pragma once
+#ifndef UPLOADRINGALLOCATOR_H
+#define UPLOADRINGALLOCATOR_H
+
+#include <cstdint>
+
+// hands out 256 byte aligned blocks of a fixed size ring, knows nothing of d3d
+// the first block of a frame restarts at zero and must discard the buffer
+// a full ring refuses blocks until the next frame, discarding mid-frame would pull data out from under earlier binds
+// each frame is a new generation, blocks handed out in an earlier one may have been discarded and must be uploaded again
+class UploadRingAllocator
+{
+public:
+	static constexpr uint32_t ALIGNMENT = 256u;
+	struct Allocation
+	{
+		uint32_t offset = 0;
+		uint32_t size = 0;
+		bool discard = false;
+	};
+	void Reset( uint32_t capacity ) noexcept;
+	void BeginFrame() noexcept;
+	bool Allocate( uint32_t size, Allocation& allocation ) noexcept;
+	uint32_t GetCapacity() const noexcept;
+	uint32_t GetHead() const noexcept;
+	uint32_t GetGeneration() const noexcept;
+	static uint32_t AlignSize( uint32_t size ) noexcept;
+private:
+	uint32_t capacity = 0;
+	uint32_t head = 0;
+	uint32_t generation = 0;
+	bool discardPending = true;
+};
+
+#endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #define VERTEX_H
 
 #include <DirectXMath.h>
+#include <DirectXPackedVector.h>
 
 struct Vertex3D
 {
@@ -11,6 +12,22 @@ struct Vertex3D
 	DirectX::XMFLOAT3 normals;
 };
 
+// compact Vertex3D, half the size
+// position is normalized to the mesh bounds, normal is octahedral encoded, texture coordinates are half precision
+struct Vertex3DQuantized
+{
+	DirectX::PackedVector::XMUSHORTN4 pos;
+	DirectX::PackedVector::XMHALF2 texCoord;
+	DirectX::PackedVector::XMSHORTN2 normals;
+};
+
+// decoded position = positionOffset + pos * positionScale
+struct VertexQuantization
+{
+	DirectX::XMFLOAT3 positionOffset = { 0.0f, 0.0f, 0.0f };
+	DirectX::XMFLOAT3 positionScale = { 1.0f, 1.0f, 1.0f };
+};
+
 struct Vertex2D
 {
 	DirectX::XMFLOAT3 pos;
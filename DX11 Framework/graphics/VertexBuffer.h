@@ -5,6 +5,7 @@
 #include <d3d11.h>
 #include <wrl/client.h>
 #include <memory>
+#include <algorithm>
 
 template<class T>
 class VertexBuffer
@@ -49,7 +50,7 @@ public:
 	{
 		return &stride;
 	}
-	HRESULT Initialize( ID3D11Device* device, T* data, UINT vertexCount )
+	HRESULT Initialize( ID3D11Device* device, const T* data, UINT vertexCount )
 	{
 		if ( buffer.Get() != nullptr )
 			buffer.Reset();
@@ -69,6 +70,34 @@ public:
 		HRESULT hr = device->CreateBuffer( &vertexBufferDesc, &vertexBufferData, buffer.GetAddressOf() );
 		return hr;
 	}
+	// dynamic buffer of up to vertexCount elements, filled by Update
+	HRESULT Initialize( ID3D11Device* device, UINT vertexCount )
+	{
+		if ( buffer.Get() != nullptr )
+			buffer.Reset();
+
+		this->vertexCount = vertexCount;
+
+		D3D11_BUFFER_DESC vertexBufferDesc = { 0 };
+		vertexBufferDesc.Usage = D3D11_USAGE_DYNAMIC;
+		vertexBufferDesc.ByteWidth = stride * vertexCount;
+		vertexBufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
+		vertexBufferDesc.CPUAccessFlags = D3D11_CPU_ACCESS_WRITE;
+		vertexBufferDesc.MiscFlags = 0;
+
+		HRESULT hr = device->CreateBuffer( &vertexBufferDesc, NULL, buffer.GetAddressOf() );
+		return hr;
+	}
+	HRESULT Update( ID3D11DeviceContext* context, const T* data, UINT count )
+	{
+		D3D11_MAPPED_SUBRESOURCE mappedResource;
+		HRESULT hr = context->Map( buffer.Get(), 0, D3D11_MAP_WRITE_DISCARD, 0, &mappedResource );
+		if ( FAILED( hr ) )
+			return hr;
+		CopyMemory( mappedResource.pData, data, stride * static_cast<size_t>( std::min( count, vertexCount ) ) );
+		context->Unmap( buffer.Get(), 0 );
+		return hr;
+	}
 };
 
 #endif
\ No newline at end of file
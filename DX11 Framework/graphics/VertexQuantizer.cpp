@@ -0,0 +1,125 @@
+#include "VertexQuantizer.h"
+#include <algorithm>
+#include <cmath>
+#include <cfloat>
+
+using namespace DirectX;
+using namespace DirectX::PackedVector;
+
+bool VertexQuantizer::Quantize( MeshData& meshData )
+{
+	if ( meshData.IsQuantized() || meshData.mappedVertices != nullptr || meshData.GetVertexCount() == 0 )
+		return false;
+
+	const Vertex3D* vertices = meshData.GetVertices();
+	const UINT vertexCount = meshData.GetVertexCount();
+	const VertexQuantization quantization = GetQuantization( vertices, vertexCount );
+	std::vector<Vertex3DQuantized> quantizedVertices( vertexCount );
+	for ( UINT i = 0; i < vertexCount; i++ )
+		quantizedVertices[i] = Encode( vertices[i], quantization );
+
+	if ( !IsWithinTolerance( Measure( vertices, quantizedVertices.data(), vertexCount, quantization ) ) )
+		return false;
+
+	meshData.quantizedVertices.swap( quantizedVertices );
+	meshData.quantization = quantization;
+	std::vector<Vertex3D>().swap( meshData.vertices );
+	return true;
+}
+
+VertexQuantization VertexQuantizer::GetQuantization( const Vertex3D* vertices, UINT vertexCount )
+{
+	XMVECTOR minimum = XMVectorReplicate( FLT_MAX );
+	XMVECTOR maximum = XMVectorReplicate( -FLT_MAX );
+	for ( UINT i = 0; i < vertexCount; i++ )
+	{
+		XMVECTOR position = XMLoadFloat3( &vertices[i].pos );
+		minimum = XMVectorMin( minimum, position );
+		maximum = XMVectorMax( maximum, position );
+	}
+
+	VertexQuantization quantization;
+	if ( vertexCount == 0 )
+		return quantization;
+	XMStoreFloat3( &quantization.positionOffset, minimum );
+	XMStoreFloat3( &quantization.positionScale, maximum - minimum );
+	return quantization;
+}
+
+Vertex3DQuantized VertexQuantizer::Encode( const Vertex3D& vertex, const VertexQuantization& quantization )
+{
+	Vertex3DQuantized quantized;
+
+	// flat axes of the bounds encode to zero
+	const XMVECTOR scale = XMLoadFloat3( &quantization.positionScale );
+	const XMVECTOR inverseScale = XMVectorSelect( XMVectorReciprocal( scale ), XMVectorZero(), XMVectorEqual( scale, XMVectorZero() ) );
+	XMVECTOR position = ( XMLoadFloat3( &vertex.pos ) - XMLoadFloat3( &quantization.positionOffset ) ) * inverseScale;
+	XMStoreUShortN4( &quantized.pos, XMVectorSetW( position, 0.0f ) );
+
+	// octahedral normal, the lower hemisphere folds over the diagonals
+	XMFLOAT3 normal = vertex.normals;
+	const float length = fabsf( normal.x ) + fabsf( normal.y ) + fabsf( normal.z );
+	float x = length > 0.0f ? normal.x / length : 0.0f;
+	float y = length > 0.0f ? normal.y / length : 0.0f;
+	if ( normal.z < 0.0f )
+	{
+		const float foldedX = ( 1.0f - fabsf( y ) ) * ( x >= 0.0f ? 1.0f : -1.0f );
+		const float foldedY = ( 1.0f - fabsf( x ) ) * ( y >= 0.0f ? 1.0f : -1.0f );
+		x = foldedX;
+		y = foldedY;
+	}
+	quantized.normals = XMSHORTN2( x, y );
+
+	quantized.texCoord = XMHALF2( vertex.texCoord.x, vertex.texCoord.y );
+	return quantized;
+}
+
+Vertex3D VertexQuantizer::Decode( const Vertex3DQuantized& vertex, const VertexQuantization& quantization )
+{
+	Vertex3D decoded;
+
+	XMVECTOR position = XMLoadUShortN4( &vertex.pos );
+	XMStoreFloat3( &decoded.pos, XMLoadFloat3( &quantization.positionOffset ) + position * XMLoadFloat3( &quantization.positionScale ) );
+
+	XMFLOAT2 encoded;
+	XMStoreFloat2( &encoded, XMLoadShortN2( &vertex.normals ) );
+	XMFLOAT3 normal = { encoded.x, encoded.y, 1.0f - fabsf( encoded.x ) - fabsf( encoded.y ) };
+	const float fold = std::max( -normal.z, 0.0f );
+	normal.x += normal.x >= 0.0f ? -fold : fold;
+	normal.y += normal.y >= 0.0f ? -fold : fold;
+	XMStoreFloat3( &decoded.normals, XMVector3Normalize( XMLoadFloat3( &normal ) ) );
+
+	XMStoreFloat2( &decoded.texCoord, XMLoadHalf2( &vertex.texCoord ) );
+	return decoded;
+}
+
+QuantizationError VertexQuantizer::Measure( const Vertex3D* vertices, const Vertex3DQuantized* quantizedVertices,
+	UINT vertexCount, const VertexQuantization& quantization )
+{
+	QuantizationError error;
+	const float diagonal = XMVectorGetX( XMVector3Length( XMLoadFloat3( &quantization.positionScale ) ) );
+	for ( UINT i = 0; i < vertexCount; i++ )
+	{
+		const Vertex3D decoded = Decode( quantizedVertices[i], quantization );
+
+		const float distance = XMVectorGetX( XMVector3Length( XMLoadFloat3( &decoded.pos ) - XMLoadFloat3( &vertices[i].pos ) ) );
+		if ( diagonal > 0.0f )
+			error.position = std::max( error.position, distance / diagonal );
+
+		// degenerate normals can't be represented, count them as fully wrong
+		const XMVECTOR normal = XMLoadFloat3( &vertices[i].normals );
+		float angle = XM_PI;
+		if ( XMVectorGetX( XMVector3LengthSq( normal ) ) > FLT_EPSILON )
+			angle = XMVectorGetX( XMVector3AngleBetweenNormals( XMVector3Normalize( normal ), XMLoadFloat3( &decoded.normals ) ) );
+		error.normal = std::max( error.normal, angle );
+
+		error.texCoord = std::max( { error.texCoord, fabsf( decoded.texCoord.x - vertices[i].texCoord.x ),
+			fabsf( decoded.texCoord.y - vertices[i].texCoord.y ) } );
+	}
+	return error;
+}
+
+bool VertexQuantizer::IsWithinTolerance( const QuantizationError& error ) noexcept
+{
+	return error.position <= POSITION_TOLERANCE && error.normal <= NORMAL_TOLERANCE && error.texCoord <= TEXCOORD_TOLERANCE;
+}
\ No newline at end of file
@@ -0,0 +1,36 @@
+#pragma once
+#ifndef VERTEXQUANTIZER_H
+#define VERTEXQUANTIZER_H
+
+#include "Mesh.h"
+
+// largest round trip error over a mesh
+//  position - distance as a fraction of the mesh bounds diagonal
+//  normal   - angle in radians
+//  texCoord - absolute difference in either coordinate
+struct QuantizationError
+{
+	float position = 0.0f;
+	float normal = 0.0f;
+	float texCoord = 0.0f;
+};
+
+// import time conversion of Vertex3D to Vertex3DQuantized
+// a mesh is only quantized when every vertex decodes within tolerance, otherwise it keeps full precision
+// Decode matches VS_Quantized in Model.fx
+class VertexQuantizer
+{
+public:
+	static constexpr float POSITION_TOLERANCE = 1.0f / 16384.0f;
+	static constexpr float NORMAL_TOLERANCE = 0.001f;
+	static constexpr float TEXCOORD_TOLERANCE = 1.0f / 2048.0f;
+	static bool Quantize( MeshData& meshData );
+	static VertexQuantization GetQuantization( const Vertex3D* vertices, UINT vertexCount );
+	static Vertex3DQuantized Encode( const Vertex3D& vertex, const VertexQuantization& quantization );
+	static Vertex3D Decode( const Vertex3DQuantized& vertex, const VertexQuantization& quantization );
+	static QuantizationError Measure( const Vertex3D* vertices, const Vertex3DQuantized* quantizedVertices,
+		UINT vertexCount, const VertexQuantization& quantization );
+	static bool IsWithinTolerance( const QuantizationError& error ) noexcept;
+};
+
+#endif
\ No newline at end of file
@@ -3,6 +3,7 @@
 #define VIEWPORT_H
 
 #include "GraphicsResource.h"
+#include <cmath>
 class Graphics;
 
 namespace Bind
@@ -33,7 +34,17 @@ namespace Bind
 		}
 		void Bind( Graphics& gfx ) noexcept override
 		{
-			GetContext( gfx )->RSSetViewports( 1u, &viewportDesc );
+			GetStateCache( gfx ).SetViewport( viewportDesc );
+		}
+		// the same layout shrunk into the top left of the target, in whole pixels
+		void Bind( Graphics& gfx, float scale ) noexcept
+		{
+			CD3D11_VIEWPORT scaledDesc = viewportDesc;
+			scaledDesc.TopLeftX = std::floor( viewportDesc.TopLeftX * scale );
+			scaledDesc.TopLeftY = std::floor( viewportDesc.TopLeftY * scale );
+			scaledDesc.Width = std::floor( viewportDesc.Width * scale );
+			scaledDesc.Height = std::floor( viewportDesc.Height * scale );
+			GetStateCache( gfx ).SetViewport( scaledDesc );
 		}
 	private:
 		Side side;
@@ -0,0 +1,99 @@
+#include "../../utility/Benchmarks.h"
+#include "../../utility/Timer.h"
+#include "../BoundingVolumeHierarchy.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <random>
+
+using namespace DirectX;
+
+// a bvh over random boxes built, queried against testing every box and refitted after a frame's worth of movement
+void Benchmarks::SceneBvh( const std::vector<std::string>& )
+{
+	constexpr UINT RAY_COUNT = 100000u;
+	constexpr UINT BRUTE_FORCE_RAY_COUNT = 1000u;
+	printf( "Scene bvh over random boxes at constant density, %u rays (%u brute force), cpu only\n", RAY_COUNT, BRUTE_FORCE_RAY_COUNT );
+	printf( "%-8s %7s %6s %11s %13s %15s %7s %13s %13s\n", "Objects", "Nodes", "Depth", "Build (ms)", "BVH (us/ray)",
+		"Brute (us/ray)", "Match", "Refit 1% (ms)", "Rebuilt" );
+
+	Timer timer;
+	timer.Start();
+	for ( UINT objectCount : { 1000u, 10000u, 100000u, 1000000u } )
+	{
+		std::mt19937_64 generator( 42 );
+		const float side = 100.0f * std::cbrt( objectCount / 1000.0f );
+		std::uniform_real_distribution<float> positions( 0.0f, side );
+		std::uniform_real_distribution<float> extents( 0.25f, 1.0f );
+		std::vector<BoundingBox> bounds( objectCount );
+		for ( BoundingBox& box : bounds )
+			box = BoundingBox( XMFLOAT3( positions( generator ), positions( generator ), positions( generator ) ),
+				XMFLOAT3( extents( generator ), extents( generator ), extents( generator ) ) );
+
+		BoundingVolumeHierarchy bvh;
+		timer.Restart();
+		bvh.Build( bounds );
+		const double buildTime = timer.GetMilliSecondsElapsed();
+
+		// rays between random points in the volume, like picks into a scene from anywhere within it
+		std::vector<PickRay> rays( RAY_COUNT );
+		for ( PickRay& ray : rays )
+		{
+			ray.origin = XMFLOAT3( positions( generator ), positions( generator ), positions( generator ) );
+			ray.direction = XMFLOAT3( positions( generator ) - ray.origin.x, positions( generator ) - ray.origin.y,
+				positions( generator ) - ray.origin.z );
+		}
+		std::vector<PickHit> hits( RAY_COUNT );
+		timer.Restart();
+		bvh.Intersect( rays.data(), RAY_COUNT, hits.data() );
+		const double queryTime = timer.GetMilliSecondsElapsed() * 1000.0 / RAY_COUNT;
+
+		// every box tested against the first rays, nearest distances must agree
+		UINT matches = 0;
+		timer.Restart();
+		for ( UINT i = 0; i < BRUTE_FORCE_RAY_COUNT; i++ )
+		{
+			const XMVECTOR origin = XMLoadFloat3( &rays[i].origin );
+			const XMVECTOR direction = XMLoadFloat3( &rays[i].direction );
+			const float length = XMVectorGetX( XMVector3Length( direction ) );
+			const XMVECTOR unitDirection = XMVectorScale( direction, 1.0f / length );
+			float nearest = FLT_MAX;
+			for ( UINT j = 0; j < objectCount; j++ )
+			{
+				float distance = 0.0f;
+				if ( bounds[j].Intersects( origin, unitDirection, distance ) )
+					nearest = std::min( nearest, distance / length );
+			}
+			matches += ( nearest == FLT_MAX && !hits[i].IsHit() ) ||
+				( hits[i].IsHit() && std::fabs( nearest - hits[i].distance ) <= 1e-3f * std::max( 1.0f, nearest ) ) ? 1u : 0u;
+		}
+		const double bruteTime = timer.GetMilliSecondsElapsed() * 1000.0 / BRUTE_FORCE_RAY_COUNT;
+
+		// a hundredth of the objects drift a little, as a frame of moving objects would
+		std::uniform_int_distribution<UINT> objects( 0, objectCount - 1 );
+		std::uniform_real_distribution<float> drift( -0.5f, 0.5f );
+		const UINT buildCount = bvh.GetStatistics().buildCount;
+		double refitTime = 0.0;
+		for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+		{
+			for ( UINT i = 0; i < objectCount / 100; i++ )
+			{
+				BoundingBox& box = bounds[objects( generator )];
+				box.Center.x += drift( generator );
+				box.Center.y += drift( generator );
+				box.Center.z += drift( generator );
+			}
+			timer.Restart();
+			for ( UINT i = 0; i < objectCount; i++ )
+				bvh.Update( i, bounds[i] );
+			bvh.Refit();
+			refitTime += timer.GetMilliSecondsElapsed();
+		}
+
+		const BVHStatistics& statistics = bvh.GetStatistics();
+		printf( "%-8u %7u %6u %11.2f %13.3f %15.3f %3u/%-3u %13.3f %13u\n", objectCount, statistics.nodeCount, statistics.depth,
+			buildTime, queryTime, bruteTime, matches, BRUTE_FORCE_RAY_COUNT, refitTime / BENCHMARK_ITERATIONS,
+			statistics.buildCount - buildCount );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,98 @@
+#include "DynamicResolution.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+// how often frames miss the budget with the resolution fixed and with the controller scaling it, on recorded or synthetic traces
+namespace
+{
+	// each trace frame is what that frame costs at full resolution, a fifth of it doesn't scale with pixel count
+	// the controller sees each frame's time 'latency' frames later, as it would from gpu timestamp queries
+	void ReplayFrameTimes( const std::string& name, const std::vector<float>& frameTimes )
+	{
+		if ( frameTimes.empty() )
+		{
+			std::printf( "%-16s no frame times\n", name.c_str() );
+			return;
+		}
+
+		DynamicResolution controller;
+		const DynamicResolutionSettings& settings = controller.GetSettings();
+		controller.Reset();
+		std::vector<float> fixed = frameTimes;
+		std::vector<float> scaled( frameTimes.size() );
+		uint32_t fixedOver = 0, scaledOver = 0;
+		double scaleSum = 0.0;
+		for ( size_t i = 0; i < frameTimes.size(); i++ )
+		{
+			if ( i >= settings.latency )
+				controller.Update( scaled[i - settings.latency] );
+			const float scale = controller.GetScale();
+			scaled[i] = frameTimes[i] * ( 0.2f + 0.8f * scale * scale );
+			scaleSum += scale;
+			fixedOver += frameTimes[i] > settings.frameBudget ? 1u : 0u;
+			scaledOver += scaled[i] > settings.frameBudget ? 1u : 0u;
+		}
+
+		const size_t p95 = fixed.size() * 95 / 100;
+		std::nth_element( fixed.begin(), fixed.begin() + p95, fixed.end() );
+		std::nth_element( scaled.begin(), scaled.begin() + p95, scaled.end() );
+		char percentile[32];
+		std::snprintf( percentile, sizeof( percentile ), "%.1f / %.1f", fixed[p95], scaled[p95] );
+		std::printf( "%-16s %7zu %13.1f%% %13.1f%% %16s %11.2f %8u\n", name.c_str(), frameTimes.size(),
+			100.0 * fixedOver / frameTimes.size(), 100.0 * scaledOver / frameTimes.size(), percentile,
+			scaleSum / frameTimes.size(), controller.GetStatistics().changeCount );
+	}
+}
+
+// recorded traces are passed as arguments, without any the synthetic ones are replayed
+int main( int argc, char** argv )
+{
+	std::printf( "%-16s %7s %14s %14s %16s %11s %8s\n", "Trace", "Frames", "Over (fixed)", "Over (scaled)",
+		"p95 fixed/scaled", "Mean scale", "Changes" );
+
+	// recorded traces, one full resolution frame time in milliseconds per line
+	for ( int i = 1; i < argc; i++ )
+	{
+		const std::string file = argv[i];
+		std::ifstream stream( file );
+		if ( !stream )
+		{
+			std::printf( "%-16s could not be opened\n", file.c_str() );
+			continue;
+		}
+		std::vector<float> frameTimes;
+		float frameTime = 0.0f;
+		while ( stream >> frameTime )
+			frameTimes.push_back( frameTime );
+		ReplayFrameTimes( file.substr( file.find_last_of( "\\/" ) + 1 ), frameTimes );
+	}
+	if ( argc > 1 )
+		return 0;
+
+	// synthetic traces against the default 14 ms budget, noise is fixed so runs compare
+	std::mt19937 random( 42 );
+	auto makeTrace = [&random]( std::initializer_list<std::pair<uint32_t, float>> segments, float noise )
+	{
+		std::uniform_real_distribution<float> jitter( 1.0f - noise, 1.0f + noise );
+		std::vector<float> frameTimes;
+		for ( const std::pair<uint32_t, float>& segment : segments )
+			for ( uint32_t i = 0; i < segment.first; i++ )
+				frameTimes.push_back( segment.second * jitter( random ) );
+		return frameTimes;
+	};
+	ReplayFrameTimes( "Light scene", makeTrace( { { 600, 8.0f } }, 0.05f ) );
+	ReplayFrameTimes( "Heavy scene", makeTrace( { { 600, 24.0f } }, 0.05f ) );
+	ReplayFrameTimes( "Load spike", makeTrace( { { 200, 10.0f }, { 200, 28.0f }, { 200, 10.0f } }, 0.05f ) );
+	ReplayFrameTimes( "Near budget", makeTrace( { { 600, 14.5f } }, 0.15f ) );
+	std::vector<float> ramp( 600 );
+	for ( size_t i = 0; i < ramp.size(); i++ )
+		ramp[i] = 6.0f + 24.0f * i / ramp.size();
+	ReplayFrameTimes( "Ramp 6-30 ms", ramp );
+	return 0;
+}
\ No newline at end of file
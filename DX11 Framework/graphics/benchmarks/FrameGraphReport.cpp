@@ -0,0 +1,121 @@
+#include "FrameGraph.h"
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+
+// compiled pass order, culling, clears and target aliasing of the renderer's frame, a deferred pipeline and a ping-pong blur
+namespace
+{
+	void PrintFrameGraph( const char* title, FrameGraph& graph )
+	{
+		if ( !graph.Compile() )
+		{
+			std::printf( "%s: failed to compile, %s\n\n", title, graph.GetError().c_str() );
+			return;
+		}
+
+		std::printf( "%s\n", title );
+		const std::vector<FrameGraph::Pass>& order = graph.GetOrder();
+		for ( uint32_t i = 0; i < order.size(); i++ )
+		{
+			std::string clears;
+			for ( FrameGraph::Resource resource : graph.GetClears( order[i] ) )
+				clears += ( clears.empty() ? "clears " : ", " ) + graph.GetResourceName( resource );
+			std::printf( "  %2u %-20s %s\n", i, graph.GetPassName( order[i] ).c_str(), clears.c_str() );
+		}
+		for ( FrameGraph::Pass i = 0; i < graph.GetPassCount(); i++ )
+			if ( graph.IsCulled( i ) )
+				std::printf( "  -- %-20s culled\n", graph.GetPassName( i ).c_str() );
+
+		std::printf( "  %-20s %10s %9s %10s\n", "Resource", "Size (KB)", "Physical", "Lifetime" );
+		for ( FrameGraph::Resource i = 0; i < graph.GetResourceCount(); i++ )
+		{
+			if ( graph.GetFirstUse( i ) == FrameGraph::INVALID )
+				continue;
+			char physical[16] = "imported";
+			if ( !graph.IsImported( i ) )
+				std::snprintf( physical, sizeof( physical ), "%u", graph.GetPhysical( i ) );
+			std::printf( "  %-20s %10.0f %9s %5u-%-4u\n", graph.GetResourceName( i ).c_str(), graph.GetDesc( i ).GetSize() / 1024.0,
+				physical, graph.GetFirstUse( i ), graph.GetLastUse( i ) );
+		}
+
+		const FrameGraphStatistics& statistics = graph.GetStatistics();
+		std::printf( "  %u passes (%u culled), %u clears, %u transient targets in %u physical, %.2f MB requested, %.2f MB allocated, %.2f MB saved\n\n",
+			statistics.passCount, statistics.culledPassCount, statistics.clearCount, statistics.transientCount, statistics.physicalCount,
+			statistics.transientBytes / ( 1024.0 * 1024.0 ), statistics.allocatedBytes / ( 1024.0 * 1024.0 ), statistics.savedBytes / ( 1024.0 * 1024.0 ) );
+	}
+}
+
+int main()
+{
+	const FrameResourceDesc color = { 1280, 720, FrameFormat::Color };
+	const FrameResourceDesc depth = { 1280, 720, FrameFormat::DepthStencil };
+	const FrameResourceDesc half = { 640, 360, FrameFormat::Color };
+	using WriteMode = FrameGraph::WriteMode;
+
+	// the renderer's own frame in edit mode
+	FrameGraph graph;
+	FrameGraph::Resource sceneColor = graph.Create( "Scene Colour", color );
+	FrameGraph::Resource sceneDepth = graph.Create( "Scene Depth", depth );
+	FrameGraph::Resource backBuffer = graph.Import( "Back Buffer", color );
+	FrameGraph::Pass pass = graph.AddPass( "Scene", nullptr );
+	graph.Write( pass, sceneColor );
+	graph.Write( pass, sceneDepth );
+	pass = graph.AddPass( "Composite", nullptr );
+	graph.Read( pass, sceneColor );
+	graph.Write( pass, backBuffer, WriteMode::Full );
+	graph.Write( graph.AddPass( "Text", nullptr ), backBuffer );
+	graph.Write( graph.AddPass( "ImGui", nullptr ), backBuffer );
+	PrintFrameGraph( "Renderer", graph );
+
+	// a deferred pipeline, its blur and bloom targets take turns in the same memory and the debug view is never read
+	graph.Reset();
+	const FrameGraph::Resource albedo = graph.Create( "Albedo", color );
+	const FrameGraph::Resource normals = graph.Create( "Normals", color );
+	sceneDepth = graph.Create( "Depth", depth );
+	const FrameGraph::Resource occlusion = graph.Create( "Occlusion", half );
+	const FrameGraph::Resource blurTemp = graph.Create( "Blur Temp", half );
+	const FrameGraph::Resource blurred = graph.Create( "Occlusion Blurred", half );
+	const FrameGraph::Resource lighting = graph.Create( "Lighting", color );
+	const FrameGraph::Resource bloomDown = graph.Create( "Bloom Down", half );
+	const FrameGraph::Resource bloomUp = graph.Create( "Bloom Up", half );
+	const FrameGraph::Resource debugView = graph.Create( "Debug View", color );
+	backBuffer = graph.Import( "Back Buffer", color );
+
+	auto addPass = [&graph]( const char* name, std::initializer_list<FrameGraph::Resource> reads, FrameGraph::Resource target, WriteMode mode )
+	{
+		const FrameGraph::Pass pass = graph.AddPass( name, nullptr );
+		for ( FrameGraph::Resource resource : reads )
+			graph.Read( pass, resource );
+		graph.Write( pass, target, mode );
+		return pass;
+	};
+	pass = addPass( "G-Buffer", {}, albedo, WriteMode::Partial );
+	graph.Write( pass, normals );
+	graph.Write( pass, sceneDepth );
+	addPass( "Debug Normals", { normals }, debugView, WriteMode::Full );
+	addPass( "Ambient Occlusion", { normals, sceneDepth }, occlusion, WriteMode::Full );
+	addPass( "Blur Horizontal", { occlusion }, blurTemp, WriteMode::Full );
+	addPass( "Blur Vertical", { blurTemp }, blurred, WriteMode::Full );
+	addPass( "Lighting", { albedo, normals, sceneDepth, blurred }, lighting, WriteMode::Full );
+	addPass( "Bloom Down", { lighting }, bloomDown, WriteMode::Full );
+	addPass( "Bloom Up", { bloomDown }, bloomUp, WriteMode::Full );
+	addPass( "Tonemap", { lighting, bloomUp }, backBuffer, WriteMode::Full );
+	addPass( "Text", {}, backBuffer, WriteMode::Partial );
+	PrintFrameGraph( "Deferred", graph );
+
+	// a separable blur run twice over the same pair of targets, each read must see the write just before it
+	graph.Reset();
+	const FrameGraph::Resource pingTarget = graph.Create( "Ping", half );
+	const FrameGraph::Resource pongTarget = graph.Create( "Pong", half );
+	backBuffer = graph.Import( "Back Buffer", color );
+	addPass( "Downsample", {}, pingTarget, WriteMode::Full );
+	addPass( "Blur Horizontal 1", { pingTarget }, pongTarget, WriteMode::Full );
+	addPass( "Blur Vertical 1", { pongTarget }, pingTarget, WriteMode::Full );
+	addPass( "Blur Horizontal 2", { pingTarget }, pongTarget, WriteMode::Full );
+	addPass( "Blur Vertical 2", { pongTarget }, pingTarget, WriteMode::Full );
+	addPass( "Composite", { pingTarget }, backBuffer, WriteMode::Full );
+	PrintFrameGraph( "Ping-pong blur", graph );
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,107 @@
+#include "../../utility/Benchmarks.h"
+#include "../../utility/Timer.h"
+#include "../TransformStore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+using namespace DirectX;
+
+// propagation through each shape of hierarchy from scratch, after the roots or a hundredth of the objects move, and with nothing moving
+void Benchmarks::HierarchyPropagation( const std::vector<std::string>& )
+{
+	printf( "World matrix propagation through synthetic hierarchies, cpu only\n" );
+	printf( "%-10s %8s %7s %11s %15s %14s %11s %10s\n", "Shape", "Objects", "Depth", "First (ms)", "Roots move (ms)",
+		"1% move (ms)", "Still (ms)", "Max error" );
+
+	// every parent has a lower handle than its children, so a walk in handle order can build the reference
+	struct Shape
+	{
+		const char* name;
+		std::function<UINT( UINT )> parent;
+	};
+	const Shape shapes[] = {
+		{ "chain", []( UINT i ) { return i - 1; } },
+		{ "wide", []( UINT ) { return 0u; } },
+		{ "tree-4", []( UINT i ) { return ( i - 1 ) / 4; } },
+		{ "chains-16", []( UINT i ) { return i % 16u == 0u ? TransformStore::INVALID : i - 1; } }
+	};
+
+	Timer timer;
+	timer.Start();
+	for ( const Shape& shape : shapes )
+	{
+		for ( UINT objectCount : { 10000u, 100000u, 1000000u } )
+		{
+			std::mt19937_64 generator( 42 );
+			std::uniform_real_distribution<float> offsets( -1.0f, 1.0f );
+			std::uniform_real_distribution<float> angles( -0.1f, 0.1f );
+			TransformStore store;
+			std::vector<TransformStore::Handle> handles( objectCount );
+			std::vector<TransformStore::Handle> roots;
+			for ( UINT i = 0; i < objectCount; i++ )
+			{
+				handles[i] = store.Allocate();
+				store.SetPosition( handles[i], XMFLOAT3( offsets( generator ), offsets( generator ), offsets( generator ) ) );
+				store.SetRotation( handles[i], XMFLOAT3( angles( generator ), angles( generator ), angles( generator ) ) );
+				const UINT parent = i == 0u ? TransformStore::INVALID : shape.parent( i );
+				if ( parent == TransformStore::INVALID )
+					roots.push_back( handles[i] );
+				else
+					store.SetParent( handles[i], handles[parent] );
+			}
+
+			// the first pass also puts the hierarchy in order
+			timer.Restart();
+			store.UpdateWorldMatrices();
+			const double firstTime = timer.GetMilliSecondsElapsed();
+
+			double rootTime = 0.0, hundredthTime = 0.0, stillTime = 0.0;
+			std::uniform_int_distribution<UINT> objects( 0, objectCount - 1 );
+			for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+			{
+				timer.Restart();
+				for ( TransformStore::Handle root : roots )
+					store.SetRotation( root, XMFLOAT3( angles( generator ), angles( generator ), angles( generator ) ) );
+				store.UpdateWorldMatrices();
+				rootTime += timer.GetMilliSecondsElapsed();
+
+				timer.Restart();
+				for ( UINT i = 0; i < objectCount / 100; i++ )
+					store.SetPosition( handles[objects( generator )], XMFLOAT3( offsets( generator ), offsets( generator ), offsets( generator ) ) );
+				store.UpdateWorldMatrices();
+				hundredthTime += timer.GetMilliSecondsElapsed();
+
+				timer.Restart();
+				store.UpdateWorldMatrices();
+				stillTime += timer.GetMilliSecondsElapsed();
+			}
+
+			// each object's local matrix times its parent's reference, relative to the size of the entry
+			std::vector<XMFLOAT4X4> reference( objectCount );
+			float maxError = 0.0f;
+			for ( UINT i = 0; i < objectCount; i++ )
+			{
+				const XMFLOAT3 position = store.GetPosition( handles[i] );
+				const XMFLOAT3 rotation = store.GetRotation( handles[i] );
+				XMMATRIX world = XMMatrixRotationRollPitchYaw( rotation.x, rotation.y, rotation.z ) *
+					XMMatrixTranslation( position.x, position.y, position.z );
+				const UINT parent = i == 0u ? TransformStore::INVALID : shape.parent( i );
+				if ( parent != TransformStore::INVALID )
+					world *= XMLoadFloat4x4( &reference[parent] );
+				XMStoreFloat4x4( &reference[i], world );
+
+				const XMFLOAT4X4& actual = store.GetWorldMatrix( handles[i] );
+				for ( int row = 0; row < 4; row++ )
+					for ( int column = 0; column < 4; column++ )
+						maxError = std::max( maxError, std::fabs( actual.m[row][column] - reference[i].m[row][column] ) /
+							std::max( 1.0f, std::fabs( reference[i].m[row][column] ) ) );
+			}
+			printf( "%-10s %8u %7u %11.3f %15.3f %14.3f %11.3f %10.2e\n", shape.name, objectCount, store.GetStatistics().depth,
+				firstTime, rootTime / BENCHMARK_ITERATIONS, hundredthTime / BENCHMARK_ITERATIONS, stillTime / BENCHMARK_ITERATIONS,
+				maxError );
+		}
+	}
+}
\ No newline at end of file
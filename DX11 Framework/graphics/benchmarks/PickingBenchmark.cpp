@@ -0,0 +1,137 @@
+#include "../../utility/Benchmarks.h"
+#include "../../utility/Timer.h"
+#include "../HeadlessDevice.h"
+#include "../Model.h"
+#include "../ModelCache.h"
+#include "../TriangleBVH.h"
+#include "../VertexQuantizer.h"
+#include <algorithm>
+#include <cfloat>
+#include <cmath>
+#include <cstdio>
+#include <memory>
+#include <numeric>
+#include <random>
+
+#define PICKING_BUDGET_US 50.0
+
+// triangle bvhs built for each model, and the time each ray takes to pick through them against the budget
+// the budget is set against sponza, the scene's own models are small next to it
+void Benchmarks::Picking( const std::vector<std::string>& models )
+{
+	const std::vector<std::string> files = models.empty() ? std::vector<std::string>( { "res\\models\\sponza\\sponza.obj" } ) : models;
+	constexpr UINT RAY_COUNT = 10000u;
+	constexpr UINT BRUTE_FORCE_RAY_COUNT = 200u;
+	Microsoft::WRL::ComPtr<ID3D11Device> device;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+	ConstantBuffer<CB_VS_matrix> cb_vs_matrix;
+	if ( !HeadlessDevice::Create( device, context ) || FAILED( cb_vs_matrix.Initialize( device.Get(), context.Get() ) ) )
+	{
+		printf( "Failed to create a device.\n" );
+		return;
+	}
+
+	printf( "Triangle picking, %u rays per model (%u brute force), budget %.0f us per ray\n", RAY_COUNT, BRUTE_FORCE_RAY_COUNT, PICKING_BUDGET_US );
+	printf( "%-40s %10s %11s %10s %10s %10s %8s %7s %9s\n", "Model", "Triangles", "Build (ms)", "Mean (us)", "P99 (us)",
+		"Max (us)", "Hits", "Match", "Budget" );
+
+	Timer timer;
+	timer.Start();
+	for ( unsigned int i = 0; i < files.size(); i++ )
+	{
+		std::vector<MeshData> meshData;
+		Assimp::Importer importer;
+		ModelCache cache;
+		if ( !Model::LoadMeshData( files[i], importer, cache, meshData ) )
+		{
+			printf( "%-40s failed to load\n", files[i].c_str() );
+			continue;
+		}
+
+		// built as the loader threads would, the model then takes them over
+		UINT triangleCount = 0;
+		timer.Restart();
+		for ( unsigned int j = 0; j < meshData.size(); j++ )
+		{
+			auto triangleBVH = std::make_shared<TriangleBVH>();
+			triangleBVH->Build( meshData[j] );
+			meshData[j].triangleBVH = triangleBVH;
+			triangleCount += triangleBVH->GetTriangleCount();
+		}
+		const double buildTime = timer.GetMilliSecondsElapsed();
+		Model model;
+		if ( !model.Initialize( meshData, device.Get(), context.Get(), cb_vs_matrix ) )
+			continue;
+
+		// rays from anywhere around the model towards anywhere inside it
+		std::mt19937_64 generator( 42 );
+		const BoundingBox& bounds = model.GetBoundingBox();
+		auto randomPoint = [&generator, &bounds]( float spread )
+		{
+			std::uniform_real_distribution<float> unit( -1.0f, 1.0f );
+			return XMFLOAT3( bounds.Center.x + bounds.Extents.x * spread * unit( generator ),
+				bounds.Center.y + bounds.Extents.y * spread * unit( generator ),
+				bounds.Center.z + bounds.Extents.z * spread * unit( generator ) );
+		};
+		std::vector<PickRay> rays( RAY_COUNT );
+		for ( PickRay& ray : rays )
+		{
+			ray.origin = randomPoint( 1.5f );
+			const XMFLOAT3 target = randomPoint( 1.0f );
+			ray.direction = XMFLOAT3( target.x - ray.origin.x, target.y - ray.origin.y, target.z - ray.origin.z );
+		}
+		std::vector<TriangleHit> hits( RAY_COUNT );
+		std::vector<double> times( RAY_COUNT );
+		UINT hitCount = 0;
+		for ( UINT j = 0; j < RAY_COUNT; j++ )
+		{
+			timer.Restart();
+			hits[j] = model.Intersect( rays[j] );
+			times[j] = timer.GetMilliSecondsElapsed() * 1000.0;
+			hitCount += hits[j].IsHit() ? 1u : 0u;
+		}
+		const double meanTime = std::accumulate( times.begin(), times.end(), 0.0 ) / RAY_COUNT;
+		std::sort( times.begin(), times.end() );
+		const double p99Time = times[RAY_COUNT * 99 / 100];
+
+		// every full detail triangle in model space against the first rays, nearest distances must agree
+		std::vector<XMFLOAT3> corners;
+		for ( unsigned int j = 0; j < meshData.size(); j++ )
+		{
+			const XMMATRIX transform = XMLoadFloat4x4( &meshData[j].transformMatrix );
+			const UINT indexOffset = meshData[j].lods.empty() ? 0u : meshData[j].lods[0].indexOffset;
+			const UINT indexCount = meshData[j].lods.empty() ? meshData[j].GetIndexCount() : meshData[j].lods[0].indexCount;
+			for ( UINT k = indexOffset; k < indexOffset + indexCount; k++ )
+			{
+				const UINT index = meshData[j].GetIndex( k );
+				XMFLOAT3 position = meshData[j].IsQuantized() ?
+					VertexQuantizer::Decode( meshData[j].GetQuantizedVertices()[index], meshData[j].quantization ).pos :
+					meshData[j].GetVertices()[index].pos;
+				XMStoreFloat3( &position, XMVector3TransformCoord( XMLoadFloat3( &position ), transform ) );
+				corners.push_back( position );
+			}
+		}
+		UINT matches = 0;
+		for ( UINT j = 0; j < BRUTE_FORCE_RAY_COUNT; j++ )
+		{
+			const XMVECTOR origin = XMLoadFloat3( &rays[j].origin );
+			const XMVECTOR direction = XMLoadFloat3( &rays[j].direction );
+			const float length = XMVectorGetX( XMVector3Length( direction ) );
+			const XMVECTOR unitDirection = XMVectorScale( direction, 1.0f / length );
+			float nearest = FLT_MAX;
+			for ( size_t k = 0; k + 2 < corners.size(); k += 3 )
+			{
+				float distance = 0.0f;
+				if ( TriangleTests::Intersects( origin, unitDirection, XMLoadFloat3( &corners[k] ),
+					XMLoadFloat3( &corners[k + 1] ), XMLoadFloat3( &corners[k + 2] ), distance ) )
+					nearest = std::min( nearest, distance / length );
+			}
+			matches += ( nearest == FLT_MAX && !hits[j].IsHit() ) ||
+				( hits[j].IsHit() && std::fabs( nearest - hits[j].distance ) <= 1e-3f * std::max( 1.0f, nearest ) ) ? 1u : 0u;
+		}
+
+		printf( "%-40s %10u %11.2f %10.2f %10.2f %10.2f %8u %3u/%-3u %9s\n", files[i].c_str(),
+			triangleCount, buildTime, meanTime, p99Time, times.back(), hitCount, matches, BRUTE_FORCE_RAY_COUNT,
+			p99Time <= PICKING_BUDGET_US ? "within" : "over" );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,102 @@
+#include "../../utility/Benchmarks.h"
+#include "../../utility/Timer.h"
+#include "../CommandRecorder.h"
+#include "../RenderQueue.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <random>
+
+// views recorded on 1, 2, 4 and all hardware threads, each run checked against the serial one command for command
+void Benchmarks::ViewRecording( const std::vector<std::string>& )
+{
+	printf( "View recording on the headless backend, cpu only, averaged over %d runs\n", BENCHMARK_ITERATIONS );
+	printf( "%-6s %-8s %-8s %12s %9s %7s\n", "Views", "Objects", "Threads", "Record (ms)", "Speedup", "Match" );
+
+	std::vector<UINT> threadCounts = { 1u, 2u, 4u, CommandRecorder::GetDefaultThreadCount() };
+	std::sort( threadCounts.begin(), threadCounts.end() );
+	threadCounts.erase( std::unique( threadCounts.begin(), threadCounts.end() ), threadCounts.end() );
+
+	Timer timer;
+	timer.Start();
+	for ( UINT viewCount : { 2u, 4u, 8u } )
+	{
+		for ( UINT objectCount : { 10000u, 100000u } )
+		{
+			// objects scattered around the origin, each view looks at them from its own side
+			std::mt19937_64 generator( 42 );
+			std::uniform_real_distribution<float> positions( -500.0f, 500.0f );
+			std::uniform_int_distribution<UINT> shaders( 0, static_cast<UINT>( ShaderId::Count ) - 1 );
+			std::uniform_int_distribution<UINT> materials( 0, 255 );
+			std::vector<XMFLOAT3> objectPositions( objectCount );
+			std::vector<UINT> objectShaders( objectCount );
+			std::vector<UINT> objectMaterials( objectCount );
+			for ( UINT i = 0; i < objectCount; i++ )
+			{
+				objectPositions[i] = { positions( generator ), positions( generator ), positions( generator ) };
+				objectShaders[i] = shaders( generator );
+				objectMaterials[i] = materials( generator );
+			}
+			std::vector<XMMATRIX> viewMatrices( viewCount );
+			for ( UINT i = 0; i < viewCount; i++ )
+			{
+				const float angle = XM_2PI * i / viewCount;
+				viewMatrices[i] = XMMatrixLookAtLH( XMVectorSet( sinf( angle ) * 1000.0f, 100.0f, cosf( angle ) * 1000.0f, 1.0f ),
+					XMVectorZero(), XMVectorSet( 0.0f, 1.0f, 0.0f, 0.0f ) );
+			}
+			const XMMATRIX projectionMatrix = XMMatrixPerspectiveFovLH( XM_PIDIV4, 16.0f / 9.0f, 0.1f, 3000.0f );
+
+			// queue, sort and walk the packets the way a view is recorded, emitting a command per draw
+			std::vector<RenderQueue> queues( viewCount );
+			HeadlessRecordingBackend backend;
+			backend.Initialize( viewCount );
+			const CommandRecorder::RecordFunction record = [&]( UINT view )
+			{
+				RenderQueue& queue = queues[view];
+				queue.Clear();
+				for ( UINT i = 0; i < objectCount; i++ )
+					queue.Submit( RenderPass::Opaque, static_cast<ShaderId>( objectShaders[i] ), objectMaterials[i],
+						RenderQueue::GetViewDepth( viewMatrices[view], objectPositions[i] ), nullptr, i );
+				queue.Sort();
+				const XMMATRIX viewProjection = viewMatrices[view] * projectionMatrix;
+				for ( UINT i = 0; i < queue.GetCount(); i++ )
+				{
+					const DrawPacket& packet = queue.GetSortedPacket( i );
+					XMFLOAT4 clip;
+					XMStoreFloat4( &clip, XMVector3Transform( XMLoadFloat3( &objectPositions[packet.index] ), viewProjection ) );
+					UINT clipBits;
+					std::memcpy( &clipBits, &clip.w, sizeof( clipBits ) );
+					backend.Record( view, packet.key ^ ( static_cast<UINT64>( packet.index ) << 32 ) ^ clipBits );
+				}
+			};
+
+			// one thread is the serial reference every other run must reproduce command for command
+			std::vector<UINT64> reference;
+			double serialTime = 0.0;
+			for ( UINT threadCount : threadCounts )
+			{
+				CommandRecorder recorder;
+				recorder.Start( threadCount );
+				double recordTime = 0.0;
+				bool match = true;
+				for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+				{
+					backend.ClearExecuted();
+					timer.Restart();
+					recorder.Record( backend, viewCount, record );
+					recordTime += timer.GetMilliSecondsElapsed();
+					CommandRecorder::Execute( backend, viewCount );
+					if ( reference.empty() )
+						reference = backend.GetExecuted();
+					match = match && backend.GetExecuted() == reference;
+				}
+				recordTime /= BENCHMARK_ITERATIONS;
+				if ( threadCount == threadCounts.front() )
+					serialTime = recordTime;
+				printf( "%-6u %-8u %-8u %12.3f %8.2fx %7s\n", viewCount, objectCount, threadCount, recordTime,
+					recordTime > 0.0 ? serialTime / recordTime : 0.0, match ? "yes" : "NO" );
+			}
+		}
+	}
+}
\ No newline at end of file
@@ -0,0 +1,59 @@
+#include "../../utility/Benchmarks.h"
+#include "../../utility/Timer.h"
+#include "../RenderQueue.h"
+#include <algorithm>
+#include <cstdio>
+#include <random>
+
+// the queue's radix sort against a comparison sort of the same keys
+void Benchmarks::QueueSort( const std::vector<std::string>& )
+{
+	printf( "Render queue sort of synthetic draw streams, cpu only, averaged over %d runs\n", BENCHMARK_ITERATIONS );
+	printf( "%-8s %14s %14s %9s %7s\n", "Draws", "Radix (ms)", "std::sort (ms)", "Speedup", "Sorted" );
+
+	// a scene's worth of distinct passes, shaders and materials at random depths
+	std::mt19937_64 generator( 42 );
+	std::uniform_int_distribution<UINT> passes( 0, static_cast<UINT>( RenderPass::Count ) - 1 );
+	std::uniform_int_distribution<UINT> shaders( 0, static_cast<UINT>( ShaderId::Count ) - 1 );
+	std::uniform_int_distribution<UINT> materials( 0, 255 );
+	std::uniform_real_distribution<float> depths( 0.1f, 1000.0f );
+
+	Timer timer;
+	timer.Start();
+	for ( UINT drawCount : { 10000u, 100000u, 1000000u } )
+	{
+		std::vector<RenderQueue::SortEntry> stream( drawCount );
+		for ( UINT i = 0; i < drawCount; i++ )
+			stream[i] = { RenderQueue::MakeKey( static_cast<RenderPass>( passes( generator ) ), static_cast<ShaderId>( shaders( generator ) ),
+				materials( generator ), depths( generator ) ), i };
+
+		std::vector<RenderQueue::SortEntry> entries;
+		std::vector<RenderQueue::SortEntry> scratch;
+		double radixTime = 0.0;
+		bool sorted = true;
+		for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+		{
+			entries = stream;
+			timer.Restart();
+			RenderQueue::RadixSort( entries, scratch );
+			radixTime += timer.GetMilliSecondsElapsed();
+			sorted = sorted && std::is_sorted( entries.begin(), entries.end(),
+				[]( const RenderQueue::SortEntry& a, const RenderQueue::SortEntry& b ) { return a.key < b.key; } );
+		}
+
+		double comparisonTime = 0.0;
+		for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+		{
+			entries = stream;
+			timer.Restart();
+			std::sort( entries.begin(), entries.end(),
+				[]( const RenderQueue::SortEntry& a, const RenderQueue::SortEntry& b ) { return a.key < b.key; } );
+			comparisonTime += timer.GetMilliSecondsElapsed();
+		}
+
+		radixTime /= BENCHMARK_ITERATIONS;
+		comparisonTime /= BENCHMARK_ITERATIONS;
+		printf( "%-8u %14.3f %14.3f %8.1fx %7s\n", drawCount, radixTime, comparisonTime,
+			radixTime > 0.0 ? comparisonTime / radixTime : 0.0, sorted ? "yes" : "NO" );
+	}
+}
\ No newline at end of file
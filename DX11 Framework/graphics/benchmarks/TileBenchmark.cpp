@@ -0,0 +1,69 @@
+#include "../../utility/Benchmarks.h"
+#include "../../utility/Timer.h"
+#include "../Plane.h"
+#include <cmath>
+#include <cstdio>
+
+// the every-frame rebuild the ground had before its layout was cached, against the cached update and a batched rebuild
+void Benchmarks::TileUpdate( const std::vector<std::string>& )
+{
+	printf( "Ground tile update cost per frame, cpu only, averaged over %d frames\n", BENCHMARK_FRAMES );
+	printf( "%-8s %14s %14s %14s %9s\n", "Tiles", "Per frame (ms)", "Cached (ms)", "Rebuild (ms)", "Speedup" );
+
+	const BoundingBox localBounds( XMFLOAT3( 0.0f, 0.0f, 0.0f ), XMFLOAT3( 3.0f, 3.0f, 0.0f ) );
+	Timer timer;
+	timer.Start();
+	for ( int tileCount : { 400, 10000, 100000 } )
+	{
+		const TileLayout layout = { 5, 6, 8, 60, tileCount };
+		std::vector<XMFLOAT4X4> matrices( tileCount );
+		std::vector<BoundingBox> bounds( tileCount );
+
+		// matrices rebuilt every frame, as the ground was updated before the layout was cached
+		timer.Restart();
+		for ( int frame = 0; frame < BENCHMARK_FRAMES; frame++ )
+		{
+			int count = 0;
+			for ( int row = 0; row < sqrt( tileCount ) && count < tileCount; row++ )
+			{
+				for ( int col = 0; col < sqrt( tileCount ) && count < tileCount; col++ )
+				{
+					const XMMATRIX matrix = XMMatrixScaling( layout.tileSize, layout.tileSize, 0.0f ) *
+						XMMatrixRotationX( XMConvertToRadians( 90.0f ) ) *
+						XMMatrixTranslation(
+							( row * layout.tileOffset * layout.tileSize ) - ( layout.worldOffsetX + layout.worldOffsetY * layout.tileSize ),
+							PlaneInstanced::TILE_HEIGHT, ( col * layout.tileOffset * layout.tileSize ) - layout.worldOffsetY * layout.tileSize );
+					XMStoreFloat4x4( &matrices[count], matrix );
+					localBounds.Transform( bounds[count], matrix );
+					count++;
+				}
+			}
+		}
+		const double perFrameTime = timer.GetMilliSecondsElapsed() / BENCHMARK_FRAMES;
+
+		// unchanged layout, the common case
+		TileLayout cachedLayout = layout;
+		volatile int rebuilds = 0;
+		timer.Restart();
+		for ( int frame = 0; frame < BENCHMARK_FRAMES; frame++ )
+		{
+			const TileLayout frameLayout = { 5, 6, 8, 60, tileCount };
+			if ( frameLayout != cachedLayout )
+			{
+				PlaneInstanced::BuildTiles( frameLayout, localBounds, matrices.data(), bounds.data() );
+				cachedLayout = frameLayout;
+				rebuilds++;
+			}
+		}
+		const double cachedTime = timer.GetMilliSecondsElapsed() / BENCHMARK_FRAMES;
+
+		// batched rebuild, paid once whenever the layout changes
+		timer.Restart();
+		for ( int frame = 0; frame < BENCHMARK_FRAMES; frame++ )
+			PlaneInstanced::BuildTiles( layout, localBounds, matrices.data(), bounds.data() );
+		const double rebuildTime = timer.GetMilliSecondsElapsed() / BENCHMARK_FRAMES;
+
+		printf( "%-8d %14.4f %14.4f %14.4f %8.1fx\n", tileCount, perFrameTime, cachedTime, rebuildTime,
+			rebuildTime > 0.0 ? perFrameTime / rebuildTime : 0.0 );
+	}
+}
\ No newline at end of file
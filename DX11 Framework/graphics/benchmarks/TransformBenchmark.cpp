@@ -0,0 +1,97 @@
+#include "../../utility/Benchmarks.h"
+#include "../../utility/Timer.h"
+#include "../TransformStore.h"
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <functional>
+#include <random>
+
+using namespace DirectX;
+
+// matrices rebuilt by every setter, as objects did before the store, against the store's batched rebuild of the dirty ones
+void Benchmarks::TransformUpdates( const std::vector<std::string>& )
+{
+	printf( "World matrix rebuilds per frame, position and rotation set on the moving objects, cpu only\n" );
+	printf( "%-8s %14s %16s %14s %13s %12s\n", "Objects", "Per set (ms)", "Batch all (ms)", "Batch 10% (ms)",
+		"Batch 1% (ms)", "Max error" );
+
+	// the old path, every setter rebuilt its object's matrix on the spot
+	auto rebuild = []( const XMFLOAT3& position, const XMFLOAT3& rotation, const XMFLOAT3& scale, XMFLOAT4X4& world )
+	{
+		XMStoreFloat4x4( &world, XMMatrixScaling( scale.x, scale.y, scale.z ) *
+			XMMatrixRotationRollPitchYaw( rotation.x, rotation.y, rotation.z ) *
+			XMMatrixTranslation( position.x, position.y, position.z ) );
+	};
+
+	Timer timer;
+	timer.Start();
+	for ( UINT objectCount : { 10000u, 100000u, 1000000u } )
+	{
+		std::mt19937_64 generator( 42 );
+		std::uniform_real_distribution<float> positions( -100.0f, 100.0f );
+		std::uniform_real_distribution<float> angles( -XM_PI, XM_PI );
+		std::uniform_real_distribution<float> scales( 0.5f, 2.0f );
+		std::vector<XMFLOAT3> position( objectCount ), rotation( objectCount ), scale( objectCount );
+		for ( UINT i = 0; i < objectCount; i++ )
+		{
+			position[i] = XMFLOAT3( positions( generator ), positions( generator ), positions( generator ) );
+			rotation[i] = XMFLOAT3( angles( generator ), angles( generator ), angles( generator ) );
+			const float uniform = scales( generator );
+			scale[i] = XMFLOAT3( uniform, uniform, uniform );
+		}
+
+		std::vector<XMFLOAT4X4> legacy( objectCount );
+		double legacyTime = 0.0;
+		for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+		{
+			// one rebuild for the position setter and one for the rotation setter
+			timer.Restart();
+			for ( int setter = 0; setter < 2; setter++ )
+				for ( UINT i = 0; i < objectCount; i++ )
+					rebuild( position[i], rotation[i], scale[i], legacy[i] );
+			legacyTime += timer.GetMilliSecondsElapsed();
+		}
+
+		TransformStore store;
+		std::vector<TransformStore::Handle> handles( objectCount );
+		for ( UINT i = 0; i < objectCount; i++ )
+		{
+			handles[i] = store.Allocate();
+			store.SetScale( handles[i], scale[i] );
+		}
+
+		// a fraction of the objects move each frame, the rest keep last frame's matrices
+		auto batch = [&]( UINT stride ) -> double
+		{
+			double time = 0.0;
+			for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+			{
+				store.UpdateWorldMatrices();
+				timer.Restart();
+				for ( UINT i = run % stride; i < objectCount; i += stride )
+				{
+					store.SetPosition( handles[i], position[i] );
+					store.SetRotation( handles[i], rotation[i] );
+				}
+				store.UpdateWorldMatrices();
+				time += timer.GetMilliSecondsElapsed();
+			}
+			return time / BENCHMARK_ITERATIONS;
+		};
+		const double allTime = batch( 1u );
+		const double tenthTime = batch( 10u );
+		const double hundredthTime = batch( 100u );
+
+		float maxError = 0.0f;
+		for ( UINT i = 0; i < objectCount; i++ )
+		{
+			const XMFLOAT4X4& world = store.GetWorldMatrix( handles[i] );
+			for ( int row = 0; row < 4; row++ )
+				for ( int column = 0; column < 4; column++ )
+					maxError = std::max( maxError, std::fabs( world.m[row][column] - legacy[i].m[row][column] ) );
+		}
+		printf( "%-8u %14.3f %16.3f %14.3f %13.3f %12.2e\n", objectCount, legacyTime / BENCHMARK_ITERATIONS,
+			allTime, tenthTime, hundredthTime, maxError );
+	}
+}
\ No newline at end of file
@@ -0,0 +1,253 @@
+#include "DynamicResolution.h"
+#include "Check.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace
+{
+	struct Replay
+	{
+		std::vector<float> scales;
+		std::vector<float> frameTimes;
+		uint32_t changeCount = 0;
+	};
+
+	// each trace frame is what that frame costs at full resolution, a fifth of it doesn't scale with pixel count
+	// the controller sees each frame's time 'latency' frames later, as it would from gpu timestamp queries
+	Replay ReplayTrace( DynamicResolution& controller, const std::vector<float>& trace )
+	{
+		const DynamicResolutionSettings& settings = controller.GetSettings();
+		controller.Reset();
+		Replay replay;
+		replay.scales.resize( trace.size() );
+		replay.frameTimes.resize( trace.size() );
+		for ( size_t i = 0; i < trace.size(); i++ )
+		{
+			if ( i >= settings.latency )
+				controller.Update( replay.frameTimes[i - settings.latency] );
+			const float scale = controller.GetScale();
+			replay.scales[i] = scale;
+			replay.frameTimes[i] = trace[i] * ( 0.2f + 0.8f * scale * scale );
+		}
+		replay.changeCount = controller.GetStatistics().changeCount;
+		return replay;
+	}
+
+	// noise is seeded so every run replays the same frames
+	std::vector<float> MakeTrace( std::initializer_list<std::pair<uint32_t, float>> segments, float noise, uint32_t seed = 42u )
+	{
+		std::mt19937 random( seed );
+		std::uniform_real_distribution<float> jitter( 1.0f - noise, 1.0f + noise );
+		std::vector<float> trace;
+		for ( const std::pair<uint32_t, float>& segment : segments )
+			for ( uint32_t i = 0; i < segment.first; i++ )
+				trace.push_back( segment.second * jitter( random ) );
+		return trace;
+	}
+
+	// the first frame from which every frame up to 'end' stays within the budget, or end if none does
+	size_t SettledFrom( const Replay& replay, size_t begin, size_t end, float budget )
+	{
+		size_t settled = end;
+		for ( size_t i = end; i-- > begin; )
+		{
+			if ( replay.frameTimes[i] > budget )
+				break;
+			settled = i;
+		}
+		return settled;
+	}
+
+	void CheckBounds( const Replay& replay, const DynamicResolutionSettings& settings )
+	{
+		for ( float scale : replay.scales )
+			CHECK( scale >= settings.minScale && scale <= settings.maxScale );
+	}
+
+	// however heavy or light the frames, the scale stays within its limits and settles at them
+	void TestBounds()
+	{
+		DynamicResolution controller;
+		const DynamicResolutionSettings& settings = controller.GetSettings();
+
+		const Replay heavy = ReplayTrace( controller, MakeTrace( { { 600, 200.0f } }, 0.05f ) );
+		CheckBounds( heavy, settings );
+		CHECK( heavy.scales.back() == settings.minScale );
+
+		const Replay light = ReplayTrace( controller, MakeTrace( { { 600, 2.0f } }, 0.05f ) );
+		CheckBounds( light, settings );
+		CHECK( light.scales.back() == settings.maxScale );
+		CHECK( light.changeCount == 0u );
+
+		// custom limits are kept too
+		controller.GetSettings().minScale = 0.7f;
+		controller.GetSettings().maxScale = 0.9f;
+		const Replay limited = ReplayTrace( controller, MakeTrace( { { 300, 40.0f }, { 300, 2.0f } }, 0.05f ) );
+		CheckBounds( limited, settings );
+		CHECK( limited.scales.front() == 0.9f );
+		CHECK( *std::min_element( limited.scales.begin(), limited.scales.end() ) == 0.7f );
+		CHECK( limited.scales.back() == 0.9f );
+
+		// timings that can't be right are ignored
+		controller.Reset();
+		controller.Update( 0.0f );
+		controller.Update( -5.0f );
+		CHECK( controller.GetStatistics().frameCount == 0u );
+		CHECK( controller.GetScale() == 0.9f );
+	}
+
+	// frames between the headroom and the budget change nothing, and noise around the budget doesn't make the scale hunt
+	void TestHysteresis()
+	{
+		DynamicResolution controller;
+		const DynamicResolutionSettings& settings = controller.GetSettings();
+		const float band = settings.frameBudget * ( 1.0f + settings.headroom ) * 0.5f;
+		const Replay steady = ReplayTrace( controller, MakeTrace( { { 600, band } }, 0.03f ) );
+		CHECK( steady.changeCount == 0u );
+
+		// heavy enough that full resolution misses the budget by a little, with 15% noise per frame
+		const Replay noisy = ReplayTrace( controller, MakeTrace( { { 1200, 14.5f } }, 0.15f ) );
+		CheckBounds( noisy, settings );
+		uint32_t reversals = 0;
+		float lastStep = 0.0f;
+		for ( size_t i = 1; i < noisy.scales.size(); i++ )
+		{
+			const float step = noisy.scales[i] - noisy.scales[i - 1];
+			if ( step == 0.0f )
+				continue;
+			reversals += lastStep != 0.0f && ( step > 0.0f ) != ( lastStep > 0.0f ) ? 1u : 0u;
+			lastStep = step;
+		}
+		CHECK( noisy.changeCount <= 12u );
+		CHECK( reversals <= 6u );
+
+		// scaling up waits for upscaleDelay frames in a row under the headroom, then moves by at most maxStepUp
+		controller.Reset();
+		controller.Update( 28.0f );
+		const float lowered = controller.GetScale();
+		CHECK( lowered < settings.maxScale );
+		for ( uint32_t i = 0; i < settings.latency; i++ )
+			controller.Update( 28.0f );
+		for ( uint32_t i = 0; i + 1u < settings.upscaleDelay; i++ )
+			controller.Update( 5.0f );
+		CHECK( controller.GetScale() == lowered );
+		controller.Update( 5.0f );
+		CHECK( controller.GetScale() > lowered );
+		CHECK( controller.GetScale() <= lowered + settings.maxStepUp + 1e-6f );
+	}
+
+	// over budget scales down straight away, timings from before the change are skipped
+	void TestLatency()
+	{
+		DynamicResolution controller;
+		const DynamicResolutionSettings& settings = controller.GetSettings();
+		controller.Reset();
+		controller.Update( 28.0f );
+		const float first = controller.GetScale();
+		CHECK( first < settings.maxScale );
+		for ( uint32_t i = 0; i < settings.latency; i++ )
+		{
+			controller.Update( 28.0f );
+			CHECK( controller.GetScale() == first );
+		}
+		controller.Update( 28.0f );
+		CHECK( controller.GetScale() < first );
+
+		controller.GetSettings().enabled = false;
+		controller.Update( 50.0f );
+		CHECK( controller.GetScale() == settings.maxScale );
+	}
+
+	// a load spike is brought back within budget in a few frames, and full resolution returns after it
+	void TestSettling()
+	{
+		DynamicResolution controller;
+		const DynamicResolutionSettings& settings = controller.GetSettings();
+		const Replay spike = ReplayTrace( controller, MakeTrace( { { 200, 10.0f }, { 200, 28.0f }, { 300, 10.0f } }, 0.05f ) );
+		CheckBounds( spike, settings );
+		CHECK( SettledFrom( spike, 0, 200, settings.frameBudget ) == 0u );
+
+		// the smoothed time is what's held to the budget, so single frames may go over it by the noise and no more
+		// that holds from 3 latencies after the spike starts, and the frames average within budget from then on
+		const float noiseBudget = settings.frameBudget * 1.05f;
+		const size_t settled = SettledFrom( spike, 200, 400, noiseBudget );
+		CHECK( settled <= 200u + 3u * ( settings.latency + 1u ) );
+		float total = 0.0f;
+		for ( size_t i = settled; i < 400; i++ )
+			total += spike.frameTimes[i];
+		CHECK( total / ( 400 - settled ) <= settings.frameBudget );
+		CHECK( spike.scales[399] < settings.maxScale );
+
+		// scaling back up is slower by design, but it gets there well before the trace ends
+		size_t restored = spike.scales.size();
+		for ( size_t i = spike.scales.size(); i-- > 400; )
+		{
+			if ( spike.scales[i] != settings.maxScale )
+				break;
+			restored = i;
+		}
+		CHECK( restored < 400u + 250u );
+		CHECK( SettledFrom( spike, 400, spike.scales.size(), settings.frameBudget ) == 400u );
+
+		// a slow ramp past the budget is followed, each step down comes at most a latency late and by a hair over
+		std::vector<float> ramp( 600 );
+		for ( size_t i = 0; i < ramp.size(); i++ )
+			ramp[i] = 6.0f + 24.0f * i / ramp.size();
+		const Replay ramped = ReplayTrace( controller, ramp );
+		CheckBounds( ramped, settings );
+		uint32_t run = 0, longestRun = 0;
+		float worst = 0.0f;
+		for ( float frameTime : ramped.frameTimes )
+		{
+			run = frameTime > settings.frameBudget ? run + 1u : 0u;
+			longestRun = std::max( longestRun, run );
+			worst = std::max( worst, frameTime );
+		}
+		CHECK( longestRun <= settings.latency + 1u );
+		CHECK( worst <= settings.frameBudget * 1.02f );
+		CHECK( ramped.scales.back() < ramped.scales.front() );
+	}
+
+	// traces recorded from the renderer, one full resolution frame time in milliseconds per line
+	// a scale only drops to its minimum when even that can't hold the budget
+	void TestRecordedTrace( const std::string& file )
+	{
+		std::ifstream stream( file );
+		CHECK( stream.good() );
+		std::vector<float> trace;
+		float frameTime = 0.0f;
+		while ( stream >> frameTime )
+			trace.push_back( frameTime );
+		CHECK( !trace.empty() );
+
+		DynamicResolution controller;
+		const DynamicResolutionSettings& settings = controller.GetSettings();
+		const Replay replay = ReplayTrace( controller, trace );
+		CheckBounds( replay, settings );
+		uint32_t fixedOver = 0, scaledOver = 0;
+		for ( size_t i = 0; i < trace.size(); i++ )
+		{
+			fixedOver += trace[i] > settings.frameBudget ? 1u : 0u;
+			scaledOver += replay.frameTimes[i] > settings.frameBudget ? 1u : 0u;
+		}
+		CHECK( scaledOver <= fixedOver );
+		std::printf( "%s: %zu frames, %u over budget at full resolution, %u scaled\n", file.c_str(), trace.size(), fixedOver, scaledOver );
+	}
+}
+
+// recorded traces are passed as arguments
+int main( int argc, char** argv )
+{
+	TestBounds();
+	TestHysteresis();
+	TestLatency();
+	TestSettling();
+	for ( int i = 1; i < argc; i++ )
+		TestRecordedTrace( argv[i] );
+	return ReportChecks();
+}
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "FrameGraph.h"
+#include "Check.h"
+#include <algorithm>
+#include <initializer_list>
+#include <string>
+#include <vector>
+
+namespace
+{
+	using Pass = FrameGraph::Pass;
+	using Resource = FrameGraph::Resource;
+	using WriteMode = FrameGraph::WriteMode;
+
+	const FrameResourceDesc color = { 1280, 720, FrameFormat::Color };
+	const FrameResourceDesc depth = { 1280, 720, FrameFormat::DepthStencil };
+	const FrameResourceDesc half = { 640, 360, FrameFormat::Color };
+
+	Pass AddPass( FrameGraph& graph, const char* name, std::initializer_list<Resource> reads, Resource target, WriteMode mode )
+	{
+		const Pass pass = graph.AddPass( name, nullptr );
+		for ( Resource resource : reads )
+			graph.Read( pass, resource );
+		graph.Write( pass, target, mode );
+		return pass;
+	}
+
+	std::vector<std::string> GetOrderNames( const FrameGraph& graph )
+	{
+		std::vector<std::string> names;
+		for ( Pass pass : graph.GetOrder() )
+			names.push_back( graph.GetPassName( pass ) );
+		return names;
+	}
+
+	bool Clears( const FrameGraph& graph, Pass pass, Resource resource )
+	{
+		const std::vector<Resource>& clears = graph.GetClears( pass );
+		return std::find( clears.begin(), clears.end(), resource ) != clears.end();
+	}
+
+	// the renderer's own frame in edit mode, nothing is culled and only the partly drawn scene targets are cleared
+	void TestRenderer()
+	{
+		FrameGraph graph;
+		const Resource sceneColor = graph.Create( "Scene Colour", color );
+		const Resource sceneDepth = graph.Create( "Scene Depth", depth );
+		const Resource backBuffer = graph.Import( "Back Buffer", color );
+		const Pass scene = graph.AddPass( "Scene", nullptr );
+		graph.Write( scene, sceneColor );
+		graph.Write( scene, sceneDepth );
+		const Pass composite = AddPass( graph, "Composite", { sceneColor }, backBuffer, WriteMode::Full );
+		const Pass text = AddPass( graph, "Text", {}, backBuffer, WriteMode::Partial );
+		const Pass imgui = AddPass( graph, "ImGui", {}, backBuffer, WriteMode::Partial );
+		CHECK( graph.Compile() );
+
+		CHECK( GetOrderNames( graph ) == std::vector<std::string>{ "Scene", "Composite", "Text", "ImGui" } );
+		CHECK( graph.GetStatistics().culledPassCount == 0u );
+		CHECK( Clears( graph, scene, sceneColor ) && Clears( graph, scene, sceneDepth ) );
+		CHECK( graph.GetClears( composite ).empty() && graph.GetClears( text ).empty() && graph.GetClears( imgui ).empty() );
+		CHECK( graph.GetStatistics().clearCount == 2u );
+		CHECK( graph.GetPhysical( backBuffer ) == FrameGraph::INVALID );
+		CHECK( graph.GetPhysical( sceneColor ) != graph.GetPhysical( sceneDepth ) );
+	}
+
+	// passes nothing reaches are culled, and so are writes a later full write hides
+	void TestCulling()
+	{
+		FrameGraph graph;
+		const Resource unused = graph.Create( "Unused", color );
+		const Resource target = graph.Create( "Target", color );
+		const Resource backBuffer = graph.Import( "Back Buffer", color );
+		const Pass orphan = AddPass( graph, "Orphan", {}, unused, WriteMode::Full );
+		const Pass hidden = AddPass( graph, "Hidden", {}, target, WriteMode::Partial );
+		const Pass cover = AddPass( graph, "Cover", {}, target, WriteMode::Full );
+		const Pass present = AddPass( graph, "Present", { target }, backBuffer, WriteMode::Full );
+		const Pass capture = graph.AddPass( "Capture", nullptr );
+		graph.Read( capture, unused );
+		graph.SetSideEffect( capture );
+		const Pass stray = graph.AddPass( "Stray", nullptr );
+		graph.Read( stray, target );
+		CHECK( graph.Compile() );
+
+		CHECK( graph.IsCulled( hidden ) );
+		CHECK( graph.IsCulled( stray ) );
+		CHECK( !graph.IsCulled( cover ) && !graph.IsCulled( present ) );
+		// a side effect keeps the pass and everything it reads from
+		CHECK( !graph.IsCulled( capture ) && !graph.IsCulled( orphan ) );
+		CHECK( graph.GetStatistics().passCount == 6u );
+		CHECK( graph.GetStatistics().culledPassCount == 2u );
+		CHECK( graph.GetOrder().size() == 4u );
+	}
+
+	// a read sees the write declared before it, so a pass reading an old version doesn't keep the newer writer alive
+	void TestVersionedCulling()
+	{
+		FrameGraph graph;
+		const Resource shared = graph.Create( "Shared", color );
+		const Resource side = graph.Create( "Side", color );
+		const Resource backBuffer = graph.Import( "Back Buffer", color );
+		const Pass first = AddPass( graph, "First", {}, shared, WriteMode::Full );
+		const Pass early = AddPass( graph, "Early Reader", { shared }, side, WriteMode::Full );
+		const Pass second = AddPass( graph, "Second", {}, shared, WriteMode::Full );
+		const Pass late = AddPass( graph, "Late Reader", { shared }, backBuffer, WriteMode::Full );
+		CHECK( graph.Compile() );
+
+		CHECK( graph.IsCulled( first ) && graph.IsCulled( early ) );
+		CHECK( !graph.IsCulled( second ) && !graph.IsCulled( late ) );
+		CHECK( GetOrderNames( graph ) == std::vector<std::string>{ "Second", "Late Reader" } );
+	}
+
+	// a reader runs after the last write declared before it and before the next one, even if that one is declared first
+	void TestReadOrdering()
+	{
+		FrameGraph graph;
+		const Resource shared = graph.Create( "Shared", color );
+		const Resource side = graph.Create( "Side", color );
+		const Resource backBuffer = graph.Import( "Back Buffer", color );
+		AddPass( graph, "Write", {}, shared, WriteMode::Full );
+		const Pass overwrite = graph.AddPass( "Overwrite", nullptr );
+		const Pass reader = AddPass( graph, "Reader", { shared }, side, WriteMode::Full );
+		// declared before the reader, written after it, the read still sees 'Write'
+		graph.Write( overwrite, shared, WriteMode::Partial );
+		AddPass( graph, "Combine", { shared, side }, backBuffer, WriteMode::Full );
+		CHECK( graph.Compile() );
+		CHECK( !graph.IsCulled( reader ) && !graph.IsCulled( overwrite ) );
+		CHECK( GetOrderNames( graph ) == std::vector<std::string>{ "Write", "Reader", "Overwrite", "Combine" } );
+	}
+
+	// a separable blur run twice over the same pair of targets, each read must see the write just before it
+	void TestPingPong()
+	{
+		FrameGraph graph;
+		const Resource ping = graph.Create( "Ping", half );
+		const Resource pong = graph.Create( "Pong", half );
+		const Resource backBuffer = graph.Import( "Back Buffer", color );
+		AddPass( graph, "Downsample", {}, ping, WriteMode::Full );
+		AddPass( graph, "Blur Horizontal 1", { ping }, pong, WriteMode::Full );
+		AddPass( graph, "Blur Vertical 1", { pong }, ping, WriteMode::Full );
+		AddPass( graph, "Blur Horizontal 2", { ping }, pong, WriteMode::Full );
+		AddPass( graph, "Blur Vertical 2", { pong }, ping, WriteMode::Full );
+		AddPass( graph, "Composite", { ping }, backBuffer, WriteMode::Full );
+		CHECK( graph.Compile() );
+
+		CHECK( GetOrderNames( graph ) == std::vector<std::string>{ "Downsample", "Blur Horizontal 1", "Blur Vertical 1",
+			"Blur Horizontal 2", "Blur Vertical 2", "Composite" } );
+		CHECK( graph.GetStatistics().clearCount == 0u );
+		CHECK( graph.GetPhysical( ping ) != graph.GetPhysical( pong ) );
+	}
+
+	// a deferred pipeline, its blur and bloom targets take turns in the same memory and the debug view is never read
+	void TestDeferredAliasing()
+	{
+		FrameGraph graph;
+		const Resource albedo = graph.Create( "Albedo", color );
+		const Resource normals = graph.Create( "Normals", color );
+		const Resource sceneDepth = graph.Create( "Depth", depth );
+		const Resource occlusion = graph.Create( "Occlusion", half );
+		const Resource blurTemp = graph.Create( "Blur Temp", half );
+		const Resource blurred = graph.Create( "Occlusion Blurred", half );
+		const Resource lighting = graph.Create( "Lighting", color );
+		const Resource bloomDown = graph.Create( "Bloom Down", half );
+		const Resource bloomUp = graph.Create( "Bloom Up", half );
+		const Resource debugView = graph.Create( "Debug View", color );
+		const Resource backBuffer = graph.Import( "Back Buffer", color );
+		const Pass gbuffer = AddPass( graph, "G-Buffer", {}, albedo, WriteMode::Partial );
+		graph.Write( gbuffer, normals );
+		graph.Write( gbuffer, sceneDepth );
+		const Pass debug = AddPass( graph, "Debug Normals", { normals }, debugView, WriteMode::Full );
+		AddPass( graph, "Ambient Occlusion", { normals, sceneDepth }, occlusion, WriteMode::Full );
+		AddPass( graph, "Blur Horizontal", { occlusion }, blurTemp, WriteMode::Full );
+		AddPass( graph, "Blur Vertical", { blurTemp }, blurred, WriteMode::Full );
+		AddPass( graph, "Lighting", { albedo, normals, sceneDepth, blurred }, lighting, WriteMode::Full );
+		AddPass( graph, "Bloom Down", { lighting }, bloomDown, WriteMode::Full );
+		AddPass( graph, "Bloom Up", { bloomDown }, bloomUp, WriteMode::Full );
+		AddPass( graph, "Tonemap", { lighting, bloomUp }, backBuffer, WriteMode::Full );
+		const Pass text = AddPass( graph, "Text", {}, backBuffer, WriteMode::Partial );
+		CHECK( graph.Compile() );
+
+		CHECK( graph.IsCulled( debug ) );
+		CHECK( graph.GetFirstUse( debugView ) == FrameGraph::INVALID && graph.GetPhysical( debugView ) == FrameGraph::INVALID );
+
+		// only the g-buffer targets are partly drawn over first, the back buffer's first write covers it
+		CHECK( Clears( graph, gbuffer, albedo ) && Clears( graph, gbuffer, normals ) && Clears( graph, gbuffer, sceneDepth ) );
+		CHECK( graph.GetClears( text ).empty() );
+		CHECK( graph.GetStatistics().clearCount == 3u );
+
+		// half size targets alternate between two physical ones as each goes out of use
+		CHECK( graph.GetPhysical( occlusion ) == graph.GetPhysical( blurred ) );
+		CHECK( graph.GetPhysical( occlusion ) == graph.GetPhysical( bloomDown ) );
+		CHECK( graph.GetPhysical( blurTemp ) == graph.GetPhysical( bloomUp ) );
+		CHECK( graph.GetPhysical( occlusion ) != graph.GetPhysical( blurTemp ) );
+		// lighting starts in the pass where the g-buffer is last read, so they overlap
+		CHECK( graph.GetPhysical( lighting ) != graph.GetPhysical( albedo ) );
+		CHECK( graph.GetPhysical( lighting ) != graph.GetPhysical( normals ) );
+		// equal sizes but different formats never share
+		CHECK( graph.GetPhysical( sceneDepth ) != graph.GetPhysical( albedo ) );
+
+		const FrameGraphStatistics& statistics = graph.GetStatistics();
+		CHECK( statistics.transientCount == 9u );
+		CHECK( statistics.physicalCount == 6u );
+		CHECK( statistics.savedBytes == 3u * half.GetSize() );
+		CHECK( statistics.transientBytes == statistics.allocatedBytes + statistics.savedBytes );
+	}
+
+	void TestErrors()
+	{
+		FrameGraph graph;
+		const Resource target = graph.Create( "Target", color );
+		const Pass reader = graph.AddPass( "Reader", nullptr );
+		graph.Read( reader, target );
+		graph.SetSideEffect( reader );
+		CHECK( !graph.Compile() );
+		CHECK( graph.GetError().find( "before anything writes it" ) != std::string::npos );
+		CHECK( graph.GetOrder().empty() );
+
+		// each pass writes what the other read first, so neither can go first
+		graph.Reset();
+		const Resource first = graph.Create( "First", color );
+		const Resource second = graph.Import( "Second", color );
+		const Pass producer = AddPass( graph, "Producer", {}, first, WriteMode::Full );
+		AddPass( graph, "Consumer", { first }, second, WriteMode::Partial );
+		graph.Write( producer, second );
+		CHECK( !graph.Compile() );
+		CHECK( graph.GetError().find( "cycle" ) != std::string::npos );
+
+		// a successful compile clears the last error
+		graph.Reset();
+		AddPass( graph, "Present", {}, graph.Import( "Back Buffer", color ), WriteMode::Full );
+		CHECK( graph.Compile() && graph.GetError().empty() );
+	}
+
+	// clears run just ahead of the pass that needs them, and compiling twice gives the same graph
+	void TestExecute()
+	{
+		std::vector<std::string> calls;
+		FrameGraph graph;
+		const Resource target = graph.Create( "Target", color );
+		const Resource backBuffer = graph.Import( "Back Buffer", color );
+		const Pass draw = graph.AddPass( "Draw", [&calls]() { calls.push_back( "Draw" ); } );
+		graph.Write( draw, target );
+		const Pass present = graph.AddPass( "Present", [&calls]() { calls.push_back( "Present" ); } );
+		graph.Read( present, target );
+		graph.Write( present, backBuffer );
+		graph.AddPass( "Unused", [&calls]() { calls.push_back( "Unused" ); } );
+		CHECK( graph.Compile() );
+		CHECK( graph.Compile() );
+
+		auto clear = [&calls, &graph]( Resource resource ) { calls.push_back( "Clear " + graph.GetResourceName( resource ) ); };
+		graph.Execute( clear );
+		graph.Execute( clear );
+		const std::vector<std::string> frame = { "Clear Target", "Draw", "Clear Back Buffer", "Present" };
+		std::vector<std::string> expected = frame;
+		expected.insert( expected.end(), frame.begin(), frame.end() );
+		CHECK( calls == expected );
+	}
+}
+
+int main()
+{
+	TestRenderer();
+	TestCulling();
+	TestVersionedCulling();
+	TestReadOrdering();
+	TestPingPong();
+	TestDeferredAliasing();
+	TestErrors();
+	TestExecute();
+	return ReportChecks();
+}
\ No newline at end of file
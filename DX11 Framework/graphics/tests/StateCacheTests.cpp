@@ -0,0 +1,252 @@
+#include "BasicStateCache.h"
+#include "Check.h"
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace
+{
+	// stands in for a device context, every call that reaches it is written down in order
+	struct FakeContext
+	{
+		std::vector<std::string> calls;
+	};
+
+	struct FakeObject { int id = 0; };
+	enum FakeTopology : int { TOPOLOGY_UNDEFINED, TOPOLOGY_TRIANGLE_LIST, TOPOLOGY_LINE_LIST };
+	enum FakeFormat : int { FORMAT_UNKNOWN, FORMAT_R16_UINT, FORMAT_R32_UINT };
+	struct FakeViewport { float TopLeftX, TopLeftY, Width, Height, MinDepth, MaxDepth; };
+
+	std::string Name( const FakeObject* object )
+	{
+		return object != nullptr ? std::to_string( object->id ) : "null";
+	}
+
+	class FakeTarget
+	{
+	public:
+		using Context = FakeContext;
+		using VertexShader = FakeObject;
+		using PixelShader = FakeObject;
+		using InputLayout = FakeObject;
+		using Topology = FakeTopology;
+		using Buffer = FakeObject;
+		using Format = FakeFormat;
+		using ShaderResourceView = FakeObject;
+		using SamplerState = FakeObject;
+		using RasterizerState = FakeObject;
+		using DepthStencilState = FakeObject;
+		using BlendState = FakeObject;
+		using Viewport = FakeViewport;
+
+		static constexpr uint32_t MAX_VERTEX_BUFFERS = 32u;
+		static constexpr uint32_t MAX_CONSTANT_BUFFERS = 14u;
+		static constexpr uint32_t MAX_SAMPLERS = 16u;
+
+		void Reset( FakeContext* context ) { this->context = context; }
+		FakeContext* GetContext() const noexcept { return context; }
+
+		void SetVertexShader( FakeObject* shader ) noexcept { Record( "VS " + Name( shader ) ); }
+		void SetPixelShader( FakeObject* shader ) noexcept { Record( "PS " + Name( shader ) ); }
+		void SetInputLayout( FakeObject* inputLayout ) noexcept { Record( "IL " + Name( inputLayout ) ); }
+		void SetPrimitiveTopology( FakeTopology topology ) noexcept { Record( "Topology " + std::to_string( topology ) ); }
+		void SetVertexBuffers( uint32_t startSlot, uint32_t count, FakeObject* const* buffers, const uint32_t* strides, const uint32_t* offsets ) noexcept
+		{
+			std::string call = "VB " + std::to_string( startSlot );
+			for ( uint32_t i = 0; i < count; i++ )
+				call += " " + Name( buffers[i] ) + "/" + std::to_string( strides[i] ) + "/" + std::to_string( offsets[i] );
+			Record( call );
+		}
+		void SetIndexBuffer( FakeObject* buffer, FakeFormat format, uint32_t offset ) noexcept
+		{
+			Record( "IB " + Name( buffer ) + " " + std::to_string( format ) + " " + std::to_string( offset ) );
+		}
+		void SetVSConstantBuffer( uint32_t slot, FakeObject* buffer, uint32_t firstConstant, uint32_t constantCount ) noexcept
+		{
+			Record( "VSCB " + std::to_string( slot ) + " " + Name( buffer ) + " " + std::to_string( firstConstant ) + " " + std::to_string( constantCount ) );
+		}
+		void SetPSConstantBuffer( uint32_t slot, FakeObject* buffer, uint32_t firstConstant, uint32_t constantCount ) noexcept
+		{
+			Record( "PSCB " + std::to_string( slot ) + " " + Name( buffer ) + " " + std::to_string( firstConstant ) + " " + std::to_string( constantCount ) );
+		}
+		void SetVSShaderResource( uint32_t slot, FakeObject* view ) noexcept { Record( "VSSRV " + std::to_string( slot ) + " " + Name( view ) ); }
+		void SetPSShaderResource( uint32_t slot, FakeObject* view ) noexcept { Record( "PSSRV " + std::to_string( slot ) + " " + Name( view ) ); }
+		void SetPSSampler( uint32_t slot, FakeObject* sampler ) noexcept { Record( "Sampler " + std::to_string( slot ) + " " + Name( sampler ) ); }
+		void SetRasterizerState( FakeObject* state ) noexcept { Record( "RS " + Name( state ) ); }
+		void SetDepthStencilState( FakeObject* state, uint32_t stencilRef ) noexcept { Record( "DSS " + Name( state ) + " " + std::to_string( stencilRef ) ); }
+		void SetBlendState( FakeObject* state ) noexcept { Record( "Blend " + Name( state ) ); }
+		void SetViewport( const FakeViewport& viewport ) noexcept
+		{
+			Record( "Viewport " + std::to_string( static_cast<int>( viewport.Width ) ) + "x" + std::to_string( static_cast<int>( viewport.Height ) ) );
+		}
+		void Draw( uint32_t vertexCount, uint32_t ) noexcept { Record( "Draw " + std::to_string( vertexCount ) ); }
+		void DrawIndexed( uint32_t indexCount, uint32_t, int32_t ) noexcept { Record( "DrawIndexed " + std::to_string( indexCount ) ); }
+		void DrawIndexedInstanced( uint32_t indexCount, uint32_t instanceCount, uint32_t, int32_t, uint32_t ) noexcept
+		{
+			Record( "DrawIndexedInstanced " + std::to_string( indexCount ) + " " + std::to_string( instanceCount ) );
+		}
+	private:
+		void Record( std::string call ) { context->calls.push_back( std::move( call ) ); }
+		FakeContext* context = nullptr;
+	};
+
+	using Cache = BasicStateCache<FakeTarget>;
+
+	FakeObject objects[8] = { { 0 }, { 1 }, { 2 }, { 3 }, { 4 }, { 5 }, { 6 }, { 7 } };
+
+	// a draw call's worth of binds, the way a mesh issues them
+	void BindMesh( Cache& cache, FakeObject* shader, FakeObject* buffer, uint32_t firstConstant )
+	{
+		uint32_t stride = 32u, offset = 0u;
+		cache.SetVertexShader( shader );
+		cache.SetPixelShader( &objects[1] );
+		cache.SetInputLayout( &objects[2] );
+		cache.SetPrimitiveTopology( TOPOLOGY_TRIANGLE_LIST );
+		cache.SetVertexBuffers( 0, 1, &buffer, &stride, &offset );
+		cache.SetIndexBuffer( buffer, FORMAT_R32_UINT, 0 );
+		cache.SetVSConstantBuffer( 0, &objects[3], firstConstant, 16u );
+		cache.SetPSSampler( 0, &objects[4] );
+		cache.DrawIndexed( 36, 0, 0 );
+	}
+
+	// only binds that change a slot reach the context, draws always do
+	void TestFiltering()
+	{
+		Cache::ResetStatistics();
+		FakeContext context;
+		Cache cache;
+		cache.Initialize( &context );
+		BindMesh( cache, &objects[0], &objects[5], 0u );
+		BindMesh( cache, &objects[0], &objects[5], 16u );
+		BindMesh( cache, &objects[6], &objects[7], 16u );
+		const std::vector<std::string> expected = {
+			"VS 0", "PS 1", "IL 2", "Topology 1", "VB 0 5/32/0", "IB 5 2 0", "VSCB 0 3 0 16", "Sampler 0 4", "DrawIndexed 36",
+			"VSCB 0 3 16 16", "DrawIndexed 36",
+			"VS 6", "VB 0 7/32/0", "IB 7 2 0", "DrawIndexed 36" };
+		CHECK( context.calls == expected );
+
+		const StateCacheStatistics statistics = Cache::GetStatistics();
+		CHECK( statistics.issuedCount == 12u );
+		CHECK( statistics.filteredCount == 12u );
+		CHECK( statistics.drawCount == 3u );
+
+		// each part of a binding counts, a buffer bound whole is not the same as a block of it
+		context.calls.clear();
+		cache.SetVSConstantBuffer( 0, &objects[3] );
+		cache.SetPSConstantBuffer( 0, &objects[3] );
+		cache.SetPSConstantBuffer( 0, &objects[3] );
+		cache.SetDepthStencilState( &objects[1], 0 );
+		cache.SetDepthStencilState( &objects[1], 1 );
+		cache.SetIndexBuffer( &objects[7], FORMAT_R16_UINT, 0 );
+		cache.SetIndexBuffer( &objects[7], FORMAT_R16_UINT, 64 );
+		CHECK( context.calls == std::vector<std::string>( { "VSCB 0 3 0 0", "PSCB 0 3 0 0", "DSS 1 0", "DSS 1 1", "IB 7 1 0", "IB 7 1 64" } ) );
+
+		// binding several vertex buffers is dropped only if every one of them matches
+		context.calls.clear();
+		FakeObject* buffers[2] = { &objects[5], &objects[6] };
+		uint32_t strides[2] = { 32u, 16u }, offsets[2] = { 0u, 0u };
+		cache.SetVertexBuffers( 0, 2, buffers, strides, offsets );
+		cache.SetVertexBuffers( 0, 2, buffers, strides, offsets );
+		cache.SetVertexBuffers( 1, 1, &buffers[1], &strides[1], &offsets[1] );
+		offsets[1] = 48u;
+		cache.SetVertexBuffers( 0, 2, buffers, strides, offsets );
+		CHECK( context.calls == std::vector<std::string>( { "VB 0 5/32/0 6/16/0", "VB 0 5/32/0 6/16/48" } ) );
+
+		// viewports compare by value
+		context.calls.clear();
+		FakeViewport viewport = { 0.0f, 0.0f, 640.0f, 480.0f, 0.0f, 1.0f };
+		cache.SetViewport( viewport );
+		cache.SetViewport( viewport );
+		viewport.Width = 320.0f;
+		cache.SetViewport( viewport );
+		CHECK( context.calls == std::vector<std::string>( { "Viewport 640x480", "Viewport 320x480" } ) );
+
+		// shader resources past the tracked slots always go through
+		context.calls.clear();
+		cache.SetPSShaderResource( Cache::MAX_SHADER_RESOURCES, &objects[1] );
+		cache.SetPSShaderResource( Cache::MAX_SHADER_RESOURCES, &objects[1] );
+		cache.SetPSShaderResource( 0, &objects[1] );
+		cache.SetPSShaderResource( 0, &objects[1] );
+		CHECK( context.calls == std::vector<std::string>( { "PSSRV 16 1", "PSSRV 16 1", "PSSRV 0 1" } ) );
+	}
+
+	// after state was set behind the cache's back, every slot is bound again once, null included
+	void TestInvalidate()
+	{
+		FakeContext context;
+		Cache cache;
+		cache.Initialize( &context );
+
+		// a fresh cache knows nothing, so binding null still goes through
+		cache.SetBlendState( nullptr );
+		cache.SetRasterizerState( nullptr );
+		cache.SetVSShaderResource( 0, nullptr );
+		cache.SetPrimitiveTopology( TOPOLOGY_UNDEFINED );
+		cache.SetBlendState( nullptr );
+		CHECK( context.calls == std::vector<std::string>( { "Blend null", "RS null", "VSSRV 0 null", "Topology 0" } ) );
+
+		context.calls.clear();
+		BindMesh( cache, &objects[0], &objects[5], 0u );
+		cache.Invalidate();
+		BindMesh( cache, &objects[0], &objects[5], 0u );
+		BindMesh( cache, &objects[0], &objects[5], 0u );
+		cache.SetBlendState( nullptr );
+		const std::vector<std::string> mesh = {
+			"VS 0", "PS 1", "IL 2", "Topology 1", "VB 0 5/32/0", "IB 5 2 0", "VSCB 0 3 0 16", "Sampler 0 4", "DrawIndexed 36" };
+		std::vector<std::string> expected = mesh;
+		expected.insert( expected.end(), mesh.begin(), mesh.end() );
+		expected.push_back( "DrawIndexed 36" );
+		expected.push_back( "Blend null" );
+		CHECK( context.calls == expected );
+	}
+
+	// contexts nobody attached a cache to get every call, the attached cache answers for its own context and its source
+	void TestPassThrough()
+	{
+		FakeContext immediate, deferred, other;
+		Cache cache;
+		cache.Initialize( &deferred, &immediate );
+		CHECK( Cache::GetAttached() == nullptr );
+
+		// nothing attached, so even the immediate context gets its repeated binds
+		Cache& passThrough = Cache::Get( &immediate );
+		CHECK( &passThrough != &cache );
+		CHECK( passThrough.GetContext() == &immediate );
+		Cache::Get( &immediate ).SetVertexShader( &objects[0] );
+		Cache::Get( &immediate ).SetVertexShader( &objects[0] );
+		Cache::Get( &immediate ).Draw( 3, 0 );
+		CHECK( immediate.calls == std::vector<std::string>( { "VS 0", "VS 0", "Draw 3" } ) );
+
+		// once attached, objects holding the immediate context record into the deferred one and are filtered
+		cache.Attach();
+		CHECK( Cache::GetAttached() == &cache );
+		CHECK( &Cache::Get( &immediate ) == &cache );
+		CHECK( &Cache::Get( &deferred ) == &cache );
+		Cache::Get( &immediate ).SetVertexShader( &objects[0] );
+		Cache::Get( &deferred ).SetVertexShader( &objects[0] );
+		Cache::Get( &immediate ).DrawIndexedInstanced( 6, 4, 0, 0, 0 );
+		CHECK( deferred.calls == std::vector<std::string>( { "VS 0", "DrawIndexedInstanced 6 4" } ) );
+		CHECK( immediate.calls.size() == 3u );
+
+		// any other context still passes straight through, and the pass-through cache follows it
+		Cache::Get( &other ).SetPixelShader( &objects[1] );
+		Cache::Get( &other ).SetPixelShader( &objects[1] );
+		CHECK( other.calls == std::vector<std::string>( { "PS 1", "PS 1" } ) );
+		CHECK( Cache::Get( &other ).GetContext() == &other );
+
+		// detaching hands the immediate context back to the pass-through cache
+		Cache::Detach();
+		CHECK( Cache::GetAttached() == nullptr );
+		Cache::Get( &immediate ).SetVertexShader( &objects[0] );
+		CHECK( immediate.calls.size() == 4u && immediate.calls.back() == "VS 0" );
+		CHECK( deferred.calls.size() == 2u );
+	}
+}
+
+int main()
+{
+	TestFiltering();
+	TestInvalidate();
+	TestPassThrough();
+	return ReportChecks();
+}
\ No newline at end of file
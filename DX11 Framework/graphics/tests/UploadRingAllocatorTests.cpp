@@ -0,0 +1,157 @@
+#include "UploadRingAllocator.h"
+#include "Check.h"
+#include <cstdint>
+#include <random>
+#include <vector>
+
+namespace
+{
+	// sizes round up to whole 256 byte blocks, and so does the capacity it's given, downwards
+	void TestAlignment()
+	{
+		CHECK( UploadRingAllocator::AlignSize( 1u ) == 256u );
+		CHECK( UploadRingAllocator::AlignSize( 256u ) == 256u );
+		CHECK( UploadRingAllocator::AlignSize( 257u ) == 512u );
+		CHECK( UploadRingAllocator::AlignSize( 2u * 256u + 1u ) == 768u );
+
+		UploadRingAllocator allocator;
+		allocator.Reset( 4096u + 100u );
+		CHECK( allocator.GetCapacity() == 4096u );
+
+		// every block starts on the alignment and doesn't overlap the one before it
+		std::mt19937 random( 42u );
+		std::uniform_int_distribution<uint32_t> sizes( 1u, 700u );
+		for ( uint32_t frame = 0; frame < 50; frame++ )
+		{
+			allocator.BeginFrame();
+			uint32_t end = 0, count = 0;
+			UploadRingAllocator::Allocation allocation;
+			for ( uint32_t size = sizes( random ); allocator.Allocate( size, allocation ); size = sizes( random ) )
+			{
+				// the ring holds no more blocks than it has room for, however small they are
+				if ( ++count > allocator.GetCapacity() / UploadRingAllocator::ALIGNMENT )
+				{
+					CHECK( count <= allocator.GetCapacity() / UploadRingAllocator::ALIGNMENT );
+					break;
+				}
+				CHECK( allocation.offset % UploadRingAllocator::ALIGNMENT == 0u );
+				CHECK( allocation.size % UploadRingAllocator::ALIGNMENT == 0u );
+				CHECK( allocation.size >= size && allocation.size < size + UploadRingAllocator::ALIGNMENT );
+				CHECK( allocation.offset == end );
+				CHECK( allocation.offset + allocation.size <= allocator.GetCapacity() );
+				end = allocation.offset + allocation.size;
+			}
+			CHECK( allocator.GetHead() == end );
+		}
+	}
+
+	// a full ring refuses blocks rather than discarding under earlier ones, and the next frame takes them again
+	void TestFullRing()
+	{
+		UploadRingAllocator allocator;
+		allocator.Reset( 1024u );
+		UploadRingAllocator::Allocation allocation;
+		for ( uint32_t i = 0; i < 4; i++ )
+		{
+			CHECK( allocator.Allocate( 200u, allocation ) );
+			CHECK( allocation.offset == i * 256u );
+			CHECK( allocation.discard == ( i == 0 ) );
+		}
+		CHECK( allocator.GetHead() == allocator.GetCapacity() );
+		CHECK( !allocator.Allocate( 1u, allocation ) );
+		CHECK( allocator.GetHead() == allocator.GetCapacity() );
+
+		// a block that only fits once the ring is empty is still refused mid-frame
+		allocator.BeginFrame();
+		CHECK( allocator.Allocate( 256u, allocation ) );
+		CHECK( !allocator.Allocate( 1024u, allocation ) );
+		CHECK( allocator.Allocate( 768u, allocation ) );
+		CHECK( allocation.offset == 256u && !allocation.discard );
+
+		// blocks that could never fit, or are empty, are always refused and leave the ring as it was
+		allocator.BeginFrame();
+		const uint32_t head = allocator.GetHead();
+		CHECK( !allocator.Allocate( 1025u, allocation ) );
+		CHECK( !allocator.Allocate( 0u, allocation ) );
+		CHECK( !allocator.Allocate( UINT32_MAX, allocation ) );
+		CHECK( allocator.GetHead() == head );
+		CHECK( allocator.Allocate( 1024u, allocation ) );
+		CHECK( allocation.offset == 0u && allocation.discard );
+
+		// a ring too small for a single block hands out nothing
+		allocator.Reset( 100u );
+		CHECK( allocator.GetCapacity() == 0u );
+		CHECK( !allocator.Allocate( 1u, allocation ) );
+	}
+
+	// the ring wraps back to the start on the first block of each frame, and only that block discards
+	void TestWrapAround()
+	{
+		UploadRingAllocator allocator;
+		allocator.Reset( 2048u );
+		UploadRingAllocator::Allocation allocation;
+		CHECK( allocator.Allocate( 1500u, allocation ) );
+		CHECK( allocation.discard );
+		CHECK( allocator.Allocate( 300u, allocation ) );
+		CHECK( allocation.offset == 1536u && !allocation.discard );
+
+		allocator.BeginFrame();
+		CHECK( allocator.Allocate( 300u, allocation ) );
+		CHECK( allocation.offset == 0u && allocation.discard );
+		CHECK( allocator.Allocate( 300u, allocation ) );
+		CHECK( allocation.offset == 512u && !allocation.discard );
+
+		// a frame with nothing to upload discards nothing, the next block still restarts the ring
+		allocator.BeginFrame();
+		allocator.BeginFrame();
+		CHECK( allocator.Allocate( 16u, allocation ) );
+		CHECK( allocation.offset == 0u && allocation.discard );
+
+		// reset starts over as if the buffer were new
+		allocator.Reset( 2048u );
+		CHECK( allocator.GetHead() == 0u );
+		CHECK( allocator.Allocate( 16u, allocation ) );
+		CHECK( allocation.offset == 0u && allocation.discard );
+	}
+
+	// blocks carry the generation they were handed out in, an earlier one means the discard may have dropped them
+	// this is how constant buffers decide whether an unchanged upload can be bound again or must be made again
+	void TestGenerations()
+	{
+		UploadRingAllocator allocator;
+		allocator.Reset( 4096u );
+		UploadRingAllocator::Allocation cached;
+		CHECK( allocator.Allocate( 64u, cached ) );
+		const uint32_t cachedGeneration = allocator.GetGeneration();
+
+		// the same frame may bind the cached block again as often as it likes
+		UploadRingAllocator::Allocation other;
+		CHECK( allocator.Allocate( 64u, other ) );
+		CHECK( allocator.GetGeneration() == cachedGeneration );
+		CHECK( other.offset != cached.offset );
+
+		// the next frame reuses its offset for something else, so the generation must have moved on
+		allocator.BeginFrame();
+		CHECK( allocator.GetGeneration() != cachedGeneration );
+		CHECK( allocator.Allocate( 64u, other ) );
+		CHECK( other.offset == cached.offset && other.discard );
+
+		// generations only move with frames, not with resets or allocations
+		const uint32_t generation = allocator.GetGeneration();
+		allocator.Reset( 4096u );
+		CHECK( allocator.Allocate( 64u, other ) );
+		CHECK( allocator.GetGeneration() == generation );
+		for ( uint32_t i = 0; i < 10; i++ )
+			allocator.BeginFrame();
+		CHECK( allocator.GetGeneration() == generation + 10u );
+	}
+}
+
+int main()
+{
+	TestAlignment();
+	TestFullRing();
+	TestWrapAround();
+	TestGenerations();
+	return ReportChecks();
+}
\ No newline at end of file
@@ -1,29 +1,23 @@
 #include "MousePicking.h"
 #include "../utility/Structs.h"
-#include "../graphics/GameObject3D.h"
-#include <DirectXCollision.h>
 
 void MousePicking::Initialize( XMMATRIX viewMatrix, XMMATRIX projectionMatrix, int width, int height )
 {
-	this->viewMatrix = viewMatrix;
-	this->projectionMatrix = projectionMatrix;
+	UpdateMatrices( viewMatrix, projectionMatrix );
 	this->width = width;
 	this->height = height;
 }
 
 void MousePicking::UpdateMatrices( XMMATRIX viewMatrix, XMMATRIX projectionMatrix )
 {
-	this->viewMatrix = viewMatrix;
-	this->projectionMatrix = projectionMatrix;
+	inverseViewMatrix = XMMatrixInverse( nullptr, viewMatrix );
+	inverseProjectionMatrix = XMMatrixInverse( nullptr, projectionMatrix );
 }
 
-bool MousePicking::TestIntersection( int mouseX, int mouseY, GameObject3D object )
+PickRay MousePicking::GetRay( int mouseX, int mouseY ) const noexcept
 {
-	XMMATRIX invProj = XMMatrixInverse( nullptr, projectionMatrix );
-	XMMATRIX invView = XMMatrixInverse( nullptr, viewMatrix );
-
 	// move the mouse cursor coordinates into the -1 to +1 range
-	static float widthToUse;
+	float widthToUse;
 	if ( viewportParams.useSplit && viewportParams.controlLeftSide )
 		widthToUse = static_cast<float>( width ) * 0.5f;
 	else
@@ -32,33 +26,23 @@ bool MousePicking::TestIntersection( int mouseX, int mouseY, GameObject3D object
 	float pointY = 1.0f - ( 2.0f * static_cast<float>( mouseY ) ) / static_cast<float>( height );
 
 	XMVECTOR eyePos, dummy;
-	XMMatrixDecompose( &dummy, &dummy, &eyePos, invView );
+	XMMatrixDecompose( &dummy, &dummy, &eyePos, inverseViewMatrix );
 
 	// transform the mouse position into world space
 	XMVECTOR rayOri = XMVectorSet( pointX, pointY, 0.0f, 0.0f );
-	rayOri = XMVector3Transform( rayOri, invProj );
-	rayOri = XMVector3Transform( rayOri, invView );
+	rayOri = XMVector3Transform( rayOri, inverseProjectionMatrix );
+	rayOri = XMVector3Transform( rayOri, inverseViewMatrix );
 
 	XMVECTOR rayDir = rayOri - eyePos;
 	rayDir = XMVector3Normalize( rayDir );
 
-	// generate bounding sphere
-	BoundingSphere bs;
-	bs.Center = object.GetPositionFloat3();
-		
-	float maxRadius = 0.0f;
-	if ( fabs( object.GetScaleFloat3().x > maxRadius ) )
-		maxRadius = fabs( object.GetScaleFloat3().x );
-	if ( fabs( object.GetScaleFloat3().y > maxRadius ) )
-		maxRadius = fabs( object.GetScaleFloat3().y );
-	if ( fabs( object.GetScaleFloat3().z > maxRadius ) )
-		maxRadius = fabs( object.GetScaleFloat3().z );
-	bs.Radius = maxRadius * 0.5f;
-
-	// check for intersection between sphere and ray
-	float distance = 1000.0f;
-	if ( bs.Intersects( rayOri, rayDir, distance ) )
-		return true;
+	PickRay ray;
+	XMStoreFloat3( &ray.origin, rayOri );
+	XMStoreFloat3( &ray.direction, rayDir );
+	return ray;
+}
 
-	return false;
+PickHit MousePicking::Pick( int mouseX, int mouseY, const BoundingVolumeHierarchy& bvh ) const noexcept
+{
+	return bvh.Intersect( GetRay( mouseX, mouseY ) );
 }
\ No newline at end of file
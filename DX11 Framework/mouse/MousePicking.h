@@ -3,19 +3,19 @@
 #define MOUSEPICKING_H
 
 #include <DirectXMath.h>
+#include "../graphics/BoundingVolumeHierarchy.h"
 using namespace DirectX;
 
-class Graphics;
-class GameObject3D;
-
+// turns cursor positions into world space rays, the inverse matrices are worked out once per UpdateMatrices
 class MousePicking
 {
 public:
 	void Initialize( XMMATRIX viewMatrix, XMMATRIX projectionMatrix, int width, int height );
 	void UpdateMatrices( XMMATRIX viewMatrix, XMMATRIX projectionMatrix );
-	bool TestIntersection( int mouseX, int mouseY, GameObject3D object );
+	PickRay GetRay( int mouseX, int mouseY ) const noexcept;
+	PickHit Pick( int mouseX, int mouseY, const BoundingVolumeHierarchy& bvh ) const noexcept;
 private:
-	XMMATRIX viewMatrix, projectionMatrix;
+	XMMATRIX inverseViewMatrix, inverseProjectionMatrix;
 	int width, height;
 };
 
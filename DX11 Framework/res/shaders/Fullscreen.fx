@@ -1,6 +1,8 @@
 // Vertex Shader
 cbuffer ViewBuffer : register( b0 )
 {
+    float2 uvScale;
+    float2 uvMax;
     bool multiView;
 };
 
@@ -47,5 +49,7 @@ SamplerState samplerState : SAMPLER : register( s0 );
 
 float4 PS( PS_INPUT input ) : SV_TARGET
 {
-    return quadTexture.Sample( samplerState, input.inTex ).rgba;
+    // the scene only covers the top left of its target below full resolution, keep filtering inside that area
+    float2 texCoord = multiView ? frac( input.inTex ) : input.inTex;
+    return quadTexture.Sample( samplerState, min( texCoord * uvScale, uvMax ) ).rgba;
 }
\ No newline at end of file
@@ -16,6 +16,12 @@ cbuffer FogBuffer : register( b1 )
     bool fogEnable;
 }
 
+cbuffer QuantizationBuffer : register( b4 )
+{
+    float3 positionOffset;
+    float3 positionScale;
+}
+
 struct VS_INPUT
 {
     float3 inPosition : POSITION;
@@ -23,6 +29,21 @@ struct VS_INPUT
     float3 inNormal : NORMAL;
 };
 
+struct VS_INPUT_INSTANCED
+{
+    float3 inPosition : POSITION;
+    float2 inTexCoord : TEXCOORD;
+    float3 inNormal : NORMAL;
+    uint inInstance : INSTANCE_INDEX;
+};
+
+struct VS_INPUT_QUANTIZED
+{
+    float4 inPosition : POSITION; // unorm, relative to the mesh bounds
+    float2 inTexCoord : TEXCOORD; // half
+    float2 inNormal : NORMAL; // snorm, octahedral
+};
+
 struct VS_OUTPUT
 {
     float4 outPosition : SV_POSITION;
@@ -33,24 +54,58 @@ struct VS_OUTPUT
     float  outFog : FOG;
 };
 
-VS_OUTPUT VS( VS_INPUT input )
+// world matrix of each instance, indexed by the per-instance stream
+StructuredBuffer<float4x4> instanceWorldMatrices : register( t0 );
+
+VS_OUTPUT Transform( VS_INPUT input, float4x4 world )
 {
     VS_OUTPUT output;
     
-    float4x4 worldView = mul( worldMatrix, viewMatrix );
+    float4x4 worldView = mul( world, viewMatrix );
     float4x4 worldViewProj = mul( worldView, projectionMatrix );
     
     output.outPosition = mul( float4( input.inPosition, 1.0f ), worldViewProj );
-    output.outWorldPos = (float3)mul( float4( input.inPosition, 1.0f ), worldMatrix );
+    output.outWorldPos = (float3)mul( float4( input.inPosition, 1.0f ), world );
     output.outViewPos = (float3)mul( float4( input.inPosition, 1.0f ), worldView );
     
     output.outTexCoord = input.inTexCoord;
-    output.outNormal = mul( input.inNormal, (float3x3)worldMatrix );
+    output.outNormal = mul( input.inNormal, (float3x3)world );
     output.outFog = saturate( ( output.outViewPos.z - fogEnd ) / ( fogEnd - fogStart ) ); // linear fog
     
     return output;
 }
 
+VS_OUTPUT VS( VS_INPUT input )
+{
+    return Transform( input, worldMatrix );
+}
+
+VS_OUTPUT VS_Instanced( VS_INPUT_INSTANCED input )
+{
+    VS_INPUT vertex;
+    vertex.inPosition = input.inPosition;
+    vertex.inTexCoord = input.inTexCoord;
+    vertex.inNormal = input.inNormal;
+    return Transform( vertex, instanceWorldMatrices[input.inInstance] );
+}
+
+float3 DecodeOctahedral( float2 encoded )
+{
+    float3 normal = float3( encoded, 1.0f - abs( encoded.x ) - abs( encoded.y ) );
+    const float fold = saturate( -normal.z );
+    normal.xy += normal.xy >= 0.0f ? -fold : fold;
+    return normalize( normal );
+}
+
+VS_OUTPUT VS_Quantized( VS_INPUT_QUANTIZED input )
+{
+    VS_INPUT decoded;
+    decoded.inPosition = positionOffset + input.inPosition.xyz * positionScale;
+    decoded.inTexCoord = input.inTexCoord;
+    decoded.inNormal = DecodeOctahedral( input.inNormal );
+    return VS( decoded );
+}
+
 // pixel shader
 cbuffer LightBuffer : register( b2 )
 {
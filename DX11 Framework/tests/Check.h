@@ -0,0 +1,25 @@
+#pragma once
+#ifndef CHECK_H
+#define CHECK_H
+
+#include <cstdio>
+
+// no test framework, a failed check reports where it was and the run ends with a failing exit code
+// variadic, so conditions with template argument lists need no extra parentheses
+inline int checkFailures = 0;
+
+#define CHECK( ... ) \
+	do { if ( !( __VA_ARGS__ ) ) { checkFailures++; std::printf( "%s:%d: check failed: %s\n", __FILE__, __LINE__, #__VA_ARGS__ ); } } while ( false )
+
+inline int ReportChecks()
+{
+	if ( checkFailures != 0 )
+	{
+		std::printf( "%d checks failed\n", checkFailures );
+		return 1;
+	}
+	std::printf( "all checks passed\n" );
+	return 0;
+}
+
+#endif
\ No newline at end of file
@@ -0,0 +1,29 @@
+#pragma once
+#ifndef DIRECTXMATH_COMPAT_H
+#define DIRECTXMATH_COMPAT_H
+
+// stands in for directxmath where it isn't installed, CMakeLists.txt only adds this directory when it can't find the real one
+// holds just the storage types that the portable code passes around, laid out as the real ones are, and none of the maths
+namespace DirectX
+{
+	struct XMFLOAT3
+	{
+		float x;
+		float y;
+		float z;
+		XMFLOAT3() = default;
+		constexpr XMFLOAT3( float x, float y, float z ) noexcept : x( x ), y( y ), z( z ) {}
+	};
+
+	struct XMFLOAT4
+	{
+		float x;
+		float y;
+		float z;
+		float w;
+		XMFLOAT4() = default;
+		constexpr XMFLOAT4( float x, float y, float z, float w ) noexcept : x( x ), y( y ), z( z ), w( w ) {}
+	};
+}
+
+#endif
\ No newline at end of file
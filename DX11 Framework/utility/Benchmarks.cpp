@@ -0,0 +1,48 @@
+#include "Benchmarks.h"
+#include "CommandLine.h"
+
+namespace
+{
+	struct Command
+	{
+		const char* name;
+		void ( *run )( const std::vector<std::string>& files );
+	};
+
+	const Command commands[] =
+	{
+		{ "-benchmark-tiles", Benchmarks::TileUpdate },
+		{ "-benchmark-queue", Benchmarks::QueueSort },
+		{ "-benchmark-recording", Benchmarks::ViewRecording },
+		{ "-benchmark-bvh", Benchmarks::SceneBvh },
+		{ "-benchmark-picking", Benchmarks::Picking },
+		{ "-benchmark-transforms", Benchmarks::TransformUpdates },
+		{ "-benchmark-hierarchy", Benchmarks::HierarchyPropagation },
+	};
+
+	const Command* FindCommand( const std::vector<std::string>& arguments )
+	{
+		if ( arguments.empty() )
+			return nullptr;
+		for ( const Command& command : commands )
+			if ( arguments[0] == command.name )
+				return &command;
+		return nullptr;
+	}
+}
+
+bool Benchmarks::IsBenchmarkCommand( const std::string& commandLine )
+{
+	return FindCommand( CommandLine::GetArguments( commandLine ) ) != nullptr;
+}
+
+int Benchmarks::Run( const std::string& commandLine )
+{
+	CommandLine::OpenConsole();
+	const std::vector<std::string> arguments = CommandLine::GetArguments( commandLine );
+	const Command* command = FindCommand( arguments );
+	if ( command == nullptr )
+		return -1;
+	command->run( CommandLine::GetFiles( arguments ) );
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,37 @@
+#pragma once
+#ifndef BENCHMARKS_H
+#define BENCHMARKS_H
+
+#include <string>
+#include <vector>
+
+#define BENCHMARK_ITERATIONS 5
+#define BENCHMARK_FRAMES 100
+
+// benchmarks of the modules that need direct3d or directxmath, run from WinMain without creating a window
+// each is defined next to its module, in that module's benchmarks folder
+// the modules that build on their own have benchmark targets in CMakeLists.txt instead
+//  -benchmark-tiles         per-frame cost of the instanced ground tile update at 400, 10k and 100k tiles
+//  -benchmark-queue         render queue radix sort against std::sort on 10k, 100k and 1m synthetic draws
+//  -benchmark-recording     parallel view recording on the headless backend with 2, 4 and 8 views of 10k and 100k draws
+//  -benchmark-bvh           bvh build, ray query against brute force, and refit against rebuild at 1k, 10k, 100k and 1m objects
+//  -benchmark-picking [files...]  triangle bvh build time and per-ray pick cost on sponza (or the given models) against the picking budget
+//  -benchmark-transforms    per-setter matrix rebuilds against the batched transform store with all, 10% and 1% of 10k, 100k and 1m objects moving
+//  -benchmark-hierarchy     world matrix propagation through deep, wide, tree and forest hierarchies of 10k, 100k and 1m objects
+class Benchmarks
+{
+public:
+	static bool IsBenchmarkCommand( const std::string& commandLine );
+	static int Run( const std::string& commandLine );
+
+	// files are the arguments after the command that aren't options
+	static void TileUpdate( const std::vector<std::string>& files );
+	static void QueueSort( const std::vector<std::string>& files );
+	static void ViewRecording( const std::vector<std::string>& files );
+	static void SceneBvh( const std::vector<std::string>& files );
+	static void Picking( const std::vector<std::string>& files );
+	static void TransformUpdates( const std::vector<std::string>& files );
+	static void HierarchyPropagation( const std::vector<std::string>& files );
+};
+
+#endif
\ No newline at end of file
@@ -4,14 +4,15 @@
 
 #include "..\\graphics\GameObject3D.h"
 #include "..\\graphics\\Camera3D.h"
+#include "..\\graphics\\Transform.h"
 
 class Billboarding
 {
 public:
-	static float BillboardModel( std::shared_ptr<Camera3D>& camera, GameObject3D& object )
+	static float BillboardModel( std::shared_ptr<Camera3D>& camera, const Transform& object )
 	{
-		double angle = atan2( object.GetPositionFloat3().x - camera->GetPositionFloat3().x,
-			object.GetPositionFloat3().z - camera->GetPositionFloat3().z ) * ( 180.0 / XM_PI );
+		double angle = atan2( object.GetWorldPositionFloat3().x - camera->GetWorldPositionFloat3().x,
+			object.GetWorldPositionFloat3().z - camera->GetWorldPositionFloat3().z ) * ( 180.0 / XM_PI );
 		return static_cast<float>( angle ) * 0.0174532925f;
 	}
 };
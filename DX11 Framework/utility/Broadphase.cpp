@@ -0,0 +1,365 @@
+#include "Broadphase.h"
+#include <algorithm>
+
+using namespace DirectX;
+
+Broadphase::Broadphase( BroadphaseMode mode, float cellSize )
+	: mode( mode ), cellSize( cellSize )
+{}
+
+// every sphere is sorted again, cells change meaning with either setting
+void Broadphase::SetMode( BroadphaseMode mode, float cellSize )
+{
+	if ( this->mode == mode && this->cellSize == cellSize )
+		return;
+	this->mode = mode;
+	this->cellSize = cellSize;
+	Rebuild();
+}
+
+BroadphaseMode Broadphase::GetMode() const noexcept
+{
+	return mode;
+}
+
+float Broadphase::GetCellSize() const noexcept
+{
+	return cellSize;
+}
+
+Broadphase::Proxy Broadphase::Add( const XMFLOAT3& center, float radius )
+{
+	Proxy proxy;
+	if ( !freeProxies.empty() )
+	{
+		proxy = freeProxies.back();
+		freeProxies.pop_back();
+	}
+	else
+	{
+		proxy = static_cast<Proxy>( proxies.size() );
+		proxies.emplace_back();
+		for ( std::vector<float>* stream : { &centerX, &centerY, &centerZ, &radii } )
+			stream->emplace_back();
+	}
+	ProxyData& data = proxies[proxy];
+	SetSphere( proxy, center, radius );
+	data.placement = Place( center, radius );
+	data.alive = true;
+	Link( proxy );
+	statistics.proxyCount++;
+	return proxy;
+}
+
+void Broadphase::Remove( Proxy proxy )
+{
+	Unlink( proxy );
+	proxies[proxy].alive = false;
+	freeProxies.push_back( proxy );
+	statistics.proxyCount--;
+}
+
+void Broadphase::Move( Proxy proxy, const XMFLOAT3& center, float radius )
+{
+	ProxyData& data = proxies[proxy];
+	SetSphere( proxy, center, radius );
+	statistics.movedCount++;
+	const Placement placement = Place( center, radius );
+	if ( placement.key == data.placement.key )
+		return;
+	Unlink( proxy );
+	data.placement = placement;
+	Link( proxy );
+	statistics.rebucketedCount++;
+}
+
+void Broadphase::Clear()
+{
+	proxies.clear();
+	for ( std::vector<float>* stream : { &centerX, &centerY, &centerZ, &radii } )
+		stream->clear();
+	freeProxies.clear();
+	cells.clear();
+	usedCellCount = 0;
+	tableBits = 0;
+	oversized = INVALID;
+	std::fill_n( levelCounts, LEVEL_COUNT, 0u );
+	statistics = BroadphaseStatistics();
+}
+
+// each sphere queries its own box, so a pair is found from both ends and kept from the lower one
+void Broadphase::FindPairs( std::vector<Pair>& pairs )
+{
+	pairs.clear();
+	for ( Proxy a = 0; a < proxies.size(); a++ )
+	{
+		if ( !proxies[a].alive )
+			continue;
+		const float min[3] = { centerX[a] - radii[a], centerY[a] - radii[a], centerZ[a] - radii[a] };
+		const float max[3] = { centerX[a] + radii[a], centerY[a] + radii[a], centerZ[a] + radii[a] };
+		Query( min, max, [this, a, &min, &max, &pairs]( Proxy b )
+		{
+			if ( b <= a )
+				return;
+			if ( centerX[b] + radii[b] >= min[0] && centerX[b] - radii[b] <= max[0] &&
+				centerY[b] + radii[b] >= min[1] && centerY[b] - radii[b] <= max[1] &&
+				centerZ[b] + radii[b] >= min[2] && centerZ[b] - radii[b] <= max[2] )
+				pairs.emplace_back( a, b );
+		} );
+	}
+	statistics.candidateCount += static_cast<uint32_t>( pairs.size() );
+}
+
+void Broadphase::FindCollisions( std::vector<Pair>& candidates, std::vector<uint8_t>& results, std::vector<Pair>& collisions )
+{
+	FindPairs( candidates );
+	results.resize( candidates.size() );
+	Intersection::SpherePairs( GetSpheres(), candidates.data(), static_cast<uint32_t>( candidates.size() ), results.data() );
+	collisions.clear();
+	for ( size_t i = 0; i < candidates.size(); i++ )
+		if ( results[i] != 0 )
+			collisions.push_back( candidates[i] );
+}
+
+void Broadphase::QueryRadius( const XMFLOAT3& center, float radius, std::vector<Proxy>& results )
+{
+	results.clear();
+	const float min[3] = { center.x - radius, center.y - radius, center.z - radius };
+	const float max[3] = { center.x + radius, center.y + radius, center.z + radius };
+	Query( min, max, [this, &center, radius, &results]( Proxy proxy )
+	{
+		const float x = centerX[proxy] - center.x;
+		const float y = centerY[proxy] - center.y;
+		const float z = centerZ[proxy] - center.z;
+		const float reach = radii[proxy] + radius;
+		if ( x * x + y * y + z * z <= reach * reach )
+			results.push_back( proxy );
+	} );
+}
+
+XMFLOAT3 Broadphase::GetCenter( Proxy proxy ) const noexcept
+{
+	return XMFLOAT3( centerX[proxy], centerY[proxy], centerZ[proxy] );
+}
+
+float Broadphase::GetRadius( Proxy proxy ) const noexcept
+{
+	return radii[proxy];
+}
+
+// removed proxies keep their last sphere until reused, pairs never refer to them
+SphereStreams Broadphase::GetSpheres() const noexcept
+{
+	return { centerX.data(), centerY.data(), centerZ.data(), radii.data() };
+}
+
+uint32_t Broadphase::GetProxyCount() const noexcept
+{
+	return statistics.proxyCount;
+}
+
+const BroadphaseStatistics& Broadphase::GetStatistics() const noexcept
+{
+	return statistics;
+}
+
+void Broadphase::ResetStatistics() noexcept
+{
+	statistics.movedCount = 0;
+	statistics.rebucketedCount = 0;
+	statistics.visitedCellCount = 0;
+	statistics.candidateCount = 0;
+}
+
+// level in the top bits, then 20 bits of each coordinate
+uint64_t Broadphase::MakeKey( uint32_t level, const int64_t coordinates[3] ) noexcept
+{
+	constexpr uint64_t mask = ( 1ull << 20 ) - 1u;
+	return static_cast<uint64_t>( level ) << 60 | ( static_cast<uint64_t>( coordinates[0] ) & mask ) << 40 |
+		( static_cast<uint64_t>( coordinates[1] ) & mask ) << 20 | ( static_cast<uint64_t>( coordinates[2] ) & mask );
+}
+
+// coordinates at every level come from the finest ones, so a node's children are always the eight cells below it
+Broadphase::Placement Broadphase::Place( const XMFLOAT3& center, float radius ) const noexcept
+{
+	Placement placement = { OVERSIZED_KEY, 0u, { 0, 0, 0 } };
+	const float diameter = radius * 2.0f;
+	if ( mode == BroadphaseMode::LooseOctree )
+		while ( placement.level < LEVEL_COUNT && diameter > cellSize * static_cast<float>( 1u << placement.level ) )
+			placement.level++;
+	else if ( diameter > cellSize )
+		placement.level = LEVEL_COUNT;
+	if ( placement.level == LEVEL_COUNT )
+		return placement;
+
+	const float position[3] = { center.x, center.y, center.z };
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		const float cell = std::floor( position[axis] / cellSize );
+		if ( !( std::fabs( cell ) < static_cast<float>( COORDINATE_LIMIT ) ) )
+			return placement;
+		placement.coordinates[axis] = static_cast<int64_t>( cell ) >> placement.level;
+	}
+	placement.key = MakeKey( placement.level, placement.coordinates );
+	return placement;
+}
+
+void Broadphase::SetSphere( Proxy proxy, const XMFLOAT3& center, float radius ) noexcept
+{
+	centerX[proxy] = center.x;
+	centerY[proxy] = center.y;
+	centerZ[proxy] = center.z;
+	radii[proxy] = radius;
+}
+
+// spheres are linked at the head of their cell's list, the octree also counts them in every node above
+void Broadphase::Link( Proxy proxy )
+{
+	ProxyData& data = proxies[proxy];
+	data.previous = INVALID;
+	if ( data.placement.key == OVERSIZED_KEY )
+	{
+		data.next = oversized;
+		if ( oversized != INVALID )
+			proxies[oversized].previous = proxy;
+		oversized = proxy;
+		statistics.oversizedCount++;
+		return;
+	}
+	Cell& cell = cells[FindOrCreate( data.placement.key )];
+	data.next = cell.head;
+	if ( cell.head != INVALID )
+		proxies[cell.head].previous = proxy;
+	cell.head = proxy;
+	AddCount( cell, true );
+	levelCounts[data.placement.level]++;
+	if ( mode == BroadphaseMode::LooseOctree )
+		CountAncestors( data.placement, true );
+}
+
+void Broadphase::Unlink( Proxy proxy )
+{
+	const ProxyData& data = proxies[proxy];
+	if ( data.next != INVALID )
+		proxies[data.next].previous = data.previous;
+	if ( data.placement.key == OVERSIZED_KEY )
+	{
+		if ( data.previous != INVALID )
+			proxies[data.previous].next = data.next;
+		else
+			oversized = data.next;
+		statistics.oversizedCount--;
+		return;
+	}
+	Cell& cell = cells[Find( data.placement.key )];
+	if ( data.previous != INVALID )
+		proxies[data.previous].next = data.next;
+	else
+		cell.head = data.next;
+	AddCount( cell, false );
+	levelCounts[data.placement.level]--;
+	if ( mode == BroadphaseMode::LooseOctree )
+		CountAncestors( data.placement, false );
+}
+
+// nodes above a sphere hold no spheres of their own for it, the counts only let queries skip empty branches
+void Broadphase::CountAncestors( const Placement& placement, bool add )
+{
+	int64_t coordinates[3] = { placement.coordinates[0], placement.coordinates[1], placement.coordinates[2] };
+	for ( uint32_t level = placement.level + 1u; level < LEVEL_COUNT; level++ )
+	{
+		for ( int axis = 0; axis < 3; axis++ )
+			coordinates[axis] >>= 1;
+		AddCount( cells[FindOrCreate( MakeKey( level, coordinates ) )], add );
+	}
+}
+
+void Broadphase::AddCount( Cell& cell, bool add ) noexcept
+{
+	if ( add && cell.count++ == 0u )
+		statistics.cellCount++;
+	else if ( !add && --cell.count == 0u )
+		statistics.cellCount--;
+}
+
+// open addressing with linear probing, emptied cells keep their slot until the next rehash drops them
+uint32_t Broadphase::Find( uint64_t key ) const noexcept
+{
+	if ( cells.empty() )
+		return INVALID;
+	const uint32_t mask = static_cast<uint32_t>( cells.size() ) - 1u;
+	for ( uint32_t slot = static_cast<uint32_t>( key * 0x9E3779B97F4A7C15ull >> ( 64u - tableBits ) ); ; slot = ( slot + 1u ) & mask )
+	{
+		if ( cells[slot].key == key )
+			return slot;
+		if ( cells[slot].key == EMPTY_KEY )
+			return INVALID;
+	}
+}
+
+uint32_t Broadphase::FindOrCreate( uint64_t key )
+{
+	uint32_t slot = Find( key );
+	if ( slot != INVALID )
+		return slot;
+	if ( ( usedCellCount + 1u ) * 2u > cells.size() )
+		Rehash( std::max( 64u, ( statistics.cellCount + 1u ) * 4u ) );
+	const uint32_t mask = static_cast<uint32_t>( cells.size() ) - 1u;
+	for ( slot = static_cast<uint32_t>( key * 0x9E3779B97F4A7C15ull >> ( 64u - tableBits ) ); cells[slot].key != EMPTY_KEY; slot = ( slot + 1u ) & mask ) {}
+	cells[slot] = { key, INVALID, 0u };
+	usedCellCount++;
+	return slot;
+}
+
+void Broadphase::Rehash( uint32_t capacity )
+{
+	std::vector<Cell> previous = std::move( cells );
+	tableBits = 1u;
+	while ( ( 1u << tableBits ) < capacity )
+		tableBits++;
+	cells.assign( static_cast<size_t>( 1u ) << tableBits, { EMPTY_KEY, INVALID, 0u } );
+	usedCellCount = 0;
+	const uint32_t mask = static_cast<uint32_t>( cells.size() ) - 1u;
+	for ( const Cell& cell : previous )
+	{
+		if ( cell.key == EMPTY_KEY || cell.count == 0u )
+			continue;
+		uint32_t slot = static_cast<uint32_t>( cell.key * 0x9E3779B97F4A7C15ull >> ( 64u - tableBits ) );
+		while ( cells[slot].key != EMPTY_KEY )
+			slot = ( slot + 1u ) & mask;
+		cells[slot] = cell;
+		usedCellCount++;
+	}
+}
+
+void Broadphase::Rebuild()
+{
+	cells.clear();
+	usedCellCount = 0;
+	tableBits = 0;
+	oversized = INVALID;
+	std::fill_n( levelCounts, LEVEL_COUNT, 0u );
+	statistics.oversizedCount = 0;
+	statistics.cellCount = 0;
+	for ( Proxy proxy = 0; proxy < proxies.size(); proxy++ )
+	{
+		if ( !proxies[proxy].alive )
+			continue;
+		proxies[proxy].placement = Place( GetCenter( proxy ), radii[proxy] );
+		Link( proxy );
+	}
+}
+
+// a node's loose bounds reach half a cell past its own cell on every side
+bool Broadphase::Overlaps( const Node& node, const float min[3], const float max[3] ) const noexcept
+{
+	const float size = cellSize * static_cast<float>( 1u << node.level );
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		const float low = static_cast<float>( node.coordinates[axis] ) * size - size * 0.5f;
+		const float high = low + size * 2.0f;
+		if ( low > max[axis] || high < min[axis] )
+			return false;
+	}
+	return true;
+}
\ No newline at end of file
@@ -0,0 +1,189 @@
+#pragma once
+#ifndef BROADPHASE_H
+#define BROADPHASE_H
+
+#include <DirectXMath.h>
+#include <cmath>
+#include <cstdint>
+#include <utility>
+#include <vector>
+#include "Intersection.h"
+
+enum class BroadphaseMode
+{
+	SpatialHash,
+	LooseOctree
+};
+
+// moved, rebucketed, visited and candidate counts are per frame, the rest describe the current contents
+struct BroadphaseStatistics
+{
+	uint32_t proxyCount = 0;
+	uint32_t oversizedCount = 0;
+	uint32_t cellCount = 0;
+	uint32_t movedCount = 0;
+	uint32_t rebucketedCount = 0;
+	uint32_t visitedCellCount = 0;
+	uint32_t candidateCount = 0;
+};
+
+// spheres sorted into space, so overlap tests only run between spheres near each other
+//  - spatial hash: one grid of cellSize, a sphere sits in the cell holding its centre
+//  - loose octree: each level doubles the cell size and a sphere sits at the finest level whose cell spans its diameter,
+//    a node's loose bounds are its cell grown by half a cell on every side, which holds every sphere it owns
+// cells of both live in one hash table keyed by level and coordinates, so space is unbounded and empty regions cost nothing
+// spheres larger than any cell, or too far out for the coordinates, are kept aside and tested against everything
+// moving a sphere only touches the table when it changes cell
+// centres and radii are kept as streams indexed by proxy, so candidate pairs are tested in batches
+class Broadphase
+{
+public:
+	using Proxy = uint32_t;
+	using Pair = std::pair<Proxy, Proxy>;
+	static constexpr Proxy INVALID = UINT32_MAX;
+	static constexpr uint32_t LEVEL_COUNT = 12u;
+
+	explicit Broadphase( BroadphaseMode mode = BroadphaseMode::SpatialHash, float cellSize = 4.0f );
+	void SetMode( BroadphaseMode mode, float cellSize );
+	BroadphaseMode GetMode() const noexcept;
+	float GetCellSize() const noexcept;
+	Proxy Add( const DirectX::XMFLOAT3& center, float radius );
+	void Remove( Proxy proxy );
+	void Move( Proxy proxy, const DirectX::XMFLOAT3& center, float radius );
+	void Clear();
+
+	// pairs whose bounding boxes overlap, each once with the lower proxy first
+	void FindPairs( std::vector<Pair>& pairs );
+	// pairs whose spheres overlap, the box pairs are sphere tested in one batch
+	// candidates and results are the caller's scratch, kept so a frame allocates nothing once they have grown
+	void FindCollisions( std::vector<Pair>& candidates, std::vector<uint8_t>& results, std::vector<Pair>& collisions );
+	// spheres that overlap the given one
+	void QueryRadius( const DirectX::XMFLOAT3& center, float radius, std::vector<Proxy>& results );
+
+	DirectX::XMFLOAT3 GetCenter( Proxy proxy ) const noexcept;
+	float GetRadius( Proxy proxy ) const noexcept;
+	SphereStreams GetSpheres() const noexcept;
+	uint32_t GetProxyCount() const noexcept;
+	const BroadphaseStatistics& GetStatistics() const noexcept;
+	void ResetStatistics() noexcept;
+private:
+	static constexpr uint64_t EMPTY_KEY = UINT64_MAX;
+	static constexpr uint64_t OVERSIZED_KEY = UINT64_MAX - 1u;
+	static constexpr int64_t COORDINATE_LIMIT = 1ll << 19;
+	struct Placement
+	{
+		uint64_t key;
+		uint32_t level;
+		int64_t coordinates[3];
+	};
+	struct ProxyData
+	{
+		Placement placement;
+		Proxy previous;
+		Proxy next;
+		bool alive;
+	};
+	// count is the number of spheres in the cell, or in the octree node and everything below it
+	struct Cell
+	{
+		uint64_t key;
+		Proxy head;
+		uint32_t count;
+	};
+	struct Node
+	{
+		uint32_t level;
+		int64_t coordinates[3];
+	};
+	static uint64_t MakeKey( uint32_t level, const int64_t coordinates[3] ) noexcept;
+	Placement Place( const DirectX::XMFLOAT3& center, float radius ) const noexcept;
+	void SetSphere( Proxy proxy, const DirectX::XMFLOAT3& center, float radius ) noexcept;
+	void Link( Proxy proxy );
+	void Unlink( Proxy proxy );
+	void CountAncestors( const Placement& placement, bool add );
+	void AddCount( Cell& cell, bool add ) noexcept;
+	uint32_t Find( uint64_t key ) const noexcept;
+	uint32_t FindOrCreate( uint64_t key );
+	void Rehash( uint32_t capacity );
+	void Rebuild();
+	bool Overlaps( const Node& node, const float min[3], const float max[3] ) const noexcept;
+	template<class Visit>
+	void Query( const float min[3], const float max[3], Visit&& visit );
+private:
+	BroadphaseMode mode;
+	float cellSize;
+	std::vector<ProxyData> proxies;
+	std::vector<float> centerX, centerY, centerZ, radii;
+	std::vector<Proxy> freeProxies;
+	std::vector<Cell> cells;
+	uint32_t usedCellCount = 0;
+	uint32_t tableBits = 0;
+	Proxy oversized = INVALID;
+	uint32_t levelCounts[LEVEL_COUNT] = {};
+	std::vector<Node> stack;
+	BroadphaseStatistics statistics;
+};
+
+// visits every sphere that may overlap the box, callers test the spheres themselves
+template<class Visit>
+void Broadphase::Query( const float min[3], const float max[3], Visit&& visit )
+{
+	for ( Proxy proxy = oversized; proxy != INVALID; proxy = proxies[proxy].next )
+		visit( proxy );
+
+	// the cells whose loose bounds reach the box, for the octree at the highest level holding any sphere
+	uint32_t top = 0u;
+	if ( mode == BroadphaseMode::LooseOctree )
+		for ( uint32_t level = 0u; level < LEVEL_COUNT; level++ )
+			if ( levelCounts[level] != 0u )
+				top = level;
+	const float size = cellSize * static_cast<float>( 1u << top );
+	int64_t low[3], high[3];
+	uint64_t rangeCount = 1u;
+	for ( int axis = 0; axis < 3; axis++ )
+	{
+		const int64_t limit = COORDINATE_LIMIT >> top;
+		const float first = std::ceil( ( min[axis] - size * 1.5f ) / size );
+		const float last = std::floor( ( max[axis] + size * 0.5f ) / size );
+		low[axis] = first < static_cast<float>( -limit ) ? -limit : static_cast<int64_t>( first );
+		high[axis] = last > static_cast<float>( limit - 1 ) ? limit - 1 : static_cast<int64_t>( last );
+		if ( high[axis] < low[axis] )
+			return;
+		rangeCount *= static_cast<uint64_t>( high[axis] - low[axis] + 1 );
+	}
+
+	// a box spanning more cells than there are spheres is cheaper answered by visiting them all
+	if ( rangeCount > proxies.size() )
+	{
+		for ( Proxy proxy = 0; proxy < proxies.size(); proxy++ )
+			if ( proxies[proxy].alive && proxies[proxy].placement.key != OVERSIZED_KEY )
+				visit( proxy );
+		return;
+	}
+
+	stack.clear();
+	for ( int64_t x = low[0]; x <= high[0]; x++ )
+		for ( int64_t y = low[1]; y <= high[1]; y++ )
+			for ( int64_t z = low[2]; z <= high[2]; z++ )
+				stack.push_back( { top, { x, y, z } } );
+	while ( !stack.empty() )
+	{
+		const Node node = stack.back();
+		stack.pop_back();
+		if ( !Overlaps( node, min, max ) )
+			continue;
+		const uint32_t slot = Find( MakeKey( node.level, node.coordinates ) );
+		if ( slot == INVALID || cells[slot].count == 0u )
+			continue;
+		statistics.visitedCellCount++;
+		for ( Proxy proxy = cells[slot].head; proxy != INVALID; proxy = proxies[proxy].next )
+			visit( proxy );
+		if ( node.level == 0u )
+			continue;
+		for ( int child = 0; child < 8; child++ )
+			stack.push_back( { node.level - 1u, { node.coordinates[0] * 2 + ( child & 1 ),
+				node.coordinates[1] * 2 + ( child >> 1 & 1 ), node.coordinates[2] * 2 + ( child >> 2 & 1 ) } } );
+	}
+}
+
+#endif
\ No newline at end of file
@@ -1,46 +1,22 @@
 #include "Collisions.h"
 
-bool Collisions::CheckCollision3D( GameObject3D& object1, GameObject3D& object2, float radius )
+// each position is read once, world positions may resolve a transform
+bool Collisions::CheckCollision3D( const XMFLOAT3& position1, const XMFLOAT3& position2, float radius ) noexcept
 {
-	if ( ( object1.GetPositionFloat3().x - object2.GetPositionFloat3().x ) *
-         ( object1.GetPositionFloat3().x - object2.GetPositionFloat3().x ) +
-         ( object1.GetPositionFloat3().y - object2.GetPositionFloat3().y ) *
-         ( object1.GetPositionFloat3().y - object2.GetPositionFloat3().y ) +
-         ( object1.GetPositionFloat3().z - object2.GetPositionFloat3().z ) *
-         ( object1.GetPositionFloat3().z - object2.GetPositionFloat3().z ) <= radius * radius )
-	     return true;
-    else
-         return false;
+    const float x = position1.x - position2.x;
+    const float y = position1.y - position2.y;
+    const float z = position1.z - position2.z;
+    return x * x + y * y + z * z <= radius * radius;
 }
 
-bool Collisions::CheckCollision3D( std::shared_ptr<Camera3D>& object1, Light& object2, float radius )
+bool Collisions::CheckCollision3D( GameObject3D& object1, GameObject3D& object2, float radius )
 {
-    if ( ( object1->GetPositionFloat3().x - object2.GetPositionFloat3().x ) *
-         ( object1->GetPositionFloat3().x - object2.GetPositionFloat3().x ) +
-         ( object1->GetPositionFloat3().y - object2.GetPositionFloat3().y ) *
-         ( object1->GetPositionFloat3().y - object2.GetPositionFloat3().y ) +
-         ( object1->GetPositionFloat3().z - object2.GetPositionFloat3().z ) *
-         ( object1->GetPositionFloat3().z - object2.GetPositionFloat3().z ) <= radius * radius )
-	     return true;
-    else
-         return false;
+    return CheckCollision3D( object1.GetWorldPositionFloat3(), object2.GetWorldPositionFloat3(), radius );
 }
 
-bool Collisions::CheckCollision3D( std::shared_ptr<Camera3D>& object1, GameObject3D& object2, float radius, float yOffset )
+bool Collisions::CheckCollision3D( std::shared_ptr<Camera3D>& object1, const Transform& object2, float radius, float yOffset )
 {
-    XMFLOAT3 lookAtPos = object2.GetPositionFloat3();
-    lookAtPos.y += yOffset;
-    object1->SetLookAtPos( XMFLOAT3( lookAtPos.x, lookAtPos.y, lookAtPos.z ) );
-
-    if ( ( object1->GetPositionFloat3().x - object2.GetPositionFloat3().x ) *
-         ( object1->GetPositionFloat3().x - object2.GetPositionFloat3().x ) +
-         ( object1->GetPositionFloat3().y - object2.GetPositionFloat3().y ) *
-         ( object1->GetPositionFloat3().y - object2.GetPositionFloat3().y ) +
-         ( object1->GetPositionFloat3().z - object2.GetPositionFloat3().z ) *
-         ( object1->GetPositionFloat3().z - object2.GetPositionFloat3().z ) <= radius * radius )
-    {
-        return true;
-    }
-    else
-        return false;
-}
\ No newline at end of file
+    const XMFLOAT3 position = object2.GetWorldPositionFloat3();
+    object1->SetLookAtPos( XMFLOAT3( position.x, position.y + yOffset, position.z ) );
+    return CheckCollision3D( object1->GetWorldPositionFloat3(), position, radius );
+}
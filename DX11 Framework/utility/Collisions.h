@@ -4,18 +4,18 @@
 
 #include "..\\graphics\GameObject3D.h"
 #include "..\\graphics\\Camera3D.h"
-#include "..\\graphics\\Light.h"
+#include "..\\graphics\\Transform.h"
 
 class GameObject3D;
 class Camera3D;
-class Light;
+class Transform;
 
 class Collisions
 {
 public:
+	static bool CheckCollision3D( const XMFLOAT3& position1, const XMFLOAT3& position2, float radius ) noexcept;
 	static bool CheckCollision3D( GameObject3D& object1, GameObject3D& object2, float radius );
-	static bool CheckCollision3D( std::shared_ptr<Camera3D>& object1, Light& object2, float radius );
-	static bool CheckCollision3D( std::shared_ptr<Camera3D>& object1, GameObject3D& object2, float radius, float yOffset = 0.0f );
+	static bool CheckCollision3D( std::shared_ptr<Camera3D>& object1, const Transform& object2, float radius, float yOffset = 0.0f );
 };
 
 #endif
\ No newline at end of file
@@ -0,0 +1,37 @@
+#include "CommandLine.h"
+#include <Windows.h>
+#include <algorithm>
+#include <cstdio>
+#include <sstream>
+
+std::vector<std::string> CommandLine::GetArguments( const std::string& commandLine )
+{
+	std::vector<std::string> arguments;
+	std::istringstream stream( commandLine );
+	std::string argument;
+	while ( stream >> argument )
+		arguments.push_back( argument );
+	return arguments;
+}
+
+std::vector<std::string> CommandLine::GetFiles( const std::vector<std::string>& arguments )
+{
+	std::vector<std::string> files;
+	for ( unsigned int i = 1; i < arguments.size(); i++ )
+		if ( arguments[i][0] != '-' )
+			files.push_back( arguments[i] );
+	return files;
+}
+
+bool CommandLine::HasOption( const std::vector<std::string>& arguments, const std::string& option )
+{
+	return std::find( arguments.begin(), arguments.end(), option ) != arguments.end();
+}
+
+void CommandLine::OpenConsole()
+{
+	if ( !AttachConsole( ATTACH_PARENT_PROCESS ) )
+		AllocConsole();
+	FILE* stream = nullptr;
+	freopen_s( &stream, "CONOUT$", "w", stdout );
+}
\ No newline at end of file
@@ -0,0 +1,20 @@
+#pragma once
+#ifndef COMMANDLINE_H
+#define COMMANDLINE_H
+
+#include <string>
+#include <vector>
+
+// the command line WinMain is given, shared by the tools and benchmarks that run without a window
+class CommandLine
+{
+public:
+	static std::vector<std::string> GetArguments( const std::string& commandLine );
+	// everything after the command that isn't an option
+	static std::vector<std::string> GetFiles( const std::vector<std::string>& arguments );
+	static bool HasOption( const std::vector<std::string>& arguments, const std::string& option );
+	// write to the console that launched us, or open a new one
+	static void OpenConsole();
+};
+
+#endif
\ No newline at end of file
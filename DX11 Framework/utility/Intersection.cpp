@@ -0,0 +1,688 @@
+#include "Intersection.h"
+#include <algorithm>
+#include <atomic>
+#include <cfloat>
+#include <cmath>
+
+#if defined( _M_X64 ) || defined( _M_IX86 ) || defined( __x86_64__ ) || defined( __i386__ )
+#define INTERSECTION_X86
+#include <immintrin.h>
+#if defined( _MSC_VER )
+#include <intrin.h>
+#define INTERSECTION_TARGET_AVX2
+#else
+#define INTERSECTION_TARGET_AVX2 __attribute__( ( target( "avx2" ) ) )
+#endif
+#endif
+
+using namespace DirectX;
+
+namespace
+{
+	struct Sphere
+	{
+		float x, y, z, radius;
+	};
+
+	// worked out once per call rather than per element
+	struct Ray
+	{
+		float origin[3];
+		float direction[3];
+		float inverseDirection[3];
+		float lengthSquared;
+		float maxDistance;
+	};
+
+	// kernels cover elements begin to end and index results from the start of the batch, so the wider ones hand their remainder on
+	struct Kernels
+	{
+		uint32_t( *sphereSphere )( const SphereStreams&, uint32_t, uint32_t, const Sphere&, uint8_t* ) noexcept;
+		uint32_t( *spherePairs )( const SphereStreams&, const Intersection::Pair*, uint32_t, uint32_t, uint8_t* ) noexcept;
+		uint32_t( *sphereFrustum )( const SphereStreams&, uint32_t, uint32_t, const XMFLOAT4*, uint8_t* ) noexcept;
+		uint32_t( *boxFrustum )( const BoxStreams&, uint32_t, uint32_t, const XMFLOAT4*, uint8_t* ) noexcept;
+		uint32_t( *raySphere )( const SphereStreams&, uint32_t, uint32_t, const Ray&, float* ) noexcept;
+		uint32_t( *rayBox )( const BoxStreams&, uint32_t, uint32_t, const Ray&, float* ) noexcept;
+	};
+
+	uint32_t SphereSphereScalar( const SphereStreams& spheres, uint32_t begin, uint32_t end, const Sphere& sphere, uint8_t* results ) noexcept
+	{
+		uint32_t hits = 0;
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			const float x = spheres.x[i] - sphere.x;
+			const float y = spheres.y[i] - sphere.y;
+			const float z = spheres.z[i] - sphere.z;
+			const float reach = spheres.radius[i] + sphere.radius;
+			results[i] = x * x + y * y + z * z <= reach * reach ? 1 : 0;
+			hits += results[i];
+		}
+		return hits;
+	}
+
+	uint32_t SpherePairsScalar( const SphereStreams& spheres, const Intersection::Pair* pairs, uint32_t begin, uint32_t end, uint8_t* results ) noexcept
+	{
+		uint32_t hits = 0;
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			const uint32_t a = pairs[i].first;
+			const uint32_t b = pairs[i].second;
+			const float x = spheres.x[a] - spheres.x[b];
+			const float y = spheres.y[a] - spheres.y[b];
+			const float z = spheres.z[a] - spheres.z[b];
+			const float reach = spheres.radius[a] + spheres.radius[b];
+			results[i] = x * x + y * y + z * z <= reach * reach ? 1 : 0;
+			hits += results[i];
+		}
+		return hits;
+	}
+
+	// outside when the sphere lies wholly behind any one plane
+	uint32_t SphereFrustumScalar( const SphereStreams& spheres, uint32_t begin, uint32_t end, const XMFLOAT4* planes, uint8_t* results ) noexcept
+	{
+		uint32_t hits = 0;
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			bool outside = false;
+			for ( uint32_t p = 0; p < 6; p++ )
+			{
+				float distance = planes[p].x * spheres.x[i] + planes[p].w;
+				distance = planes[p].y * spheres.y[i] + distance;
+				distance = planes[p].z * spheres.z[i] + distance;
+				outside = outside || distance + spheres.radius[i] < 0.0f;
+			}
+			results[i] = outside ? 0 : 1;
+			hits += results[i];
+		}
+		return hits;
+	}
+
+	// a box is outside when its extents projected onto a plane's normal don't reach the inner side
+	uint32_t BoxFrustumScalar( const BoxStreams& boxes, uint32_t begin, uint32_t end, const XMFLOAT4* planes, uint8_t* results ) noexcept
+	{
+		uint32_t hits = 0;
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			bool outside = false;
+			for ( uint32_t p = 0; p < 6; p++ )
+			{
+				float distance = planes[p].x * boxes.centerX[i] + planes[p].w;
+				distance = planes[p].y * boxes.centerY[i] + distance;
+				distance = planes[p].z * boxes.centerZ[i] + distance;
+				float radius = std::fabs( planes[p].x ) * boxes.extentX[i];
+				radius = std::fabs( planes[p].y ) * boxes.extentY[i] + radius;
+				radius = std::fabs( planes[p].z ) * boxes.extentZ[i] + radius;
+				outside = outside || distance + radius < 0.0f;
+			}
+			results[i] = outside ? 0 : 1;
+			hits += results[i];
+		}
+		return hits;
+	}
+
+	// nearer root of |origin + t * direction - center| = radius, a ray only hits a sphere it starts outside of when heading towards it
+	uint32_t RaySphereScalar( const SphereStreams& spheres, uint32_t begin, uint32_t end, const Ray& ray, float* distances ) noexcept
+	{
+		uint32_t hits = 0;
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			const float x = ray.origin[0] - spheres.x[i];
+			const float y = ray.origin[1] - spheres.y[i];
+			const float z = ray.origin[2] - spheres.z[i];
+			const float b = x * ray.direction[0] + y * ray.direction[1] + z * ray.direction[2];
+			const float c = x * x + y * y + z * z - spheres.radius[i] * spheres.radius[i];
+			const float discriminant = b * b - ray.lengthSquared * c;
+			float distance = FLT_MAX;
+			if ( c <= 0.0f )
+				distance = 0.0f;
+			else if ( discriminant >= 0.0f && b < 0.0f )
+			{
+				const float t = ( -b - std::sqrt( discriminant ) ) / ray.lengthSquared;
+				if ( t <= ray.maxDistance )
+					distance = t;
+			}
+			distances[i] = distance;
+			hits += distance != FLT_MAX ? 1u : 0u;
+		}
+		return hits;
+	}
+
+	// slab test, axes the ray runs parallel to give nans which the min and max pass over
+	uint32_t RayBoxScalar( const BoxStreams& boxes, uint32_t begin, uint32_t end, const Ray& ray, float* distances ) noexcept
+	{
+		const float* centers[3] = { boxes.centerX, boxes.centerY, boxes.centerZ };
+		const float* extents[3] = { boxes.extentX, boxes.extentY, boxes.extentZ };
+		uint32_t hits = 0;
+		for ( uint32_t i = begin; i < end; i++ )
+		{
+			float entry = 0.0f;
+			float exit = ray.maxDistance;
+			for ( uint32_t axis = 0; axis < 3; axis++ )
+			{
+				const float t1 = ( centers[axis][i] - extents[axis][i] - ray.origin[axis] ) * ray.inverseDirection[axis];
+				const float t2 = ( centers[axis][i] + extents[axis][i] - ray.origin[axis] ) * ray.inverseDirection[axis];
+				entry = std::max( entry, std::min( t1, t2 ) );
+				exit = std::min( exit, std::max( t1, t2 ) );
+			}
+			distances[i] = entry <= exit ? entry : FLT_MAX;
+			hits += entry <= exit ? 1u : 0u;
+		}
+		return hits;
+	}
+
+#ifdef INTERSECTION_X86
+	// one byte per lane of a comparison mask
+	uint32_t StoreHits( int mask, uint32_t lanes, uint8_t* results ) noexcept
+	{
+		uint32_t hits = 0;
+		for ( uint32_t k = 0; k < lanes; k++ )
+		{
+			results[k] = static_cast<uint8_t>( mask >> k & 1 );
+			hits += results[k];
+		}
+		return hits;
+	}
+
+	// ray kernels write distances, this only counts the lanes that hit
+	uint32_t CountHits( int mask ) noexcept
+	{
+		uint32_t hits = 0;
+		for ( ; mask != 0; mask &= mask - 1 )
+			hits++;
+		return hits;
+	}
+
+	uint32_t SphereSphereSSE( const SphereStreams& spheres, uint32_t begin, uint32_t end, const Sphere& sphere, uint8_t* results ) noexcept
+	{
+		const __m128 centerX = _mm_set1_ps( sphere.x );
+		const __m128 centerY = _mm_set1_ps( sphere.y );
+		const __m128 centerZ = _mm_set1_ps( sphere.z );
+		const __m128 radius = _mm_set1_ps( sphere.radius );
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			const __m128 x = _mm_sub_ps( _mm_loadu_ps( spheres.x + i ), centerX );
+			const __m128 y = _mm_sub_ps( _mm_loadu_ps( spheres.y + i ), centerY );
+			const __m128 z = _mm_sub_ps( _mm_loadu_ps( spheres.z + i ), centerZ );
+			const __m128 reach = _mm_add_ps( _mm_loadu_ps( spheres.radius + i ), radius );
+			const __m128 lengthSquared = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+			hits += StoreHits( _mm_movemask_ps( _mm_cmple_ps( lengthSquared, _mm_mul_ps( reach, reach ) ) ), 4, results + i );
+		}
+		return hits + SphereSphereScalar( spheres, i, end, sphere, results );
+	}
+
+	uint32_t SpherePairsSSE( const SphereStreams& spheres, const Intersection::Pair* pairs, uint32_t begin, uint32_t end, uint8_t* results ) noexcept
+	{
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			const Intersection::Pair* p = pairs + i;
+			const __m128 x = _mm_sub_ps( _mm_setr_ps( spheres.x[p[0].first], spheres.x[p[1].first], spheres.x[p[2].first], spheres.x[p[3].first] ),
+				_mm_setr_ps( spheres.x[p[0].second], spheres.x[p[1].second], spheres.x[p[2].second], spheres.x[p[3].second] ) );
+			const __m128 y = _mm_sub_ps( _mm_setr_ps( spheres.y[p[0].first], spheres.y[p[1].first], spheres.y[p[2].first], spheres.y[p[3].first] ),
+				_mm_setr_ps( spheres.y[p[0].second], spheres.y[p[1].second], spheres.y[p[2].second], spheres.y[p[3].second] ) );
+			const __m128 z = _mm_sub_ps( _mm_setr_ps( spheres.z[p[0].first], spheres.z[p[1].first], spheres.z[p[2].first], spheres.z[p[3].first] ),
+				_mm_setr_ps( spheres.z[p[0].second], spheres.z[p[1].second], spheres.z[p[2].second], spheres.z[p[3].second] ) );
+			const __m128 reach = _mm_add_ps(
+				_mm_setr_ps( spheres.radius[p[0].first], spheres.radius[p[1].first], spheres.radius[p[2].first], spheres.radius[p[3].first] ),
+				_mm_setr_ps( spheres.radius[p[0].second], spheres.radius[p[1].second], spheres.radius[p[2].second], spheres.radius[p[3].second] ) );
+			const __m128 lengthSquared = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) );
+			hits += StoreHits( _mm_movemask_ps( _mm_cmple_ps( lengthSquared, _mm_mul_ps( reach, reach ) ) ), 4, results + i );
+		}
+		return hits + SpherePairsScalar( spheres, pairs, i, end, results );
+	}
+
+	uint32_t SphereFrustumSSE( const SphereStreams& spheres, uint32_t begin, uint32_t end, const XMFLOAT4* planes, uint8_t* results ) noexcept
+	{
+		__m128 planeX[6], planeY[6], planeZ[6], planeD[6];
+		for ( uint32_t p = 0; p < 6; p++ )
+		{
+			planeX[p] = _mm_set1_ps( planes[p].x );
+			planeY[p] = _mm_set1_ps( planes[p].y );
+			planeZ[p] = _mm_set1_ps( planes[p].z );
+			planeD[p] = _mm_set1_ps( planes[p].w );
+		}
+		const __m128 zero = _mm_setzero_ps();
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			const __m128 x = _mm_loadu_ps( spheres.x + i );
+			const __m128 y = _mm_loadu_ps( spheres.y + i );
+			const __m128 z = _mm_loadu_ps( spheres.z + i );
+			const __m128 radius = _mm_loadu_ps( spheres.radius + i );
+			__m128 outside = zero;
+			for ( uint32_t p = 0; p < 6; p++ )
+			{
+				__m128 distance = _mm_add_ps( _mm_mul_ps( planeX[p], x ), planeD[p] );
+				distance = _mm_add_ps( _mm_mul_ps( planeY[p], y ), distance );
+				distance = _mm_add_ps( _mm_mul_ps( planeZ[p], z ), distance );
+				outside = _mm_or_ps( outside, _mm_cmplt_ps( _mm_add_ps( distance, radius ), zero ) );
+			}
+			hits += StoreHits( ~_mm_movemask_ps( outside ), 4, results + i );
+		}
+		return hits + SphereFrustumScalar( spheres, i, end, planes, results );
+	}
+
+	uint32_t BoxFrustumSSE( const BoxStreams& boxes, uint32_t begin, uint32_t end, const XMFLOAT4* planes, uint8_t* results ) noexcept
+	{
+		__m128 planeX[6], planeY[6], planeZ[6], planeD[6];
+		__m128 absX[6], absY[6], absZ[6];
+		for ( uint32_t p = 0; p < 6; p++ )
+		{
+			planeX[p] = _mm_set1_ps( planes[p].x );
+			planeY[p] = _mm_set1_ps( planes[p].y );
+			planeZ[p] = _mm_set1_ps( planes[p].z );
+			planeD[p] = _mm_set1_ps( planes[p].w );
+			absX[p] = _mm_set1_ps( std::fabs( planes[p].x ) );
+			absY[p] = _mm_set1_ps( std::fabs( planes[p].y ) );
+			absZ[p] = _mm_set1_ps( std::fabs( planes[p].z ) );
+		}
+		const __m128 zero = _mm_setzero_ps();
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			const __m128 centerX = _mm_loadu_ps( boxes.centerX + i );
+			const __m128 centerY = _mm_loadu_ps( boxes.centerY + i );
+			const __m128 centerZ = _mm_loadu_ps( boxes.centerZ + i );
+			const __m128 extentX = _mm_loadu_ps( boxes.extentX + i );
+			const __m128 extentY = _mm_loadu_ps( boxes.extentY + i );
+			const __m128 extentZ = _mm_loadu_ps( boxes.extentZ + i );
+			__m128 outside = zero;
+			for ( uint32_t p = 0; p < 6; p++ )
+			{
+				__m128 distance = _mm_add_ps( _mm_mul_ps( planeX[p], centerX ), planeD[p] );
+				distance = _mm_add_ps( _mm_mul_ps( planeY[p], centerY ), distance );
+				distance = _mm_add_ps( _mm_mul_ps( planeZ[p], centerZ ), distance );
+				__m128 radius = _mm_mul_ps( absX[p], extentX );
+				radius = _mm_add_ps( _mm_mul_ps( absY[p], extentY ), radius );
+				radius = _mm_add_ps( _mm_mul_ps( absZ[p], extentZ ), radius );
+				outside = _mm_or_ps( outside, _mm_cmplt_ps( _mm_add_ps( distance, radius ), zero ) );
+			}
+			hits += StoreHits( ~_mm_movemask_ps( outside ), 4, results + i );
+		}
+		return hits + BoxFrustumScalar( boxes, i, end, planes, results );
+	}
+
+	uint32_t RaySphereSSE( const SphereStreams& spheres, uint32_t begin, uint32_t end, const Ray& ray, float* distances ) noexcept
+	{
+		const __m128 originX = _mm_set1_ps( ray.origin[0] );
+		const __m128 originY = _mm_set1_ps( ray.origin[1] );
+		const __m128 originZ = _mm_set1_ps( ray.origin[2] );
+		const __m128 directionX = _mm_set1_ps( ray.direction[0] );
+		const __m128 directionY = _mm_set1_ps( ray.direction[1] );
+		const __m128 directionZ = _mm_set1_ps( ray.direction[2] );
+		const __m128 lengthSquared = _mm_set1_ps( ray.lengthSquared );
+		const __m128 maxDistance = _mm_set1_ps( ray.maxDistance );
+		const __m128 miss = _mm_set1_ps( FLT_MAX );
+		const __m128 sign = _mm_set1_ps( -0.0f );
+		const __m128 zero = _mm_setzero_ps();
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			const __m128 x = _mm_sub_ps( originX, _mm_loadu_ps( spheres.x + i ) );
+			const __m128 y = _mm_sub_ps( originY, _mm_loadu_ps( spheres.y + i ) );
+			const __m128 z = _mm_sub_ps( originZ, _mm_loadu_ps( spheres.z + i ) );
+			const __m128 radius = _mm_loadu_ps( spheres.radius + i );
+			const __m128 b = _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, directionX ), _mm_mul_ps( y, directionY ) ), _mm_mul_ps( z, directionZ ) );
+			const __m128 c = _mm_sub_ps( _mm_add_ps( _mm_add_ps( _mm_mul_ps( x, x ), _mm_mul_ps( y, y ) ), _mm_mul_ps( z, z ) ), _mm_mul_ps( radius, radius ) );
+			const __m128 discriminant = _mm_sub_ps( _mm_mul_ps( b, b ), _mm_mul_ps( lengthSquared, c ) );
+			const __m128 t = _mm_div_ps( _mm_sub_ps( _mm_xor_ps( b, sign ), _mm_sqrt_ps( discriminant ) ), lengthSquared );
+			const __m128 inside = _mm_cmple_ps( c, zero );
+			const __m128 hit = _mm_and_ps( _mm_and_ps( _mm_cmpge_ps( discriminant, zero ), _mm_cmplt_ps( b, zero ) ), _mm_cmple_ps( t, maxDistance ) );
+			const __m128 distance = _mm_andnot_ps( inside, _mm_or_ps( _mm_and_ps( hit, t ), _mm_andnot_ps( hit, miss ) ) );
+			_mm_storeu_ps( distances + i, distance );
+			hits += CountHits( _mm_movemask_ps( _mm_or_ps( inside, hit ) ) );
+		}
+		return hits + RaySphereScalar( spheres, i, end, ray, distances );
+	}
+
+	uint32_t RayBoxSSE( const BoxStreams& boxes, uint32_t begin, uint32_t end, const Ray& ray, float* distances ) noexcept
+	{
+		const float* centers[3] = { boxes.centerX, boxes.centerY, boxes.centerZ };
+		const float* extents[3] = { boxes.extentX, boxes.extentY, boxes.extentZ };
+		__m128 origin[3], inverseDirection[3];
+		for ( uint32_t axis = 0; axis < 3; axis++ )
+		{
+			origin[axis] = _mm_set1_ps( ray.origin[axis] );
+			inverseDirection[axis] = _mm_set1_ps( ray.inverseDirection[axis] );
+		}
+		const __m128 maxDistance = _mm_set1_ps( ray.maxDistance );
+		const __m128 miss = _mm_set1_ps( FLT_MAX );
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 4 <= end; i += 4 )
+		{
+			// operands ordered so a nan picks the same side std::min and std::max do
+			__m128 entry = _mm_setzero_ps();
+			__m128 exit = maxDistance;
+			for ( uint32_t axis = 0; axis < 3; axis++ )
+			{
+				const __m128 center = _mm_loadu_ps( centers[axis] + i );
+				const __m128 extent = _mm_loadu_ps( extents[axis] + i );
+				const __m128 t1 = _mm_mul_ps( _mm_sub_ps( _mm_sub_ps( center, extent ), origin[axis] ), inverseDirection[axis] );
+				const __m128 t2 = _mm_mul_ps( _mm_sub_ps( _mm_add_ps( center, extent ), origin[axis] ), inverseDirection[axis] );
+				entry = _mm_max_ps( _mm_min_ps( t2, t1 ), entry );
+				exit = _mm_min_ps( _mm_max_ps( t2, t1 ), exit );
+			}
+			const __m128 hit = _mm_cmple_ps( entry, exit );
+			_mm_storeu_ps( distances + i, _mm_or_ps( _mm_and_ps( hit, entry ), _mm_andnot_ps( hit, miss ) ) );
+			hits += CountHits( _mm_movemask_ps( hit ) );
+		}
+		return hits + RayBoxScalar( boxes, i, end, ray, distances );
+	}
+
+	// the upper halves are cleared before handing on, so the narrower kernels don't pay for mixing encodings
+	INTERSECTION_TARGET_AVX2 uint32_t SphereSphereAVX2( const SphereStreams& spheres, uint32_t begin, uint32_t end, const Sphere& sphere, uint8_t* results ) noexcept
+	{
+		const __m256 centerX = _mm256_set1_ps( sphere.x );
+		const __m256 centerY = _mm256_set1_ps( sphere.y );
+		const __m256 centerZ = _mm256_set1_ps( sphere.z );
+		const __m256 radius = _mm256_set1_ps( sphere.radius );
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 8 <= end; i += 8 )
+		{
+			const __m256 x = _mm256_sub_ps( _mm256_loadu_ps( spheres.x + i ), centerX );
+			const __m256 y = _mm256_sub_ps( _mm256_loadu_ps( spheres.y + i ), centerY );
+			const __m256 z = _mm256_sub_ps( _mm256_loadu_ps( spheres.z + i ), centerZ );
+			const __m256 reach = _mm256_add_ps( _mm256_loadu_ps( spheres.radius + i ), radius );
+			const __m256 lengthSquared = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, x ), _mm256_mul_ps( y, y ) ), _mm256_mul_ps( z, z ) );
+			hits += StoreHits( _mm256_movemask_ps( _mm256_cmp_ps( lengthSquared, _mm256_mul_ps( reach, reach ), _CMP_LE_OQ ) ), 8, results + i );
+		}
+		_mm256_zeroupper();
+		return hits + SphereSphereSSE( spheres, i, end, sphere, results );
+	}
+
+	// eight pairs are two rows of interleaved indices, split into the firsts and the seconds then gathered
+	INTERSECTION_TARGET_AVX2 uint32_t SpherePairsAVX2( const SphereStreams& spheres, const Intersection::Pair* pairs, uint32_t begin, uint32_t end, uint8_t* results ) noexcept
+	{
+		static_assert( sizeof( Intersection::Pair ) == sizeof( uint32_t ) * 2, "pairs are loaded as rows of indices" );
+		const __m256i split = _mm256_setr_epi32( 0, 2, 4, 6, 1, 3, 5, 7 );
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 8 <= end; i += 8 )
+		{
+			const __m256i low = _mm256_permutevar8x32_epi32( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pairs + i ) ), split );
+			const __m256i high = _mm256_permutevar8x32_epi32( _mm256_loadu_si256( reinterpret_cast<const __m256i*>( pairs + i + 4 ) ), split );
+			const __m256i first = _mm256_permute2x128_si256( low, high, 0x20 );
+			const __m256i second = _mm256_permute2x128_si256( low, high, 0x31 );
+			const __m256 x = _mm256_sub_ps( _mm256_i32gather_ps( spheres.x, first, 4 ), _mm256_i32gather_ps( spheres.x, second, 4 ) );
+			const __m256 y = _mm256_sub_ps( _mm256_i32gather_ps( spheres.y, first, 4 ), _mm256_i32gather_ps( spheres.y, second, 4 ) );
+			const __m256 z = _mm256_sub_ps( _mm256_i32gather_ps( spheres.z, first, 4 ), _mm256_i32gather_ps( spheres.z, second, 4 ) );
+			const __m256 reach = _mm256_add_ps( _mm256_i32gather_ps( spheres.radius, first, 4 ), _mm256_i32gather_ps( spheres.radius, second, 4 ) );
+			const __m256 lengthSquared = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, x ), _mm256_mul_ps( y, y ) ), _mm256_mul_ps( z, z ) );
+			hits += StoreHits( _mm256_movemask_ps( _mm256_cmp_ps( lengthSquared, _mm256_mul_ps( reach, reach ), _CMP_LE_OQ ) ), 8, results + i );
+		}
+		_mm256_zeroupper();
+		return hits + SpherePairsSSE( spheres, pairs, i, end, results );
+	}
+
+	INTERSECTION_TARGET_AVX2 uint32_t SphereFrustumAVX2( const SphereStreams& spheres, uint32_t begin, uint32_t end, const XMFLOAT4* planes, uint8_t* results ) noexcept
+	{
+		__m256 planeX[6], planeY[6], planeZ[6], planeD[6];
+		for ( uint32_t p = 0; p < 6; p++ )
+		{
+			planeX[p] = _mm256_set1_ps( planes[p].x );
+			planeY[p] = _mm256_set1_ps( planes[p].y );
+			planeZ[p] = _mm256_set1_ps( planes[p].z );
+			planeD[p] = _mm256_set1_ps( planes[p].w );
+		}
+		const __m256 zero = _mm256_setzero_ps();
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 8 <= end; i += 8 )
+		{
+			const __m256 x = _mm256_loadu_ps( spheres.x + i );
+			const __m256 y = _mm256_loadu_ps( spheres.y + i );
+			const __m256 z = _mm256_loadu_ps( spheres.z + i );
+			const __m256 radius = _mm256_loadu_ps( spheres.radius + i );
+			__m256 outside = zero;
+			for ( uint32_t p = 0; p < 6; p++ )
+			{
+				__m256 distance = _mm256_add_ps( _mm256_mul_ps( planeX[p], x ), planeD[p] );
+				distance = _mm256_add_ps( _mm256_mul_ps( planeY[p], y ), distance );
+				distance = _mm256_add_ps( _mm256_mul_ps( planeZ[p], z ), distance );
+				outside = _mm256_or_ps( outside, _mm256_cmp_ps( _mm256_add_ps( distance, radius ), zero, _CMP_LT_OQ ) );
+			}
+			hits += StoreHits( ~_mm256_movemask_ps( outside ), 8, results + i );
+		}
+		_mm256_zeroupper();
+		return hits + SphereFrustumSSE( spheres, i, end, planes, results );
+	}
+
+	INTERSECTION_TARGET_AVX2 uint32_t BoxFrustumAVX2( const BoxStreams& boxes, uint32_t begin, uint32_t end, const XMFLOAT4* planes, uint8_t* results ) noexcept
+	{
+		__m256 planeX[6], planeY[6], planeZ[6], planeD[6];
+		__m256 absX[6], absY[6], absZ[6];
+		for ( uint32_t p = 0; p < 6; p++ )
+		{
+			planeX[p] = _mm256_set1_ps( planes[p].x );
+			planeY[p] = _mm256_set1_ps( planes[p].y );
+			planeZ[p] = _mm256_set1_ps( planes[p].z );
+			planeD[p] = _mm256_set1_ps( planes[p].w );
+			absX[p] = _mm256_set1_ps( std::fabs( planes[p].x ) );
+			absY[p] = _mm256_set1_ps( std::fabs( planes[p].y ) );
+			absZ[p] = _mm256_set1_ps( std::fabs( planes[p].z ) );
+		}
+		const __m256 zero = _mm256_setzero_ps();
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 8 <= end; i += 8 )
+		{
+			const __m256 centerX = _mm256_loadu_ps( boxes.centerX + i );
+			const __m256 centerY = _mm256_loadu_ps( boxes.centerY + i );
+			const __m256 centerZ = _mm256_loadu_ps( boxes.centerZ + i );
+			const __m256 extentX = _mm256_loadu_ps( boxes.extentX + i );
+			const __m256 extentY = _mm256_loadu_ps( boxes.extentY + i );
+			const __m256 extentZ = _mm256_loadu_ps( boxes.extentZ + i );
+			__m256 outside = zero;
+			for ( uint32_t p = 0; p < 6; p++ )
+			{
+				__m256 distance = _mm256_add_ps( _mm256_mul_ps( planeX[p], centerX ), planeD[p] );
+				distance = _mm256_add_ps( _mm256_mul_ps( planeY[p], centerY ), distance );
+				distance = _mm256_add_ps( _mm256_mul_ps( planeZ[p], centerZ ), distance );
+				__m256 radius = _mm256_mul_ps( absX[p], extentX );
+				radius = _mm256_add_ps( _mm256_mul_ps( absY[p], extentY ), radius );
+				radius = _mm256_add_ps( _mm256_mul_ps( absZ[p], extentZ ), radius );
+				outside = _mm256_or_ps( outside, _mm256_cmp_ps( _mm256_add_ps( distance, radius ), zero, _CMP_LT_OQ ) );
+			}
+			hits += StoreHits( ~_mm256_movemask_ps( outside ), 8, results + i );
+		}
+		_mm256_zeroupper();
+		return hits + BoxFrustumSSE( boxes, i, end, planes, results );
+	}
+
+	INTERSECTION_TARGET_AVX2 uint32_t RaySphereAVX2( const SphereStreams& spheres, uint32_t begin, uint32_t end, const Ray& ray, float* distances ) noexcept
+	{
+		const __m256 originX = _mm256_set1_ps( ray.origin[0] );
+		const __m256 originY = _mm256_set1_ps( ray.origin[1] );
+		const __m256 originZ = _mm256_set1_ps( ray.origin[2] );
+		const __m256 directionX = _mm256_set1_ps( ray.direction[0] );
+		const __m256 directionY = _mm256_set1_ps( ray.direction[1] );
+		const __m256 directionZ = _mm256_set1_ps( ray.direction[2] );
+		const __m256 lengthSquared = _mm256_set1_ps( ray.lengthSquared );
+		const __m256 maxDistance = _mm256_set1_ps( ray.maxDistance );
+		const __m256 miss = _mm256_set1_ps( FLT_MAX );
+		const __m256 sign = _mm256_set1_ps( -0.0f );
+		const __m256 zero = _mm256_setzero_ps();
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 8 <= end; i += 8 )
+		{
+			const __m256 x = _mm256_sub_ps( originX, _mm256_loadu_ps( spheres.x + i ) );
+			const __m256 y = _mm256_sub_ps( originY, _mm256_loadu_ps( spheres.y + i ) );
+			const __m256 z = _mm256_sub_ps( originZ, _mm256_loadu_ps( spheres.z + i ) );
+			const __m256 radius = _mm256_loadu_ps( spheres.radius + i );
+			const __m256 b = _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, directionX ), _mm256_mul_ps( y, directionY ) ), _mm256_mul_ps( z, directionZ ) );
+			const __m256 c = _mm256_sub_ps( _mm256_add_ps( _mm256_add_ps( _mm256_mul_ps( x, x ), _mm256_mul_ps( y, y ) ), _mm256_mul_ps( z, z ) ),
+				_mm256_mul_ps( radius, radius ) );
+			const __m256 discriminant = _mm256_sub_ps( _mm256_mul_ps( b, b ), _mm256_mul_ps( lengthSquared, c ) );
+			const __m256 t = _mm256_div_ps( _mm256_sub_ps( _mm256_xor_ps( b, sign ), _mm256_sqrt_ps( discriminant ) ), lengthSquared );
+			const __m256 inside = _mm256_cmp_ps( c, zero, _CMP_LE_OQ );
+			const __m256 hit = _mm256_and_ps( _mm256_and_ps( _mm256_cmp_ps( discriminant, zero, _CMP_GE_OQ ), _mm256_cmp_ps( b, zero, _CMP_LT_OQ ) ),
+				_mm256_cmp_ps( t, maxDistance, _CMP_LE_OQ ) );
+			_mm256_storeu_ps( distances + i, _mm256_andnot_ps( inside, _mm256_blendv_ps( miss, t, hit ) ) );
+			hits += CountHits( _mm256_movemask_ps( _mm256_or_ps( inside, hit ) ) );
+		}
+		_mm256_zeroupper();
+		return hits + RaySphereSSE( spheres, i, end, ray, distances );
+	}
+
+	INTERSECTION_TARGET_AVX2 uint32_t RayBoxAVX2( const BoxStreams& boxes, uint32_t begin, uint32_t end, const Ray& ray, float* distances ) noexcept
+	{
+		const float* centers[3] = { boxes.centerX, boxes.centerY, boxes.centerZ };
+		const float* extents[3] = { boxes.extentX, boxes.extentY, boxes.extentZ };
+		__m256 origin[3], inverseDirection[3];
+		for ( uint32_t axis = 0; axis < 3; axis++ )
+		{
+			origin[axis] = _mm256_set1_ps( ray.origin[axis] );
+			inverseDirection[axis] = _mm256_set1_ps( ray.inverseDirection[axis] );
+		}
+		const __m256 maxDistance = _mm256_set1_ps( ray.maxDistance );
+		const __m256 miss = _mm256_set1_ps( FLT_MAX );
+		uint32_t hits = 0;
+		uint32_t i = begin;
+		for ( ; i + 8 <= end; i += 8 )
+		{
+			__m256 entry = _mm256_setzero_ps();
+			__m256 exit = maxDistance;
+			for ( uint32_t axis = 0; axis < 3; axis++ )
+			{
+				const __m256 center = _mm256_loadu_ps( centers[axis] + i );
+				const __m256 extent = _mm256_loadu_ps( extents[axis] + i );
+				const __m256 t1 = _mm256_mul_ps( _mm256_sub_ps( _mm256_sub_ps( center, extent ), origin[axis] ), inverseDirection[axis] );
+				const __m256 t2 = _mm256_mul_ps( _mm256_sub_ps( _mm256_add_ps( center, extent ), origin[axis] ), inverseDirection[axis] );
+				entry = _mm256_max_ps( _mm256_min_ps( t2, t1 ), entry );
+				exit = _mm256_min_ps( _mm256_max_ps( t2, t1 ), exit );
+			}
+			const __m256 hit = _mm256_cmp_ps( entry, exit, _CMP_LE_OQ );
+			_mm256_storeu_ps( distances + i, _mm256_blendv_ps( miss, entry, hit ) );
+			hits += CountHits( _mm256_movemask_ps( hit ) );
+		}
+		_mm256_zeroupper();
+		return hits + RayBoxSSE( boxes, i, end, ray, distances );
+	}
+#endif
+
+	// indexed by IntersectionPath
+	const Kernels kernels[] = {
+		{ SphereSphereScalar, SpherePairsScalar, SphereFrustumScalar, BoxFrustumScalar, RaySphereScalar, RayBoxScalar },
+#ifdef INTERSECTION_X86
+		{ SphereSphereSSE, SpherePairsSSE, SphereFrustumSSE, BoxFrustumSSE, RaySphereSSE, RayBoxSSE },
+		{ SphereSphereAVX2, SpherePairsAVX2, SphereFrustumAVX2, BoxFrustumAVX2, RaySphereAVX2, RayBoxAVX2 }
+#endif
+	};
+
+	// avx needs the os to save the wider registers as well as the cpu to have them
+	IntersectionPath DetectPath() noexcept
+	{
+#if defined( INTERSECTION_X86 ) && defined( _MSC_VER )
+		int info[4];
+		__cpuid( info, 0 );
+		const int leafCount = info[0];
+		__cpuid( info, 1 );
+		if ( ( info[3] & 1 << 26 ) == 0 )
+			return IntersectionPath::Scalar;
+		const bool avx = ( info[2] & 1 << 27 ) != 0 && ( info[2] & 1 << 28 ) != 0 && ( _xgetbv( 0 ) & 6 ) == 6;
+		if ( avx && leafCount >= 7 )
+		{
+			__cpuidex( info, 7, 0 );
+			if ( ( info[1] & 1 << 5 ) != 0 )
+				return IntersectionPath::AVX2;
+		}
+		return IntersectionPath::SSE;
+#elif defined( INTERSECTION_X86 )
+		__builtin_cpu_init();
+		if ( __builtin_cpu_supports( "avx2" ) )
+			return IntersectionPath::AVX2;
+		return __builtin_cpu_supports( "sse2" ) ? IntersectionPath::SSE : IntersectionPath::Scalar;
+#else
+		return IntersectionPath::Scalar;
+#endif
+	}
+
+	std::atomic<IntersectionPath>& SelectedPath() noexcept
+	{
+		static std::atomic<IntersectionPath> path( Intersection::GetSupportedPath() );
+		return path;
+	}
+
+	const Kernels& GetKernels() noexcept
+	{
+		return kernels[static_cast<int>( SelectedPath().load( std::memory_order_relaxed ) )];
+	}
+
+	Ray MakeRay( const XMFLOAT3& origin, const XMFLOAT3& direction, float maxDistance ) noexcept
+	{
+		return {
+			{ origin.x, origin.y, origin.z },
+			{ direction.x, direction.y, direction.z },
+			{ 1.0f / direction.x, 1.0f / direction.y, 1.0f / direction.z },
+			direction.x * direction.x + direction.y * direction.y + direction.z * direction.z,
+			maxDistance
+		};
+	}
+}
+
+IntersectionPath Intersection::GetSupportedPath() noexcept
+{
+	static const IntersectionPath path = DetectPath();
+	return path;
+}
+
+IntersectionPath Intersection::GetPath() noexcept
+{
+	return SelectedPath().load( std::memory_order_relaxed );
+}
+
+void Intersection::SetPath( IntersectionPath path ) noexcept
+{
+	SelectedPath().store( std::min( path, GetSupportedPath() ), std::memory_order_relaxed );
+}
+
+const char* Intersection::GetPathName( IntersectionPath path ) noexcept
+{
+	switch ( path )
+	{
+	case IntersectionPath::SSE: return "SSE";
+	case IntersectionPath::AVX2: return "AVX2";
+	default: return "Scalar";
+	}
+}
+
+uint32_t Intersection::SphereSphere( const SphereStreams& spheres, uint32_t count, const XMFLOAT3& center, float radius, uint8_t* results ) noexcept
+{
+	return GetKernels().sphereSphere( spheres, 0, count, { center.x, center.y, center.z, radius }, results );
+}
+
+uint32_t Intersection::SpherePairs( const SphereStreams& spheres, const Pair* pairs, uint32_t count, uint8_t* results ) noexcept
+{
+	return GetKernels().spherePairs( spheres, pairs, 0, count, results );
+}
+
+uint32_t Intersection::SphereFrustum( const SphereStreams& spheres, uint32_t count, const XMFLOAT4 planes[6], uint8_t* results ) noexcept
+{
+	return GetKernels().sphereFrustum( spheres, 0, count, planes, results );
+}
+
+uint32_t Intersection::BoxFrustum( const BoxStreams& boxes, uint32_t count, const XMFLOAT4 planes[6], uint8_t* results ) noexcept
+{
+	return GetKernels().boxFrustum( boxes, 0, count, planes, results );
+}
+
+uint32_t Intersection::RaySphere( const SphereStreams& spheres, uint32_t count, const XMFLOAT3& origin,
+	const XMFLOAT3& direction, float maxDistance, float* distances ) noexcept
+{
+	return GetKernels().raySphere( spheres, 0, count, MakeRay( origin, direction, maxDistance ), distances );
+}
+
+uint32_t Intersection::RayBox( const BoxStreams& boxes, uint32_t count, const XMFLOAT3& origin,
+	const XMFLOAT3& direction, float maxDistance, float* distances ) noexcept
+{
+	return GetKernels().rayBox( boxes, 0, count, MakeRay( origin, direction, maxDistance ), distances );
+}
\ No newline at end of file
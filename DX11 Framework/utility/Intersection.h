@@ -0,0 +1,63 @@
+#pragma once
+#ifndef INTERSECTION_H
+#define INTERSECTION_H
+
+#include <DirectXMath.h>
+#include <cstdint>
+#include <utility>
+
+// the widest kernels the cpu runs, each falls back to the narrower ones for what is left over
+enum class IntersectionPath
+{
+	Scalar,
+	SSE,
+	AVX2
+};
+
+// a batch as one array per component, element i of every array belongs to the same sphere or box
+struct SphereStreams
+{
+	const float* x;
+	const float* y;
+	const float* z;
+	const float* radius;
+};
+
+struct BoxStreams
+{
+	const float* centerX;
+	const float* centerY;
+	const float* centerZ;
+	const float* extentX;
+	const float* extentY;
+	const float* extentZ;
+};
+
+// intersection tests over whole batches, the scalar kernels are the reference the wider ones must match exactly
+// vector kernels do the same operations in the same order without fused multiply-adds, so every path gives identical results
+// tests write one result per element and return how many intersect
+//  - overlap tests write 1 or 0, frustum planes are normalized and face inwards
+//  - ray tests write the distance to where the ray enters, or FLT_MAX when it misses within maxDistance
+//    the direction needn't be normalized, distances are measured in its length and a ray starting inside hits at 0
+class Intersection
+{
+public:
+	using Pair = std::pair<uint32_t, uint32_t>;
+	static IntersectionPath GetSupportedPath() noexcept;
+	static IntersectionPath GetPath() noexcept;
+	// paths the cpu can't run fall back to the widest it can
+	static void SetPath( IntersectionPath path ) noexcept;
+	static const char* GetPathName( IntersectionPath path ) noexcept;
+
+	static uint32_t SphereSphere( const SphereStreams& spheres, uint32_t count, const DirectX::XMFLOAT3& center, float radius, uint8_t* results ) noexcept;
+	// spheres by index into the batch, as a broadphase hands out candidates
+	static uint32_t SpherePairs( const SphereStreams& spheres, const Pair* pairs, uint32_t count, uint8_t* results ) noexcept;
+	static uint32_t SphereFrustum( const SphereStreams& spheres, uint32_t count, const DirectX::XMFLOAT4 planes[6], uint8_t* results ) noexcept;
+	static uint32_t BoxFrustum( const BoxStreams& boxes, uint32_t count, const DirectX::XMFLOAT4 planes[6], uint8_t* results ) noexcept;
+	static uint32_t RaySphere( const SphereStreams& spheres, uint32_t count, const DirectX::XMFLOAT3& origin,
+		const DirectX::XMFLOAT3& direction, float maxDistance, float* distances ) noexcept;
+	static uint32_t RayBox( const BoxStreams& boxes, uint32_t count, const DirectX::XMFLOAT3& origin,
+		const DirectX::XMFLOAT3& direction, float maxDistance, float* distances ) noexcept;
+};
+
+#endif
\ No newline at end of file
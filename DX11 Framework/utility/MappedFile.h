@@ -0,0 +1,85 @@
+#pragma once
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#include <Windows.h>
+#include <string>
+
+// read-only memory mapped view of a whole file
+class MappedFile
+{
+public:
+	MappedFile() = default;
+	MappedFile( const MappedFile& ) = delete;
+	MappedFile& operator=( const MappedFile& ) = delete;
+	~MappedFile() noexcept
+	{
+		Close();
+	}
+	bool Open( const std::string& filePath ) noexcept
+	{
+		Close();
+
+		file = CreateFileA( filePath.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL,
+			OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL );
+		if ( file == INVALID_HANDLE_VALUE )
+			return false;
+
+		LARGE_INTEGER fileSize;
+		if ( !GetFileSizeEx( file, &fileSize ) || fileSize.QuadPart == 0 )
+		{
+			Close();
+			return false;
+		}
+
+		mapping = CreateFileMappingA( file, NULL, PAGE_READONLY, 0, 0, NULL );
+		if ( mapping == NULL )
+		{
+			Close();
+			return false;
+		}
+
+		data = static_cast<const BYTE*>( MapViewOfFile( mapping, FILE_MAP_READ, 0, 0, 0 ) );
+		if ( data == nullptr )
+		{
+			Close();
+			return false;
+		}
+
+		size = static_cast<size_t>( fileSize.QuadPart );
+		return true;
+	}
+	void Close() noexcept
+	{
+		if ( data != nullptr )
+			UnmapViewOfFile( data );
+		if ( mapping != NULL )
+			CloseHandle( mapping );
+		if ( file != INVALID_HANDLE_VALUE )
+			CloseHandle( file );
+
+		data = nullptr;
+		mapping = NULL;
+		file = INVALID_HANDLE_VALUE;
+		size = 0;
+	}
+	bool IsOpen() const noexcept
+	{
+		return data != nullptr;
+	}
+	const BYTE* GetData() const noexcept
+	{
+		return data;
+	}
+	size_t GetSize() const noexcept
+	{
+		return size;
+	}
+private:
+	HANDLE file = INVALID_HANDLE_VALUE;
+	HANDLE mapping = NULL;
+	const BYTE* data = nullptr;
+	size_t size = 0;
+};
+
+#endif
\ No newline at end of file
@@ -2,6 +2,8 @@
 #ifndef STRUCTS_H
 #define STRUCTS_H
 
+// shared by every file that includes this, the windows, input and renderer all read and write the same settings
+
 struct SceneParameters
 {
 	bool useMask = false;
@@ -11,20 +13,19 @@ struct SceneParameters
 	bool rasterizerSolid = true;
 	bool cameraCollision = false;
 	bool useBillboarding = false;
+	bool precisePicking = true;
 	float alphaFactor = 1.0f;
 	float clearColor[4] = { 0.0f, 0.75f, 1.0f, 1.0f };
 };
-static SceneParameters sceneParams;
+inline SceneParameters sceneParams;
 
 struct ViewportParameters
 {
 	bool useFull = true;
-	bool useLeft = false;
-	bool useRight = false;
 	bool useSplit = false;
 	bool controlLeftSide = true;
 };
-static ViewportParameters viewportParams;
+inline ViewportParameters viewportParams;
 
 struct SamplerParameters
 {
@@ -32,7 +33,7 @@ struct SamplerParameters
 	bool useBilinear = false;
 	bool usePoint = false;
 };
-static SamplerParameters samplerParams;
+inline SamplerParameters samplerParams;
 
 struct SpawnWindow
 {
@@ -43,7 +44,7 @@ struct SpawnWindow
 	bool cameraWindow = false;
 	bool stencilWindow = false;
 };
-static SpawnWindow spawnWindow;
+inline SpawnWindow spawnWindow;
 
 struct LightParameters
 {
@@ -56,13 +57,13 @@ struct LightParameters
 	float flickerAmount = 2.0f;
 	bool lightIntersection = false;
 };
-static LightParameters lightParams;
+inline LightParameters lightParams;
 
 struct StencilOutline
 {
 	XMFLOAT3 outlineColor = { 1.0f, 0.0f, 0.0f };
 	float outlineSize = 1.3f;
 };
-static StencilOutline outlineParams;
+inline StencilOutline outlineParams;
 
 #endif
\ No newline at end of file
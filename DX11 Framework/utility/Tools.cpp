@@ -0,0 +1,408 @@
+#include "Tools.h"
+#include "Timer.h"
+#include "CommandLine.h"
+#include "../graphics/Model.h"
+#include "../graphics/HeadlessDevice.h"
+#include "../graphics/ModelData.h"
+#include "../graphics/ModelCache.h"
+#include "../graphics/ModelLoader.h"
+#include "../graphics/TextureCache.h"
+#include "../graphics/MeshOptimizer.h"
+#include "../graphics/MeshSimplifier.h"
+#include "../graphics/VertexQuantizer.h"
+#include <algorithm>
+#include <cstdio>
+
+#define BENCHMARK_ITERATIONS 5
+
+bool Tools::IsToolCommand( const std::string& commandLine )
+{
+	std::vector<std::string> arguments = CommandLine::GetArguments( commandLine );
+	return !arguments.empty() && ( arguments[0] == "-cook" || arguments[0] == "-benchmark" || arguments[0] == "-benchmark-scene" ||
+		arguments[0] == "-analyze" || arguments[0] == "-lods" || arguments[0] == "-quantize" );
+}
+
+int Tools::Run( const std::string& commandLine )
+{
+	CommandLine::OpenConsole();
+	std::vector<std::string> arguments = CommandLine::GetArguments( commandLine );
+	if ( CommandLine::HasOption( arguments, "-split-meshes" ) )
+		Model::SetSplitLargeMeshes( true );
+	if ( CommandLine::HasOption( arguments, "-no-optimize" ) )
+		Model::SetOptimizeMeshes( false );
+	if ( CommandLine::HasOption( arguments, "-no-lods" ) )
+		Model::SetGenerateLods( false );
+	if ( CommandLine::HasOption( arguments, "-no-quantize" ) )
+		Model::SetQuantizeVertices( false );
+
+	std::vector<std::string> files = GetModelFiles( arguments );
+	if ( files.empty() )
+	{
+		printf( "No models to process.\n" );
+		return -1;
+	}
+
+	if ( arguments[0] == "-cook" )
+		return CookModels( files ) ? 0 : -1;
+
+	if ( arguments[0] == "-benchmark" )
+		BenchmarkModelLoading( files );
+
+	if ( arguments[0] == "-benchmark-scene" )
+		BenchmarkSceneLoading( files );
+
+	if ( arguments[0] == "-analyze" )
+		AnalyzeMeshes( files );
+
+	if ( arguments[0] == "-lods" )
+		AnalyzeLods( files );
+
+	if ( arguments[0] == "-quantize" )
+		AnalyzeQuantization( files );
+
+	return 0;
+}
+
+std::vector<std::string> Tools::GetModelFiles( const std::vector<std::string>& arguments )
+{
+	// explicit model paths take priority over the scene description
+	std::vector<std::string> files = CommandLine::GetFiles( arguments );
+	if ( !files.empty() )
+		return files;
+
+	if ( !ModelData::LoadModelData( "res\\objects.json" ) )
+		return files;
+	for ( unsigned int i = 0; i < drawables.size(); i++ )
+		files.push_back( "res\\models\\" + drawables[i].fileName );
+	files.push_back( "res\\models\\light.fbx" );
+	return files;
+}
+
+bool Tools::CookModels( const std::vector<std::string>& files )
+{
+	bool success = true;
+	Timer timer;
+	timer.Start();
+	for ( unsigned int i = 0; i < files.size(); i++ )
+	{
+		timer.Restart();
+		if ( ModelCache::Cook( files[i] ) )
+		{
+			printf( "Cooked %-40s -> %s (%.2f ms)\n", files[i].c_str(),
+				ModelCache::GetCachePath( files[i] ).c_str(), timer.GetMilliSecondsElapsed() );
+		}
+		else
+		{
+			printf( "Failed to cook %s\n", files[i].c_str() );
+			success = false;
+		}
+	}
+	return success;
+}
+
+void Tools::BenchmarkModelLoading( const std::vector<std::string>& files )
+{
+	printf( "Model load times, cpu only, averaged over %d runs\n", BENCHMARK_ITERATIONS );
+	printf( "%-40s %12s %12s %9s %8s %10s\n", "Model", "Assimp (ms)", "Cache (ms)", "Speedup", "Meshes", "Cache (MB)" );
+
+	Timer timer;
+	timer.Start();
+	for ( unsigned int i = 0; i < files.size(); i++ )
+	{
+		// assimp import and vertex conversion
+		double assimpTime = 0.0;
+		size_t meshCount = 0;
+		for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+		{
+			std::vector<MeshData> meshData;
+			Assimp::Importer importer;
+			timer.Restart();
+			if ( !Model::ImportModel( files[i], importer, meshData ) )
+				break;
+			assimpTime += timer.GetMilliSecondsElapsed();
+			meshCount = meshData.size();
+		}
+
+		if ( meshCount == 0 || !ModelCache::Cook( files[i] ) )
+		{
+			printf( "%-40s failed to load\n", files[i].c_str() );
+			continue;
+		}
+
+		// mapped cache, touching every page of the streams as the upload would
+		double cacheTime = 0.0;
+		size_t cacheSize = 0;
+		for ( int run = 0; run < BENCHMARK_ITERATIONS; run++ )
+		{
+			timer.Restart();
+			ModelCache cache;
+			std::vector<MeshData> meshData;
+			if ( !cache.Open( files[i], Model::GetImportSettings() ) || !cache.GetMeshData( meshData ) )
+				break;
+			volatile BYTE checksum = 0;
+			for ( unsigned int j = 0; j < meshData.size(); j++ )
+			{
+				const BYTE* vertices = reinterpret_cast<const BYTE*>( meshData[j].GetVertexData() );
+				const size_t vertexBytes = static_cast<size_t>( meshData[j].GetVertexStride() ) * meshData[j].GetVertexCount();
+				for ( size_t k = 0; k < vertexBytes; k += 4096 )
+					checksum ^= vertices[k];
+			}
+			cacheTime += timer.GetMilliSecondsElapsed();
+			cacheSize = cache.GetSize();
+		}
+
+		assimpTime /= BENCHMARK_ITERATIONS;
+		cacheTime /= BENCHMARK_ITERATIONS;
+		printf( "%-40s %12.2f %12.2f %8.1fx %8zu %10.2f\n", files[i].c_str(), assimpTime, cacheTime,
+			cacheTime > 0.0 ? assimpTime / cacheTime : 0.0, meshCount, cacheSize / ( 1024.0 * 1024.0 ) );
+	}
+}
+
+void Tools::BenchmarkSceneLoading( const std::vector<std::string>& files )
+{
+	Microsoft::WRL::ComPtr<ID3D11Device> device;
+	Microsoft::WRL::ComPtr<ID3D11DeviceContext> context;
+	ConstantBuffer<CB_VS_matrix> cb_vs_matrix;
+	if ( !HeadlessDevice::Create( device, context ) || FAILED( cb_vs_matrix.Initialize( device.Get(), context.Get() ) ) )
+	{
+		printf( "Failed to create a device.\n" );
+		return;
+	}
+
+	// cook up front so the cache column only measures hits
+	for ( unsigned int i = 0; i < files.size(); i++ )
+		ModelCache::Cook( files[i] );
+
+	std::vector<UINT> threadCounts = { 1, 2, 4 };
+	const UINT maxThreads = std::thread::hardware_concurrency();
+	if ( maxThreads > 4 )
+		threadCounts.push_back( maxThreads );
+
+	// time until every model has its buffers created on this thread
+	printf( "Scene load times for %zu models, including buffer creation on the device thread\n", files.size() );
+	printf( "%-8s %14s %10s %14s %10s\n", "Threads", "Assimp (ms)", "Speedup", "Cache (ms)", "Speedup" );
+
+	Timer timer;
+	timer.Start();
+	double baseTime[2] = { 0.0, 0.0 };
+	for ( unsigned int i = 0; i < threadCounts.size(); i++ )
+	{
+		double loadTime[2] = { 0.0, 0.0 };
+		for ( int useCache = 0; useCache < 2; useCache++ )
+		{
+			std::vector<Model> models;
+			TextureCache::Clear();
+			ModelLoader loader;
+			timer.Restart();
+			loader.Start( files, threadCounts[i], useCache == 1 );
+			UINT created = 0;
+			while ( created < loader.GetTotalCount() )
+			{
+				std::vector<LoadedModel> completed;
+				if ( !loader.GetCompleted( completed ) )
+				{
+					std::this_thread::yield();
+					continue;
+				}
+				for ( unsigned int j = 0; j < completed.size(); j++ )
+				{
+					Model model;
+					if ( completed[j].success )
+						model.Initialize( completed[j].meshData, device.Get(), context.Get(), cb_vs_matrix );
+					models.push_back( model );
+					created++;
+				}
+			}
+			loadTime[useCache] = timer.GetMilliSecondsElapsed();
+			if ( i == 0 )
+				baseTime[useCache] = loadTime[useCache];
+		}
+
+		printf( "%-8u %14.2f %9.1fx %14.2f %9.1fx\n", threadCounts[i],
+			loadTime[0], loadTime[0] > 0.0 ? baseTime[0] / loadTime[0] : 0.0,
+			loadTime[1], loadTime[1] > 0.0 ? baseTime[1] / loadTime[1] : 0.0 );
+	}
+
+	TextureCacheStats textureStats = TextureCache::GetStats();
+	printf( "Texture cache: %u unique, %u hits / %u misses, %.2f MB resident, %.2f MB saved\n",
+		textureStats.textureCount, textureStats.hits, textureStats.misses,
+		textureStats.residentBytes / ( 1024.0 * 1024.0 ), textureStats.savedBytes / ( 1024.0 * 1024.0 ) );
+}
+
+void Tools::AnalyzeMeshes( const std::vector<std::string>& files )
+{
+	// import without the optimization stage, then run it here to compare
+	Model::SetOptimizeMeshes( false );
+	Model::SetGenerateLods( false );
+	Model::SetQuantizeVertices( false );
+
+	printf( "Post-transform cache efficiency, fifo cache of %u vertices\n", MeshOptimizer::CACHE_SIZE );
+	printf( "%-40s %10s %10s %10s %8s %8s %8s %8s %10s\n", "Model", "Triangles", "Vertices", "Unique",
+		"ACMR", "ACMR'", "ATVR", "ATVR'", "Time (ms)" );
+
+	Timer timer;
+	timer.Start();
+	MeshStatistics total, totalOptimized;
+	double totalMissesBefore = 0.0, totalMissesAfter = 0.0, totalTime = 0.0;
+	UINT totalVertices = 0;
+	for ( unsigned int i = 0; i < files.size(); i++ )
+	{
+		std::vector<MeshData> meshData;
+		Assimp::Importer importer;
+		if ( !Model::ImportModel( files[i], importer, meshData ) )
+		{
+			printf( "%-40s failed to load\n", files[i].c_str() );
+			continue;
+		}
+
+		MeshStatistics before, after;
+		double missesBefore = 0.0, missesAfter = 0.0, time = 0.0;
+		UINT vertexCount = 0;
+		for ( unsigned int j = 0; j < meshData.size(); j++ )
+		{
+			vertexCount += meshData[j].GetVertexCount();
+			MeshStatistics statistics = MeshOptimizer::Analyze( meshData[j] );
+			before.triangleCount += statistics.triangleCount;
+			before.vertexCount += statistics.vertexCount;
+			missesBefore += statistics.acmr * statistics.triangleCount;
+
+			timer.Restart();
+			MeshOptimizer::Optimize( meshData[j] );
+			time += timer.GetMilliSecondsElapsed();
+
+			statistics = MeshOptimizer::Analyze( meshData[j] );
+			after.triangleCount += statistics.triangleCount;
+			after.vertexCount += statistics.vertexCount;
+			missesAfter += statistics.acmr * statistics.triangleCount;
+		}
+
+		printf( "%-40s %10u %10u %10u %8.3f %8.3f %8.3f %8.3f %10.2f\n", files[i].c_str(),
+			before.triangleCount, vertexCount, after.vertexCount,
+			before.triangleCount > 0 ? missesBefore / before.triangleCount : 0.0,
+			after.triangleCount > 0 ? missesAfter / after.triangleCount : 0.0,
+			before.vertexCount > 0 ? missesBefore / before.vertexCount : 0.0,
+			after.vertexCount > 0 ? missesAfter / after.vertexCount : 0.0, time );
+
+		total.triangleCount += before.triangleCount;
+		total.vertexCount += before.vertexCount;
+		totalOptimized.vertexCount += after.vertexCount;
+		totalMissesBefore += missesBefore;
+		totalMissesAfter += missesAfter;
+		totalVertices += vertexCount;
+		totalTime += time;
+	}
+
+	printf( "%-40s %10u %10u %10u %8.3f %8.3f %8.3f %8.3f %10.2f\n", "Total",
+		total.triangleCount, totalVertices, totalOptimized.vertexCount,
+		total.triangleCount > 0 ? totalMissesBefore / total.triangleCount : 0.0,
+		total.triangleCount > 0 ? totalMissesAfter / total.triangleCount : 0.0,
+		total.vertexCount > 0 ? totalMissesBefore / total.vertexCount : 0.0,
+		totalOptimized.vertexCount > 0 ? totalMissesAfter / totalOptimized.vertexCount : 0.0, totalTime );
+}
+
+void Tools::AnalyzeLods( const std::vector<std::string>& files )
+{
+	// import without lods, then generate the chain here to time it
+	Model::SetGenerateLods( false );
+	Model::SetQuantizeVertices( false );
+
+	printf( "LOD chains, %u levels at %.0f%% triangle reduction per level\n", MeshSimplifier::MAX_LOD_COUNT,
+		100.0f * MeshSimplifier::LOD_REDUCTION );
+	printf( "%-40s %5s %10s %12s %10s\n", "Model", "LOD", "Triangles", "Max Error", "Time (ms)" );
+
+	Timer timer;
+	for ( unsigned int i = 0; i < files.size(); i++ )
+	{
+		std::vector<MeshData> meshData;
+		Assimp::Importer importer;
+		if ( !Model::ImportModel( files[i], importer, meshData ) )
+		{
+			printf( "%-40s failed to load\n", files[i].c_str() );
+			continue;
+		}
+
+		timer.Restart();
+		for ( unsigned int j = 0; j < meshData.size(); j++ )
+			MeshSimplifier::GenerateLods( meshData[j] );
+		const double time = timer.GetMilliSecondsElapsed();
+
+		// meshes stop simplifying at different levels, report each level against the last one they reached
+		for ( UINT lod = 0; lod < MeshSimplifier::MAX_LOD_COUNT; lod++ )
+		{
+			UINT triangleCount = 0;
+			float error = 0.0f;
+			for ( unsigned int j = 0; j < meshData.size(); j++ )
+			{
+				if ( meshData[j].lods.empty() )
+				{
+					triangleCount += meshData[j].GetIndexCount() / 3;
+					continue;
+				}
+				const MeshLod& meshLod = meshData[j].lods[std::min<size_t>( lod, meshData[j].lods.size() - 1 )];
+				triangleCount += meshLod.indexCount / 3;
+				error = std::max( error, meshLod.error );
+			}
+			printf( "%-40s %5u %10u %12.5f %10.2f\n", lod == 0 ? files[i].c_str() : "", lod, triangleCount, error,
+				lod == 0 ? time : 0.0 );
+		}
+	}
+}
+
+void Tools::AnalyzeQuantization( const std::vector<std::string>& files )
+{
+	// import at full precision, then round trip every mesh through the quantized format
+	Model::SetQuantizeVertices( false );
+
+	printf( "Vertex quantization, tolerance %.6f of bounds / %.4f rad / %.6f uv\n", VertexQuantizer::POSITION_TOLERANCE,
+		VertexQuantizer::NORMAL_TOLERANCE, VertexQuantizer::TEXCOORD_TOLERANCE );
+	printf( "%-40s %8s %12s %12s %12s %12s %12s\n", "Model", "Meshes", "Position", "Normal", "UV", "Before (KB)", "After (KB)" );
+
+	size_t totalBefore = 0, totalAfter = 0;
+	UINT totalMeshes = 0, totalQuantized = 0;
+	for ( unsigned int i = 0; i < files.size(); i++ )
+	{
+		std::vector<MeshData> meshData;
+		Assimp::Importer importer;
+		if ( !Model::ImportModel( files[i], importer, meshData ) )
+		{
+			printf( "%-40s failed to load\n", files[i].c_str() );
+			continue;
+		}
+
+		// error is reported for every mesh, including those left at full precision
+		QuantizationError error;
+		size_t bytesBefore = 0, bytesAfter = 0;
+		UINT quantizedCount = 0;
+		for ( unsigned int j = 0; j < meshData.size(); j++ )
+		{
+			const Vertex3D* vertices = meshData[j].GetVertices();
+			const UINT vertexCount = meshData[j].GetVertexCount();
+			const VertexQuantization quantization = VertexQuantizer::GetQuantization( vertices, vertexCount );
+			std::vector<Vertex3DQuantized> quantizedVertices( vertexCount );
+			for ( UINT k = 0; k < vertexCount; k++ )
+				quantizedVertices[k] = VertexQuantizer::Encode( vertices[k], quantization );
+
+			const QuantizationError meshError = VertexQuantizer::Measure( vertices, quantizedVertices.data(), vertexCount, quantization );
+			error.position = std::max( error.position, meshError.position );
+			error.normal = std::max( error.normal, meshError.normal );
+			error.texCoord = std::max( error.texCoord, meshError.texCoord );
+
+			const bool quantized = VertexQuantizer::IsWithinTolerance( meshError );
+			bytesBefore += sizeof( Vertex3D ) * static_cast<size_t>( vertexCount );
+			bytesAfter += ( quantized ? sizeof( Vertex3DQuantized ) : sizeof( Vertex3D ) ) * static_cast<size_t>( vertexCount );
+			quantizedCount += quantized ? 1 : 0;
+		}
+
+		printf( "%-40s %3u / %-3u %12.7f %12.7f %12.7f %12.1f %12.1f\n", files[i].c_str(), quantizedCount,
+			static_cast<UINT>( meshData.size() ), error.position, error.normal, error.texCoord,
+			bytesBefore / 1024.0, bytesAfter / 1024.0 );
+
+		totalBefore += bytesBefore;
+		totalAfter += bytesAfter;
+		totalMeshes += static_cast<UINT>( meshData.size() );
+		totalQuantized += quantizedCount;
+	}
+
+	printf( "%u of %u meshes quantized, vertex memory %.1f KB -> %.1f KB (%.1f%% saved)\n", totalQuantized, totalMeshes,
+		totalBefore / 1024.0, totalAfter / 1024.0, totalBefore > 0 ? 100.0 * ( totalBefore - totalAfter ) / totalBefore : 0.0 );
+}
\ No newline at end of file
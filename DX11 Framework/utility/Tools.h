@@ -0,0 +1,35 @@
+#pragma once
+#ifndef TOOLS_H
+#define TOOLS_H
+
+#include <string>
+#include <vector>
+
+// offline command-line tools, run from WinMain without creating a window
+//  -cook [files...]        write the binary model cache for objects.json (or the given models)
+//  -benchmark [files...]   compare assimp and model cache load times
+//  -benchmark-scene         startup time of the threaded scene loader with 1, 2, 4 and N threads
+//  -analyze [files...]      post-transform cache efficiency (acmr/atvr) before and after mesh optimization
+//  -lods [files...]         triangle counts and simplification error of each generated lod level
+//  -quantize [files...]     round trip error and vertex memory saved by the quantized vertex format
+// options
+//  -split-meshes            split meshes too large for 16-bit indices instead of using 32-bit indices
+//  -no-optimize             skip the mesh optimization stage on import
+//  -no-lods                 skip lod chain generation on import
+//  -no-quantize             keep full precision vertices for every mesh
+class Tools
+{
+public:
+	static bool IsToolCommand( const std::string& commandLine );
+	static int Run( const std::string& commandLine );
+private:
+	static std::vector<std::string> GetModelFiles( const std::vector<std::string>& arguments );
+	static bool CookModels( const std::vector<std::string>& files );
+	static void BenchmarkModelLoading( const std::vector<std::string>& files );
+	static void BenchmarkSceneLoading( const std::vector<std::string>& files );
+	static void AnalyzeMeshes( const std::vector<std::string>& files );
+	static void AnalyzeLods( const std::vector<std::string>& files );
+	static void AnalyzeQuantization( const std::vector<std::string>& files );
+};
+
+#endif
\ No newline at end of file
@@ -0,0 +1,117 @@
+#include "Broadphase.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+// the spatial hash and the loose octree against testing every pair, on 1k, 10k and 100k moving spheres
+namespace
+{
+	constexpr int FRAMES = 100;
+
+	double Milliseconds( std::chrono::steady_clock::time_point start )
+	{
+		return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	bool Overlap( const XMFLOAT3& a, const XMFLOAT3& b, float reach )
+	{
+		const float x = a.x - b.x;
+		const float y = a.y - b.y;
+		const float z = a.z - b.z;
+		return x * x + y * y + z * z <= reach * reach;
+	}
+
+	// the same density at every count, a sphere touches a few others at a time
+	void Run( uint32_t sphereCount )
+	{
+		std::mt19937_64 generator( 42 );
+		const float extent = std::cbrt( static_cast<float>( sphereCount ) * 40.0f ) * 0.5f;
+		std::uniform_real_distribution<float> positions( -extent, extent );
+		std::uniform_real_distribution<float> radii( 0.25f, 1.0f );
+		std::uniform_real_distribution<float> velocities( -0.1f, 0.1f );
+		std::vector<XMFLOAT3> center( sphereCount ), velocity( sphereCount );
+		std::vector<float> radius( sphereCount );
+		Broadphase hash( BroadphaseMode::SpatialHash, 2.0f );
+		Broadphase octree( BroadphaseMode::LooseOctree, 2.0f );
+		std::vector<Broadphase::Proxy> hashProxies( sphereCount ), octreeProxies( sphereCount );
+		for ( uint32_t i = 0; i < sphereCount; i++ )
+		{
+			center[i] = XMFLOAT3( positions( generator ), positions( generator ), positions( generator ) );
+			velocity[i] = XMFLOAT3( velocities( generator ), velocities( generator ), velocities( generator ) );
+			radius[i] = radii( generator );
+			hashProxies[i] = hash.Add( center[i], radius[i] );
+			octreeProxies[i] = octree.Add( center[i], radius[i] );
+		}
+
+		std::vector<Broadphase::Pair> candidates, hashCollisions, octreeCollisions;
+		std::vector<uint8_t> results;
+		double hashUpdate = 0.0, hashTest = 0.0, octreeUpdate = 0.0, octreeTest = 0.0;
+		uint32_t rebucketedCount = 0;
+		for ( int frame = 0; frame < FRAMES; frame++ )
+		{
+			// spheres bounce off the walls of the volume
+			for ( uint32_t i = 0; i < sphereCount; i++ )
+			{
+				float* position[3] = { &center[i].x, &center[i].y, &center[i].z };
+				float* speed[3] = { &velocity[i].x, &velocity[i].y, &velocity[i].z };
+				for ( int axis = 0; axis < 3; axis++ )
+				{
+					*position[axis] += *speed[axis];
+					if ( std::fabs( *position[axis] ) > extent )
+						*speed[axis] = -*speed[axis];
+				}
+			}
+			hash.ResetStatistics();
+			auto start = std::chrono::steady_clock::now();
+			for ( uint32_t i = 0; i < sphereCount; i++ )
+				hash.Move( hashProxies[i], center[i], radius[i] );
+			hashUpdate += Milliseconds( start );
+			start = std::chrono::steady_clock::now();
+			hash.FindCollisions( candidates, results, hashCollisions );
+			hashTest += Milliseconds( start );
+			rebucketedCount += hash.GetStatistics().rebucketedCount;
+
+			start = std::chrono::steady_clock::now();
+			for ( uint32_t i = 0; i < sphereCount; i++ )
+				octree.Move( octreeProxies[i], center[i], radius[i] );
+			octreeUpdate += Milliseconds( start );
+			start = std::chrono::steady_clock::now();
+			octree.FindCollisions( candidates, results, octreeCollisions );
+			octreeTest += Milliseconds( start );
+		}
+
+		// every pair once, on the last frame's positions
+		std::vector<Broadphase::Pair> bruteCollisions;
+		const auto start = std::chrono::steady_clock::now();
+		for ( uint32_t i = 0; i < sphereCount; i++ )
+			for ( uint32_t j = i + 1; j < sphereCount; j++ )
+				if ( Overlap( center[i], center[j], radius[i] + radius[j] ) )
+					bruteCollisions.emplace_back( i, j );
+		const double bruteTime = Milliseconds( start );
+
+		// proxies were handed out in order, so they are the sphere indices
+		std::sort( hashCollisions.begin(), hashCollisions.end() );
+		std::sort( octreeCollisions.begin(), octreeCollisions.end() );
+		const bool match = hashCollisions == bruteCollisions && octreeCollisions == bruteCollisions;
+		std::printf( "%-8u %11.3f %16.3f %14.3f %15.3f %15.3f %11.1f%% %11u %11u %6s\n", sphereCount, bruteTime,
+			hashUpdate / FRAMES, hashTest / FRAMES, octreeUpdate / FRAMES, octreeTest / FRAMES,
+			100.0 * rebucketedCount / ( static_cast<double>( sphereCount ) * FRAMES ), static_cast<uint32_t>( candidates.size() ),
+			static_cast<uint32_t>( bruteCollisions.size() ), match ? "yes" : "no" );
+	}
+}
+
+int main()
+{
+	std::printf( "Sphere collisions per frame with every sphere moving, averaged over %d frames, cpu only\n", FRAMES );
+	std::printf( "%-8s %11s %16s %14s %15s %15s %12s %11s %11s %6s\n", "Spheres", "Brute (ms)", "Hash update (ms)", "Hash test (ms)",
+		"Octree upd (ms)", "Octree test (ms)", "Rebucketed", "Candidates", "Collisions", "Match" );
+	for ( uint32_t sphereCount : { 1000u, 10000u, 100000u } )
+		Run( sphereCount );
+	return 0;
+}
\ No newline at end of file
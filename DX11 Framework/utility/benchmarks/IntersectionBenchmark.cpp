@@ -0,0 +1,131 @@
+#include "Intersection.h"
+#include <cfloat>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+// each intersection kernel on every path the cpu runs, checked against the scalar reference on 1m spheres and boxes
+namespace
+{
+	constexpr int ITERATIONS = 5;
+	constexpr uint32_t ELEMENT_COUNT = 1000000;
+
+	double Milliseconds( std::chrono::steady_clock::time_point start )
+	{
+		return std::chrono::duration<double, std::milli>( std::chrono::steady_clock::now() - start ).count();
+	}
+
+	XMFLOAT4 Normalized( float x, float y, float z, float d )
+	{
+		const float length = std::sqrt( x * x + y * y + z * z );
+		return XMFLOAT4( x / length, y / length, z / length, d / length );
+	}
+
+	// a camera at z = -150 looking down +z with a 45 degree 16:9 view out to 1000, built without directxmath's matrices
+	void ViewFrustum( XMFLOAT4 planes[6] )
+	{
+		const float eye = -150.0f;
+		const float tanY = std::tan( 3.14159265f / 8.0f );
+		const float tanX = tanY * 16.0f / 9.0f;
+		planes[0] = Normalized( 1.0f, 0.0f, tanX, -eye * tanX );
+		planes[1] = Normalized( -1.0f, 0.0f, tanX, -eye * tanX );
+		planes[2] = Normalized( 0.0f, 1.0f, tanY, -eye * tanY );
+		planes[3] = Normalized( 0.0f, -1.0f, tanY, -eye * tanY );
+		planes[4] = XMFLOAT4( 0.0f, 0.0f, 1.0f, -( eye + 0.1f ) );
+		planes[5] = XMFLOAT4( 0.0f, 0.0f, -1.0f, eye + 1000.0f );
+	}
+}
+
+int main()
+{
+	const IntersectionPath supported = Intersection::GetSupportedPath();
+	std::printf( "Intersection kernels over %u spheres or boxes, cpu only, averaged over %d runs, %s is the widest path here\n", ELEMENT_COUNT,
+		ITERATIONS, Intersection::GetPathName( supported ) );
+	std::printf( "%-15s %11s %11s %11s %8s %9s %6s\n", "Kernel", "Scalar (ms)", "SSE (ms)", "AVX2 (ms)", "Speedup", "Hits", "Match" );
+
+	// spheres reuse the box centres, with the x extent as their radius
+	std::mt19937_64 generator( 42 );
+	std::uniform_real_distribution<float> positions( -100.0f, 100.0f );
+	std::uniform_real_distribution<float> sizes( 0.5f, 4.0f );
+	std::uniform_real_distribution<float> directions( -1.0f, 1.0f );
+	std::uniform_int_distribution<uint32_t> indices( 0, ELEMENT_COUNT - 1 );
+	std::vector<float> streams[6];
+	for ( uint32_t i = 0; i < 6; i++ )
+	{
+		streams[i].resize( ELEMENT_COUNT );
+		for ( float& value : streams[i] )
+			value = i < 3 ? positions( generator ) : sizes( generator );
+	}
+	const SphereStreams spheres = { streams[0].data(), streams[1].data(), streams[2].data(), streams[3].data() };
+	const BoxStreams boxes = { streams[0].data(), streams[1].data(), streams[2].data(), streams[3].data(), streams[4].data(), streams[5].data() };
+	std::vector<Intersection::Pair> pairs( ELEMENT_COUNT );
+	for ( Intersection::Pair& pair : pairs )
+		pair = { indices( generator ), indices( generator ) };
+	XMFLOAT3 rayOrigins[ITERATIONS], rayDirections[ITERATIONS];
+	for ( int run = 0; run < ITERATIONS; run++ )
+	{
+		rayOrigins[run] = XMFLOAT3( positions( generator ), positions( generator ), positions( generator ) );
+		rayDirections[run] = XMFLOAT3( directions( generator ), directions( generator ), directions( generator ) );
+	}
+	XMFLOAT4 planes[6];
+	ViewFrustum( planes );
+
+	// every path runs the same inputs, the last run's output must match the scalar path's bit for bit
+	std::vector<uint8_t> results( ELEMENT_COUNT ), referenceResults;
+	std::vector<float> distances( ELEMENT_COUNT ), referenceDistances;
+	auto measure = [&]( const char* name, auto&& kernel )
+	{
+		double times[3] = { 0.0, 0.0, 0.0 };
+		uint32_t referenceHits = 0;
+		bool match = true;
+		for ( int path = 0; path <= static_cast<int>( supported ); path++ )
+		{
+			Intersection::SetPath( static_cast<IntersectionPath>( path ) );
+			uint32_t hits = 0;
+			for ( int run = 0; run < ITERATIONS; run++ )
+			{
+				const auto start = std::chrono::steady_clock::now();
+				hits = kernel( run, results.data(), distances.data() );
+				times[path] += Milliseconds( start ) / ITERATIONS;
+			}
+			if ( path == 0 )
+			{
+				referenceHits = hits;
+				referenceResults = results;
+				referenceDistances = distances;
+				continue;
+			}
+			match = match && hits == referenceHits && std::memcmp( results.data(), referenceResults.data(), ELEMENT_COUNT ) == 0 &&
+				std::memcmp( distances.data(), referenceDistances.data(), ELEMENT_COUNT * sizeof( float ) ) == 0;
+		}
+		char columns[3][16];
+		for ( int path = 0; path < 3; path++ )
+			if ( path <= static_cast<int>( supported ) )
+				std::snprintf( columns[path], sizeof( columns[path] ), "%.3f", times[path] );
+			else
+				std::snprintf( columns[path], sizeof( columns[path] ), "-" );
+		std::printf( "%-15s %11s %11s %11s %7.1fx %9u %6s\n", name, columns[0], columns[1], columns[2],
+			times[0] / times[static_cast<int>( supported )], referenceHits, match ? "yes" : "no" );
+	};
+
+	measure( "Sphere-sphere", [&]( int run, uint8_t* out, float* ) { return Intersection::SphereSphere( spheres, ELEMENT_COUNT, rayOrigins[run], 20.0f, out ); } );
+	measure( "Sphere pairs", [&]( int, uint8_t* out, float* ) { return Intersection::SpherePairs( spheres, pairs.data(), ELEMENT_COUNT, out ); } );
+	measure( "Sphere-frustum", [&]( int, uint8_t* out, float* ) { return Intersection::SphereFrustum( spheres, ELEMENT_COUNT, planes, out ); } );
+	measure( "Box-frustum", [&]( int, uint8_t* out, float* ) { return Intersection::BoxFrustum( boxes, ELEMENT_COUNT, planes, out ); } );
+	measure( "Ray-sphere", [&]( int run, uint8_t*, float* out )
+	{
+		return Intersection::RaySphere( spheres, ELEMENT_COUNT, rayOrigins[run], rayDirections[run], FLT_MAX, out );
+	} );
+	measure( "Ray-box", [&]( int run, uint8_t*, float* out )
+	{
+		return Intersection::RayBox( boxes, ELEMENT_COUNT, rayOrigins[run], rayDirections[run], FLT_MAX, out );
+	} );
+	Intersection::SetPath( supported );
+	return 0;
+}
\ No newline at end of file
@@ -0,0 +1,270 @@
+#include "Broadphase.h"
+#include "Check.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <random>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	struct Sphere
+	{
+		XMFLOAT3 center;
+		float radius;
+		bool alive;
+	};
+
+	// every sphere against every other, the answers the broadphase must give
+	class Reference
+	{
+	public:
+		void Set( Broadphase::Proxy proxy, const XMFLOAT3& center, float radius )
+		{
+			if ( proxy >= spheres.size() )
+				spheres.resize( proxy + 1u, { { 0.0f, 0.0f, 0.0f }, 0.0f, false } );
+			spheres[proxy] = { center, radius, true };
+		}
+		void Remove( Broadphase::Proxy proxy ) { spheres[proxy].alive = false; }
+		bool IsAlive( Broadphase::Proxy proxy ) const { return proxy < spheres.size() && spheres[proxy].alive; }
+		uint32_t GetCount() const
+		{
+			return static_cast<uint32_t>( std::count_if( spheres.begin(), spheres.end(), []( const Sphere& sphere ) { return sphere.alive; } ) );
+		}
+		std::vector<Broadphase::Proxy> GetAlive() const
+		{
+			std::vector<Broadphase::Proxy> alive;
+			for ( Broadphase::Proxy proxy = 0; proxy < spheres.size(); proxy++ )
+				if ( spheres[proxy].alive )
+					alive.push_back( proxy );
+			return alive;
+		}
+
+		// pairs whose bounding boxes overlap, lower proxy first, computed as the broadphase does so rounding agrees
+		std::vector<Broadphase::Pair> FindPairs() const
+		{
+			std::vector<Broadphase::Pair> pairs;
+			for ( Broadphase::Proxy a = 0; a < spheres.size(); a++ )
+			{
+				if ( !spheres[a].alive )
+					continue;
+				const Sphere& s = spheres[a];
+				const float min[3] = { s.center.x - s.radius, s.center.y - s.radius, s.center.z - s.radius };
+				const float max[3] = { s.center.x + s.radius, s.center.y + s.radius, s.center.z + s.radius };
+				for ( Broadphase::Proxy b = a + 1u; b < spheres.size(); b++ )
+				{
+					const Sphere& o = spheres[b];
+					if ( o.alive && o.center.x + o.radius >= min[0] && o.center.x - o.radius <= max[0] &&
+						o.center.y + o.radius >= min[1] && o.center.y - o.radius <= max[1] &&
+						o.center.z + o.radius >= min[2] && o.center.z - o.radius <= max[2] )
+						pairs.emplace_back( a, b );
+				}
+			}
+			return pairs;
+		}
+		// the box pairs whose spheres overlap too
+		std::vector<Broadphase::Pair> FindCollisions() const
+		{
+			std::vector<Broadphase::Pair> collisions;
+			for ( const Broadphase::Pair& pair : FindPairs() )
+			{
+				const Sphere& a = spheres[pair.first];
+				const Sphere& b = spheres[pair.second];
+				const float x = a.center.x - b.center.x;
+				const float y = a.center.y - b.center.y;
+				const float z = a.center.z - b.center.z;
+				const float reach = a.radius + b.radius;
+				if ( x * x + y * y + z * z <= reach * reach )
+					collisions.push_back( pair );
+			}
+			return collisions;
+		}
+		std::vector<Broadphase::Proxy> QueryRadius( const XMFLOAT3& center, float radius ) const
+		{
+			std::vector<Broadphase::Proxy> results;
+			for ( Broadphase::Proxy proxy = 0; proxy < spheres.size(); proxy++ )
+			{
+				const Sphere& s = spheres[proxy];
+				const float x = s.center.x - center.x;
+				const float y = s.center.y - center.y;
+				const float z = s.center.z - center.z;
+				const float reach = s.radius + radius;
+				if ( s.alive && x * x + y * y + z * z <= reach * reach )
+					results.push_back( proxy );
+			}
+			return results;
+		}
+	private:
+		std::vector<Sphere> spheres;
+	};
+
+	// mostly small spheres in a crowded region, with some too large for any cell and some too far out for the coordinates
+	struct Generator
+	{
+		std::mt19937 random;
+		explicit Generator( uint32_t seed ) : random( seed ) {}
+		float Uniform( float low, float high ) { return std::uniform_real_distribution<float>( low, high )( random ); }
+		XMFLOAT3 Center()
+		{
+			const float roll = Uniform( 0.0f, 1.0f );
+			const float reach = roll < 0.02f ? 1.0e7f : roll < 0.3f ? 500.0f : 60.0f;
+			return { Uniform( -reach, reach ), Uniform( -reach, reach ), Uniform( -reach, reach ) };
+		}
+		float Radius()
+		{
+			const float roll = Uniform( 0.0f, 1.0f );
+			return roll < 0.03f ? Uniform( 50.0f, 20000.0f ) : roll < 0.2f ? Uniform( 2.0f, 12.0f ) : Uniform( 0.0f, 2.0f );
+		}
+	};
+
+	void CheckAgainst( Broadphase& broadphase, const Reference& reference, Generator& generator, const char* stage )
+	{
+		std::vector<Broadphase::Pair> pairs;
+		broadphase.FindPairs( pairs );
+		const size_t found = pairs.size();
+		for ( const Broadphase::Pair& pair : pairs )
+			CHECK( pair.first < pair.second && reference.IsAlive( pair.first ) && reference.IsAlive( pair.second ) );
+		std::sort( pairs.begin(), pairs.end() );
+		CHECK( std::unique( pairs.begin(), pairs.end() ) == pairs.end() && pairs.size() == found );
+		const bool samePairs = pairs == reference.FindPairs();
+		if ( !samePairs )
+			std::printf( "%s: %zu pairs found, %zu expected\n", stage, pairs.size(), reference.FindPairs().size() );
+		CHECK( samePairs );
+		CHECK( broadphase.GetProxyCount() == reference.GetCount() );
+
+		// the batched sphere test keeps the colliding pairs out of the same candidates
+		std::vector<Broadphase::Pair> collisions;
+		std::vector<uint8_t> overlaps;
+		broadphase.FindCollisions( pairs, overlaps, collisions );
+		CHECK( overlaps.size() == pairs.size() );
+		std::sort( collisions.begin(), collisions.end() );
+		CHECK( collisions == reference.FindCollisions() );
+
+		// the streams hold every live sphere where the batched tests expect it
+		const SphereStreams spheres = broadphase.GetSpheres();
+		for ( Broadphase::Proxy proxy : reference.GetAlive() )
+		{
+			const XMFLOAT3 center = broadphase.GetCenter( proxy );
+			CHECK( spheres.x[proxy] == center.x && spheres.y[proxy] == center.y && spheres.z[proxy] == center.z );
+			CHECK( spheres.radius[proxy] == broadphase.GetRadius( proxy ) );
+		}
+
+		std::vector<Broadphase::Proxy> results;
+		for ( int query = 0; query < 8; query++ )
+		{
+			const XMFLOAT3 center = generator.Center();
+			const float radius = query == 0 ? 0.0f : generator.Radius();
+			broadphase.QueryRadius( center, radius, results );
+			std::sort( results.begin(), results.end() );
+			CHECK( results == reference.QueryRadius( center, radius ) );
+		}
+	}
+
+	// adds, moves by a little and a lot, removes, and checks the lot against the reference as it goes
+	void TestRandomized( BroadphaseMode mode, float cellSize, uint32_t seed )
+	{
+		Broadphase broadphase( mode, cellSize );
+		Reference reference;
+		Generator generator( seed );
+		std::vector<Broadphase::Proxy> alive;
+		Broadphase::Proxy highest = 0;
+		for ( uint32_t step = 1; step <= 4000u; step++ )
+		{
+			const float roll = generator.Uniform( 0.0f, 1.0f );
+			if ( alive.size() < 20u || roll < 0.3f )
+			{
+				const XMFLOAT3 center = generator.Center();
+				const float radius = generator.Radius();
+				const Broadphase::Proxy proxy = broadphase.Add( center, radius );
+				CHECK( !reference.IsAlive( proxy ) );
+				reference.Set( proxy, center, radius );
+				alive.push_back( proxy );
+				highest = std::max( highest, proxy );
+			}
+			else if ( roll < 0.45f )
+			{
+				const size_t index = static_cast<size_t>( generator.Uniform( 0.0f, 1.0f ) * alive.size() ) % alive.size();
+				broadphase.Remove( alive[index] );
+				reference.Remove( alive[index] );
+				alive[index] = alive.back();
+				alive.pop_back();
+			}
+			else
+			{
+				// small moves mostly stay in their cell, large ones cross cells, levels and into or out of the oversized list
+				const Broadphase::Proxy proxy = alive[static_cast<size_t>( generator.Uniform( 0.0f, 1.0f ) * alive.size() ) % alive.size()];
+				XMFLOAT3 center = broadphase.GetCenter( proxy );
+				float radius = broadphase.GetRadius( proxy );
+				if ( roll < 0.85f )
+				{
+					center.x += generator.Uniform( -0.5f, 0.5f );
+					center.y += generator.Uniform( -0.5f, 0.5f );
+					center.z += generator.Uniform( -0.5f, 0.5f );
+				}
+				else
+				{
+					center = generator.Center();
+					radius = generator.Radius();
+				}
+				broadphase.Move( proxy, center, radius );
+				reference.Set( proxy, center, radius );
+			}
+			if ( step % 250u == 0u )
+				CheckAgainst( broadphase, reference, generator, mode == BroadphaseMode::SpatialHash ? "spatial hash" : "loose octree" );
+		}
+
+		// changing the settings sorts everything again without losing any of it
+		broadphase.SetMode( mode == BroadphaseMode::SpatialHash ? BroadphaseMode::LooseOctree : BroadphaseMode::SpatialHash, cellSize * 2.0f );
+		CheckAgainst( broadphase, reference, generator, "after switching" );
+
+		// removing everything leaves nothing behind, and the proxies are handed out again
+		for ( Broadphase::Proxy proxy : alive )
+		{
+			broadphase.Remove( proxy );
+			reference.Remove( proxy );
+		}
+		CHECK( broadphase.GetProxyCount() == 0u );
+		CHECK( broadphase.GetStatistics().cellCount == 0u && broadphase.GetStatistics().oversizedCount == 0u );
+		CheckAgainst( broadphase, reference, generator, "emptied" );
+		const Broadphase::Proxy reused = broadphase.Add( { 0.0f, 0.0f, 0.0f }, 1.0f );
+		CHECK( reused <= highest );
+		broadphase.Clear();
+		CHECK( broadphase.GetProxyCount() == 0u );
+	}
+
+	// spheres whose boxes only touch are a pair, spheres a hair apart aren't, wherever the cell boundaries fall
+	void TestTouching()
+	{
+		for ( BroadphaseMode mode : { BroadphaseMode::SpatialHash, BroadphaseMode::LooseOctree } )
+		{
+			Broadphase broadphase( mode, 4.0f );
+			const Broadphase::Proxy a = broadphase.Add( { 3.5f, 0.0f, 0.0f }, 0.5f );
+			const Broadphase::Proxy b = broadphase.Add( { 5.0f, 0.0f, 0.0f }, 1.0f );
+			const Broadphase::Proxy c = broadphase.Add( { 9.0f, 0.0f, 0.0f }, 1.0f );
+			std::vector<Broadphase::Pair> pairs;
+			broadphase.FindPairs( pairs );
+			CHECK( pairs == std::vector<Broadphase::Pair>( { { a, b } } ) );
+
+			// moving within a cell doesn't rebucket, crossing one does
+			broadphase.ResetStatistics();
+			broadphase.Move( c, { 11.5f, 0.0f, 0.0f }, 1.0f );
+			CHECK( broadphase.GetStatistics().movedCount == 1u && broadphase.GetStatistics().rebucketedCount == 0u );
+			broadphase.Move( c, { 7.0f, 0.0f, 0.0f }, 1.0f );
+			CHECK( broadphase.GetStatistics().rebucketedCount == 1u );
+			broadphase.FindPairs( pairs );
+			CHECK( pairs == std::vector<Broadphase::Pair>( { { a, b }, { b, c } } ) );
+		}
+	}
+}
+
+int main()
+{
+	TestTouching();
+	uint32_t seed = 1u;
+	for ( BroadphaseMode mode : { BroadphaseMode::SpatialHash, BroadphaseMode::LooseOctree } )
+		for ( float cellSize : { 1.0f, 4.0f, 32.0f } )
+			TestRandomized( mode, cellSize, seed++ );
+	return ReportChecks();
+}
\ No newline at end of file
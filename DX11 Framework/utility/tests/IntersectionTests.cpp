@@ -0,0 +1,214 @@
+#include "Intersection.h"
+#include "Check.h"
+#include <cfloat>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <random>
+#include <type_traits>
+#include <vector>
+
+using namespace DirectX;
+
+namespace
+{
+	constexpr uint8_t RESULT_SENTINEL = 0xCD;
+	constexpr float DISTANCE_SENTINEL = -7.0f;
+	const IntersectionPath paths[] = { IntersectionPath::Scalar, IntersectionPath::SSE, IntersectionPath::AVX2 };
+
+	// every count up to a few past the widest kernel, so each path hands a remainder of every size to the next
+	std::vector<uint32_t> Counts()
+	{
+		std::vector<uint32_t> counts;
+		for ( uint32_t count = 0; count <= 17u; count++ )
+			counts.push_back( count );
+		counts.push_back( 64u );
+		counts.push_back( 257u );
+		return counts;
+	}
+
+	// components are put on a grid of quarters, so touching spheres and rays grazing faces come up often and exactly
+	struct Batch
+	{
+		std::vector<float> x, y, z, radius, extentX, extentY, extentZ;
+		explicit Batch( uint32_t count, std::mt19937& random )
+		{
+			std::uniform_int_distribution<int> position( -40, 40 );
+			std::uniform_int_distribution<int> size( 0, 12 );
+			for ( uint32_t i = 0; i < count; i++ )
+			{
+				x.push_back( position( random ) * 0.25f );
+				y.push_back( position( random ) * 0.25f );
+				z.push_back( position( random ) * 0.25f );
+				radius.push_back( size( random ) * 0.25f );
+				extentX.push_back( size( random ) * 0.25f );
+				extentY.push_back( size( random ) * 0.25f );
+				extentZ.push_back( size( random ) * 0.25f );
+			}
+		}
+		SphereStreams Spheres() const { return { x.data(), y.data(), z.data(), radius.data() }; }
+		BoxStreams Boxes() const { return { x.data(), y.data(), z.data(), extentX.data(), extentY.data(), extentZ.data() }; }
+	};
+
+	// runs a test on every path the cpu has, checking each against the scalar one bit for bit
+	// results are padded past the count to catch any lane written beyond it
+	template<class T, class Test>
+	void CompareOutputs( const char* name, uint32_t count, T sentinel, Test&& test )
+	{
+		std::vector<T> reference;
+		uint32_t referenceHits = 0;
+		for ( IntersectionPath path : paths )
+		{
+			Intersection::SetPath( path );
+			if ( Intersection::GetPath() != path )
+				continue;
+			std::vector<T> output( count + 8u, sentinel );
+			const uint32_t hits = test( output.data() );
+			uint32_t counted = 0;
+			for ( uint32_t i = 0; i < count; i++ )
+				counted += output[i] != sentinel && ( std::is_same<T, float>::value ? output[i] != FLT_MAX : output[i] != 0 ) ? 1u : 0u;
+			CHECK( hits == counted );
+			for ( uint32_t i = count; i < output.size(); i++ )
+				CHECK( output[i] == sentinel );
+			if ( path == IntersectionPath::Scalar )
+			{
+				reference = output;
+				referenceHits = hits;
+				continue;
+			}
+			const bool same = hits == referenceHits && std::memcmp( output.data(), reference.data(), output.size() * sizeof( T ) ) == 0;
+			if ( !same )
+				std::printf( "%s: %s differs from scalar with %u elements\n", name, Intersection::GetPathName( path ), count );
+			CHECK( same );
+		}
+		Intersection::SetPath( Intersection::GetSupportedPath() );
+	}
+
+	void TestSpheres()
+	{
+		std::mt19937 random( 42u );
+		for ( uint32_t count : Counts() )
+		{
+			const Batch batch( count, random );
+			const SphereStreams spheres = batch.Spheres();
+			for ( const XMFLOAT3& center : { XMFLOAT3( 0.0f, 0.0f, 0.0f ), XMFLOAT3( 2.5f, -1.25f, 4.0f ) } )
+				CompareOutputs( "SphereSphere", count, RESULT_SENTINEL, [&]( uint8_t* results )
+				{
+					return Intersection::SphereSphere( spheres, count, center, 1.5f, results );
+				} );
+
+			// pairs index anywhere in the batch, in any order
+			std::vector<Intersection::Pair> pairs;
+			std::uniform_int_distribution<uint32_t> index( 0u, count > 0u ? count - 1u : 0u );
+			for ( uint32_t i = 0; i < count; i++ )
+				pairs.push_back( { index( random ), index( random ) } );
+			CompareOutputs( "SpherePairs", count, RESULT_SENTINEL, [&]( uint8_t* results )
+			{
+				return Intersection::SpherePairs( spheres, pairs.data(), count, results );
+			} );
+		}
+
+		// touching counts as overlapping on every path
+		const float x[] = { 0.0f, 3.0f }, y[] = { 0.0f, 0.0f }, z[] = { 0.0f, 0.0f }, radius[] = { 1.0f, 2.0f };
+		const Intersection::Pair pair = { 0u, 1u };
+		for ( IntersectionPath path : paths )
+		{
+			Intersection::SetPath( path );
+			uint8_t result = 0;
+			CHECK( Intersection::SpherePairs( { x, y, z, radius }, &pair, 1u, &result ) == 1u && result == 1u );
+		}
+		Intersection::SetPath( Intersection::GetSupportedPath() );
+	}
+
+	void TestFrustums()
+	{
+		// a box from -5 to 5 on every axis with inward planes, and a tilted one
+		const float s = 0.70710678f;
+		const XMFLOAT4 cube[6] = { { 1.0f, 0.0f, 0.0f, 5.0f }, { -1.0f, 0.0f, 0.0f, 5.0f }, { 0.0f, 1.0f, 0.0f, 5.0f },
+			{ 0.0f, -1.0f, 0.0f, 5.0f }, { 0.0f, 0.0f, 1.0f, 5.0f }, { 0.0f, 0.0f, -1.0f, 5.0f } };
+		const XMFLOAT4 tilted[6] = { { s, s, 0.0f, 3.0f }, { -s, -s, 0.0f, 3.0f }, { s, -s, 0.0f, 3.0f },
+			{ -s, s, 0.0f, 3.0f }, { 0.0f, s, s, 2.0f }, { 0.0f, -s, -s, 6.0f } };
+		std::mt19937 random( 7u );
+		for ( uint32_t count : Counts() )
+		{
+			const Batch batch( count, random );
+			for ( const XMFLOAT4* planes : { cube, tilted } )
+			{
+				CompareOutputs( "SphereFrustum", count, RESULT_SENTINEL, [&]( uint8_t* results )
+				{
+					return Intersection::SphereFrustum( batch.Spheres(), count, planes, results );
+				} );
+				CompareOutputs( "BoxFrustum", count, RESULT_SENTINEL, [&]( uint8_t* results )
+				{
+					return Intersection::BoxFrustum( batch.Boxes(), count, planes, results );
+				} );
+			}
+		}
+
+		// a sphere and a box just touching the outside of the cube are kept, a hair further out they aren't
+		const float x[] = { 6.0f, 6.01f }, y[] = { 0.0f, 0.0f }, z[] = { 0.0f, 0.0f }, size[] = { 1.0f, 1.0f };
+		uint8_t results[2] = {};
+		CHECK( Intersection::SphereFrustum( { x, y, z, size }, 2u, cube, results ) == 1u && results[0] == 1u && results[1] == 0u );
+		CHECK( Intersection::BoxFrustum( { x, y, z, size, size, size }, 2u, cube, results ) == 1u && results[0] == 1u && results[1] == 0u );
+	}
+
+	void TestRays()
+	{
+		// random directions, then the axes both ways, whose inverse directions are infinite on the other two
+		std::vector<XMFLOAT3> directions = { { 1.0f, 0.0f, 0.0f }, { -1.0f, 0.0f, 0.0f }, { 0.0f, 1.0f, 0.0f },
+			{ 0.0f, -1.0f, 0.0f }, { 0.0f, 0.0f, 1.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 2.0f, 0.0f }, { 1.0f, 1.0f, 0.0f } };
+		std::mt19937 random( 11u );
+		std::uniform_real_distribution<float> component( -1.0f, 1.0f );
+		for ( int i = 0; i < 4; i++ )
+			directions.push_back( { component( random ), component( random ), component( random ) } );
+
+		// origins on the quarter grid sit exactly on box faces, where the slab test multiplies zero by an infinite inverse
+		const XMFLOAT3 origins[] = { { -12.0f, 0.0f, 0.0f }, { 0.25f, 0.5f, -0.75f }, { 1.0f, -2.0f, 3.0f } };
+		for ( uint32_t count : Counts() )
+		{
+			const Batch batch( count, random );
+			for ( const XMFLOAT3& origin : origins )
+				for ( const XMFLOAT3& direction : directions )
+					for ( float maxDistance : { FLT_MAX, 6.0f } )
+					{
+						CompareOutputs( "RaySphere", count, DISTANCE_SENTINEL, [&]( float* distances )
+						{
+							return Intersection::RaySphere( batch.Spheres(), count, origin, direction, maxDistance, distances );
+						} );
+						CompareOutputs( "RayBox", count, DISTANCE_SENTINEL, [&]( float* distances )
+						{
+							return Intersection::RayBox( batch.Boxes(), count, origin, direction, maxDistance, distances );
+						} );
+					}
+		}
+
+		// an axis-parallel ray: a box ahead, one beside it, one it starts in, one behind and one past the maximum distance
+		const float x[] = { 0.0f, 0.0f, -10.0f, -20.0f, 40.0f }, y[] = { 0.0f, 3.0f, 0.0f, 0.0f, 0.0f };
+		const float z[] = { 0.0f, 0.0f, 0.0f, 0.0f, 0.0f }, extent[] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+		for ( IntersectionPath path : paths )
+		{
+			Intersection::SetPath( path );
+			float distances[5] = {};
+			const uint32_t boxHits = Intersection::RayBox( { x, y, z, extent, extent, extent }, 5u, { -10.0f, 0.0f, 0.0f },
+				{ 1.0f, 0.0f, 0.0f }, 30.0f, distances );
+			CHECK( boxHits == 2u );
+			CHECK( distances[0] == 9.0f && distances[1] == FLT_MAX && distances[2] == 0.0f );
+			CHECK( distances[3] == FLT_MAX && distances[4] == FLT_MAX );
+			const uint32_t sphereHits = Intersection::RaySphere( { x, y, z, extent }, 5u, { -10.0f, 0.0f, 0.0f },
+				{ 1.0f, 0.0f, 0.0f }, 30.0f, distances );
+			CHECK( sphereHits == 2u );
+			CHECK( distances[0] == 9.0f && distances[1] == FLT_MAX && distances[2] == 0.0f );
+			CHECK( distances[3] == FLT_MAX && distances[4] == FLT_MAX );
+		}
+		Intersection::SetPath( Intersection::GetSupportedPath() );
+	}
+}
+
+int main()
+{
+	std::printf( "widest path: %s\n", Intersection::GetPathName( Intersection::GetSupportedPath() ) );
+	TestSpheres();
+	TestFrustums();
+	TestRays();
+	return ReportChecks();
+}
\ No newline at end of file